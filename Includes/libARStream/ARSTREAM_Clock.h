@@ -0,0 +1,128 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Clock.h
+ * @brief Time source and waiting primitives used by libARStream
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_CLOCK_H_
+#define _ARSTREAM_CLOCK_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+#include <time.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARStream/ARSTREAM_Error.h>
+
+/*
+ * Macros
+ */
+
+/*
+ * Types
+ */
+
+/**
+ * @brief ARStream clock interface.
+ * All the time reads and all the condition waits of the senders, the
+ * readers and the in-process transports (loopback, impairment) go
+ * through this interface. The default clock uses ARSAL. Replacing it
+ * lets a simulator run the protocol threads in virtual time.
+ *
+ * Members:
+ * - void getTime (void *context, struct timespec *now)
+ *   -> reads the current time (same clock as ARSAL_Time_GetTime)
+ * - int condWait (void *context, ARSAL_Cond_t *cond,
+ *                 ARSAL_Mutex_t *mutex, int timeoutMs)
+ *   -> waits for cond to be signaled, with mutex locked, for at most
+ *      timeoutMs milliseconds (forever if timeoutMs is negative).
+ *      returns 0 when signaled, ETIMEDOUT on timeout. May return
+ *      early (spurious wakeup).
+ * - void condSignal (void *context, ARSAL_Cond_t *cond)
+ *   -> wakes up one thread waiting on cond
+ * - void *context
+ *   -> Implementation private data, given as the first argument to all
+ *      other functions.
+ */
+typedef struct {
+    void (*getTime)(void *context, struct timespec *now);
+    int (*condWait)(void *context, ARSAL_Cond_t *cond, ARSAL_Mutex_t *mutex, int timeoutMs);
+    void (*condSignal)(void *context, ARSAL_Cond_t *cond);
+    void *context;
+} ARSTREAM_Clock_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Replaces the clock of libARStream
+ * @warning The clock is global: it must only be changed while no sender, reader or transport exists
+ * @param[in] clock The new clock (copied), or NULL to restore the default ARSAL clock
+ * @return ARSTREAM_OK, or ARSTREAM_ERROR_BAD_PARAMETERS if a member of clock (except context) is NULL
+ */
+eARSTREAM_ERROR ARSTREAM_Clock_SetClock (const ARSTREAM_Clock_t *clock);
+
+/**
+ * @brief Reads the current time of the libARStream clock
+ * @param[out] now The current time
+ */
+void ARSTREAM_Clock_GetTime (struct timespec *now);
+
+/**
+ * @brief Reads the current time of the libARStream clock, in microseconds
+ * @return The current time
+ */
+uint64_t ARSTREAM_Clock_GetTimeUs (void);
+
+/**
+ * @brief Waits on a condition with the libARStream clock
+ * @param[in] cond The condition
+ * @param[in] mutex The mutex, locked by the caller
+ * @param[in] timeoutMs The maximum wait, or a negative value to wait forever
+ * @return 0 when signaled, ETIMEDOUT on timeout
+ */
+int ARSTREAM_Clock_CondWait (ARSAL_Cond_t *cond, ARSAL_Mutex_t *mutex, int timeoutMs);
+
+/**
+ * @brief Signals a condition with the libARStream clock
+ * @param[in] cond The condition
+ */
+void ARSTREAM_Clock_CondSignal (ARSAL_Cond_t *cond);
+
+#endif /* _ARSTREAM_CLOCK_H_ */
@@ -49,12 +49,32 @@
 #include <libARNetwork/ARNETWORK_Manager.h>
 #include <libARStream/ARSTREAM_Error.h>
 #include <libARStream/ARSTREAM_Filter.h>
+#include <libARStream/ARSTREAM_Transport.h>
 
 /*
  * Macros
  */
 #define ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT (5)
 
+/**
+ * @brief maxAckInterval value which disables ACKs completely
+ * With this value, the reader never sends any ACK, and ARSTREAM_Reader_RunAckThread returns immediately.
+ * The ack buffer is then only used for feedback and clock messages (see ARSTREAM_Reader_SetFeedback() and ARSTREAM_Reader_SetClockSyncInterval()).
+ * This is intended to be used with a sender in ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT mode.
+ */
+#define ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK (-1)
+
+/**
+ * @brief Minimum time between two automatic keyframe requests, if no keyframe was received in between
+ */
+#define ARSTREAM_READER_KEYFRAME_REQUEST_RETRY_MS (250)
+
+/**
+ * @brief Clock exchange interval used by the jitter buffer when ARSTREAM_Reader_SetClockSyncInterval() was not called
+ * Clock exchanges tell the sender that the reader understands frame timestamps.
+ */
+#define ARSTREAM_READER_JITTER_BUFFER_CLOCK_SYNC_INTERVAL_MS (1000)
+
 /*
  * Types
  */
@@ -70,6 +90,26 @@ typedef enum {
     ARSTREAM_READER_CAUSE_MAX,
 } eARSTREAM_READER_CAUSE;
 
+/**
+ * @brief Packetization of the frames on the network
+ * @see ARSTREAM_Reader_SetPacketizationMode()
+ */
+typedef enum {
+    ARSTREAM_READER_PACKETIZATION_NATIVE = 0, /**< Frames are received as fixed size fragments, with an ARStream header. This is the default mode */
+    ARSTREAM_READER_PACKETIZATION_RTP_H264, /**< Frames are received as RTP packets (RFC 6184) from a sender in ARSTREAM_SENDER_PACKETIZATION_RTP_H264 mode */
+    ARSTREAM_READER_PACKETIZATION_MAX,
+} eARSTREAM_READER_PACKETIZATION;
+
+/**
+ * @brief Startup modes of the reader
+ * @see ARSTREAM_Reader_SetStartupMode()
+ */
+typedef enum {
+    ARSTREAM_READER_STARTUP_FIRST_FRAME = 0, /**< Frames are given to the application from the first complete frame. This is the default mode */
+    ARSTREAM_READER_STARTUP_WAIT_KEYFRAME, /**< Frames are discarded until the first complete flush frame or keyframe */
+    ARSTREAM_READER_STARTUP_MAX,
+} eARSTREAM_READER_STARTUP;
+
 /**
  * @brief Callback called when a new frame is ready in a buffer
  *
@@ -93,6 +133,52 @@ typedef enum {
  */
 typedef uint8_t* (*ARSTREAM_Reader_FrameCompleteCallback_t) (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom);
 
+/**
+ * @brief Informations about the last complete frame
+ * @see ARSTREAM_Reader_GetFrameInfos()
+ */
+typedef struct {
+    uint16_t frameNumber; /**< Frame number given by the sender */
+    int isFlushFrame; /**< Boolean-like (0-1) flag telling if the frame was a flush frame */
+    int priority; /**< Priority class given by the sender (see eARSTREAM_SENDER_FRAME_PRIORITY) */
+    int hasTimestamp; /**< Boolean-like (0-1) flag telling if timestampUs is valid (senders only send timestamps to readers which exchange clock or feedback frames) */
+    uint64_t timestampUs; /**< Sender time when the frame was given to the sender, in microseconds (see ARSTREAM_Reader_SenderTimeToReaderTime()) */
+} ARSTREAM_Reader_FrameInfos_t;
+
+/**
+ * @brief Informations about the clock synchronization with the sender
+ * @see ARSTREAM_Reader_GetClockInfos()
+ */
+typedef struct {
+    int isSynchronized; /**< Boolean-like (0-1) flag telling if the other fields are valid */
+    int64_t offsetUs; /**< Sender clock minus reader clock, in microseconds */
+    double driftPpm; /**< Drift of the sender clock relative to the reader clock, in parts per million */
+    int64_t rttUs; /**< Round trip time of the best clock exchange, in microseconds */
+} ARSTREAM_Reader_ClockInfos_t;
+
+/**
+ * @brief Informations about the jitter buffer
+ * @see ARSTREAM_Reader_GetJitterBufferInfos()
+ */
+typedef struct {
+    int isEnabled; /**< Boolean-like (0-1) flag telling if the jitter buffer is enabled */
+    int targetDelayMs; /**< Current delay added to the frames with the smallest transit time, in milliseconds */
+    int nbWaitingFrames; /**< Number of frames waiting for their playout time */
+    uint32_t nbLateFrames; /**< Number of frames which completed after their playout time */
+    uint32_t nbSkippedFrames; /**< Number of late frames which were skipped to catch up with the stream */
+} ARSTREAM_Reader_JitterBufferInfos_t;
+
+/**
+ * @brief Stream startup metrics, measured from the start of ARSTREAM_Reader_RunDataThread()
+ * @see ARSTREAM_Reader_GetStartupInfos()
+ */
+typedef struct {
+    int timeToFirstPacketMs; /**< Time until the first stream packet was received, in milliseconds (-1 if none yet) */
+    int timeToFirstFrameMs; /**< Time until the first frame was complete, in milliseconds (-1 if none yet) */
+    int timeToFirstDecodableFrameMs; /**< Time until the first flush frame or keyframe was complete, in milliseconds (-1 if none yet). The jitter buffer delay is not included */
+    uint32_t nbDiscardedFrames; /**< Number of complete frames discarded while waiting for the first keyframe (ARSTREAM_READER_STARTUP_WAIT_KEYFRAME mode only) */
+} ARSTREAM_Reader_StartupInfos_t;
+
 /**
  * @brief An ARSTREAM_Reader_t instance allow reading streamed frames from a network
  */
@@ -129,7 +215,7 @@ void ARSTREAM_Reader_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
  * @param[in] frameBuffer The adress of the first frameBuffer to use
  * @param[in] frameBufferSize The length of the frameBuffer (to avoid overflow)
  * @param[in] maxFragmentSize Maximum allowed size for a video data fragment. Video frames larger that will be fragmented.
- * @param[in] maxAckInterval Maximum interval between sending ACKs. 0 disables only periodic ACKs. -1 disables ACKs completely.
+ * @param[in] maxAckInterval Maximum interval between sending ACKs. 0 disables only periodic ACKs. ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK (-1) disables ACKs completely.
  * If unsure, use the default value in ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT.
  * @param[in] custom Custom pointer which will be passed to callback
  * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
@@ -141,6 +227,25 @@ void ARSTREAM_Reader_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
  */
 ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, ARSTREAM_Reader_FrameCompleteCallback_t callback, uint8_t *frameBuffer, uint32_t frameBufferSize, uint32_t maxFragmentSize, int32_t maxAckInterval, void *custom, eARSTREAM_ERROR *error);
 
+/**
+ * @brief Creates a new ARSTREAM_Reader_t which receives frames from the given transport
+ * @warning This function allocates memory. An ARSTREAM_Reader_t muse be deleted by a call to ARSTREAM_Reader_Delete
+ *
+ * @param[in] transport The transport to use. The structure is copied, but the transport context must stay valid until ARSTREAM_Reader_Delete(), which does not release it
+ * @param[in] callback The callback which will be called every time a new frame is available
+ * @param[in] frameBuffer The adress of the first frameBuffer to use
+ * @param[in] frameBufferSize The length of the frameBuffer (to avoid overflow)
+ * @param[in] maxFragmentSize Maximum allowed size for a video data fragment. Video frames larger that will be fragmented.
+ * @param[in] maxAckInterval Maximum interval between sending ACKs. 0 disables only periodic ACKs. ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK (-1) disables ACKs completely.
+ * If unsure, use the default value in ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT.
+ * @param[in] custom Custom pointer which will be passed to callback
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Reader_t, or NULL if an error occured
+ * @see ARSTREAM_Reader_New()
+ * @see ARSTREAM_Reader_Delete()
+ */
+ARSTREAM_Reader_t* ARSTREAM_Reader_NewWithTransport (const ARSTREAM_Transport_t *transport, ARSTREAM_Reader_FrameCompleteCallback_t callback, uint8_t *frameBuffer, uint32_t frameBufferSize, uint32_t maxFragmentSize, int32_t maxAckInterval, void *custom, eARSTREAM_ERROR *error);
+
 /**
  * @brief Stops a running ARSTREAM_Reader_t
  * @warning Once stopped, an ARSTREAM_Reader_t can not be restarted
@@ -176,11 +281,24 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param);
 /**
  * @brief Runs the acknowledge loop of the ARSTREAM_Reader_t
  * @warning This function never returns until ARSTREAM_Reader_StopReader() is called. Thus, it should be called on its own thread
+ * @note If the reader was created with ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK, this function returns immediately
  * @post Stop the ARSTREAM_Reader_t by calling ARSTREAM_Reader_StopReader() before joining the thread calling this function
  * @param[in] ARSTREAM_Reader_t_Param A valid (ARSTREAM_Reader_t *) casted as a (void *)
  */
 void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param);
 
+/**
+ * @brief Runs the playout loop of the ARSTREAM_Reader_t
+ * This loop releases the frames held by the jitter buffer to the application callback.
+ * When the jitter buffer is enabled, the application callback is only called from this thread.
+ * @warning This function never returns until ARSTREAM_Reader_StopReader() is called. Thus, it should be called on its own thread
+ * @note If the jitter buffer is not enabled, this function returns immediately
+ * @post Stop the ARSTREAM_Reader_t by calling ARSTREAM_Reader_StopReader() before joining the thread calling this function
+ * @param[in] ARSTREAM_Reader_t_Param A valid (ARSTREAM_Reader_t *) casted as a (void *)
+ * @see ARSTREAM_Reader_SetJitterBuffer()
+ */
+void* ARSTREAM_Reader_RunPlayoutThread (void *ARSTREAM_Reader_t_Param);
+
 /**
  * @brief Gets the estimated network efficiency for the ARSTREAM link
  * An efficiency of 1.0f means that we did not receive any useless packet.
@@ -190,6 +308,163 @@ void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param);
  */
 float ARSTREAM_Reader_GetEstimatedEfficiency (ARSTREAM_Reader_t *reader);
 
+/**
+ * @brief Gets informations about the last complete frame
+ * This function is intended to be called from the callback, during an ARSTREAM_READER_CAUSE_FRAME_COMPLETE call.
+ * Outside of the callback, the informations may already refer to the next frame.
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[out] infos Pointer to the ARSTREAM_Reader_FrameInfos_t to fill
+ * @return ARSTREAM_OK if infos was filled
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader or infos is NULL
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_GetFrameInfos (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_FrameInfos_t *infos);
+
+/**
+ * @brief Configures the feedback messages sent by the reader on the ack buffer
+ * When autoKeyframeRequest is active, the reader asks the sender for a new keyframe when it
+ * misses frames and the next complete frame is not a keyframe (reference break). Requests are
+ * repeated at most every ARSTREAM_READER_KEYFRAME_REQUEST_RETRY_MS until a keyframe is received.
+ * When receiverReportIntervalMs is positive, the reader periodically sends a report with the
+ * fraction of frames lost, the frame interarrival jitter and the highest frame number seen.
+ * Feedback is disabled by default, as senders older than this feature log an error for each message.
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] autoKeyframeRequest Boolean-like (0-1) flag enabling automatic keyframe requests
+ * @param[in] receiverReportIntervalMs Time between two receiver reports, in milliseconds (0 disables the reports)
+ * @return ARSTREAM_OK if the new configuration is set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is NULL or receiverReportIntervalMs is negative
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetFeedback (ARSTREAM_Reader_t *reader, int autoKeyframeRequest, int receiverReportIntervalMs);
+
+/**
+ * @brief Asks the sender for a new keyframe
+ * This can be used when the decoder detects an error that the reader can not see.
+ * @note This function can be called from the ARSTREAM_Reader_FrameCompleteCallback_t
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @return ARSTREAM_OK if the request was sent
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is NULL
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_RequestKeyframe (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Sets the maximum time the reader waits for a frame to complete
+ * When a frame is still incomplete maxFrameLatencyMs after its first fragment was received,
+ * the reader abandons it, and tells the sender to stop retrying it.
+ * The sender then cancels the frame (ARSTREAM_SENDER_STATUS_FRAME_CANCEL), and moves on to the next one.
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] maxFrameLatencyMs Maximum frame latency, in milliseconds (0 means "never abandon", which is the default)
+ * @return ARSTREAM_OK if the new latency is set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is NULL or maxFrameLatencyMs is negative
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetMaximumFrameLatency (ARSTREAM_Reader_t *reader, int maxFrameLatencyMs);
+
+/**
+ * @brief Sets the interval between two clock exchanges with the sender
+ * Clock exchanges let the reader estimate the offset and drift between the sender clock and its
+ * own monotonic clock (ARSAL_Time_GetTime), to convert sender timestamps into reader time.
+ * The sender answers them from its ack thread, which must be running.
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] intervalMs Time between two clock exchanges, in milliseconds (0 disables the exchanges, which is the default)
+ * @return ARSTREAM_OK if the new interval is set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is NULL or intervalMs is negative
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetClockSyncInterval (ARSTREAM_Reader_t *reader, int intervalMs);
+
+/**
+ * @brief Gets the current state of the clock synchronization with the sender
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[out] infos Pointer to the ARSTREAM_Reader_ClockInfos_t to fill
+ * @return ARSTREAM_OK if infos was filled
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader or infos is NULL
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_GetClockInfos (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_ClockInfos_t *infos);
+
+/**
+ * @brief Converts a sender timestamp into reader time
+ * Both times are in microseconds of the ARSAL_Time_GetTime clock of each side.
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] senderTimeUs The sender timestamp
+ * @param[out] readerTimeUs Pointer which will hold the corresponding reader time
+ * @return ARSTREAM_OK if readerTimeUs was set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader or readerTimeUs is NULL
+ * @return ARSTREAM_ERROR_NOT_SYNCHRONIZED if not enough clock exchanges were done yet
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SenderTimeToReaderTime (ARSTREAM_Reader_t *reader, uint64_t senderTimeUs, uint64_t *readerTimeUs);
+
+/**
+ * @brief Configures the jitter buffer
+ * When enabled, complete frames are not given to the application at once. They are held by the
+ * reader, and released by ARSTREAM_Reader_RunPlayoutThread() at the pace they were given to the sender.
+ * Each frame is delayed so that its total transit time matches a high percentile of the recent
+ * transit times : the delay grows as soon as the network jitter grows, and shrinks slowly to keep
+ * a smooth cadence. The delay never goes above maxDelayMs. When frames are late and the next frame
+ * is also due, frames with a priority of ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE or lower are
+ * skipped (and counted in numberOfSkippedFrames). When too many frames are waiting, the oldest frame
+ * of lowest priority is skipped, and flush frames are kept as long as possible.
+ * Frame timestamps are only sent to readers which exchange clock or feedback frames, so enabling the
+ * jitter buffer also enables clock exchanges (every ARSTREAM_READER_JITTER_BUFFER_CLOCK_SYNC_INTERVAL_MS)
+ * if they were disabled. Frames without timestamp are released after minDelayMs.
+ * @note Frames are copied once more, from the jitter buffer to the application buffers
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] minDelayMs Minimum delay added to the frames, in milliseconds
+ * @param[in] maxDelayMs Maximum delay added to the frames, in milliseconds (0 disables the jitter buffer, which is the default)
+ * @return ARSTREAM_OK if the new configuration is set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is NULL, minDelayMs is negative, or maxDelayMs is non-zero and lower than minDelayMs
+ * @return ARSTREAM_ERROR_BUSY if the reader threads are running and the jitter buffer would be enabled or disabled (limits can be changed at any time)
+ * @return ARSTREAM_ERROR_ALLOC if the jitter buffer could not allocate its first buffer
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetJitterBuffer (ARSTREAM_Reader_t *reader, int minDelayMs, int maxDelayMs);
+
+/**
+ * @brief Sets the packetization used by the sender
+ * In ARSTREAM_READER_PACKETIZATION_RTP_H264 mode, the frames are rebuilt in H.264 Annex-B format,
+ * with 4 bytes start codes. The sender only sends each packet once, so the reader should be
+ * created with ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK. When packets are lost, the damaged NAL units
+ * are removed and the other NAL units of the frame are still given to the application.
+ * Frame numbers are counted by the reader, priorities are read from the NAL units headers, and
+ * frames never have a timestamp (ARSTREAM_Reader_FrameInfos_t hasTimestamp is always 0).
+ * Clock and feedback frames are still handled in this mode.
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] mode The new packetization mode
+ * @return ARSTREAM_OK if the new mode is set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is NULL or mode is invalid
+ * @return ARSTREAM_ERROR_BUSY if the reader threads are running
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetPacketizationMode (ARSTREAM_Reader_t *reader, eARSTREAM_READER_PACKETIZATION mode);
+
+/**
+ * @brief Sets the startup mode of the reader
+ * In ARSTREAM_READER_STARTUP_WAIT_KEYFRAME mode, the reader does not give the application any frame
+ * before the first complete flush frame or keyframe, as the decoder could not use them. Frames without
+ * any slice (e.g. SPS/PPS only) are still given to the application. The frame buffer is grown to the
+ * full size announced by the first fragment of the keyframe, instead of growing each time a fragment
+ * does not fit. If automatic keyframe requests are enabled (see ARSTREAM_Reader_SetFeedback()), the
+ * reader asks for a keyframe as soon as it discards a frame.
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] mode The new startup mode
+ * @return ARSTREAM_OK if the new mode is set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is NULL or mode is invalid
+ * @return ARSTREAM_ERROR_BUSY if the reader threads are running
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetStartupMode (ARSTREAM_Reader_t *reader, eARSTREAM_READER_STARTUP mode);
+
+/**
+ * @brief Gets the current state of the jitter buffer
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[out] infos Pointer to the ARSTREAM_Reader_JitterBufferInfos_t to fill
+ * @return ARSTREAM_OK if infos was filled
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader or infos is NULL
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_GetJitterBufferInfos (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_JitterBufferInfos_t *infos);
+
+/**
+ * @brief Gets the stream startup metrics of the reader
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[out] infos Pointer to the ARSTREAM_Reader_StartupInfos_t to fill
+ * @return ARSTREAM_OK if infos was filled
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader or infos is NULL
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_GetStartupInfos (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_StartupInfos_t *infos);
+
 /**
  * @brief Gets the custom pointer associated with the reader
  * @param[in] reader The ARSTREAM_Reader_t
@@ -49,6 +49,7 @@
 #include <libARNetwork/ARNETWORK_Manager.h>
 #include <libARStream/ARSTREAM_Filter.h>
 #include <libARStream/ARSTREAM_Error.h>
+#include <libARStream/ARSTREAM_Transport.h>
 
 /*
  * Macros
@@ -63,15 +64,98 @@
  */
 typedef enum {
     ARSTREAM_SENDER_STATUS_FRAME_SENT = 0, /**< Frame was sent and acknowledged by peer */
-    ARSTREAM_SENDER_STATUS_FRAME_CANCEL, /**< Frame was not sent, and was cancelled by a new frame */
+    ARSTREAM_SENDER_STATUS_FRAME_CANCEL, /**< Frame was not sent, and was cancelled by a new frame, or abandoned by the reader */
     ARSTREAM_SENDER_STATUS_FRAME_LATE_ACK, /**< We received a full ack for an old frame. The callback will be called with null pointer and zero size. */
+    ARSTREAM_SENDER_STATUS_FRAME_EXPIRED, /**< Frame was not sent before its maximum age, and was cancelled */
     ARSTREAM_SENDER_STATUS_MAX,
 } eARSTREAM_SENDER_STATUS;
 
+/**
+ * @brief Priority classes of the frames
+ * The priority of a frame should follow how many later frames depend on it.
+ * Lower priority frames are dropped first when the frame queue is congested.
+ */
+typedef enum {
+    ARSTREAM_SENDER_FRAME_PRIORITY_DISPOSABLE = 0, /**< Frame can be dropped without any impact on other frames */
+    ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE, /**< Non-reference frame (no later frame depends on it, e.g. non-reference B/P frames) */
+    ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE, /**< Reference frame (later frames depend on it, e.g. reference P frames) */
+    ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME, /**< Key frame (all later frames depend on it, e.g. IDR frames). Flush frames always have this priority */
+    ARSTREAM_SENDER_FRAME_PRIORITY_MAX,
+} eARSTREAM_SENDER_FRAME_PRIORITY;
+
+/**
+ * @brief Policies applied when a new frame is sent while the frame queue is full
+ */
+typedef enum {
+    ARSTREAM_SENDER_QUEUE_POLICY_DROP_NEWEST = 0, /**< The new frame is rejected (ARSTREAM_ERROR_QUEUE_FULL). This is the default policy */
+    ARSTREAM_SENDER_QUEUE_POLICY_DROP_OLDEST, /**< The oldest queued frame which is not a flush frame is cancelled to make room for the new frame */
+    ARSTREAM_SENDER_QUEUE_POLICY_REPLACE_WITH_KEYFRAME, /**< A new key frame cancels all the queued frames of lower priority. Other new frames are rejected */
+    ARSTREAM_SENDER_QUEUE_POLICY_MAX,
+} eARSTREAM_SENDER_QUEUE_POLICY;
+
+/**
+ * @brief Reliability modes of the sender
+ * @see ARSTREAM_Sender_SetReliabilityMode()
+ */
+typedef enum {
+    ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT = 0, /**< Each fragment is sent once, and the frame is considered as sent. No acknowledge is used, so ARSTREAM_Sender_RunAckThread only needs to run to receive feedback and clock messages (pair with a reader using ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK) */
+    ARSTREAM_SENDER_RELIABILITY_SEMI_RELIABLE, /**< Missing fragments are retried until the frame is replaced, expires, or reaches its maximum number of retries. This is the default mode : with the default settings and ARSTREAM_Sender_SendNewFrame() frames, any new frame replaces the current one, and frames are retried until replaced */
+    ARSTREAM_SENDER_RELIABILITY_FULLY_RELIABLE, /**< Missing fragments are retried until the frame is fully acknowledged. Only flush frames can replace a frame which was not acknowledged */
+    ARSTREAM_SENDER_RELIABILITY_MAX,
+} eARSTREAM_SENDER_RELIABILITY;
+
+/**
+ * @brief Packetization modes of the sender
+ * @see ARSTREAM_Sender_SetPacketizationMode()
+ */
+typedef enum {
+    ARSTREAM_SENDER_PACKETIZATION_NATIVE = 0, /**< Frames are cut in fixed size fragments, with an ARStream header. This is the default mode */
+    ARSTREAM_SENDER_PACKETIZATION_RTP_H264, /**< Frames are H.264 Annex-B access units, sent as RTP packets (RFC 6184) aligned on NAL units. Pair with a reader in ARSTREAM_READER_PACKETIZATION_RTP_H264 mode */
+    ARSTREAM_SENDER_PACKETIZATION_MAX,
+} eARSTREAM_SENDER_PACKETIZATION;
+
+/**
+ * @brief Fragmentation modes of the sender (ARSTREAM_SENDER_PACKETIZATION_NATIVE only)
+ * @see ARSTREAM_Sender_SetFragmentationMode()
+ */
+typedef enum {
+    ARSTREAM_SENDER_FRAGMENTATION_FIXED = 0, /**< Frames are cut every maxFragmentSize bytes. This is the default mode */
+    ARSTREAM_SENDER_FRAGMENTATION_NAL_ALIGNED, /**< Frames are cut on H.264 Annex-B start codes when possible, in variable size fragments */
+    ARSTREAM_SENDER_FRAGMENTATION_MAX,
+} eARSTREAM_SENDER_FRAGMENTATION;
+
+/**
+ * @brief Types of the feedback messages sent by the reader
+ * @see ARSTREAM_Sender_SetFeedbackCallback()
+ */
+typedef enum {
+    ARSTREAM_SENDER_FEEDBACK_KEYFRAME_REQUEST = 0, /**< The reader lost a reference frame and asks for a new keyframe */
+    ARSTREAM_SENDER_FEEDBACK_RECEIVER_REPORT, /**< Periodic reception statistics */
+    ARSTREAM_SENDER_FEEDBACK_MAX,
+} eARSTREAM_SENDER_FEEDBACK;
+
+/**
+ * @brief Content of a feedback message sent by the reader
+ */
+typedef struct {
+    eARSTREAM_SENDER_FEEDBACK type; /**< Type of the feedback */
+    uint16_t lastCompleteFrameNumber; /**< Number of the last frame completed by the reader */
+    uint16_t highestFrameNumber; /**< Highest frame number seen by the reader */
+    float lossFraction; /**< Fraction of frames lost since the previous report (0.0-1.0). Only valid for receiver reports */
+    uint32_t cumulativeLost; /**< Total number of frames lost by the reader */
+    uint32_t jitterUs; /**< Frame interarrival jitter, in microseconds */
+} ARSTREAM_Sender_Feedback_t;
+
+/**
+ * @brief Maximum number of retries which means "use the default for the frame priority"
+ * @see ARSTREAM_Sender_SetReliabilityMode()
+ */
+#define ARSTREAM_SENDER_DEFAULT_MAX_RETRIES (-1)
+
 /**
  * @brief Callback type for sender informations
  * This callback is called when a frame pointer is no longer needed by the library.
- * This can occur when a frame is acknowledged, cancelled, or if a network error happened.
+ * This can occur when a frame is acknowledged, cancelled, expired, or if a network error happened.
  *
  * This callback is also used when we receive the first "full-ack" for an old frame. In
  * this case, the framePointer and frameSize arguments are unused and set to NULL. There
@@ -87,6 +171,31 @@ typedef enum {
  */
 typedef void (*ARSTREAM_Sender_FrameUpdateCallback_t)(eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
 
+/**
+ * @brief Callback type for target bitrate changes
+ * This callback is called by the congestion controller of the sender when its target
+ * bitrate changes significantly (more than 10% since the last call). The application
+ * should adapt its encoder bitrate to the target.
+ *
+ * @param[in] targetBitrate New target bitrate, in bits per second
+ * @param[in] custom Custom pointer passed during ARSTREAM_Sender_New
+ * @warning This callback is called from the sender internal threads
+ * @see ARSTREAM_Sender_SetTargetBitrateCallback()
+ */
+typedef void (*ARSTREAM_Sender_TargetBitrateCallback_t)(uint32_t targetBitrate, void *custom);
+
+/**
+ * @brief Callback type for reader feedback
+ * On ARSTREAM_SENDER_FEEDBACK_KEYFRAME_REQUEST, the application should ask its encoder for a
+ * new keyframe, and send it as a flush frame.
+ *
+ * @param[in] feedback The feedback message (only valid during the call)
+ * @param[in] custom Custom pointer passed during ARSTREAM_Sender_New
+ * @warning This callback is called from the ack thread
+ * @see ARSTREAM_Sender_SetFeedbackCallback()
+ */
+typedef void (*ARSTREAM_Sender_FeedbackCallback_t)(const ARSTREAM_Sender_Feedback_t *feedback, void *custom);
+
 /**
  * @brief An ARSTREAM_Sender_t instance allow streaming frames over a network
  */
@@ -108,6 +217,46 @@ typedef struct ARSTREAM_Sender_t ARSTREAM_Sender_t;
  */
 #define ARSTREAM_SENDER_INFINITE_TIME_BETWEEN_RETRIES (100000)
 
+/**
+ * @brief "Infinite" frame age.
+ * Frames with this maximum age never expire. This is the default sender setting.
+ */
+#define ARSTREAM_SENDER_INFINITE_FRAME_AGE (0)
+/**
+ * @brief Per-frame maximum age value which means "use the sender setting"
+ * @see ARSTREAM_Sender_SetMaximumFrameAge()
+ */
+#define ARSTREAM_SENDER_STREAM_FRAME_AGE (-1)
+
+/**
+ * @brief Per-frame priority value which means "no priority given by the application"
+ * Such frames are handled as ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE frames (or
+ * ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME for flush frames) by the queue policies, but are
+ * retried as ARSTREAM_Sender_SendNewFrame() frames always were : until replaced, with no retry limit.
+ * @see ARSTREAM_Sender_FrameParams_t
+ */
+#define ARSTREAM_SENDER_FRAME_PRIORITY_DEFAULT (-1)
+
+/**
+ * @brief Default lower limit of the target bitrate, in bits per second
+ * @see ARSTREAM_Sender_SetTargetBitrateLimits()
+ */
+#define ARSTREAM_SENDER_DEFAULT_MIN_TARGET_BITRATE (250000)
+/**
+ * @brief Default upper limit of the target bitrate, in bits per second
+ * @see ARSTREAM_Sender_SetTargetBitrateLimits()
+ */
+#define ARSTREAM_SENDER_DEFAULT_MAX_TARGET_BITRATE (10000000)
+
+/**
+ * @brief Per-frame parameters for ARSTREAM_Sender_SendNewFrameWithParams calls
+ * @see ARSTREAM_Sender_FrameParamsDefaultInit()
+ */
+typedef struct {
+    int flushPreviousFrames; /**< Boolean-like flag (0/1). If active, tells the sender to flush the frame queue when adding this frame. */
+    int maxFrameAgeMs; /**< Maximum age of the frame, in miliseconds. ARSTREAM_SENDER_STREAM_FRAME_AGE to use the sender setting, ARSTREAM_SENDER_INFINITE_FRAME_AGE to never expire */
+    eARSTREAM_SENDER_FRAME_PRIORITY priority; /**< Priority class of the frame, or ARSTREAM_SENDER_FRAME_PRIORITY_DEFAULT */
+} ARSTREAM_Sender_FrameParams_t;
 
 
 /*
@@ -154,6 +303,26 @@ void ARSTREAM_Sender_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
  */
 ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, ARSTREAM_Sender_FrameUpdateCallback_t callback, uint32_t framesBufferSize, uint32_t maxFragmentSize, uint32_t maxNumberOfFragment,  void *custom, eARSTREAM_ERROR *error);
 
+/**
+ * @brief Creates a new ARSTREAM_Sender_t which streams frames on the given transport
+ * @warning This function allocates memory. An ARSTREAM_Sender_t muse be deleted by a call to ARSTREAM_Sender_Delete
+ *
+ * @param[in] transport The transport to use. The structure is copied, but the transport context must stay valid until ARSTREAM_Sender_Delete(), which does not release it
+ * @param[in] callback The status update callback which will be called every time the status of a send-frame is updated
+ * @param[in] framesBufferSize Number of frames that the ARSTREAM_Sender_t instance will be able to hold in queue
+ * @param[in] maxFragmentSize Maximum allowed size for a video data fragment. Video frames larger that will be fragmented.
+ * @param[in] maxNumberOfFragment number maximum of fragment of one frame.
+ * @param[in] custom Custom pointer which will be passed to callback
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Sender_t, or NULL if an error occured
+ *
+ * @note The transport must be able to carry packets of maxFragmentSize bytes plus the stream headers
+ *
+ * @see ARSTREAM_Sender_New()
+ * @see ARSTREAM_Sender_Delete()
+ */
+ARSTREAM_Sender_t* ARSTREAM_Sender_NewWithTransport (const ARSTREAM_Transport_t *transport, ARSTREAM_Sender_FrameUpdateCallback_t callback, uint32_t framesBufferSize, uint32_t maxFragmentSize, uint32_t maxNumberOfFragment, void *custom, eARSTREAM_ERROR *error);
+
 /**
  * @brief Sets the minimum and maximum time between retries.
  * Setting a small retry time might increase reliability, at the cost of network and cpu loads.
@@ -176,6 +345,172 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
  */
 eARSTREAM_ERROR ARSTREAM_Sender_SetTimeBetweenRetries (ARSTREAM_Sender_t *sender, int minWaitTimeMs, int maxWaitTimeMs);
 
+/**
+ * @brief Sets the maximum age of the frames sent by the sender.
+ * A frame which is still in the queue, or not yet acknowledged, when its age exceeds this value
+ * is cancelled, and the callback is called with the ARSTREAM_SENDER_STATUS_FRAME_EXPIRED status.
+ * The age of a frame is computed from the ARSTREAM_Sender_SendNewFrame call.
+ *
+ * @note This value is only used for frames which don't override it (see ARSTREAM_Sender_FrameParams_t).
+ * @note To disable frame expiry, use ARSTREAM_SENDER_INFINITE_FRAME_AGE.
+ * @param sender The ARSTREAM_Sender_t
+ * @param maxFrameAgeMs The maximum age of a frame, in miliseconds.
+ *
+ * @return ARSTREAM_OK if the new maximum age is set.
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, or if maxFrameAgeMs is negative.
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetMaximumFrameAge (ARSTREAM_Sender_t *sender, int maxFrameAgeMs);
+
+/**
+ * @brief Sets the behavior of the sender when the frame queue is congested.
+ *
+ * The policy is applied when a new frame is sent while the frame queue is full.
+ *
+ * The decimation watermark is applied before the policy: when a new frame is sent while
+ * at least decimationWatermark frames are waiting in the queue, the queued frames with a priority
+ * of ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE or lower are cancelled (lowest priority first,
+ * then oldest first) until the queue goes below the watermark. If the queue is still above the
+ * watermark, a new frame with such a priority is rejected.
+ *
+ * @param sender The ARSTREAM_Sender_t
+ * @param policy The policy to apply when the queue is full
+ * @param decimationWatermark Number of queued frames above which non-reference frames are dropped. Zero disables decimation.
+ *
+ * @return ARSTREAM_OK if the new policy is set.
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, or if policy is not a valid eARSTREAM_SENDER_QUEUE_POLICY.
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetQueuePolicy (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_QUEUE_POLICY policy, uint32_t decimationWatermark);
+
+/**
+ * @brief Sets the reliability mode of the sender.
+ *
+ * In ARSTREAM_SENDER_RELIABILITY_SEMI_RELIABLE mode, maxRetries limits the number of retry rounds
+ * of each frame. By default (ARSTREAM_SENDER_DEFAULT_MAX_RETRIES), the limit depends on the priority
+ * given to the frame (see ARSTREAM_Sender_FrameParams_t) : disposable frames are never retried,
+ * non-reference frames are retried once, and other frames are retried until replaced. Frames
+ * without a priority (ARSTREAM_Sender_SendNewFrame() frames) are retried until replaced.
+ * maxRetries is unused in other modes.
+ * In this mode, an unacknowledged reference or key frame with a priority is also kept for a few
+ * retry rounds (1 and 3) before a frame of lower priority can replace it. Frames without a priority
+ * are always replaced by the next frame.
+ *
+ * @note In ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT mode, the ack thread only handles feedback and clock messages from the reader.
+ * @param sender The ARSTREAM_Sender_t
+ * @param mode The new reliability mode
+ * @param maxRetries Maximum number of retry rounds for a frame, or ARSTREAM_SENDER_DEFAULT_MAX_RETRIES.
+ *
+ * @return ARSTREAM_OK if the new mode is set.
+ * @return ARSTREAM_ERROR_BUSY if the ARSTREAM_Sender_t is running (the mode must be set before starting the threads)
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, if mode is not a valid eARSTREAM_SENDER_RELIABILITY, or if maxRetries is invalid.
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if mode is not ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT while in ARSTREAM_SENDER_PACKETIZATION_RTP_H264 mode.
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetReliabilityMode (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_RELIABILITY mode, int maxRetries);
+
+/**
+ * @brief Sets the packetization mode of the sender.
+ *
+ * In ARSTREAM_SENDER_PACKETIZATION_RTP_H264 mode, the NAL units of each frame are sent in RTP packets :
+ * small NAL units are aggregated in STAP-A packets, large ones are split in FU-A packets, and the
+ * last packet of each frame has the marker bit set. A lost packet then only costs the NAL units it
+ * carried, instead of the whole frame. RTP packets are never retried, so this mode also sets the
+ * reliability mode to ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT. The RTP header is larger than the
+ * ARStream header, so RTP payloads are at most maxFragmentSize - 7 bytes.
+ *
+ * @param sender The ARSTREAM_Sender_t
+ * @param mode The new packetization mode
+ *
+ * @return ARSTREAM_OK if the new mode is set.
+ * @return ARSTREAM_ERROR_BUSY if the ARSTREAM_Sender_t is running (the mode must be set before starting the threads)
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, if mode is not a valid eARSTREAM_SENDER_PACKETIZATION, or if maxFragmentSize is too small for RTP packets.
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetPacketizationMode (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_PACKETIZATION mode);
+
+/**
+ * @brief Sets the fragmentation mode of the sender.
+ *
+ * In ARSTREAM_SENDER_FRAGMENTATION_NAL_ALIGNED mode, each fragment ends on a NAL unit start code
+ * when a start code can be found in the last maxFragmentSize bytes, so that fragments carry whole
+ * NAL units (slices) wherever possible. Several small NAL units are grouped in one fragment, and NAL
+ * units larger than a fragment are cut at fixed size. Fragments are sent with their byte offset in
+ * the frame, which uses 4 bytes of each fragment.
+ * Older readers can not place variable size fragments, so frames are still cut at fixed size until
+ * the reader sent clock or feedback frames. Frames which are not in Annex-B format, or which would
+ * need more than maxNumberOfFragment fragments, are also cut at fixed size.
+ *
+ * @param sender The ARSTREAM_Sender_t
+ * @param mode The new fragmentation mode
+ *
+ * @return ARSTREAM_OK if the new mode is set.
+ * @return ARSTREAM_ERROR_BUSY if the ARSTREAM_Sender_t is running (the mode must be set before starting the threads)
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, or if mode is not a valid eARSTREAM_SENDER_FRAGMENTATION.
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetFragmentationMode (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_FRAGMENTATION mode);
+
+/**
+ * @brief Enables or disables the automatic classification of the frames.
+ *
+ * When enabled, each H.264 Annex-B frame given to ARSTREAM_Sender_SendNewFrame() or
+ * ARSTREAM_Sender_SendNewFrameWithParams() is scanned for its NAL units, and its priority
+ * class is set from their types:
+ * - Frames with an IDR slice are flush frames, with ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME
+ * - Frames with a reference slice, or with SPS/PPS only, are ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE
+ * - Frames with only non-reference slices (nal_ref_idc == 0) are ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE
+ * - Frames without any slice (SEI, AUD...) are ARSTREAM_SENDER_FRAME_PRIORITY_DISPOSABLE
+ * A flush requested by the application is always kept. Frames which do not start with a start
+ * code keep the priority given by the application.
+ * The NAL units found are kept with the frame, so the ARSTREAM_SENDER_FRAGMENTATION_NAL_ALIGNED
+ * mode does not need to scan the frame again.
+ *
+ * @param sender The ARSTREAM_Sender_t
+ * @param enable Boolean-like (0/1) flag. Disabled by default
+ *
+ * @return ARSTREAM_OK if the new setting is applied to the next frames.
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, or if enable is not 0 or 1.
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetAutoClassification (ARSTREAM_Sender_t *sender, int enable);
+
+/**
+ * @brief Enables or disables the keyframe cache of the sender.
+ *
+ * When enabled, the sender keeps a reference to the latest frame with an IDR slice, and to
+ * the latest frame with SPS/PPS but without IDR slice (frames are inspected as with
+ * ARSTREAM_Sender_SetAutoClassification(), and flush frames are used as keyframes if they are
+ * not in Annex-B format). When a reader joins the stream (first clock or feedback frame) or asks
+ * for a keyframe, the cached frames are sent again right away as key frames, the first one being
+ * a flush frame, so that the reader can start decoding after about one round trip instead of
+ * waiting for the next keyframe of the encoder. The resend is skipped if a key frame is already
+ * waiting in the queue.
+ *
+ * Cached frames are not copied: the frame callback of a cached frame is delayed until the frame
+ * is replaced in the cache by a newer one, or until ARSTREAM_Sender_Delete(). The application
+ * must provide enough frame buffers for two frames to be held this way.
+ *
+ * @note Later frames of the encoder may reference frames that the reader never received, so the
+ * application should still answer the ARSTREAM_SENDER_FEEDBACK_KEYFRAME_REQUEST feedback with a
+ * fresh keyframe.
+ *
+ * @param sender The ARSTREAM_Sender_t
+ * @param enable Boolean-like (0/1) flag. Disabled by default
+ *
+ * @return ARSTREAM_OK if the new setting is applied.
+ * @return ARSTREAM_ERROR_BUSY if the ARSTREAM_Sender_t is running (the cache must be set before starting the threads)
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, or if enable is not 0 or 1.
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetKeyframeCache (ARSTREAM_Sender_t *sender, int enable);
+
+/**
+ * @brief Sends the keyframe cache again, as when a new reader joins the stream.
+ * Use this function when the application detects a new reader by other means (e.g. a new connection).
+ * Does nothing if the cache is empty.
+ *
+ * @param sender The ARSTREAM_Sender_t
+ *
+ * @return ARSTREAM_OK if the resend is scheduled.
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, or if the keyframe cache is not enabled.
+ * @see ARSTREAM_Sender_SetKeyframeCache()
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_ResendKeyframeCache (ARSTREAM_Sender_t *sender);
+
 /**
  * @brief Stops a running ARSTREAM_Sender_t
  * @warning Once stopped, an ARSTREAM_Sender_t can not be restarted
@@ -211,10 +546,32 @@ eARSTREAM_ERROR ARSTREAM_Sender_Delete (ARSTREAM_Sender_t **sender);
  * @return ARSTREAM_OK if no error happened
  * @return ARSTREAM_ERROR_BAD_PARAMETERS if the sender or frameBuffer pointer is invalid, or if frameSize is zero
  * @return ARSTREAM_ERROR_FRAME_TOO_LARGE if the frameSize is greater that the maximum frame size of the libARStream (typically 128000 bytes)
- * @return ARSTREAM_ERROR_QUEUE_FULL if the frame can not be added to queue. This value can not happen if flushPreviousFrames is active
+ * @return ARSTREAM_ERROR_QUEUE_FULL if the frame can not be added to queue (see ARSTREAM_Sender_SetQueuePolicy()). This value can not happen if flushPreviousFrames is active
  */
 eARSTREAM_ERROR ARSTREAM_Sender_SendNewFrame (ARSTREAM_Sender_t *sender, uint8_t *frameBuffer, uint32_t frameSize, int flushPreviousFrames, int *nbPreviousFrames);
 
+/**
+ * @brief Sets an ARSTREAM_Sender_FrameParams_t to its default values
+ * Default values give the same behavior as an ARSTREAM_Sender_SendNewFrame call without flush.
+ * @param[in] params Pointer to the ARSTREAM_Sender_FrameParams_t to set
+ */
+void ARSTREAM_Sender_FrameParamsDefaultInit (ARSTREAM_Sender_FrameParams_t *params);
+
+/**
+ * @brief Sends a new frame, with per-frame parameters
+ *
+ * @param[in] sender The ARSTREAM_Sender_t which will try to send the frame
+ * @param[in] frameBuffer pointer to the frame in memory
+ * @param[in] frameSize size of the frame in memory
+ * @param[in] params Parameters of the frame. If NULL, default parameters are used.
+ * @param[out] nbPreviousFrames Optionnal int pointer which will store the number of frames previously in the buffer (even if the buffer is flushed)
+ * @return Same values as ARSTREAM_Sender_SendNewFrame
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if params contains invalid values
+ *
+ * @see ARSTREAM_Sender_FrameParamsDefaultInit()
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SendNewFrameWithParams (ARSTREAM_Sender_t *sender, uint8_t *frameBuffer, uint32_t frameSize, const ARSTREAM_Sender_FrameParams_t *params, int *nbPreviousFrames);
+
 /**
  * @brief Flushes all currently queued frames
  *
@@ -235,6 +592,7 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param);
 /**
  * @brief Runs the acknowledge loop of the ARSTREAM_Sender_t
  * @warning This function never returns until ARSTREAM_Sender_StopSender() is called. Thus, it should be called on its own thread
+ * @note In ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT mode, this function only handles feedback and clock messages from the reader
  * @post Stop the ARSTREAM_Sender_t by calling ARSTREAM_Sender_StopSender() before joining the thread calling this function
  * @param[in] ARSTREAM_Sender_t_Param A valid (ARSTREAM_Sender_t *) casted as a (void *)
  */
@@ -248,6 +606,47 @@ void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param);
  */
 float ARSTREAM_Sender_GetEstimatedEfficiency (ARSTREAM_Sender_t *sender);
 
+/**
+ * @brief Sets the limits of the target bitrate computed by the congestion controller
+ * The controller starts at the upper limit, then estimates the available bandwidth from the
+ * acknowledge rate, and lowers its target when the acknowledge delay grows (queueing) or when
+ * fragments are lost.
+ * @param[in] sender The ARSTREAM_Sender_t
+ * @param[in] minBitrate Lower limit of the target bitrate, in bits per second
+ * @param[in] maxBitrate Upper limit of the target bitrate, in bits per second
+ * @return ARSTREAM_OK if the new limits are set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, or if minBitrate is greater than maxBitrate
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetTargetBitrateLimits (ARSTREAM_Sender_t *sender, uint32_t minBitrate, uint32_t maxBitrate);
+
+/**
+ * @brief Sets the callback called on significant target bitrate changes
+ * @param[in] sender The ARSTREAM_Sender_t
+ * @param[in] callback The callback, or NULL to disable notifications
+ * @return ARSTREAM_OK if the callback is set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL
+ * @see ARSTREAM_Sender_TargetBitrateCallback_t
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetTargetBitrateCallback (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_TargetBitrateCallback_t callback);
+
+/**
+ * @brief Gets the target bitrate computed by the congestion controller
+ * @note In ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT mode, no acknowledge is received, so the target stays at its upper limit
+ * @param[in] sender The ARSTREAM_Sender_t
+ * @return The target bitrate, in bits per second, or 0 if sender is NULL
+ */
+uint32_t ARSTREAM_Sender_GetTargetBitrate (ARSTREAM_Sender_t *sender);
+
+/**
+ * @brief Sets the callback called when a feedback message is received from the reader
+ * @param[in] sender The ARSTREAM_Sender_t
+ * @param[in] callback The callback, or NULL to ignore feedback messages
+ * @return ARSTREAM_OK if the callback is set
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL
+ * @see ARSTREAM_Sender_FeedbackCallback_t
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetFeedbackCallback (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_FeedbackCallback_t callback);
+
 /**
  * @brief Gets the custom pointer associated with the sender
  * @param[in] sender The ARSTREAM_Sender_t
@@ -0,0 +1,509 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Transport.h
+ * @brief Transport layer used by the ARSTREAM_Sender_t and ARSTREAM_Reader_t
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_TRANSPORT_H_
+#define _ARSTREAM_TRANSPORT_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARNetwork/ARNETWORK_Manager.h>
+#include <libARStream/ARSTREAM_Error.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Default number of packets sent or received by one system call on an UDP transport
+ */
+#define ARSTREAM_TRANSPORT_UDP_DEFAULT_BATCH_SIZE (64)
+
+/**
+ * @brief Maximum number of packets sent or received by one system call on an UDP transport
+ */
+#define ARSTREAM_TRANSPORT_UDP_MAX_BATCH_SIZE (1024)
+
+/**
+ * @brief Default number of packet slots from the sender to the reader on a shared memory transport
+ */
+#define ARSTREAM_TRANSPORT_SHM_DEFAULT_NB_DATA_SLOTS (512)
+
+/**
+ * @brief Default number of packet slots from the reader to the sender on a shared memory transport
+ */
+#define ARSTREAM_TRANSPORT_SHM_DEFAULT_NB_ACK_SLOTS (64)
+
+/**
+ * @brief Default number of packets which can wait in each direction of a loopback transport
+ */
+#define ARSTREAM_TRANSPORT_LOOPBACK_DEFAULT_NB_SLOTS (1024)
+
+/**
+ * @brief Default maximum queueing delay of the bandwidth limited link of an impairment transport
+ */
+#define ARSTREAM_TRANSPORT_IMPAIRMENT_DEFAULT_QUEUE_LIMIT_MS (200)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Status given to an ARSTREAM_Transport_SendCallback_t
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_SEND_STATUS_SENT = 0, /**< The fragment was sent on the network */
+    ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL, /**< The fragment was flushed before being sent */
+} eARSTREAM_TRANSPORT_SEND_STATUS;
+
+/**
+ * @brief I/O engine of an UDP transport
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_UDP_IO_ENGINE_SYSCALLS = 0, /**< Batched sendmmsg() / recvmmsg() system calls */
+    ARSTREAM_TRANSPORT_UDP_IO_ENGINE_IO_URING, /**< io_uring (Linux 6.0 or later), falls back to ARSTREAM_TRANSPORT_UDP_IO_ENGINE_SYSCALLS when unavailable */
+    ARSTREAM_TRANSPORT_UDP_IO_ENGINE_MAX, /**< Max value for eARSTREAM_TRANSPORT_UDP_IO_ENGINE */
+} eARSTREAM_TRANSPORT_UDP_IO_ENGINE;
+
+/**
+ * @brief Callback called by a transport when a fragment given to sendFragment was sent or flushed
+ * @param[in] customData The customData given to sendFragment
+ * @param[in] status The fragment status
+ */
+typedef void (*ARSTREAM_Transport_SendCallback_t) (void *customData, eARSTREAM_TRANSPORT_SEND_STATUS status);
+
+/**
+ * @brief ARStream transport interface.
+ * A transport carries the stream data (frame fragments and control
+ * frames) from the sender to the reader, and the acknowledges and
+ * feedback packets from the reader to the sender. Packets are always
+ * delivered whole: each call of a send function is received by
+ * exactly one call of the matching receive function (or lost).
+ * A transport is used by one sender or one reader at a time.
+ *
+ * Members:
+ * - eARSTREAM_ERROR sendFragment (void *context,
+ *                                 uint8_t *data, int size,
+ *                                 void *customData,
+ *                                 ARSTREAM_Transport_SendCallback_t callback)
+ *   -> sends a data packet to the reader. data is copied or sent
+ *      before the call returns. If callback is not NULL and the call
+ *      returns ARSTREAM_OK, callback will be called exactly once with
+ *      customData, when the packet is sent or flushed. It can be called
+ *      from within sendFragment(), submit() or flush().
+ * - void submit (void *context)
+ *   -> sends the data packets buffered by sendFragment. Called by the
+ *      sender after each burst of packets (e.g. all the fragments of
+ *      a frame), so that a transport can send them with a single
+ *      system call. May be NULL if sendFragment sends immediately.
+ * - eARSTREAM_ERROR receiveFragment (void *context,
+ *                                    uint8_t *data, int maxSize,
+ *                                    int *size, int timeoutMs)
+ *   -> waits at most timeoutMs for a data packet from the sender.
+ *      returns ARSTREAM_ERROR_TIMEOUT if no packet was received.
+ * - eARSTREAM_ERROR sendAck (void *context, uint8_t *data, int size)
+ *   -> sends an acknowledge or feedback packet to the sender.
+ * - eARSTREAM_ERROR receiveAck (void *context,
+ *                               uint8_t *data, int maxSize,
+ *                               int *size, int timeoutMs)
+ *   -> waits at most timeoutMs for a packet from the reader.
+ *      returns ARSTREAM_ERROR_TIMEOUT if no packet was received.
+ * - void flush (void *context)
+ *   -> drops the data packets which were not sent yet (their callbacks
+ *      are called with ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL).
+ *      May be NULL if the transport never delays packets.
+ * - int getEstimatedLatency (void *context)
+ *   -> returns the estimated one way latency in milliseconds, or a
+ *      negative value if unknown. May be NULL.
+ * - void destroy (void *context)
+ *   -> frees the context. Called by ARSTREAM_Transport_Destroy(). May
+ *      be NULL.
+ * - void *context
+ *   -> Implementation private data, given as the first argument to all
+ *      other functions.
+ *
+ * A sender only uses sendFragment, submit, receiveAck, flush and
+ * getEstimatedLatency. A reader only uses receiveFragment and sendAck.
+ */
+typedef struct {
+    eARSTREAM_ERROR (*sendFragment)(void *context,
+                                    uint8_t *data, int size,
+                                    void *customData,
+                                    ARSTREAM_Transport_SendCallback_t callback);
+    void (*submit)(void *context);
+    eARSTREAM_ERROR (*receiveFragment)(void *context,
+                                       uint8_t *data, int maxSize,
+                                       int *size, int timeoutMs);
+    eARSTREAM_ERROR (*sendAck)(void *context, uint8_t *data, int size);
+    eARSTREAM_ERROR (*receiveAck)(void *context,
+                                  uint8_t *data, int maxSize,
+                                  int *size, int timeoutMs);
+    void (*flush)(void *context);
+    int (*getEstimatedLatency)(void *context);
+    void (*destroy)(void *context);
+    void *context;
+} ARSTREAM_Transport_t;
+
+/**
+ * @brief Parameters of a raw UDP transport
+ * @see ARSTREAM_Transport_UdpParamsDefaultInit()
+ * @see ARSTREAM_Transport_InitUdp()
+ */
+typedef struct {
+    const char *localAddress; /**< IPv4 address to bind to, or NULL for any address */
+    int localPort; /**< UDP port to bind to, or 0 for any port */
+    const char *remoteAddress; /**< IPv4 address of the peer, or NULL to answer the source of the last received packet (reader side) */
+    int remotePort; /**< UDP port of the peer (ignored if remoteAddress is NULL) */
+    uint32_t maxFragmentSize; /**< maxFragmentSize given to the sender / reader using this transport */
+    int batchSize; /**< Maximum number of packets sent or received by one system call (1 to ARSTREAM_TRANSPORT_UDP_MAX_BATCH_SIZE) */
+    int socketBufferSize; /**< Socket send and receive buffer size in bytes, or 0 to keep the system default */
+    int offload; /**< Boolean-like (0-1) flag: use UDP segmentation offload (UDP_SEGMENT) on send and receive offload (UDP_GRO) if the system supports them (Linux only) */
+    eARSTREAM_TRANSPORT_UDP_IO_ENGINE ioEngine; /**< I/O engine used for the data path */
+    int estimatedLatencyMs; /**< Round trip time of the link in milliseconds, used by the sender to time its retries, or -1 if unknown */
+} ARSTREAM_Transport_UdpParams_t;
+
+/**
+ * @brief Side of a shared memory transport
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_SHM_SIDE_SENDER = 0, /**< Transport used by an ARSTREAM_Sender_t */
+    ARSTREAM_TRANSPORT_SHM_SIDE_READER, /**< Transport used by an ARSTREAM_Reader_t */
+    ARSTREAM_TRANSPORT_SHM_SIDE_MAX, /**< Max value for eARSTREAM_TRANSPORT_SHM_SIDE */
+} eARSTREAM_TRANSPORT_SHM_SIDE;
+
+/**
+ * @brief Parameters of a shared memory transport
+ * @see ARSTREAM_Transport_ShmParamsDefaultInit()
+ * @see ARSTREAM_Transport_InitShmCreate()
+ */
+typedef struct {
+    uint32_t maxFragmentSize; /**< maxFragmentSize given to the sender / reader using this transport. There is no MTU : a whole frame can be one fragment */
+    int nbDataSlots; /**< Number of packets which can wait from the sender to the reader (a power of two) */
+    int nbAckSlots; /**< Number of packets which can wait from the reader to the sender (a power of two) */
+} ARSTREAM_Transport_ShmParams_t;
+
+/**
+ * @brief Direction of a packet on a loopback transport
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_DATA = 0, /**< From the sender to the reader (fragments and control frames) */
+    ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_ACK, /**< From the reader to the sender (acknowledges and feedback) */
+    ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX, /**< Max value for eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION */
+} eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION;
+
+/**
+ * @brief Hook called by a loopback transport for each packet, before it is queued
+ * Called from the sending thread (sender or reader threads), possibly from
+ * several threads at once.
+ * @param[in] customData The hookCustomData of the parameters
+ * @param[in] direction The packet direction
+ * @param[in] data The packet
+ * @param[in] size The packet size
+ * @return 1 to deliver the packet, 0 to drop it
+ */
+typedef int (*ARSTREAM_Transport_LoopbackHook_t) (void *customData, eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION direction, const uint8_t *data, int size);
+
+/**
+ * @brief Parameters of a loopback transport
+ * @see ARSTREAM_Transport_LoopbackParamsDefaultInit()
+ * @see ARSTREAM_Transport_InitLoopback()
+ */
+typedef struct {
+    uint32_t maxFragmentSize; /**< maxFragmentSize given to the sender / reader using this transport */
+    int nbSlots; /**< Number of packets which can wait in each direction (a power of two) */
+    ARSTREAM_Transport_LoopbackHook_t hook; /**< Packet hook, or NULL */
+    void *hookCustomData; /**< Custom data given to the hook */
+} ARSTREAM_Transport_LoopbackParams_t;
+
+/**
+ * @brief Counters of one direction of a loopback transport
+ */
+typedef struct {
+    uint64_t nbPackets; /**< Packets queued */
+    uint64_t nbBytes; /**< Bytes queued */
+    uint64_t nbHookDropped; /**< Packets dropped by the hook */
+    uint64_t nbOverflowDropped; /**< Packets dropped because the queue was full */
+} ARSTREAM_Transport_LoopbackStats_t;
+
+/**
+ * @brief Packet loss model of an impairment transport
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_NONE = 0, /**< No random loss */
+    ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_BERNOULLI, /**< Independent losses with probability lossRate */
+    ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_GILBERT_ELLIOTT, /**< Burst losses: two states Markov chain, with a loss probability per state */
+    ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_MAX, /**< Max value for eARSTREAM_TRANSPORT_IMPAIRMENT_LOSS */
+} eARSTREAM_TRANSPORT_IMPAIRMENT_LOSS;
+
+/**
+ * @brief Parameters of an impairment transport
+ * Probabilities are in [0, 1]. Impairments apply to the packets sent through
+ * the wrapped transport (fragments and acks), in this order: loss, bandwidth
+ * limit (with its queue), delay and jitter, reordering, duplication.
+ * @see ARSTREAM_Transport_ImpairmentParamsDefaultInit()
+ * @see ARSTREAM_Transport_InitImpairment()
+ */
+typedef struct {
+    uint32_t seed; /**< Seed of the random generator: the same seed gives the same impairments for the same packet sequence */
+    eARSTREAM_TRANSPORT_IMPAIRMENT_LOSS lossModel; /**< Loss model */
+    double lossRate; /**< Loss probability (Bernoulli model) */
+    double goodToBadRate; /**< Probability to go from the good to the bad state, per packet (Gilbert-Elliott model) */
+    double badToGoodRate; /**< Probability to go from the bad to the good state, per packet (Gilbert-Elliott model) */
+    double goodLossRate; /**< Loss probability in the good state (Gilbert-Elliott model) */
+    double badLossRate; /**< Loss probability in the bad state (Gilbert-Elliott model) */
+    int delayMs; /**< Fixed one way delay */
+    int jitterMs; /**< Random delay variation, uniform in [-jitterMs, +jitterMs] (packets can be reordered by the jitter) */
+    double reorderRate; /**< Probability to hold a packet back by reorderDelayMs more */
+    int reorderDelayMs; /**< Extra delay of the reordered packets */
+    double duplicateRate; /**< Probability to send a packet twice */
+    int bandwidthKbps; /**< Link bandwidth in kbit/s, or 0 for unlimited */
+    int queueLimitMs; /**< Maximum queueing delay of the bandwidth limited link: packets which would wait longer are dropped */
+} ARSTREAM_Transport_ImpairmentParams_t;
+
+/**
+ * @brief Counters of an impairment transport
+ */
+typedef struct {
+    uint64_t nbPackets; /**< Packets given to the impairment transport */
+    uint64_t nbLost; /**< Packets dropped by the loss model */
+    uint64_t nbQueueDropped; /**< Packets dropped by the bandwidth limited link queue */
+    uint64_t nbReordered; /**< Packets held back by the reordering */
+    uint64_t nbDuplicated; /**< Packets sent twice */
+} ARSTREAM_Transport_ImpairmentStats_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Sets up an ARSTREAM_Transport_t which uses ARNetwork IOBuffers
+ * This is the transport used by ARSTREAM_Sender_New() and ARSTREAM_Reader_New().
+ * @warning This function allocates memory. The transport must be released by a call to ARSTREAM_Transport_Destroy()
+ *
+ * @param[out] transport The ARSTREAM_Transport_t to set up
+ * @param[in] manager Pointer to a valid and connected ARNETWORK_Manager_t
+ * @param[in] dataBufferID ID of the stream data buffer within the manager
+ * @param[in] ackBufferID ID of the stream ack buffer within the manager
+ * @return ARSTREAM_OK if the transport was set up
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if transport or manager is NULL
+ * @return ARSTREAM_ERROR_ALLOC if the transport context could not be allocated
+ *
+ * @see ARSTREAM_Sender_InitStreamDataBuffer()
+ * @see ARSTREAM_Sender_InitStreamAckBuffer()
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_InitARNetwork (ARSTREAM_Transport_t *transport, ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID);
+
+/**
+ * @brief Sets the default values of ARSTREAM_Transport_UdpParams_t
+ * Addresses are NULL, ports are 0, batchSize is ARSTREAM_TRANSPORT_UDP_DEFAULT_BATCH_SIZE,
+ * socketBufferSize is 0, offload is 1, ioEngine is ARSTREAM_TRANSPORT_UDP_IO_ENGINE_SYSCALLS
+ * and estimatedLatencyMs is -1 (the sender then uses its default retry time).
+ * maxFragmentSize and the ports must still be set.
+ * @param[out] params The parameters to initialize
+ */
+void ARSTREAM_Transport_UdpParamsDefaultInit (ARSTREAM_Transport_UdpParams_t *params);
+
+/**
+ * @brief Sets up an ARSTREAM_Transport_t which sends the stream directly on an UDP socket
+ * Data and acknowledges share the socket. The fragments given to sendFragment are buffered
+ * until submit (or until batchSize fragments are waiting), then sent with one system call
+ * (sendmmsg() on Linux). Received packets are drained by bursts of up to batchSize packets
+ * (recvmmsg() on Linux) into preallocated slots.
+ * With offload, consecutive fragments of the same size are given to the kernel as one
+ * message which it splits into datagrams (UDP_SEGMENT), and the datagrams coalesced by the
+ * kernel on reception (UDP_GRO) are split back. Each offload is disabled if the system
+ * does not support it, or rejects it (e.g. fragments larger than the path MTU).
+ * With the io_uring engine, a batch is submitted as one chain of linked send requests, and
+ * packets are received by a multishot receive request into a ring of buffers registered
+ * with the kernel : a busy reader only enters the kernel to wait when no packet is pending.
+ * Both ends of the stream must use this transport.
+ * @warning This function allocates memory. The transport must be released by a call to ARSTREAM_Transport_Destroy()
+ *
+ * @param[out] transport The ARSTREAM_Transport_t to set up
+ * @param[in] params The transport parameters
+ * @return ARSTREAM_OK if the transport was set up
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if a parameter is invalid
+ * @return ARSTREAM_ERROR_ALLOC if the transport context could not be allocated
+ * @return ARSTREAM_ERROR_TRANSPORT if the socket could not be created or bound
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_InitUdp (ARSTREAM_Transport_t *transport, const ARSTREAM_Transport_UdpParams_t *params);
+
+/**
+ * @brief Sets the default values of ARSTREAM_Transport_ShmParams_t
+ * nbDataSlots is ARSTREAM_TRANSPORT_SHM_DEFAULT_NB_DATA_SLOTS and nbAckSlots is
+ * ARSTREAM_TRANSPORT_SHM_DEFAULT_NB_ACK_SLOTS. maxFragmentSize must still be set.
+ * @param[out] params The parameters to initialize
+ */
+void ARSTREAM_Transport_ShmParamsDefaultInit (ARSTREAM_Transport_ShmParams_t *params);
+
+/**
+ * @brief Sets up an ARSTREAM_Transport_t which sends the stream through shared memory, and creates the shared memory
+ * For a sender and a reader on the same host. The shared memory (an anonymous
+ * memfd) holds one ring of packet slots for each direction. Sending copies
+ * the packet in the next slot, receiving copies it out : no system call is made,
+ * except to wake up a peer waiting for packets (futex). When a ring is full, the
+ * packet is dropped, as it would be by a full socket buffer.
+ * The returned file descriptor must be given to the other process (inherited
+ * through fork(), or sent with SCM_RIGHTS), which calls ARSTREAM_Transport_InitShmAttach()
+ * with the other side. It can be closed once shared : the transport keeps its own mapping.
+ * Linux only.
+ * @warning This function allocates memory. The transport must be released by a call to ARSTREAM_Transport_Destroy()
+ *
+ * @param[out] transport The ARSTREAM_Transport_t to set up
+ * @param[in] params The transport parameters
+ * @param[in] side The side of the stream using this transport
+ * @param[out] fd Pointer which will hold the shared memory file descriptor
+ * @return ARSTREAM_OK if the transport was set up
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if a parameter is invalid
+ * @return ARSTREAM_ERROR_ALLOC if the transport context could not be allocated
+ * @return ARSTREAM_ERROR_TRANSPORT if the shared memory could not be created or mapped
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_InitShmCreate (ARSTREAM_Transport_t *transport, const ARSTREAM_Transport_ShmParams_t *params, eARSTREAM_TRANSPORT_SHM_SIDE side, int *fd);
+
+/**
+ * @brief Sets up an ARSTREAM_Transport_t on a shared memory created by ARSTREAM_Transport_InitShmCreate()
+ * @warning This function allocates memory. The transport must be released by a call to ARSTREAM_Transport_Destroy()
+ *
+ * @param[out] transport The ARSTREAM_Transport_t to set up
+ * @param[in] fd The shared memory file descriptor (not closed by the transport)
+ * @param[in] side The side of the stream using this transport (not the side given at creation)
+ * @return ARSTREAM_OK if the transport was set up
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if a parameter is invalid, or fd is not an ARStream shared memory
+ * @return ARSTREAM_ERROR_ALLOC if the transport context could not be allocated
+ * @return ARSTREAM_ERROR_TRANSPORT if the shared memory could not be mapped
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_InitShmAttach (ARSTREAM_Transport_t *transport, int fd, eARSTREAM_TRANSPORT_SHM_SIDE side);
+
+/**
+ * @brief Sets the default values of ARSTREAM_Transport_LoopbackParams_t
+ * nbSlots is ARSTREAM_TRANSPORT_LOOPBACK_DEFAULT_NB_SLOTS and there is no hook.
+ * maxFragmentSize must still be set.
+ * @param[out] params The parameters to initialize
+ */
+void ARSTREAM_Transport_LoopbackParamsDefaultInit (ARSTREAM_Transport_LoopbackParams_t *params);
+
+/**
+ * @brief Sets up a pair of connected ARSTREAM_Transport_t, for a sender and a reader in the same process
+ * Packets go through one bounded lock-free queue per direction: no socket, no
+ * ARNetwork manager and no system call, except to wake up a receiving thread
+ * waiting on an empty queue. This isolates the protocol cost (tests, benchmarks).
+ * When a queue is full, the packet is dropped, as it would be by a full socket buffer.
+ * @warning This function allocates memory. Both transports must be released by a call to ARSTREAM_Transport_Destroy()
+ *
+ * @param[out] senderTransport The transport to give to the sender
+ * @param[out] readerTransport The transport to give to the reader
+ * @param[in] params The transport parameters
+ * @return ARSTREAM_OK if the transports were set up
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if a parameter is invalid
+ * @return ARSTREAM_ERROR_ALLOC if the transport context could not be allocated
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_InitLoopback (ARSTREAM_Transport_t *senderTransport, ARSTREAM_Transport_t *readerTransport, const ARSTREAM_Transport_LoopbackParams_t *params);
+
+/**
+ * @brief Gets the counters of one direction of a loopback transport
+ * @param[in] transport Either transport of the pair
+ * @param[in] direction The direction
+ * @param[out] stats The counters
+ * @return ARSTREAM_OK, or ARSTREAM_ERROR_BAD_PARAMETERS if transport is not a loopback transport
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_GetLoopbackStats (const ARSTREAM_Transport_t *transport, eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION direction, ARSTREAM_Transport_LoopbackStats_t *stats);
+
+/**
+ * @brief Sets the default values of ARSTREAM_Transport_ImpairmentParams_t
+ * Everything is disabled (seed 0, no loss, no delay, unlimited bandwidth), and
+ * queueLimitMs is ARSTREAM_TRANSPORT_IMPAIRMENT_DEFAULT_QUEUE_LIMIT_MS.
+ * @param[out] params The parameters to initialize
+ */
+void ARSTREAM_Transport_ImpairmentParamsDefaultInit (ARSTREAM_Transport_ImpairmentParams_t *params);
+
+/**
+ * @brief Sets up an ARSTREAM_Transport_t which emulates an impaired network on top of another transport
+ * The packets sent through the transport are dropped, delayed, reordered, duplicated
+ * or rate limited before being given to the inner transport. Received packets are not
+ * modified: to impair both directions, wrap the transports of both the sender and the reader.
+ * Combined with ARSTREAM_Transport_InitLoopback(), configurations can be compared on
+ * identical loss patterns on a single host.
+ * If a delay, a jitter, a reordering or a bandwidth limit is set, the delayed packets are
+ * sent by ARSTREAM_Transport_RunImpairmentThread(), which must run on its own thread.
+ * @warning This function allocates memory. The transport must be released by a call to ARSTREAM_Transport_Destroy()
+ *
+ * @param[out] transport The ARSTREAM_Transport_t to set up (may be inner itself, to wrap it in place)
+ * @param[in] inner The transport to wrap. On success, it is owned by the new transport and released with it
+ * @param[in] params The impairment parameters
+ * @return ARSTREAM_OK if the transport was set up
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if a parameter is invalid
+ * @return ARSTREAM_ERROR_ALLOC if the transport context could not be allocated
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_InitImpairment (ARSTREAM_Transport_t *transport, const ARSTREAM_Transport_t *inner, const ARSTREAM_Transport_ImpairmentParams_t *params);
+
+/**
+ * @brief Runs the delayed packets sending loop of an impairment transport
+ * @warning This function never returns until ARSTREAM_Transport_StopImpairment() is called. Thus, it should be called on its own thread
+ * @post Stop the transport by calling ARSTREAM_Transport_StopImpairment() before joining the thread calling this function, and before ARSTREAM_Transport_Destroy()
+ * @param ARSTREAM_Transport_t_Param A valid (ARSTREAM_Transport_t *) set up by ARSTREAM_Transport_InitImpairment(), casted as a (void *)
+ */
+void* ARSTREAM_Transport_RunImpairmentThread (void *ARSTREAM_Transport_t_Param);
+
+/**
+ * @brief Stops ARSTREAM_Transport_RunImpairmentThread()
+ * The packets still delayed are dropped.
+ * @param[in] transport The impairment transport
+ */
+void ARSTREAM_Transport_StopImpairment (ARSTREAM_Transport_t *transport);
+
+/**
+ * @brief Gets the counters of an impairment transport
+ * @param[in] transport The impairment transport
+ * @param[out] stats The counters
+ * @return ARSTREAM_OK, or ARSTREAM_ERROR_BAD_PARAMETERS if transport is not an impairment transport
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_GetImpairmentStats (const ARSTREAM_Transport_t *transport, ARSTREAM_Transport_ImpairmentStats_t *stats);
+
+/**
+ * @brief Releases an ARSTREAM_Transport_t
+ * Calls the destroy function of the transport, then clears it.
+ * @warning The transport must not be used by any sender or reader anymore
+ *
+ * @param[in] transport The ARSTREAM_Transport_t to release
+ */
+void ARSTREAM_Transport_Destroy (ARSTREAM_Transport_t *transport);
+
+#endif /* _ARSTREAM_TRANSPORT_H_ */
@@ -38,9 +38,11 @@
 #ifndef _ARSTREAM_H_
 #define _ARSTREAM_H_
 
+#include <libARStream/ARSTREAM_Clock.h>
 #include <libARStream/ARSTREAM_Error.h>
 #include <libARStream/ARSTREAM_Filter.h>
 #include <libARStream/ARSTREAM_Sender.h>
 #include <libARStream/ARSTREAM_Reader.h>
+#include <libARStream/ARSTREAM_Transport.h>
 
 #endif /* _ARSTREAM_H_ */
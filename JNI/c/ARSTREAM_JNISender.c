@@ -35,6 +35,7 @@
 #define JNI_SENDER_TAG "ARSTREAM_JNISender"
 
 static jmethodID g_cbWrapper_id = 0;
+static jmethodID g_bitrateCbWrapper_id = 0;
 static JavaVM *g_vm = NULL;
 
 
@@ -68,6 +69,36 @@ static void internalCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePoin
     return;
 }
 
+static void internalTargetBitrateCallback (uint32_t targetBitrate, void *thizz)
+{
+    JNIEnv *env = NULL;
+    int wasAlreadyAttached = 1;
+    int envStatus = (*g_vm)->GetEnv(g_vm, (void **)&env, JNI_VERSION_1_6);
+    if (envStatus == JNI_EDETACHED)
+    {
+        wasAlreadyAttached = 0;
+        if ((*g_vm)->AttachCurrentThread(g_vm, &env, NULL) != 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Unable to attach thread to VM");
+            return;
+        }
+    }
+    else if (envStatus != JNI_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Error %d while getting JNI Environment", envStatus);
+        return;
+    }
+
+    (*env)->CallVoidMethod(env, (jobject)thizz, g_bitrateCbWrapper_id, (jint)targetBitrate);
+
+    if (wasAlreadyAttached == 0)
+    {
+        (*g_vm)->DetachCurrentThread(g_vm);
+    }
+
+    return;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamSender_nativeGetDefaultMinTimeBetweenRetries (JNIEnv *env, jclass clazz)
 {
@@ -95,6 +126,7 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeInitClass (JNIEnv *env, jcla
         ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Unable to get JavaVM pointer");
     }
     g_cbWrapper_id = (*env)->GetMethodID (env, clazz, "callbackWrapper", "(IJI)V");
+    g_bitrateCbWrapper_id = (*env)->GetMethodID (env, clazz, "bitrateCallbackWrapper", "(I)V");
 }
 
 JNIEXPORT void JNICALL
@@ -116,6 +148,10 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeConstructor (JNIEnv *env, jo
     jobject g_thizz = (*env)->NewGlobalRef(env, thizz);
     ARSTREAM_Sender_t *retSender = ARSTREAM_Sender_New ((ARNETWORK_Manager_t *)(intptr_t)cNetManager, dataBufferId, ackBufferId, internalCallback, framesBufferSize, maxFragmentSize, maxNumberOfFragment, (void *)g_thizz, &err);
 
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Sender_SetTargetBitrateCallback (retSender, internalTargetBitrateCallback);
+    }
     if (err != ARSTREAM_OK)
     {
         ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Error while creating sender : %s", ARSTREAM_Error_ToString (err));
@@ -173,6 +209,12 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeGetEfficiency (JNIEnv *env,
     return ARSTREAM_Sender_GetEstimatedEfficiency ((ARSTREAM_Sender_t *)(intptr_t)cSender);
 }
 
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeGetTargetBitrate (JNIEnv *env, jobject thizz, jlong cSender)
+{
+    return (jint)ARSTREAM_Sender_GetTargetBitrate ((ARSTREAM_Sender_t *)(intptr_t)cSender);
+}
+
 JNIEXPORT jint JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSendNewFrame (JNIEnv *env, jobject thizz, jlong cSender, jlong frameBuffer, jint frameSize, jboolean flushPreviousFrames)
 {
@@ -71,6 +71,11 @@ public class ARStreamSender
      */
     private ARStreamSenderListener eventListener;
 
+    /**
+     * Optional target bitrate listener
+     */
+    private ARStreamSenderBitrateListener bitrateListener;
+
     /**
      * Check validity before all function calls
      */
@@ -304,6 +309,29 @@ public class ARStreamSender
         return nativeGetEfficiency (cSender);
     }
 
+    /**
+     * Gets the target bitrate computed by the sender congestion controller<br>
+     * The encoder bitrate should be adapted to this value.
+     * Significant changes are also reported to the ARStreamSenderBitrateListener, if any.
+     * @return Target bitrate, in bits per second
+     */
+    public int getTargetBitrate () {
+        return nativeGetTargetBitrate (cSender);
+    }
+
+    /**
+     * Sets the listener of the target bitrate changes<br>
+     * The listener is optional : without it, the target bitrate can still be polled
+     * with getTargetBitrate.
+     * @param listener The new listener, or null to remove the current one
+     */
+    public void setBitrateListener (ARStreamSenderBitrateListener listener) {
+        synchronized (this)
+        {
+            bitrateListener = listener;
+        }
+    }
+
     /**
      * Adds a new ARStreamFilter to the filter chain (at the end).<br>
      * This function can only be called on non-started instances.
@@ -332,6 +360,7 @@ public class ARStreamSender
         switch (status) {
             case ARSTREAM_SENDER_STATUS_FRAME_SENT:
             case ARSTREAM_SENDER_STATUS_FRAME_CANCEL:
+            case ARSTREAM_SENDER_STATUS_FRAME_EXPIRED:
                 ARNativeData data = null;
                 synchronized (this)
                 {
@@ -346,6 +375,21 @@ public class ARStreamSender
         }
     }
 
+    /**
+     * Target bitrate callback wrapper for the listener
+     */
+    private void bitrateCallbackWrapper (int targetBitrate) {
+        ARStreamSenderBitrateListener listener = null;
+        synchronized (this)
+        {
+            listener = bitrateListener;
+        }
+        if (listener == null) {
+            return;
+        }
+        listener.didUpdateTargetBitrate (targetBitrate);
+    }
+
     /* **************** */
     /* NATIVE FUNCTIONS */
     /* **************** */
@@ -412,6 +456,12 @@ public class ARStreamSender
      */
     private native float nativeGetEfficiency (long cSender);
 
+    /**
+     * Gets the target bitrate of the sender
+     * @param cSender C-Pointer to the ARSTREAM_Sender C object
+     */
+    private native int nativeGetTargetBitrate (long cSender);
+
     /**
      * Tries to send a new frame.
      * @param cSender C-Pointer to the ARSTREAM_Sender C object
@@ -43,7 +43,9 @@ public interface ARStreamSenderListener
      *       The frame was successfully sent to the reader<br>
      *    - Frame cancel:<br>
      *       The frame was cancelled before it was acknowledged<br>
-     *       This does not ensure that the frame was not received.
+     *       This does not ensure that the frame was not received.<br>
+     *    - Frame expired:<br>
+     *       The frame was cancelled because it was older than its maximum age
      * @param cause The event that triggered this call (see global func description)
      * @param currentFrame The frame buffer for the event (see global func description)
      */
@@ -55,6 +55,8 @@
 /*
  * Macros
  */
+#define ARSTREAM_BUFFERS_MAX(A,B) (((A) > (B)) ? (A) : (B))
+
 #define ARSTREAM_BUFFERS_DATA_BUFFER_TYPE            (ARNETWORKAL_FRAME_TYPE_DATA_LOW_LATENCY)
 #define ARSTREAM_BUFFERS_DATA_BUFFER_SEND_EVERY_MS   (0) // Zero means "send every time we can"
 #define ARSTREAM_BUFFERS_DATA_BUFFER_NUMBER_OF_CELLS (128)
@@ -64,7 +66,9 @@
 #define ARSTREAM_BUFFERS_ACK_BUFFER_TYPE             (ARNETWORKAL_FRAME_TYPE_DATA_LOW_LATENCY)
 #define ARSTREAM_BUFFERS_ACK_BUFFER_SEND_EVERY_MS    (0) // Zero means "send every time we can"
 #define ARSTREAM_BUFFERS_ACK_BUFFER_NUMBER_OF_CELLS  (1000) // TODO: Change to 1 when mantis 115578 will be fixed
-#define ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE    (sizeof (ARSTREAM_NetworkHeaders_AckPacket_t))
+#define ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE    (ARSTREAM_BUFFERS_MAX (sizeof (ARSTREAM_NetworkHeaders_AckPacket_t), \
+                                                                        ARSTREAM_BUFFERS_MAX (sizeof (ARSTREAM_NetworkHeaders_FeedbackPacket_t), \
+                                                                                              sizeof (ARSTREAM_NetworkHeaders_ClockFrame_t))))
 #define ARSTREAM_BUFFERS_ACK_BUFFER_OVERWRITE        (1)
 
 /*
@@ -0,0 +1,152 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Clock.c
+ * @brief Time source and waiting primitives used by libARStream
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <errno.h>
+#include <stdlib.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Clock.h>
+#include <libARSAL/ARSAL_Time.h>
+
+/*
+ * Internal functions declarations
+ */
+
+static void ARSTREAM_Clock_DefaultGetTime (void *context, struct timespec *now);
+static int ARSTREAM_Clock_DefaultCondWait (void *context, ARSAL_Cond_t *cond, ARSAL_Mutex_t *mutex, int timeoutMs);
+static void ARSTREAM_Clock_DefaultCondSignal (void *context, ARSAL_Cond_t *cond);
+
+/*
+ * Globals
+ */
+
+static const ARSTREAM_Clock_t ARSTREAM_Clock_Default = {
+    ARSTREAM_Clock_DefaultGetTime,
+    ARSTREAM_Clock_DefaultCondWait,
+    ARSTREAM_Clock_DefaultCondSignal,
+    NULL,
+};
+
+static ARSTREAM_Clock_t ARSTREAM_Clock_Current = {
+    ARSTREAM_Clock_DefaultGetTime,
+    ARSTREAM_Clock_DefaultCondWait,
+    ARSTREAM_Clock_DefaultCondSignal,
+    NULL,
+};
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_Clock_DefaultGetTime (void *context, struct timespec *now)
+{
+    (void)context;
+    ARSAL_Time_GetTime (now);
+}
+
+static int ARSTREAM_Clock_DefaultCondWait (void *context, ARSAL_Cond_t *cond, ARSAL_Mutex_t *mutex, int timeoutMs)
+{
+    int ret;
+    (void)context;
+    if (timeoutMs < 0)
+    {
+        return ARSAL_Cond_Wait (cond, mutex);
+    }
+    ret = ARSAL_Cond_Timedwait (cond, mutex, timeoutMs);
+    /* Depending on the platform, a timeout is reported as ETIMEDOUT or as -1 with errno set */
+    if ((ret == ETIMEDOUT) ||
+        ((ret == -1) && (errno == ETIMEDOUT)))
+    {
+        return ETIMEDOUT;
+    }
+    return ret;
+}
+
+static void ARSTREAM_Clock_DefaultCondSignal (void *context, ARSAL_Cond_t *cond)
+{
+    (void)context;
+    ARSAL_Cond_Signal (cond);
+}
+
+/*
+ * Implementation
+ */
+
+eARSTREAM_ERROR ARSTREAM_Clock_SetClock (const ARSTREAM_Clock_t *clock)
+{
+    if (clock == NULL)
+    {
+        ARSTREAM_Clock_Current = ARSTREAM_Clock_Default;
+        return ARSTREAM_OK;
+    }
+    if ((clock->getTime == NULL) ||
+        (clock->condWait == NULL) ||
+        (clock->condSignal == NULL))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    ARSTREAM_Clock_Current = *clock;
+    return ARSTREAM_OK;
+}
+
+void ARSTREAM_Clock_GetTime (struct timespec *now)
+{
+    ARSTREAM_Clock_Current.getTime (ARSTREAM_Clock_Current.context, now);
+}
+
+uint64_t ARSTREAM_Clock_GetTimeUs (void)
+{
+    struct timespec now;
+    ARSTREAM_Clock_Current.getTime (ARSTREAM_Clock_Current.context, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+int ARSTREAM_Clock_CondWait (ARSAL_Cond_t *cond, ARSAL_Mutex_t *mutex, int timeoutMs)
+{
+    return ARSTREAM_Clock_Current.condWait (ARSTREAM_Clock_Current.context, cond, mutex, timeoutMs);
+}
+
+void ARSTREAM_Clock_CondSignal (ARSAL_Cond_t *cond)
+{
+    ARSTREAM_Clock_Current.condSignal (ARSTREAM_Clock_Current.context, cond);
+}
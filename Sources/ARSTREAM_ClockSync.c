@@ -0,0 +1,225 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_ClockSync.c
+ * @brief Sender/Reader clock synchronization
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_ClockSync.h"
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Clock.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Exchanges with a round trip time above twice the minimum (plus this margin) are not used for the drift
+ */
+#define ARSTREAM_CLOCK_SYNC_RTT_MARGIN_US (500)
+
+/**
+ * @brief Minimum time span of the exchanges used to compute the drift
+ */
+#define ARSTREAM_CLOCK_SYNC_MIN_DRIFT_SPAN_US (2000000)
+
+/**
+ * @brief Maximum absolute drift (500 ppm), larger values are measurement errors
+ */
+#define ARSTREAM_CLOCK_SYNC_MAX_DRIFT (0.0005)
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Recomputes the reference offset and the drift from the samples
+ * @param cs The state
+ */
+static void ARSTREAM_ClockSync_Estimate (ARSTREAM_ClockSync_t *cs);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_ClockSync_Estimate (ARSTREAM_ClockSync_t *cs)
+{
+    int i;
+    int best = 0;
+    int nbFit = 0;
+    int64_t maxRttUs;
+    int64_t minTimeUs = INT64_MAX;
+    int64_t maxTimeUs = INT64_MIN;
+    double sumX = 0., sumY = 0., sumXX = 0., sumXY = 0.;
+
+    for (i = 1; i < cs->nbSamples; i++)
+    {
+        if (cs->samples[i].rttUs < cs->samples[best].rttUs)
+        {
+            best = i;
+        }
+    }
+    cs->refReaderTimeUs = cs->samples[best].readerTimeUs;
+    cs->refOffsetUs = cs->samples[best].offsetUs;
+    cs->rttUs = cs->samples[best].rttUs;
+
+    /* Least squares fit of the offset against the reader time, centered on
+     * the reference exchange to keep the numbers small */
+    maxRttUs = 2 * cs->rttUs + ARSTREAM_CLOCK_SYNC_RTT_MARGIN_US;
+    for (i = 0; i < cs->nbSamples; i++)
+    {
+        ARSTREAM_ClockSync_Sample_t *sample = &(cs->samples[i]);
+        double x, y;
+        if (sample->rttUs > maxRttUs)
+        {
+            continue;
+        }
+        x = (double)(sample->readerTimeUs - cs->refReaderTimeUs);
+        y = (double)(sample->offsetUs - cs->refOffsetUs);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        nbFit++;
+        if (sample->readerTimeUs < minTimeUs)
+        {
+            minTimeUs = sample->readerTimeUs;
+        }
+        if (sample->readerTimeUs > maxTimeUs)
+        {
+            maxTimeUs = sample->readerTimeUs;
+        }
+    }
+
+    cs->drift = 0.;
+    if ((nbFit >= 2) &&
+        (maxTimeUs - minTimeUs >= ARSTREAM_CLOCK_SYNC_MIN_DRIFT_SPAN_US))
+    {
+        double denom = nbFit * sumXX - sumX * sumX;
+        if (denom > 0.)
+        {
+            cs->drift = (nbFit * sumXY - sumX * sumY) / denom;
+        }
+        if (cs->drift > ARSTREAM_CLOCK_SYNC_MAX_DRIFT)
+        {
+            cs->drift = ARSTREAM_CLOCK_SYNC_MAX_DRIFT;
+        }
+        else if (cs->drift < -ARSTREAM_CLOCK_SYNC_MAX_DRIFT)
+        {
+            cs->drift = -ARSTREAM_CLOCK_SYNC_MAX_DRIFT;
+        }
+    }
+}
+
+/*
+ * Implementation
+ */
+
+uint64_t ARSTREAM_ClockSync_GetTimeUs (void)
+{
+    return ARSTREAM_Clock_GetTimeUs ();
+}
+
+void ARSTREAM_ClockSync_WriteTimestamp (uint32_t *high, uint32_t *low, uint64_t timeUs)
+{
+    *high = (uint32_t)(timeUs >> 32);
+    *low = (uint32_t)(timeUs & 0xFFFFFFFF);
+}
+
+uint64_t ARSTREAM_ClockSync_ReadTimestamp (uint32_t high, uint32_t low)
+{
+    return ((uint64_t)high << 32) | (uint64_t)low;
+}
+
+void ARSTREAM_ClockSync_Init (ARSTREAM_ClockSync_t *cs)
+{
+    memset (cs, 0, sizeof (*cs));
+}
+
+void ARSTREAM_ClockSync_AddSample (ARSTREAM_ClockSync_t *cs, uint64_t originateUs, uint64_t receiveUs, uint64_t transmitUs, uint64_t arrivalUs)
+{
+    ARSTREAM_ClockSync_Sample_t *sample;
+    int64_t rttUs;
+
+    if ((arrivalUs < originateUs) ||
+        (transmitUs < receiveUs))
+    {
+        return;
+    }
+    rttUs = (int64_t)(arrivalUs - originateUs) - (int64_t)(transmitUs - receiveUs);
+    if (rttUs < 0)
+    {
+        rttUs = 0;
+    }
+
+    sample = &(cs->samples[cs->index]);
+    sample->readerTimeUs = (int64_t)(originateUs + (arrivalUs - originateUs) / 2);
+    sample->offsetUs = (((int64_t)receiveUs - (int64_t)originateUs) + ((int64_t)transmitUs - (int64_t)arrivalUs)) / 2;
+    sample->rttUs = rttUs;
+    cs->index = (cs->index + 1) % ARSTREAM_CLOCK_SYNC_NB_SAMPLES;
+    if (cs->nbSamples < ARSTREAM_CLOCK_SYNC_NB_SAMPLES)
+    {
+        cs->nbSamples++;
+    }
+
+    ARSTREAM_ClockSync_Estimate (cs);
+    if (cs->nbSamples >= ARSTREAM_CLOCK_SYNC_MIN_SAMPLES)
+    {
+        cs->isSynchronized = 1;
+    }
+}
+
+int64_t ARSTREAM_ClockSync_GetOffsetUs (ARSTREAM_ClockSync_t *cs, uint64_t readerTimeUs)
+{
+    return cs->refOffsetUs + (int64_t)(cs->drift * (double)((int64_t)readerTimeUs - cs->refReaderTimeUs));
+}
+
+uint64_t ARSTREAM_ClockSync_SenderToReaderTime (ARSTREAM_ClockSync_t *cs, uint64_t senderTimeUs)
+{
+    /* The drift is small, so the offset at the first guess is precise enough */
+    uint64_t guessUs = (uint64_t)((int64_t)senderTimeUs - cs->refOffsetUs);
+    return (uint64_t)((int64_t)senderTimeUs - ARSTREAM_ClockSync_GetOffsetUs (cs, guessUs));
+}
@@ -0,0 +1,157 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_ClockSync.h
+ * @brief Sender/Reader clock synchronization
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_CLOCK_SYNC_PRIVATE_H_
+#define _ARSTREAM_CLOCK_SYNC_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * Private Headers
+ */
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Number of clock exchanges kept for the offset and drift estimation
+ */
+#define ARSTREAM_CLOCK_SYNC_NB_SAMPLES (16)
+
+/**
+ * @brief Number of clock exchanges needed before the clocks are considered as synchronized
+ */
+#define ARSTREAM_CLOCK_SYNC_MIN_SAMPLES (3)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Result of one clock exchange
+ */
+typedef struct {
+    int64_t readerTimeUs; /**< Reader time at the middle of the exchange */
+    int64_t offsetUs; /**< Estimated sender clock minus reader clock */
+    int64_t rttUs; /**< Network round trip time of the exchange */
+} ARSTREAM_ClockSync_Sample_t;
+
+/**
+ * @brief Clock synchronization state (reader side)
+ * Each exchange is NTP-like : the reader sends its time (originate), the sender
+ * answers with its reception (receive) and emission (transmit) times, and the
+ * reader notes the answer arrival time. The offset is taken from the exchange
+ * with the lowest round trip time (least queueing), and the drift is fitted
+ * on the recent exchanges with a low round trip time.
+ */
+typedef struct {
+    ARSTREAM_ClockSync_Sample_t samples [ARSTREAM_CLOCK_SYNC_NB_SAMPLES]; /**< Recent exchanges */
+    int index; /**< Next sample index */
+    int nbSamples; /**< Number of valid samples */
+    int isSynchronized; /**< Boolean-like flag set once enough exchanges were done */
+    int64_t refReaderTimeUs; /**< Reader time of the reference (lowest rtt) exchange */
+    int64_t refOffsetUs; /**< Offset of the reference exchange */
+    int64_t rttUs; /**< Round trip time of the reference exchange */
+    double drift; /**< Offset variation per reader time unit */
+} ARSTREAM_ClockSync_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Gets the local time used for clock synchronization
+ * @return The ARSAL_Time_GetTime clock, in microseconds
+ */
+uint64_t ARSTREAM_ClockSync_GetTimeUs (void);
+
+/**
+ * @brief Writes a timestamp into a clock frame field pair
+ * @param high Pointer to the upper 32 bits field
+ * @param low Pointer to the lower 32 bits field
+ * @param timeUs The timestamp, in microseconds
+ */
+void ARSTREAM_ClockSync_WriteTimestamp (uint32_t *high, uint32_t *low, uint64_t timeUs);
+
+/**
+ * @brief Reads a timestamp from a clock frame field pair
+ * @param high The upper 32 bits field
+ * @param low The lower 32 bits field
+ * @return The timestamp, in microseconds
+ */
+uint64_t ARSTREAM_ClockSync_ReadTimestamp (uint32_t high, uint32_t low);
+
+/**
+ * @brief Initializes a clock synchronization state
+ * @param cs The state to initialize
+ */
+void ARSTREAM_ClockSync_Init (ARSTREAM_ClockSync_t *cs);
+
+/**
+ * @brief Adds the result of a clock exchange
+ * @param cs The state
+ * @param originateUs Reader time when the request was sent
+ * @param receiveUs Sender time when the request was received
+ * @param transmitUs Sender time when the answer was sent
+ * @param arrivalUs Reader time when the answer was received
+ */
+void ARSTREAM_ClockSync_AddSample (ARSTREAM_ClockSync_t *cs, uint64_t originateUs, uint64_t receiveUs, uint64_t transmitUs, uint64_t arrivalUs);
+
+/**
+ * @brief Gets the estimated offset between the clocks
+ * @param cs The state
+ * @param readerTimeUs The reader time at which the offset is wanted
+ * @return The sender clock minus the reader clock, in microseconds
+ */
+int64_t ARSTREAM_ClockSync_GetOffsetUs (ARSTREAM_ClockSync_t *cs, uint64_t readerTimeUs);
+
+/**
+ * @brief Converts a sender timestamp into reader time
+ * @param cs The state
+ * @param senderTimeUs The sender timestamp, in microseconds
+ * @return The corresponding reader time, in microseconds
+ */
+uint64_t ARSTREAM_ClockSync_SenderToReaderTime (ARSTREAM_ClockSync_t *cs, uint64_t senderTimeUs);
+
+#endif /* _ARSTREAM_CLOCK_SYNC_PRIVATE_H_ */
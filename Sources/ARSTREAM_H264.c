@@ -0,0 +1,238 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_H264.c
+ * @brief H.264 Annex-B bitstream helpers
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_H264.h"
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+
+/**
+ * Number of bytes tested at once by the vector start code search
+ */
+#define ARSTREAM_H264_VECTOR_SIZE (16)
+
+/**
+ * Number of vectors tested at once when skipping the bytes which can not begin a start code
+ */
+#define ARSTREAM_H264_VECTORS_PER_SKIP (4)
+
+/**
+ * Flags the positions of BUF where two zero bytes begin (0xFF lanes)
+ */
+#if defined(__SSE2__)
+#define ARSTREAM_H264_ZERO_PAIRS(BUF, ZERO) _mm_cmpeq_epi8 (_mm_or_si128 (_mm_loadu_si128 ((const __m128i *)(BUF)), _mm_loadu_si128 ((const __m128i *)((BUF) + 1))), (ZERO))
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define ARSTREAM_H264_ZERO_PAIRS(BUF, ZERO) vceqq_u8 (vorrq_u8 (vld1q_u8 (BUF), vld1q_u8 ((BUF) + 1)), (ZERO))
+#endif
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Finds the next 3 bytes start code (00 00 01)
+ * SSE2 or NEON units, when available, test 16 positions at once for the two
+ * zero bytes of a start code. Thanks to the emulation prevention bytes, these
+ * only occur around start codes (and 00 00 03 sequences), so most of the frame
+ * is skipped 64 bytes at a time, and bytes are only looked at one by one
+ * at the end of the frame.
+ * @param buffer The frame
+ * @param size The frame size
+ * @param from Offset to start the search at
+ * @return The offset of the start code, or size if none was found
+ */
+static uint32_t ARSTREAM_H264_FindStartCode (const uint8_t *buffer, uint32_t size, uint32_t from);
+
+/*
+ * Internal functions implementation
+ */
+
+static uint32_t ARSTREAM_H264_FindStartCode (const uint8_t *buffer, uint32_t size, uint32_t from)
+{
+    uint32_t i = from;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    while (i + ARSTREAM_H264_VECTORS_PER_SKIP * ARSTREAM_H264_VECTOR_SIZE + 2 <= size)
+    {
+        __m128i pairs = _mm_or_si128 (_mm_or_si128 (ARSTREAM_H264_ZERO_PAIRS (&buffer[i], zero),
+                                                    ARSTREAM_H264_ZERO_PAIRS (&buffer[i + ARSTREAM_H264_VECTOR_SIZE], zero)),
+                                      _mm_or_si128 (ARSTREAM_H264_ZERO_PAIRS (&buffer[i + 2 * ARSTREAM_H264_VECTOR_SIZE], zero),
+                                                    ARSTREAM_H264_ZERO_PAIRS (&buffer[i + 3 * ARSTREAM_H264_VECTOR_SIZE], zero)));
+        if (_mm_movemask_epi8 (pairs) != 0)
+        {
+            break;
+        }
+        i += ARSTREAM_H264_VECTORS_PER_SKIP * ARSTREAM_H264_VECTOR_SIZE;
+    }
+    while (i + ARSTREAM_H264_VECTOR_SIZE + 2 <= size)
+    {
+        // Bit n is set if bytes i+n and i+n+1 are both zero
+        unsigned int pairs = _mm_movemask_epi8 (ARSTREAM_H264_ZERO_PAIRS (&buffer[i], zero));
+        while (pairs != 0)
+        {
+            uint32_t pos = i + __builtin_ctz (pairs);
+            if (buffer[pos+2] == 1)
+            {
+                return pos;
+            }
+            pairs &= pairs - 1;
+        }
+        i += ARSTREAM_H264_VECTOR_SIZE;
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    const uint8x16_t zero = vdupq_n_u8 (0);
+    while (i + ARSTREAM_H264_VECTORS_PER_SKIP * ARSTREAM_H264_VECTOR_SIZE + 2 <= size)
+    {
+        uint8x16_t pairs = vorrq_u8 (vorrq_u8 (ARSTREAM_H264_ZERO_PAIRS (&buffer[i], zero),
+                                               ARSTREAM_H264_ZERO_PAIRS (&buffer[i + ARSTREAM_H264_VECTOR_SIZE], zero)),
+                                     vorrq_u8 (ARSTREAM_H264_ZERO_PAIRS (&buffer[i + 2 * ARSTREAM_H264_VECTOR_SIZE], zero),
+                                               ARSTREAM_H264_ZERO_PAIRS (&buffer[i + 3 * ARSTREAM_H264_VECTOR_SIZE], zero)));
+        uint64x2_t pairs64 = vreinterpretq_u64_u8 (pairs);
+        if ((vgetq_lane_u64 (pairs64, 0) | vgetq_lane_u64 (pairs64, 1)) != 0)
+        {
+            break;
+        }
+        i += ARSTREAM_H264_VECTORS_PER_SKIP * ARSTREAM_H264_VECTOR_SIZE;
+    }
+    while (i + ARSTREAM_H264_VECTOR_SIZE + 2 <= size)
+    {
+        // Lane n is 0xFF if bytes i+n and i+n+1 are both zero
+        uint64x2_t pairs64 = vreinterpretq_u64_u8 (ARSTREAM_H264_ZERO_PAIRS (&buffer[i], zero));
+        if ((vgetq_lane_u64 (pairs64, 0) | vgetq_lane_u64 (pairs64, 1)) != 0)
+        {
+            uint32_t pos;
+            for (pos = i; pos < i + ARSTREAM_H264_VECTOR_SIZE; pos++)
+            {
+                if ((buffer[pos] == 0) && (buffer[pos+1] == 0) && (buffer[pos+2] == 1))
+                {
+                    return pos;
+                }
+            }
+        }
+        i += ARSTREAM_H264_VECTOR_SIZE;
+    }
+#endif
+    while (i + 2 < size)
+    {
+        if (buffer[i+2] > 1)
+        {
+            i += 3;
+        }
+        else if (buffer[i+2] == 0)
+        {
+            i++;
+        }
+        else if ((buffer[i] == 0) && (buffer[i+1] == 0))
+        {
+            return i;
+        }
+        else
+        {
+            i += 3;
+        }
+    }
+    return size;
+}
+
+/*
+ * Implementation
+ */
+
+int ARSTREAM_H264_FindNalUnits (const uint8_t *buffer, uint32_t size, ARSTREAM_H264_NalUnit_t *nalUnits, int maxNalUnits)
+{
+    int nbNalUnits = 0;
+    uint32_t start = ARSTREAM_H264_FindStartCode (buffer, size, 0);
+    uint32_t i;
+
+    /* Only zero bytes may come before the first start code */
+    if (start == size)
+    {
+        return 0;
+    }
+    for (i = 0; i < start; i++)
+    {
+        if (buffer[i] != 0)
+        {
+            return 0;
+        }
+    }
+    while (start < size)
+    {
+        uint32_t nalOffset = start + 3;
+        uint32_t next = size;
+        uint32_t end;
+        if (nbNalUnits < maxNalUnits - 1)
+        {
+            next = ARSTREAM_H264_FindStartCode (buffer, size, nalOffset);
+        }
+        /* Trailing zero bytes belong to the next start code */
+        end = next;
+        while ((end > nalOffset) &&
+               (buffer[end-1] == 0) &&
+               (next != size))
+        {
+            end--;
+        }
+        if (end > nalOffset)
+        {
+            nalUnits[nbNalUnits].offset = nalOffset;
+            nalUnits[nbNalUnits].size = end - nalOffset;
+            nbNalUnits++;
+        }
+        start = next;
+    }
+    return nbNalUnits;
+}
@@ -0,0 +1,106 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_H264.h
+ * @brief H.264 Annex-B bitstream helpers
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_H264_PRIVATE_H_
+#define _ARSTREAM_H264_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * Private Headers
+ */
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Maximum number of NAL units located in a frame
+ * If a frame holds more NAL units, the last one extends up to the end of the frame
+ */
+#define ARSTREAM_H264_MAX_NAL_UNITS (256)
+
+#define ARSTREAM_H264_NALU_TYPE_SLICE (1)
+#define ARSTREAM_H264_NALU_TYPE_IDR (5)
+#define ARSTREAM_H264_NALU_TYPE_SEI (6)
+#define ARSTREAM_H264_NALU_TYPE_SPS (7)
+#define ARSTREAM_H264_NALU_TYPE_PPS (8)
+#define ARSTREAM_H264_NALU_TYPE_AUD (9)
+
+/**
+ * @brief Gets the type of a NAL unit from its header byte
+ */
+#define ARSTREAM_H264_NALU_TYPE(HEADER) ((HEADER) & 0x1F)
+
+/**
+ * @brief Gets the nal_ref_idc of a NAL unit from its header byte (0 for non-reference NAL units)
+ */
+#define ARSTREAM_H264_NALU_REF_IDC(HEADER) (((HEADER) >> 5) & 0x03)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Location of a NAL unit in a frame
+ */
+typedef struct {
+    uint32_t offset; /**< Offset of the NAL unit header byte (after the start code) */
+    uint32_t size; /**< Size of the NAL unit, without the start code */
+} ARSTREAM_H264_NalUnit_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Locates the NAL units of an Annex-B frame
+ * @param buffer The frame
+ * @param size The frame size
+ * @param nalUnits Array which will hold the NAL units
+ * @param maxNalUnits Size of the nalUnits array
+ * @return The number of NAL units found (0 if the frame does not start with a start code)
+ */
+int ARSTREAM_H264_FindNalUnits (const uint8_t *buffer, uint32_t size, ARSTREAM_H264_NalUnit_t *nalUnits, int maxNalUnits);
+
+#endif /* _ARSTREAM_H264_PRIVATE_H_ */
@@ -0,0 +1,396 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_JitterBuffer.c
+ * @brief Reader jitter buffer and playout scheduler
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_JitterBuffer.h"
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Sender.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Maximum decrease of the target delay for each frame, so that frames are not released in bursts
+ */
+#define ARSTREAM_JITTER_BUFFER_DECREASE_STEP_US (500)
+
+/**
+ * @brief Transit time jumps larger than this (sender restart, clock change) reset the transit history
+ */
+#define ARSTREAM_JITTER_BUFFER_RESET_THRESHOLD_US (10000000)
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Adds a transit time to the history
+ * @param jb The jitter buffer
+ * @param transitUs The new transit time
+ * @return The smallest transit time of the history
+ */
+static int64_t ARSTREAM_JitterBuffer_AddTransit (ARSTREAM_JitterBuffer_t *jb, int64_t transitUs);
+
+/**
+ * @brief Updates the target delay from the transit time history
+ * @param jb The jitter buffer
+ * @param baseTransitUs The smallest transit time of the history
+ */
+static void ARSTREAM_JitterBuffer_UpdateTargetDelay (ARSTREAM_JitterBuffer_t *jb, int64_t baseTransitUs);
+
+/**
+ * @brief Skips the least valuable waiting frame to make room for a new one
+ * The least valuable frame is the oldest frame of lowest priority which is not a flush frame.
+ * If all waiting frames are flush frames, the oldest one is skipped.
+ * @param jb The jitter buffer, which must not be empty
+ * @param newFrame The frame which will be pushed after the waiting frames
+ */
+static void ARSTREAM_JitterBuffer_DropLeastValuableFrame (ARSTREAM_JitterBuffer_t *jb, ARSTREAM_JitterBuffer_Frame_t *newFrame);
+
+/**
+ * @brief qsort comparison function for int64_t
+ */
+static int ARSTREAM_JitterBuffer_CompareInt64 (const void *a, const void *b);
+
+/*
+ * Internal functions implementation
+ */
+
+static int64_t ARSTREAM_JitterBuffer_AddTransit (ARSTREAM_JitterBuffer_t *jb, int64_t transitUs)
+{
+    int i;
+    int64_t baseTransitUs;
+
+    if (jb->nbTransit > 0)
+    {
+        int64_t lastUs = jb->transitUs [(jb->transitIndex + ARSTREAM_JITTER_BUFFER_NB_TRANSIT - 1) % ARSTREAM_JITTER_BUFFER_NB_TRANSIT];
+        if ((transitUs - lastUs > ARSTREAM_JITTER_BUFFER_RESET_THRESHOLD_US) ||
+            (lastUs - transitUs > ARSTREAM_JITTER_BUFFER_RESET_THRESHOLD_US))
+        {
+            jb->nbTransit = 0;
+            jb->transitIndex = 0;
+        }
+    }
+
+    jb->transitUs [jb->transitIndex] = transitUs;
+    jb->transitIndex = (jb->transitIndex + 1) % ARSTREAM_JITTER_BUFFER_NB_TRANSIT;
+    if (jb->nbTransit < ARSTREAM_JITTER_BUFFER_NB_TRANSIT)
+    {
+        jb->nbTransit++;
+    }
+
+    baseTransitUs = transitUs;
+    for (i = 0; i < jb->nbTransit; i++)
+    {
+        if (jb->transitUs [i] < baseTransitUs)
+        {
+            baseTransitUs = jb->transitUs [i];
+        }
+    }
+    return baseTransitUs;
+}
+
+static void ARSTREAM_JitterBuffer_UpdateTargetDelay (ARSTREAM_JitterBuffer_t *jb, int64_t baseTransitUs)
+{
+    int64_t sorted [ARSTREAM_JITTER_BUFFER_NB_TRANSIT];
+    int64_t wantedUs;
+    int rank;
+
+    memcpy (sorted, jb->transitUs, jb->nbTransit * sizeof (int64_t));
+    qsort (sorted, jb->nbTransit, sizeof (int64_t), ARSTREAM_JitterBuffer_CompareInt64);
+    rank = ((jb->nbTransit - 1) * ARSTREAM_JITTER_BUFFER_PERCENTILE) / 100;
+    wantedUs = sorted [rank] - baseTransitUs + jb->minDelayUs;
+    if (wantedUs > jb->maxDelayUs)
+    {
+        wantedUs = jb->maxDelayUs;
+    }
+
+    if (wantedUs >= jb->targetDelayUs)
+    {
+        jb->targetDelayUs = wantedUs;
+    }
+    else if (jb->targetDelayUs - wantedUs > ARSTREAM_JITTER_BUFFER_DECREASE_STEP_US)
+    {
+        jb->targetDelayUs -= ARSTREAM_JITTER_BUFFER_DECREASE_STEP_US;
+    }
+    else
+    {
+        jb->targetDelayUs = wantedUs;
+    }
+}
+
+static void ARSTREAM_JitterBuffer_DropLeastValuableFrame (ARSTREAM_JitterBuffer_t *jb, ARSTREAM_JitterBuffer_Frame_t *newFrame)
+{
+    ARSTREAM_JitterBuffer_Frame_t *dropped;
+    int found = 0;
+    int position = 0;
+    int i;
+
+    for (i = 0; i < jb->nbFrames; i++)
+    {
+        ARSTREAM_JitterBuffer_Frame_t *waiting = &(jb->frames [(jb->head + i) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES]);
+        // Strictly lower priority only, so we keep the oldest frame on ties
+        if ((waiting->isFlushFrame == 0) &&
+            ((found == 0) ||
+             (waiting->infos.priority < jb->frames [(jb->head + position) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES].infos.priority)))
+        {
+            found = 1;
+            position = i;
+        }
+    }
+
+    // The skipped frames are reported with the frame which follows the dropped one
+    dropped = &(jb->frames [(jb->head + position) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES]);
+    if (position + 1 < jb->nbFrames)
+    {
+        jb->frames [(jb->head + position + 1) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES].numberOfSkippedFrames += 1 + dropped->numberOfSkippedFrames;
+    }
+    else
+    {
+        newFrame->numberOfSkippedFrames += 1 + dropped->numberOfSkippedFrames;
+    }
+    jb->nbSkippedFrames++;
+    ARSTREAM_JitterBuffer_ReleaseBuffer (jb, dropped->buffer, dropped->capacity);
+
+    // Move all older frames one step towards the tail of the ring
+    for (i = position; i > 0; i--)
+    {
+        jb->frames [(jb->head + i) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES] = jb->frames [(jb->head + i - 1) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES];
+    }
+    jb->head = (jb->head + 1) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES;
+    jb->nbFrames--;
+}
+
+static int ARSTREAM_JitterBuffer_CompareInt64 (const void *a, const void *b)
+{
+    int64_t va = *(const int64_t *)a;
+    int64_t vb = *(const int64_t *)b;
+    return (va > vb) - (va < vb);
+}
+
+/*
+ * Implementation
+ */
+
+void ARSTREAM_JitterBuffer_Init (ARSTREAM_JitterBuffer_t *jb, int minDelayMs, int maxDelayMs)
+{
+    memset (jb, 0, sizeof (*jb));
+    ARSTREAM_JitterBuffer_SetLimits (jb, minDelayMs, maxDelayMs);
+    jb->targetDelayUs = jb->minDelayUs;
+}
+
+void ARSTREAM_JitterBuffer_SetLimits (ARSTREAM_JitterBuffer_t *jb, int minDelayMs, int maxDelayMs)
+{
+    jb->minDelayUs = (int64_t)minDelayMs * 1000;
+    jb->maxDelayUs = (int64_t)maxDelayMs * 1000;
+    if (jb->targetDelayUs < jb->minDelayUs)
+    {
+        jb->targetDelayUs = jb->minDelayUs;
+    }
+    if (jb->targetDelayUs > jb->maxDelayUs)
+    {
+        jb->targetDelayUs = jb->maxDelayUs;
+    }
+}
+
+void ARSTREAM_JitterBuffer_Free (ARSTREAM_JitterBuffer_t *jb)
+{
+    int i;
+    while (jb->nbFrames > 0)
+    {
+        free (jb->frames [jb->head].buffer);
+        jb->head = (jb->head + 1) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES;
+        jb->nbFrames--;
+    }
+    for (i = 0; i < jb->nbFreeBuffers; i++)
+    {
+        free (jb->freeBuffers [i]);
+    }
+    jb->nbFreeBuffers = 0;
+}
+
+uint8_t* ARSTREAM_JitterBuffer_GetBuffer (ARSTREAM_JitterBuffer_t *jb, uint32_t *capacity)
+{
+    uint8_t *buffer = NULL;
+    int i;
+
+    for (i = 0; i < jb->nbFreeBuffers; i++)
+    {
+        if (jb->freeCapacities [i] >= *capacity)
+        {
+            buffer = jb->freeBuffers [i];
+            *capacity = jb->freeCapacities [i];
+            jb->nbFreeBuffers--;
+            jb->freeBuffers [i] = jb->freeBuffers [jb->nbFreeBuffers];
+            jb->freeCapacities [i] = jb->freeCapacities [jb->nbFreeBuffers];
+            return buffer;
+        }
+    }
+
+    /* No buffer large enough : drop a small one so that the pool follows the frame sizes */
+    if (jb->nbFreeBuffers > 0)
+    {
+        jb->nbFreeBuffers--;
+        free (jb->freeBuffers [jb->nbFreeBuffers]);
+    }
+    return malloc (*capacity);
+}
+
+void ARSTREAM_JitterBuffer_ReleaseBuffer (ARSTREAM_JitterBuffer_t *jb, uint8_t *buffer, uint32_t capacity)
+{
+    if (buffer == NULL)
+    {
+        return;
+    }
+    if (jb->nbFreeBuffers < ARSTREAM_JITTER_BUFFER_MAX_FREE_BUFFERS)
+    {
+        jb->freeBuffers [jb->nbFreeBuffers] = buffer;
+        jb->freeCapacities [jb->nbFreeBuffers] = capacity;
+        jb->nbFreeBuffers++;
+    }
+    else
+    {
+        free (buffer);
+    }
+}
+
+void ARSTREAM_JitterBuffer_Push (ARSTREAM_JitterBuffer_t *jb, ARSTREAM_JitterBuffer_Frame_t *frame, uint64_t arrivalUs)
+{
+    int64_t waitUs;
+    ARSTREAM_JitterBuffer_Frame_t *slot;
+
+    if (frame->infos.hasTimestamp != 0)
+    {
+        /* The transit time holds the clock offset, which cancels out
+         * when comparing it to the smallest recent transit time */
+        int64_t transitUs = (int64_t)(arrivalUs - frame->infos.timestampUs);
+        int64_t baseTransitUs = ARSTREAM_JitterBuffer_AddTransit (jb, transitUs);
+        ARSTREAM_JitterBuffer_UpdateTargetDelay (jb, baseTransitUs);
+        waitUs = baseTransitUs + jb->targetDelayUs - transitUs;
+    }
+    else
+    {
+        waitUs = jb->minDelayUs;
+    }
+
+    if (waitUs < 0)
+    {
+        jb->nbLateFrames++;
+        waitUs = 0;
+    }
+    frame->playoutTimeUs = arrivalUs + waitUs;
+    /* Never release frames out of order */
+    if (frame->playoutTimeUs < jb->lastPlayoutTimeUs)
+    {
+        frame->playoutTimeUs = jb->lastPlayoutTimeUs;
+    }
+    jb->lastPlayoutTimeUs = frame->playoutTimeUs;
+
+    if (jb->nbFrames == ARSTREAM_JITTER_BUFFER_MAX_FRAMES)
+    {
+        ARSTREAM_JitterBuffer_DropLeastValuableFrame (jb, frame);
+    }
+
+    slot = &(jb->frames [(jb->head + jb->nbFrames) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES]);
+    *slot = *frame;
+    jb->nbFrames++;
+}
+
+int ARSTREAM_JitterBuffer_NextPlayoutTime (ARSTREAM_JitterBuffer_t *jb, uint64_t *playoutTimeUs)
+{
+    if (jb->nbFrames == 0)
+    {
+        return 0;
+    }
+    *playoutTimeUs = jb->frames [jb->head].playoutTimeUs;
+    return 1;
+}
+
+int ARSTREAM_JitterBuffer_Pop (ARSTREAM_JitterBuffer_t *jb, uint64_t nowUs, ARSTREAM_JitterBuffer_Frame_t *frame)
+{
+    while ((jb->nbFrames > 0) &&
+           (jb->frames [jb->head].playoutTimeUs <= nowUs))
+    {
+        ARSTREAM_JitterBuffer_Frame_t *oldest = &(jb->frames [jb->head]);
+        ARSTREAM_JitterBuffer_Frame_t *next = &(jb->frames [(jb->head + 1) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES]);
+        int skip = 0;
+
+        if ((jb->nbFrames > 1) &&
+            (next->playoutTimeUs <= nowUs) &&
+            (oldest->isFlushFrame == 0) &&
+            (oldest->infos.priority <= ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE))
+        {
+            skip = 1;
+        }
+
+        jb->head = (jb->head + 1) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES;
+        jb->nbFrames--;
+
+        if (skip == 1)
+        {
+            jb->pendingSkippedFrames += 1 + oldest->numberOfSkippedFrames;
+            jb->nbSkippedFrames++;
+            ARSTREAM_JitterBuffer_ReleaseBuffer (jb, oldest->buffer, oldest->capacity);
+        }
+        else
+        {
+            *frame = *oldest;
+            frame->numberOfSkippedFrames += jb->pendingSkippedFrames;
+            jb->pendingSkippedFrames = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int64_t ARSTREAM_JitterBuffer_GetTargetDelayUs (ARSTREAM_JitterBuffer_t *jb)
+{
+    return jb->targetDelayUs;
+}
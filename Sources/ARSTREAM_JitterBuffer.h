@@ -0,0 +1,206 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_JitterBuffer.h
+ * @brief Reader jitter buffer and playout scheduler
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_JITTER_BUFFER_PRIVATE_H_
+#define _ARSTREAM_JITTER_BUFFER_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * Private Headers
+ */
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Reader.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Maximum number of frames waiting for their playout time
+ */
+#define ARSTREAM_JITTER_BUFFER_MAX_FRAMES (64)
+
+/**
+ * @brief Maximum number of unused buffers kept for later frames
+ */
+#define ARSTREAM_JITTER_BUFFER_MAX_FREE_BUFFERS (8)
+
+/**
+ * @brief Number of frame transit times used to compute the jitter percentile
+ */
+#define ARSTREAM_JITTER_BUFFER_NB_TRANSIT (128)
+
+/**
+ * @brief Percentile of the transit time variation covered by the target delay
+ */
+#define ARSTREAM_JITTER_BUFFER_PERCENTILE (95)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief A complete frame waiting in the jitter buffer
+ */
+typedef struct {
+    uint8_t *buffer; /**< Frame buffer, owned by the jitter buffer */
+    uint32_t capacity; /**< Allocated size of buffer */
+    uint32_t size; /**< Frame size */
+    int numberOfSkippedFrames; /**< Frames skipped before this one */
+    int isFlushFrame; /**< Boolean-like flag telling if the frame was a flush frame */
+    ARSTREAM_Reader_FrameInfos_t infos; /**< Frame informations */
+    uint64_t playoutTimeUs; /**< Reader time at which the frame should be released */
+} ARSTREAM_JitterBuffer_Frame_t;
+
+/**
+ * @brief Jitter buffer state
+ * Frames are released at their sender timestamp, plus the smallest recent
+ * transit time (which also absorbs the clock offset), plus the target delay.
+ * The target delay follows a percentile of the recent transit times above the
+ * smallest one : it grows at once when the jitter grows, and shrinks slowly
+ * so that the release cadence stays smooth. It never goes above the ceiling.
+ * Frames without timestamp are released after the minimum delay.
+ */
+typedef struct {
+    int64_t minDelayUs; /**< Minimum target delay */
+    int64_t maxDelayUs; /**< Target delay ceiling */
+    int64_t targetDelayUs; /**< Current target delay */
+
+    ARSTREAM_JitterBuffer_Frame_t frames [ARSTREAM_JITTER_BUFFER_MAX_FRAMES]; /**< Waiting frames (ring) */
+    int head; /**< Index of the oldest waiting frame */
+    int nbFrames; /**< Number of waiting frames */
+    uint64_t lastPlayoutTimeUs; /**< Playout time of the newest frame */
+
+    uint8_t *freeBuffers [ARSTREAM_JITTER_BUFFER_MAX_FREE_BUFFERS]; /**< Unused buffers */
+    uint32_t freeCapacities [ARSTREAM_JITTER_BUFFER_MAX_FREE_BUFFERS]; /**< Allocated size of unused buffers */
+    int nbFreeBuffers; /**< Number of unused buffers */
+
+    int64_t transitUs [ARSTREAM_JITTER_BUFFER_NB_TRANSIT]; /**< Recent transit times (arrival minus sender timestamp) */
+    int transitIndex; /**< Next transit index */
+    int nbTransit; /**< Number of valid transit times */
+
+    int pendingSkippedFrames; /**< Frames skipped since the last released frame */
+    uint32_t nbLateFrames; /**< Frames which arrived after their playout time */
+    uint32_t nbSkippedFrames; /**< Late frames skipped to catch up */
+} ARSTREAM_JitterBuffer_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Initializes a jitter buffer
+ * @param jb The jitter buffer to initialize
+ * @param minDelayMs Minimum target delay, in milliseconds
+ * @param maxDelayMs Target delay ceiling, in milliseconds
+ */
+void ARSTREAM_JitterBuffer_Init (ARSTREAM_JitterBuffer_t *jb, int minDelayMs, int maxDelayMs);
+
+/**
+ * @brief Changes the target delay limits of a jitter buffer
+ * @param jb The jitter buffer
+ * @param minDelayMs Minimum target delay, in milliseconds
+ * @param maxDelayMs Target delay ceiling, in milliseconds
+ */
+void ARSTREAM_JitterBuffer_SetLimits (ARSTREAM_JitterBuffer_t *jb, int minDelayMs, int maxDelayMs);
+
+/**
+ * @brief Frees all the buffers owned by a jitter buffer, and drops the waiting frames
+ * @param jb The jitter buffer
+ */
+void ARSTREAM_JitterBuffer_Free (ARSTREAM_JitterBuffer_t *jb);
+
+/**
+ * @brief Gets a buffer to reassemble a frame in
+ * @param jb The jitter buffer
+ * @param capacity Pointer to the minimum capacity of the buffer, updated with the actual capacity
+ * @return The buffer, or NULL if the allocation failed
+ */
+uint8_t* ARSTREAM_JitterBuffer_GetBuffer (ARSTREAM_JitterBuffer_t *jb, uint32_t *capacity);
+
+/**
+ * @brief Gives back a buffer which is no longer used
+ * @param jb The jitter buffer
+ * @param buffer The buffer (may be NULL)
+ * @param capacity The allocated size of the buffer
+ */
+void ARSTREAM_JitterBuffer_ReleaseBuffer (ARSTREAM_JitterBuffer_t *jb, uint8_t *buffer, uint32_t capacity);
+
+/**
+ * @brief Adds a complete frame to the jitter buffer, and schedules its playout
+ * @param jb The jitter buffer
+ * @param frame The frame (buffer, capacity, size, numberOfSkippedFrames, isFlushFrame and infos must be set)
+ * @param arrivalUs Reader time when the frame was completed
+ * @note The jitter buffer takes the ownership of frame->buffer
+ * @note If the jitter buffer is full, the oldest frame of lowest priority is skipped (flush frames are only skipped if all waiting frames are flush frames)
+ */
+void ARSTREAM_JitterBuffer_Push (ARSTREAM_JitterBuffer_t *jb, ARSTREAM_JitterBuffer_Frame_t *frame, uint64_t arrivalUs);
+
+/**
+ * @brief Gets the playout time of the oldest waiting frame
+ * @param jb The jitter buffer
+ * @param playoutTimeUs Pointer which will hold the playout time
+ * @return 1 if a frame is waiting, 0 otherwise
+ */
+int ARSTREAM_JitterBuffer_NextPlayoutTime (ARSTREAM_JitterBuffer_t *jb, uint64_t *playoutTimeUs);
+
+/**
+ * @brief Removes the oldest frame if its playout time is reached
+ * Low priority frames which are late while the next frame is also due are
+ * skipped, so that the playout catches up with the stream.
+ * @param jb The jitter buffer
+ * @param nowUs The current reader time
+ * @param frame Pointer which will hold the frame to release
+ * @return 1 if frame was set, 0 if no frame is due
+ * @note The caller takes the ownership of frame->buffer, and should give it back with ARSTREAM_JitterBuffer_ReleaseBuffer
+ */
+int ARSTREAM_JitterBuffer_Pop (ARSTREAM_JitterBuffer_t *jb, uint64_t nowUs, ARSTREAM_JitterBuffer_Frame_t *frame);
+
+/**
+ * @brief Gets the current target delay
+ * @param jb The jitter buffer
+ * @return The target delay, in microseconds
+ */
+int64_t ARSTREAM_JitterBuffer_GetTargetDelayUs (ARSTREAM_JitterBuffer_t *jb);
+
+#endif /* _ARSTREAM_JITTER_BUFFER_PRIVATE_H_ */
@@ -40,6 +40,7 @@
 /*
  * System Headers
  */
+#include <string.h>
 
 /*
  * Private Headers
@@ -50,6 +51,7 @@
  * ARSDK Headers
  */
 #include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Endianness.h>
 
 /*
  * Macros
@@ -94,14 +96,15 @@ int ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (ARSTREAM_NetworkHeaders_AckPac
     if (0 < maxFlag && maxFlag <= 64)
     {
         // Check only in first packet
-        uint64_t lo_mask = (1ll << maxFlag) - 1ll;
+        // A full 64 bits shift is undefined, 64 flags use the whole word
+        uint64_t lo_mask = (maxFlag == 64) ? UINT64_MAX : (1ull << maxFlag) - 1ull;
         res = ((packet->lowPacketsAck & lo_mask) == lo_mask) ? 1 : 0;
     }
     else if (64 < maxFlag && maxFlag <= 128)
     {
         // We need to check for the second packet also
         uint64_t lo_mask = UINT64_MAX;
-        uint64_t hi_mask = (1ll << (maxFlag-64)) - 1ll;
+        uint64_t hi_mask = (maxFlag == 128) ? UINT64_MAX : (1ull << (maxFlag-64)) - 1ull;
         int hi_res = ((packet->highPacketsAck & hi_mask) == hi_mask) ? 1 : 0;
         int lo_res = ((packet->lowPacketsAck & lo_mask) == lo_mask) ? 1 : 0;
         res = (hi_res == 1 && lo_res == 1) ? 1 : 0;
@@ -119,11 +122,11 @@ int ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (ARSTREAM_NetworkHeaders_AckPacke
     int retVal = 0;
     if (0 <= flag && flag < 64)
     {
-        retVal = ((packet->lowPacketsAck & (1ll << flag)) != 0) ? 1 : 0;
+        retVal = ((packet->lowPacketsAck & (1ull << flag)) != 0) ? 1 : 0;
     }
     else if (64 <= flag && flag < 128)
     {
-        retVal = ((packet->highPacketsAck & (1ll << (flag - 64))) != 0) ? 1 : 0;
+        retVal = ((packet->highPacketsAck & (1ull << (flag - 64))) != 0) ? 1 : 0;
     }
     return retVal;
 }
@@ -157,11 +160,11 @@ void ARSTREAM_NetworkHeaders_AckPacketSetFlag (ARSTREAM_NetworkHeaders_AckPacket
 {
     if (0 <= flagToSet && flagToSet < 64)
     {
-        packet->lowPacketsAck |= (1ll << flagToSet);
+        packet->lowPacketsAck |= (1ull << flagToSet);
     }
     else if (64 <= flagToSet && flagToSet < 128)
     {
-        packet->highPacketsAck |= (1ll << (flagToSet-64));
+        packet->highPacketsAck |= (1ull << (flagToSet-64));
     }
 }
 
@@ -176,11 +179,11 @@ int ARSTREAM_NetworkHeaders_AckPacketUnsetFlag (ARSTREAM_NetworkHeaders_AckPacke
     int retVal = 0;
     if (0 <= flagToRemove && flagToRemove < 64)
     {
-        packet->lowPacketsAck &= ~(1ll << flagToRemove);
+        packet->lowPacketsAck &= ~(1ull << flagToRemove);
     }
     else if (64 <= flagToRemove && flagToRemove < 128)
     {
-        packet->highPacketsAck &= ~(1ll << flagToRemove);
+        packet->highPacketsAck &= ~(1ull << (flagToRemove-64));
     }
 
     if (0ll == packet->lowPacketsAck &&
@@ -270,6 +273,30 @@ uint32_t ARSTREAM_NetworkHeaders_AckPacketCountNotSet (ARSTREAM_NetworkHeaders_A
     return retVal;
 }
 
+void ARSTREAM_NetworkHeaders_ControlHeaderInit (ARSTREAM_NetworkHeaders_ControlHeader_t *header, uint8_t type)
+{
+    header->magic = htods (ARSTREAM_NETWORK_HEADERS_CONTROL_MAGIC);
+    header->type = type;
+    header->reserved = 0;
+}
+
+uint8_t ARSTREAM_NetworkHeaders_ControlFrameType (const uint8_t *buffer, int size)
+{
+    uint8_t retVal = ARSTREAM_NETWORK_HEADERS_CONTROL_NONE;
+    ARSTREAM_NetworkHeaders_ControlHeader_t header;
+    if ((buffer != NULL) &&
+        (size >= (int)sizeof (header)) &&
+        (size != (int)sizeof (ARSTREAM_NetworkHeaders_AckPacket_t)))
+    {
+        memcpy (&header, buffer, sizeof (header));
+        if (dtohs (header.magic) == ARSTREAM_NETWORK_HEADERS_CONTROL_MAGIC)
+        {
+            retVal = header.type;
+        }
+    }
+    return retVal;
+}
+
 static void ARSTREAM_NetworkHeaders_InternalAckPacketDump (const char *prefix, ARSTREAM_NetworkHeaders_AckPacket_t *packet, eARSAL_PRINT_LEVEL level)
 {
     ARSAL_PRINT (level, ARSTREAM_NETWORK_HEADERS_TAG, "Packet dump: %s", prefix);
@@ -59,6 +59,21 @@
 #define ARSTREAM_NETWORK_HEADERS_MAX_FRAGMENTS_PER_FRAME (128)
 
 #define ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME (1)
+#define ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK (0x06)
+#define ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT (1)
+#define ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_VALID (0x08)
+#define ARSTREAM_NETWORK_HEADERS_FLAG_CLOCK_FRAME (0x10)
+#define ARSTREAM_NETWORK_HEADERS_FLAG_FRAME_TIMESTAMP (0x20)
+#define ARSTREAM_NETWORK_HEADERS_FLAG_FRAGMENT_OFFSET (0x40)
+
+#define ARSTREAM_NETWORK_HEADERS_FEEDBACK_KEYFRAME_REQUEST (1)
+#define ARSTREAM_NETWORK_HEADERS_FEEDBACK_RECEIVER_REPORT (2)
+#define ARSTREAM_NETWORK_HEADERS_FEEDBACK_ABANDON_FRAME (3)
+
+#define ARSTREAM_NETWORK_HEADERS_CONTROL_MAGIC (0x4153) /* "AS" */
+#define ARSTREAM_NETWORK_HEADERS_CONTROL_NONE (0)
+#define ARSTREAM_NETWORK_HEADERS_CONTROL_FEEDBACK (1)
+#define ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK (2)
 
 #define ARSTREAM_NETWORK_HEADERS2_SSRC 0x41525354
 
@@ -87,12 +102,11 @@ typedef struct {
 /* frameFlags structure :
  *  x x x x x x x x
  *  | | | | | | | \-> FLUSH FRAME
- *  | | | | | | \-> UNUSED
- *  | | | | | \-> UNUSED
- *  | | | | \-> UNUSED
- *  | | | \-> UNUSED
- *  | | \-> UNUSED
- *  | \-> UNUSED
+ *  | | | | | \-\-> PRIORITY (eARSTREAM_SENDER_FRAME_PRIORITY)
+ *  | | | | \-> PRIORITY VALID (0 for old senders, which did not send a priority)
+ *  | | | \-> CLOCK FRAME (the packet holds an ARSTREAM_NetworkHeaders_ClockFrame_t, fragmentsPerFrame is 0)
+ *  | | \-> FRAME TIMESTAMP (the packet holds an ARSTREAM_NetworkHeaders_FrameTimestamp_t, fragmentsPerFrame is 0)
+ *  | \-> FRAGMENT OFFSET (an ARSTREAM_NetworkHeaders_FragmentOffset_t comes before the fragment data)
  *  \-> UNUSED
  */
 
@@ -112,6 +126,36 @@ typedef struct {
     uint64_t lowPacketsAck; /**< Lower 64 packets bitfield */
 } __attribute__ ((packed)) ARSTREAM_NetworkHeaders_AckPacket_t;
 
+/**
+ * @brief Header of the tagged frames sent by the reader on the ack buffer
+ *
+ * Ack frames (ARSTREAM_NetworkHeaders_AckPacket_t) are the only untagged frames
+ * of the ack buffer. They are told apart by their size, so no tagged frame may
+ * have a size equal to sizeof (ARSTREAM_NetworkHeaders_AckPacket_t)
+ */
+typedef struct {
+    uint16_t magic; /**< ARSTREAM_NETWORK_HEADERS_CONTROL_MAGIC */
+    uint8_t type; /**< Frame type (ARSTREAM_NETWORK_HEADERS_CONTROL_xxx) */
+    uint8_t reserved; /**< Padding, must be 0 */
+} __attribute__ ((packed)) ARSTREAM_NetworkHeaders_ControlHeader_t;
+
+/**
+ * @brief Content of stream feedback frames
+ *
+ * Feedback frames are sent by the reader on the ack buffer, tagged with the
+ * ARSTREAM_NETWORK_HEADERS_CONTROL_FEEDBACK type
+ */
+typedef struct {
+    ARSTREAM_NetworkHeaders_ControlHeader_t control; /**< Control frame header */
+    uint8_t type; /**< Feedback type (ARSTREAM_NETWORK_HEADERS_FEEDBACK_xxx) */
+    uint8_t fractionLost; /**< Fraction of frames lost since the previous report, in 1/256 */
+    uint16_t frameNumber; /**< id of the last complete frame (id of the abandoned frame for ABANDON_FRAME) */
+    uint16_t highestFrameNumber; /**< Highest frame id seen by the reader */
+    uint16_t reserved; /**< Padding, must be 0 */
+    uint32_t cumulativeLost; /**< Total number of frames lost */
+    uint32_t jitterUs; /**< Frame interarrival jitter, in microseconds */
+} __attribute__ ((packed)) ARSTREAM_NetworkHeaders_FeedbackPacket_t;
+
 /**
  * @brief Header for v2 stream data frames (RTP-like, see RFC3550)
  */
@@ -125,9 +169,18 @@ typedef struct {
 #define ARSTREAM_NETWORK_MAX_RTP_PAYLOAD_SIZE (0xFFFF - sizeof(ARSTREAM_NetworkHeaders_DataHeader2_t) - ARSTREAM_NETWORK_UDP_HEADER_SIZE - ARSTREAM_NETWORK_IP_HEADER_SIZE)
 
 /**
- * @brief Format of v2 stream clock frames
+ * @brief Format of stream clock frames
+ *
+ * Timestamps are in microseconds, split in two 32 bits fields (H for the upper bits).
+ * The reader sends clock frames on the ack buffer with only the originate
+ * timestamp set. The sender answers on the data buffer, after an
+ * ARSTREAM_NetworkHeaders_DataHeader_t with the CLOCK FRAME flag, with the
+ * originate timestamp copied, and its own receive and transmit timestamps.
+ * Both ways, clock frames are tagged with the ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK
+ * type.
  */
 typedef struct {
+    ARSTREAM_NetworkHeaders_ControlHeader_t control; /**< Control frame header */
     uint32_t originateTimestampH;
     uint32_t originateTimestampL;
     uint32_t receiveTimestampH;
@@ -136,6 +189,35 @@ typedef struct {
     uint32_t transmitTimestampL;
 } __attribute__ ((packed)) ARSTREAM_NetworkHeaders_ClockFrame_t;
 
+/**
+ * @brief Format of stream frame timestamp frames
+ *
+ * Sent by the sender on the data buffer, after an
+ * ARSTREAM_NetworkHeaders_DataHeader_t with the FRAME TIMESTAMP flag and the
+ * frameNumber of the frame it describes. The timestamp is the sender clock
+ * time (in microseconds) when the frame was given to the library.
+ * Only sent to readers which sent clock or feedback frames, as older readers
+ * would mistake it for a new frame.
+ */
+typedef struct {
+    uint32_t timestampH;
+    uint32_t timestampL;
+} __attribute__ ((packed)) ARSTREAM_NetworkHeaders_FrameTimestamp_t;
+
+/**
+ * @brief Byte offset of a variable size fragment
+ *
+ * Sent after the ARSTREAM_NetworkHeaders_DataHeader_t of fragments with the
+ * FRAGMENT OFFSET flag, before the fragment data. The offset is the position
+ * of the fragment data in the frame. Fragments without this flag are placed at
+ * fragmentNumber * maxFragmentSize.
+ * Only sent to readers which sent clock or feedback frames, as older readers
+ * would copy it into the frame.
+ */
+typedef struct {
+    uint32_t offset;
+} __attribute__ ((packed)) ARSTREAM_NetworkHeaders_FragmentOffset_t;
+
 /*
  * Functions declarations
  */
@@ -219,6 +301,22 @@ uint32_t ARSTREAM_NetworkHeaders_AckPacketCountSet (ARSTREAM_NetworkHeaders_AckP
 uint32_t ARSTREAM_NetworkHeaders_AckPacketCountNotSet (ARSTREAM_NetworkHeaders_AckPacket_t *packet, int nb);
 
 
+/**
+ * @brief Fills the header of a tagged ack buffer frame
+ * @param header The header to fill
+ * @param type The frame type (ARSTREAM_NETWORK_HEADERS_CONTROL_xxx)
+ */
+void ARSTREAM_NetworkHeaders_ControlHeaderInit (ARSTREAM_NetworkHeaders_ControlHeader_t *header, uint8_t type);
+
+/**
+ * @brief Gets the type of a frame received on the ack buffer
+ * @param buffer The received frame
+ * @param size The size of the received frame
+ * @return The frame type (ARSTREAM_NETWORK_HEADERS_CONTROL_xxx)
+ * @return ARSTREAM_NETWORK_HEADERS_CONTROL_NONE if the frame is not tagged (ack frames, or unknown data)
+ */
+uint8_t ARSTREAM_NetworkHeaders_ControlFrameType (const uint8_t *buffer, int size);
+
 /**
  * @brief Dump an ack packet
  * @param prefix prefix of the dump
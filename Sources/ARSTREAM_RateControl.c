@@ -0,0 +1,340 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_RateControl.c
+ * @brief Sender-side congestion controller
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_RateControl.h"
+
+/*
+ * ARSDK Headers
+ */
+#include <libARSAL/ARSAL_Time.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Minimum time between two controller updates
+ */
+#define ARSTREAM_RATE_CONTROL_UPDATE_INTERVAL_MS (100)
+
+/**
+ * @brief Queueing delay above which the link is considered as overused (if the delay is still growing)
+ */
+#define ARSTREAM_RATE_CONTROL_OVERUSE_DELAY_MS (30)
+
+/**
+ * @brief Loss rate (percent) above which the target is decreased
+ */
+#define ARSTREAM_RATE_CONTROL_HIGH_LOSS_PERCENT (10)
+
+/**
+ * @brief Loss rate (percent) under which the target may be increased
+ */
+#define ARSTREAM_RATE_CONTROL_LOW_LOSS_PERCENT (2)
+
+/**
+ * @brief Multiplicative decrease factor (percent of the measured delivery rate)
+ */
+#define ARSTREAM_RATE_CONTROL_DECREASE_PERCENT (85)
+
+/**
+ * @brief Multiplicative increase factor per update interval (percent)
+ */
+#define ARSTREAM_RATE_CONTROL_INCREASE_PERCENT (102)
+
+/**
+ * @brief Maximum target bitrate relative to the measured delivery rate (percent)
+ */
+#define ARSTREAM_RATE_CONTROL_PROBE_PERCENT (125)
+
+/**
+ * @brief Relative change (percent) of the target bitrate that triggers a report
+ */
+#define ARSTREAM_RATE_CONTROL_REPORT_PERCENT (10)
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Clamps the target bitrate into the controller limits
+ * @param rc The controller
+ */
+static void ARSTREAM_RateControl_ClampTarget (ARSTREAM_RateControl_t *rc);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_RateControl_ClampTarget (ARSTREAM_RateControl_t *rc)
+{
+    if (rc->targetBitrate < rc->minBitrate)
+    {
+        rc->targetBitrate = rc->minBitrate;
+    }
+    if (rc->targetBitrate > rc->maxBitrate)
+    {
+        rc->targetBitrate = rc->maxBitrate;
+    }
+}
+
+/*
+ * Implementation
+ */
+
+void ARSTREAM_RateControl_Init (ARSTREAM_RateControl_t *rc, uint32_t minBitrate, uint32_t maxBitrate)
+{
+    memset (rc, 0, sizeof (*rc));
+    rc->minBitrate = minBitrate;
+    rc->maxBitrate = (maxBitrate > minBitrate) ? maxBitrate : minBitrate;
+    rc->targetBitrate = rc->maxBitrate;
+    rc->reportedBitrate = rc->maxBitrate;
+    rc->intervalMinDelay = -1;
+    rc->smoothedDelay = -1;
+    rc->previousSmoothedDelay = -1;
+    rc->receiverLoss = -1;
+}
+
+void ARSTREAM_RateControl_SetLimits (ARSTREAM_RateControl_t *rc, uint32_t minBitrate, uint32_t maxBitrate)
+{
+    rc->minBitrate = minBitrate;
+    rc->maxBitrate = (maxBitrate > minBitrate) ? maxBitrate : minBitrate;
+    ARSTREAM_RateControl_ClampTarget (rc);
+}
+
+void ARSTREAM_RateControl_FrameStarted (ARSTREAM_RateControl_t *rc, struct timespec *now)
+{
+    rc->frameStartTime = *now;
+    rc->waitingFirstAck = 1;
+}
+
+void ARSTREAM_RateControl_DataSent (ARSTREAM_RateControl_t *rc, uint32_t bytes)
+{
+    rc->sentBytes += bytes;
+}
+
+void ARSTREAM_RateControl_AckReceived (ARSTREAM_RateControl_t *rc, uint32_t bytes, struct timespec *now)
+{
+    rc->ackedBytes += bytes;
+    if (rc->waitingFirstAck == 1 &&
+        bytes > 0)
+    {
+        /* The delay between the first send of a frame and its first ack
+         * contains the link RTT plus the time spent in the queues. Its
+         * growth above the windowed minimum is the queueing delay */
+        int delay = ARSAL_Time_ComputeTimespecMsTimeDiff (&rc->frameStartTime, now);
+        if (delay < 0)
+        {
+            delay = 0;
+        }
+        rc->waitingFirstAck = 0;
+        if (rc->intervalMinDelay < 0 ||
+            delay < rc->intervalMinDelay)
+        {
+            rc->intervalMinDelay = delay;
+        }
+        if (rc->smoothedDelay < 0)
+        {
+            rc->smoothedDelay = delay;
+        }
+        else
+        {
+            rc->smoothedDelay = (7 * rc->smoothedDelay + delay) / 8;
+        }
+    }
+}
+
+void ARSTREAM_RateControl_FragmentsAcked (ARSTREAM_RateControl_t *rc, uint32_t nbAcked, uint32_t nbLost)
+{
+    rc->ackedFragments += nbAcked;
+    rc->lostFragments += nbLost;
+}
+
+void ARSTREAM_RateControl_ReceiverReport (ARSTREAM_RateControl_t *rc, uint8_t fractionLost)
+{
+    rc->receiverLoss = fractionLost;
+}
+
+int ARSTREAM_RateControl_Update (ARSTREAM_RateControl_t *rc, struct timespec *now)
+{
+    int elapsed;
+    int i;
+    uint32_t maxDeliveryRate = 0;
+    int baseDelay = -1;
+    int queueDelay = 0;
+    int overuse = 0;
+    uint32_t lossPercent = 0;
+    uint32_t diff;
+
+    if (rc->hasLastUpdateTime == 0)
+    {
+        rc->lastUpdateTime = *now;
+        rc->hasLastUpdateTime = 1;
+        return 0;
+    }
+
+    elapsed = ARSAL_Time_ComputeTimespecMsTimeDiff (&rc->lastUpdateTime, now);
+    if (elapsed < ARSTREAM_RATE_CONTROL_UPDATE_INTERVAL_MS)
+    {
+        return 0;
+    }
+
+    /* Bandwidth estimation : windowed max of the delivery rate. Intervals
+     * where nothing was sent carry no information */
+    if (rc->sentBytes > 0)
+    {
+        rc->deliveryRate[rc->deliveryRateIndex] = (uint32_t)(((uint64_t)rc->ackedBytes * 8 * 1000) / elapsed);
+        rc->deliveryRateIndex = (rc->deliveryRateIndex + 1) % ARSTREAM_RATE_CONTROL_NB_SAMPLES;
+        if (rc->nbDeliveryRate < ARSTREAM_RATE_CONTROL_NB_SAMPLES)
+        {
+            rc->nbDeliveryRate++;
+        }
+    }
+
+    /* Loss estimation : bytes in flight are not lost, only the fragments
+     * reported missing by the reader count */
+    if (rc->ackedFragments + rc->lostFragments > 0)
+    {
+        lossPercent = (uint32_t)(((uint64_t)rc->lostFragments * 100) / (rc->ackedFragments + rc->lostFragments));
+    }
+    else if (rc->receiverLoss >= 0)
+    {
+        lossPercent = (uint32_t)((rc->receiverLoss * 100) / 256);
+    }
+    for (i = 0; i < rc->nbDeliveryRate; i++)
+    {
+        if (rc->deliveryRate[i] > maxDeliveryRate)
+        {
+            maxDeliveryRate = rc->deliveryRate[i];
+        }
+    }
+
+    /* Delay estimation : windowed min of the ack delay is the base delay */
+    if (rc->intervalMinDelay >= 0)
+    {
+        rc->delaySamples[rc->delayIndex] = rc->intervalMinDelay;
+        rc->delayIndex = (rc->delayIndex + 1) % ARSTREAM_RATE_CONTROL_NB_SAMPLES;
+        if (rc->nbDelay < ARSTREAM_RATE_CONTROL_NB_SAMPLES)
+        {
+            rc->nbDelay++;
+        }
+    }
+    for (i = 0; i < rc->nbDelay; i++)
+    {
+        if (baseDelay < 0 ||
+            rc->delaySamples[i] < baseDelay)
+        {
+            baseDelay = rc->delaySamples[i];
+        }
+    }
+    if (baseDelay >= 0 &&
+        rc->smoothedDelay >= 0)
+    {
+        queueDelay = rc->smoothedDelay - baseDelay;
+        overuse = (queueDelay > ARSTREAM_RATE_CONTROL_OVERUSE_DELAY_MS) &&
+            (rc->smoothedDelay > rc->previousSmoothedDelay);
+    }
+
+    if (overuse == 1 ||
+        lossPercent > ARSTREAM_RATE_CONTROL_HIGH_LOSS_PERCENT)
+    {
+        /* Back off under what the link actually delivered */
+        uint32_t newTarget = (uint32_t)(((uint64_t)rc->targetBitrate * ARSTREAM_RATE_CONTROL_DECREASE_PERCENT) / 100);
+        if (maxDeliveryRate > 0)
+        {
+            newTarget = (uint32_t)(((uint64_t)maxDeliveryRate * ARSTREAM_RATE_CONTROL_DECREASE_PERCENT) / 100);
+        }
+        if (newTarget < rc->targetBitrate)
+        {
+            rc->targetBitrate = newTarget;
+        }
+    }
+    else if (lossPercent < ARSTREAM_RATE_CONTROL_LOW_LOSS_PERCENT &&
+             queueDelay <= ARSTREAM_RATE_CONTROL_OVERUSE_DELAY_MS / 2)
+    {
+        /* Probe for more bandwidth, but not too far above the measured rate */
+        uint64_t newTarget = ((uint64_t)rc->targetBitrate * ARSTREAM_RATE_CONTROL_INCREASE_PERCENT) / 100 + 1;
+        if (maxDeliveryRate > 0)
+        {
+            uint64_t probeLimit = ((uint64_t)maxDeliveryRate * ARSTREAM_RATE_CONTROL_PROBE_PERCENT) / 100;
+            if (probeLimit < rc->targetBitrate)
+            {
+                probeLimit = rc->targetBitrate;
+            }
+            if (newTarget > probeLimit)
+            {
+                newTarget = probeLimit;
+            }
+        }
+        rc->targetBitrate = (newTarget > UINT32_MAX) ? UINT32_MAX : (uint32_t)newTarget;
+    }
+    ARSTREAM_RateControl_ClampTarget (rc);
+
+    rc->sentBytes = 0;
+    rc->ackedBytes = 0;
+    rc->ackedFragments = 0;
+    rc->lostFragments = 0;
+    rc->receiverLoss = -1;
+    rc->intervalMinDelay = -1;
+    rc->previousSmoothedDelay = rc->smoothedDelay;
+    rc->lastUpdateTime = *now;
+
+    diff = (rc->targetBitrate > rc->reportedBitrate) ?
+        rc->targetBitrate - rc->reportedBitrate :
+        rc->reportedBitrate - rc->targetBitrate;
+    if ((uint64_t)diff * 100 > (uint64_t)rc->reportedBitrate * ARSTREAM_RATE_CONTROL_REPORT_PERCENT)
+    {
+        rc->reportedBitrate = rc->targetBitrate;
+        return 1;
+    }
+    return 0;
+}
+
+uint32_t ARSTREAM_RateControl_GetTargetBitrate (ARSTREAM_RateControl_t *rc)
+{
+    return rc->targetBitrate;
+}
@@ -0,0 +1,180 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_RateControl.h
+ * @brief Sender-side congestion controller
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_RATE_CONTROL_PRIVATE_H_
+#define _ARSTREAM_RATE_CONTROL_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+#include <time.h>
+
+/*
+ * Private Headers
+ */
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Number of delivery rate samples kept for the bandwidth estimation
+ */
+#define ARSTREAM_RATE_CONTROL_NB_SAMPLES (10)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Congestion controller state
+ * The controller estimates the available bandwidth from the rate at which
+ * fragments are acknowledged (windowed maximum of the delivery rate), and
+ * detects congestion from the growth of the ack delay above its windowed
+ * minimum (queueing delay), or from the loss rate. The loss rate counts the
+ * fragments declared missing by the acknowledges, or comes from the reader
+ * receiver reports when no fragment was acknowledged (best effort mode).
+ */
+typedef struct {
+    uint32_t minBitrate; /**< Lower limit of the target bitrate (bits/s) */
+    uint32_t maxBitrate; /**< Upper limit of the target bitrate (bits/s) */
+    uint32_t targetBitrate; /**< Current target bitrate (bits/s) */
+    uint32_t reportedBitrate; /**< Last target bitrate reported to the application */
+
+    uint32_t sentBytes; /**< Bytes sent since last update */
+    uint32_t ackedBytes; /**< Bytes acknowledged since last update */
+    uint32_t ackedFragments; /**< Fragments acknowledged on their first transmission since last update */
+    uint32_t lostFragments; /**< Fragments declared missing by the acknowledges since last update */
+    int receiverLoss; /**< Loss fraction (1/256) of the last receiver report since last update, -1 if none */
+    struct timespec lastUpdateTime; /**< Time of the last update */
+    int hasLastUpdateTime; /**< Set once lastUpdateTime is valid */
+
+    uint32_t deliveryRate[ARSTREAM_RATE_CONTROL_NB_SAMPLES]; /**< Delivery rate samples (bits/s) */
+    int deliveryRateIndex; /**< Next sample index */
+    int nbDeliveryRate; /**< Number of valid samples */
+
+    struct timespec frameStartTime; /**< Time when the current frame was first sent */
+    int waitingFirstAck; /**< Set until the first ack of the current frame is received */
+
+    int delaySamples[ARSTREAM_RATE_CONTROL_NB_SAMPLES]; /**< Per-interval minimum ack delays (ms) */
+    int delayIndex; /**< Next delay sample index */
+    int nbDelay; /**< Number of valid delay samples */
+    int intervalMinDelay; /**< Minimum ack delay in the current interval, -1 if none */
+    int smoothedDelay; /**< Smoothed ack delay (ms), -1 if none */
+    int previousSmoothedDelay; /**< Smoothed ack delay at the previous update */
+} ARSTREAM_RateControl_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Initializes a congestion controller
+ * The target bitrate starts at maxBitrate
+ * @param rc The controller
+ * @param minBitrate The lower limit of the target bitrate (bits/s)
+ * @param maxBitrate The upper limit of the target bitrate (bits/s)
+ */
+void ARSTREAM_RateControl_Init (ARSTREAM_RateControl_t *rc, uint32_t minBitrate, uint32_t maxBitrate);
+
+/**
+ * @brief Changes the limits of the target bitrate
+ * The current target is clamped into the new limits
+ * @param rc The controller
+ * @param minBitrate The lower limit of the target bitrate (bits/s)
+ * @param maxBitrate The upper limit of the target bitrate (bits/s)
+ */
+void ARSTREAM_RateControl_SetLimits (ARSTREAM_RateControl_t *rc, uint32_t minBitrate, uint32_t maxBitrate);
+
+/**
+ * @brief Notifies the controller that a new frame started to be sent
+ * @param rc The controller
+ * @param now The current time
+ */
+void ARSTREAM_RateControl_FrameStarted (ARSTREAM_RateControl_t *rc, struct timespec *now);
+
+/**
+ * @brief Notifies the controller that data was sent
+ * @param rc The controller
+ * @param bytes The number of bytes sent
+ */
+void ARSTREAM_RateControl_DataSent (ARSTREAM_RateControl_t *rc, uint32_t bytes);
+
+/**
+ * @brief Notifies the controller that data was acknowledged
+ * @param rc The controller
+ * @param bytes The number of newly acknowledged bytes
+ * @param now The current time
+ */
+void ARSTREAM_RateControl_AckReceived (ARSTREAM_RateControl_t *rc, uint32_t bytes, struct timespec *now);
+
+/**
+ * @brief Notifies the controller of the fragments newly acknowledged or declared missing
+ * @param rc The controller
+ * @param nbAcked The number of fragments acknowledged, which were not declared missing before
+ * @param nbLost The number of fragments newly declared missing
+ */
+void ARSTREAM_RateControl_FragmentsAcked (ARSTREAM_RateControl_t *rc, uint32_t nbAcked, uint32_t nbLost);
+
+/**
+ * @brief Notifies the controller of a receiver report
+ * @param rc The controller
+ * @param fractionLost The fraction of frames lost by the reader since its previous report, in 1/256
+ */
+void ARSTREAM_RateControl_ReceiverReport (ARSTREAM_RateControl_t *rc, uint8_t fractionLost);
+
+/**
+ * @brief Runs the controller update if an update interval elapsed
+ * @param rc The controller
+ * @param now The current time
+ * @return 1 if the target bitrate changed significantly since the last report, 0 otherwise
+ * @note When 1 is returned, the new target is considered as reported
+ */
+int ARSTREAM_RateControl_Update (ARSTREAM_RateControl_t *rc, struct timespec *now);
+
+/**
+ * @brief Gets the current target bitrate
+ * @param rc The controller
+ * @return The target bitrate, in bits per second
+ */
+uint32_t ARSTREAM_RateControl_GetTargetBitrate (ARSTREAM_RateControl_t *rc);
+
+#endif /* _ARSTREAM_RATE_CONTROL_PRIVATE_H_ */
@@ -52,14 +52,21 @@
 
 #include "ARSTREAM_Buffers.h"
 #include "ARSTREAM_NetworkHeaders.h"
+#include "ARSTREAM_ClockSync.h"
+#include "ARSTREAM_JitterBuffer.h"
+#include "ARSTREAM_Rtp.h"
+#include "ARSTREAM_H264.h"
 
 /*
  * ARSDK Headers
  */
 
 #include <libARStream/ARSTREAM_Reader.h>
+#include <libARStream/ARSTREAM_Sender.h>
+#include <libARStream/ARSTREAM_Clock.h>
 #include <libARSAL/ARSAL_Print.h>
 #include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Time.h>
 #include <libARSAL/ARSAL_Endianness.h>
 
 /*
@@ -89,14 +96,17 @@
 
 struct ARSTREAM_Reader_t {
     /* Configuration on New */
-    ARNETWORK_Manager_t *manager;
-    int dataBufferID;
-    int ackBufferID;
+    ARSTREAM_Transport_t transport;
+    int ownsTransport; // The transport was created by ARSTREAM_Reader_New()
     uint32_t maxFragmentSize;
     int32_t maxAckInterval;
     ARSTREAM_Reader_FrameCompleteCallback_t callback;
     void *custom;
 
+    /* Configuration (only changed while the threads are not running) */
+    eARSTREAM_READER_PACKETIZATION packetizationMode;
+    eARSTREAM_READER_STARTUP startupMode;
+
     /* Current frame storage */
     uint32_t currentFrameBufferSize; // Usable length of the buffer
     uint32_t currentFrameSize;       // Actual data length
@@ -105,6 +115,8 @@ struct ARSTREAM_Reader_t {
     /* Output frame storage */
     uint32_t outputFrameBufferSize; // Usable length of the buffer
     uint8_t *outputFrameBuffer;
+    ARSTREAM_Reader_FrameInfos_t outputFrameInfos;
+    ARSTREAM_Reader_FrameInfos_t reassembledFrameInfos; // Infos of the last complete frame, before the jitter buffer
 
     /* Acknowledge storage */
     ARSAL_Mutex_t ackPacketMutex;
@@ -116,6 +128,7 @@ struct ARSTREAM_Reader_t {
     int threadsShouldStop;
     int dataThreadStarted;
     int ackThreadStarted;
+    int playoutThreadStarted;
 
     /* Efficiency calculations */
     int efficiency_nbUseful [ARSTREAM_READER_EFFICIENCY_AVERAGE_NB_FRAMES];
@@ -125,6 +138,48 @@ struct ARSTREAM_Reader_t {
     /* Filters */
     ARSTREAM_Filter_t **filters;
     int nbFilters;
+
+    /* Feedback */
+    ARSAL_Mutex_t feedbackMutex;
+    int autoKeyframeRequest;
+    int receiverReportIntervalMs;
+    int waitingKeyframe;
+    struct timespec lastKeyframeRequestTime;
+    struct timespec lastReportTime;
+    struct timespec lastFrameCompleteTime;
+    int hasLastFrameCompleteTime;
+    int32_t lastInterArrivalUs;
+    uint32_t jitterUs16; // 16 times the jitter (RFC3550 fixed point)
+    uint16_t lastCompleteFrameNumber;
+    uint16_t highestFrameNumber;
+    uint32_t reportExpectedFrames;
+    uint32_t reportLostFrames;
+    uint32_t cumulativeLost;
+    int maxFrameLatencyMs;
+
+    /* Startup (protected by feedbackMutex) */
+    int waitingDecodableFrame;
+    struct timespec startupTime;
+    int timeToFirstPacketMs;
+    int timeToFirstFrameMs;
+    int timeToFirstDecodableFrameMs;
+    uint32_t nbDiscardedFrames;
+
+    /* Clock synchronization (protected by feedbackMutex) */
+    ARSTREAM_ClockSync_t clockSync;
+    int clockSyncIntervalMs;
+    struct timespec lastClockSyncTime;
+
+    /* Jitter buffer (protected by jitterBufferMutex) */
+    int jitterBufferEnabled; // Only changed while the threads are not running
+    ARSAL_Mutex_t jitterBufferMutex;
+    ARSAL_Cond_t jitterBufferCond;
+    ARSTREAM_JitterBuffer_t jitterBuffer;
+    uint8_t *jitterBufferNewBuffer; // Buffer returned on the last FRAME_TOO_SMALL (data thread only)
+
+    /* Application buffer when the jitter buffer is enabled (playout thread only) */
+    uint32_t playoutFrameBufferSize;
+    uint8_t *playoutFrameBuffer;
 };
 
 /*
@@ -132,30 +187,701 @@ struct ARSTREAM_Reader_t {
  */
 
 /**
- * @brief ARNETWORK_Manager_Callback_t for ARNETWORK_... calls
- * @param IoBufferId Unused as we always send on one unique buffer
- * @param dataPtr Unused as we don't need to free the memory
- * @param customData Unused
- * @param status Unused
- * @return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT
+ * @brief Sends a feedback packet on the ack buffer
+ * @param reader The reader
+ * @param type The feedback type (ARSTREAM_NETWORK_HEADERS_FEEDBACK_xxx)
+ * @param frameNumber The frame number to send
+ * @param fractionLost The fraction of frames lost since the previous report, in 1/256
+ * @warning Must be called with feedbackMutex held
+ */
+static void ARSTREAM_Reader_SendFeedback (ARSTREAM_Reader_t *reader, uint8_t type, uint16_t frameNumber, uint8_t fractionLost);
+
+/**
+ * @brief Updates the feedback statistics on a frame completion, and requests a keyframe if needed
+ * @param reader The reader
+ * @param frameNumber The id of the complete frame
+ * @param nbMissedFrame Number of frames missed since the previous complete frame
+ * @param isKeyFrame Boolean-like (0-1) flag telling if the complete frame is a keyframe
+ * @param isDamaged Boolean-like (0-1) flag telling if NAL units of the complete frame were lost
+ */
+static void ARSTREAM_Reader_FeedbackFrameComplete (ARSTREAM_Reader_t *reader, uint16_t frameNumber, int nbMissedFrame, int isKeyFrame, int isDamaged);
+
+/**
+ * @brief Sends a receiver report if the report interval elapsed
+ * @param reader The reader
+ */
+static void ARSTREAM_Reader_FeedbackPeriodicReport (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Resets the startup metrics, called when the data thread starts
+ * @param reader The reader
+ */
+static void ARSTREAM_Reader_StartupBegin (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Records the arrival of a stream packet in the startup metrics
+ * @param reader The reader
+ */
+static void ARSTREAM_Reader_StartupPacketReceived (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Updates the startup state on a frame completion, and tells if the frame must be given to the application
+ * @param reader The reader
+ * @param isKeyFrame Boolean-like (0-1) flag telling if the complete frame is a flush frame or a keyframe
+ * @param hasSlice Boolean-like (0-1) flag telling if the complete frame holds any slice (1 if unknown)
+ * @return 1 if the frame must be given to the application, 0 if it must be discarded
+ */
+static int ARSTREAM_Reader_StartupFrameComplete (ARSTREAM_Reader_t *reader, int isKeyFrame, int hasSlice);
+
+/**
+ * @brief Tells if the current (native) frame holds any slice
+ * @param reader The reader
+ * @return 0 if the frame is an Annex-B frame without any slice (e.g. SPS/PPS only), 1 otherwise
+ * @warning Must be called from the data thread
+ */
+static int ARSTREAM_Reader_CurrentFrameHasSlice (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Abandons the current frame if it did not complete in time
+ * @param reader The reader
+ * @param frameNumber The id of the current frame
+ * @param frameStartTime The time when the first fragment of the current frame was received
+ * @param timeLeftMs Pointer which will hold the time left before abandoning the frame (-1 if frames are never abandoned)
+ * @return 1 if the frame was abandoned (the sender was told to stop retrying it), 0 otherwise
+ */
+static int ARSTREAM_Reader_AbandonLateFrame (ARSTREAM_Reader_t *reader, uint16_t frameNumber, struct timespec *frameStartTime, int *timeLeftMs);
+
+/**
+ * @brief Sends a clock frame to the sender if the clock sync interval elapsed
+ * @param reader The reader
+ */
+static void ARSTREAM_Reader_ClockSyncPeriodicRequest (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Uses a clock frame answered by the sender
+ * @param reader The reader
+ * @param answer The clock frame, in network endianness
+ * @param arrivalUs The time when the clock frame was received
+ */
+static void ARSTREAM_Reader_ClockSyncAnswer (ARSTREAM_Reader_t *reader, ARSTREAM_NetworkHeaders_ClockFrame_t *answer, uint64_t arrivalUs);
+
+/**
+ * @brief Calls the frame callback from the data thread
+ * When the jitter buffer is enabled, the call is answered by the jitter buffer with its own
+ * buffers, and complete frames are queued until ARSTREAM_Reader_RunPlayoutThread releases them.
+ * Otherwise, the application callback is called.
+ * @param reader The reader
+ * @param cause The callback cause
+ * @param framePointer The frame buffer
+ * @param frameSize The frame size
+ * @param numberOfSkippedFrames Number of frames skipped before this one
+ * @param isFlushFrame Boolean-like (0-1) flag telling if the frame is a flush frame
+ * @param newBufferCapacity Capacity of the current buffer, updated with the capacity of the returned buffer
+ * @return The new buffer, as for ARSTREAM_Reader_FrameCompleteCallback_t
+ */
+static uint8_t* ARSTREAM_Reader_CallCallback (ARSTREAM_Reader_t *reader, eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity);
+
+/**
+ * @brief Gives a frame released by the jitter buffer to the application
+ * @param reader The reader
+ * @param frame The released frame
+ * @param numberOfSkippedFrames Number of frames skipped since the previous frame given to the application
+ * @return 1 if the frame was given to the application, 0 if the application buffer was too small
+ * @warning Must be called from the playout thread, without jitterBufferMutex held
+ */
+static int ARSTREAM_Reader_PlayoutFrame (ARSTREAM_Reader_t *reader, ARSTREAM_JitterBuffer_Frame_t *frame, int numberOfSkippedFrames);
+
+/**
+ * @brief Grows the frame buffers (and the filters buffers) until they can hold endIndex bytes
+ * The data already received for the current frame is copied into the new buffers.
+ * @param reader The reader
+ * @param endIndex The size the current frame buffer must be able to hold
+ * @param skipCurrentFrame Pointer to the skip flag of the current frame, set to 1 if the application did not give a big enough buffer
+ * @warning Must be called from the data thread
  */
-eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Reader_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status);
+static void ARSTREAM_Reader_GrowFrameBuffer (ARSTREAM_Reader_t *reader, uint32_t endIndex, int *skipCurrentFrame);
+
+/**
+ * @brief Gives the current frame to the filters and to the application
+ * reassembledFrameInfos must already describe the current frame.
+ * @param reader The reader
+ * @param nbMissedFrame Number of frames skipped before this one
+ * @param isFlushFrame Boolean-like (0-1) flag telling if the frame is a flush frame
+ * @warning Must be called from the data thread
+ */
+static void ARSTREAM_Reader_FrameComplete (ARSTREAM_Reader_t *reader, int nbMissedFrame, int isFlushFrame);
+
+/**
+ * @brief Handles a RTP packet received in ARSTREAM_READER_PACKETIZATION_RTP_H264 mode
+ * @param reader The reader
+ * @param depacketizer The depacketizer of the data thread
+ * @param rtpHeader The parsed RTP header of the packet
+ * @param packet The packet
+ * @warning Must be called from the data thread
+ */
+static void ARSTREAM_Reader_ProcessRtpPacket (ARSTREAM_Reader_t *reader, ARSTREAM_Rtp_Depacketizer_t *depacketizer, ARSTREAM_Rtp_Header_t *rtpHeader, uint8_t *packet);
+
+/**
+ * @brief Ends the frame rebuilt by the depacketizer, and gives it to the application if it holds any data
+ * @param reader The reader
+ * @param depacketizer The depacketizer of the data thread
+ * @warning Must be called from the data thread
+ */
+static void ARSTREAM_Reader_RtpFrameComplete (ARSTREAM_Reader_t *reader, ARSTREAM_Rtp_Depacketizer_t *depacketizer);
 
 /*
  * Internal functions implementation
  */
 
-//TODO: Network, NULL callback should be ok ?
-eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Reader_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status)
+static void ARSTREAM_Reader_SendFeedback (ARSTREAM_Reader_t *reader, uint8_t type, uint16_t frameNumber, uint8_t fractionLost)
+{
+    ARSTREAM_NetworkHeaders_FeedbackPacket_t sendPacket;
+    memset (&sendPacket, 0, sizeof (sendPacket));
+    ARSTREAM_NetworkHeaders_ControlHeaderInit (&(sendPacket.control), ARSTREAM_NETWORK_HEADERS_CONTROL_FEEDBACK);
+    sendPacket.type = type;
+    sendPacket.fractionLost = fractionLost;
+    sendPacket.frameNumber = htods (frameNumber);
+    sendPacket.highestFrameNumber = htods (reader->highestFrameNumber);
+    sendPacket.cumulativeLost = htodl (reader->cumulativeLost);
+    sendPacket.jitterUs = htodl (reader->jitterUs16 >> 4);
+    reader->transport.sendAck (reader->transport.context, (uint8_t *)&sendPacket, sizeof (sendPacket));
+}
+
+static void ARSTREAM_Reader_FeedbackFrameComplete (ARSTREAM_Reader_t *reader, uint16_t frameNumber, int nbMissedFrame, int isKeyFrame, int isDamaged)
+{
+    struct timespec now;
+    ARSTREAM_Clock_GetTime (&now);
+
+    /* Frame numbers wrap around at 16 bits */
+    nbMissedFrame = (uint16_t)nbMissedFrame;
+
+    ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+    /* Interarrival jitter, computed as in RFC3550 with frame completion times */
+    if (reader->hasLastFrameCompleteTime == 1)
+    {
+        int32_t interArrivalUs = (int32_t)((now.tv_sec - reader->lastFrameCompleteTime.tv_sec) * 1000000 +
+                                           (now.tv_nsec - reader->lastFrameCompleteTime.tv_nsec) / 1000);
+        int32_t d = interArrivalUs - reader->lastInterArrivalUs;
+        if (d < 0)
+        {
+            d = -d;
+        }
+        reader->jitterUs16 += d - ((reader->jitterUs16 + 8) >> 4);
+        reader->lastInterArrivalUs = interArrivalUs;
+    }
+    reader->lastFrameCompleteTime = now;
+    reader->hasLastFrameCompleteTime = 1;
+    reader->lastCompleteFrameNumber = frameNumber;
+
+    reader->reportExpectedFrames += nbMissedFrame + 1;
+    reader->reportLostFrames += nbMissedFrame;
+    reader->cumulativeLost += nbMissedFrame;
+
+    if (isKeyFrame == 1)
+    {
+        reader->waitingKeyframe = 0;
+    }
+    else if ((nbMissedFrame > 0) ||
+             (isDamaged == 1))
+    {
+        /* The decoder lost a reference */
+        reader->waitingKeyframe = 1;
+    }
+
+    if ((reader->autoKeyframeRequest == 1) &&
+        (reader->waitingKeyframe == 1) &&
+        (ARSAL_Time_ComputeTimespecMsTimeDiff (&(reader->lastKeyframeRequestTime), &now) >= ARSTREAM_READER_KEYFRAME_REQUEST_RETRY_MS))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Requesting a keyframe (missed %d frames)", nbMissedFrame);
+        ARSTREAM_Reader_SendFeedback (reader, ARSTREAM_NETWORK_HEADERS_FEEDBACK_KEYFRAME_REQUEST, reader->lastCompleteFrameNumber, 0);
+        reader->lastKeyframeRequestTime = now;
+    }
+    ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+}
+
+static void ARSTREAM_Reader_FeedbackPeriodicReport (ARSTREAM_Reader_t *reader)
+{
+    struct timespec now;
+    ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+    if (reader->receiverReportIntervalMs > 0)
+    {
+        ARSTREAM_Clock_GetTime (&now);
+        if (ARSAL_Time_ComputeTimespecMsTimeDiff (&(reader->lastReportTime), &now) >= reader->receiverReportIntervalMs)
+        {
+            uint32_t fractionLost = 0;
+            if (reader->reportExpectedFrames > 0)
+            {
+                fractionLost = (reader->reportLostFrames * 256) / reader->reportExpectedFrames;
+                fractionLost = (fractionLost > UINT8_MAX) ? UINT8_MAX : fractionLost;
+            }
+            ARSTREAM_Reader_SendFeedback (reader, ARSTREAM_NETWORK_HEADERS_FEEDBACK_RECEIVER_REPORT, reader->lastCompleteFrameNumber, (uint8_t)fractionLost);
+            reader->reportExpectedFrames = 0;
+            reader->reportLostFrames = 0;
+            reader->lastReportTime = now;
+        }
+    }
+    ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+}
+
+static void ARSTREAM_Reader_StartupBegin (ARSTREAM_Reader_t *reader)
+{
+    ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+    ARSTREAM_Clock_GetTime (&(reader->startupTime));
+    reader->timeToFirstPacketMs = -1;
+    reader->timeToFirstFrameMs = -1;
+    reader->timeToFirstDecodableFrameMs = -1;
+    reader->nbDiscardedFrames = 0;
+    reader->waitingDecodableFrame = (reader->startupMode == ARSTREAM_READER_STARTUP_WAIT_KEYFRAME) ? 1 : 0;
+    if (reader->waitingDecodableFrame == 1)
+    {
+        /* Ask for a keyframe on the first discarded frame */
+        reader->waitingKeyframe = 1;
+    }
+    ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+}
+
+static void ARSTREAM_Reader_StartupPacketReceived (ARSTREAM_Reader_t *reader)
+{
+    if (reader->timeToFirstPacketMs < 0)
+    {
+        struct timespec now;
+        ARSTREAM_Clock_GetTime (&now);
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        reader->timeToFirstPacketMs = ARSAL_Time_ComputeTimespecMsTimeDiff (&(reader->startupTime), &now);
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+}
+
+static int ARSTREAM_Reader_StartupFrameComplete (ARSTREAM_Reader_t *reader, int isKeyFrame, int hasSlice)
+{
+    int retVal = 1;
+    struct timespec now;
+    ARSTREAM_Clock_GetTime (&now);
+
+    ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+    if (reader->timeToFirstFrameMs < 0)
+    {
+        reader->timeToFirstFrameMs = ARSAL_Time_ComputeTimespecMsTimeDiff (&(reader->startupTime), &now);
+    }
+    if (isKeyFrame == 1)
+    {
+        if (reader->timeToFirstDecodableFrameMs < 0)
+        {
+            reader->timeToFirstDecodableFrameMs = ARSAL_Time_ComputeTimespecMsTimeDiff (&(reader->startupTime), &now);
+        }
+        reader->waitingDecodableFrame = 0;
+    }
+    else if ((reader->waitingDecodableFrame == 1) &&
+             (hasSlice == 1))
+    {
+        reader->nbDiscardedFrames++;
+        retVal = 0;
+    }
+    ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    return retVal;
+}
+
+static int ARSTREAM_Reader_CurrentFrameHasSlice (ARSTREAM_Reader_t *reader)
 {
-    /* Avoid "unused parameters" warnings */
-    (void)IoBufferId;
-    (void)dataPtr;
-    (void)customData;
-    (void)status;
+    ARSTREAM_H264_NalUnit_t nalUnits [ARSTREAM_H264_MAX_NAL_UNITS];
+    int nbNalUnits = ARSTREAM_H264_FindNalUnits (reader->currentFrameBuffer, reader->currentFrameSize, nalUnits, ARSTREAM_H264_MAX_NAL_UNITS);
+    int i;
 
-    /* Dummy return value */
-    return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT;
+    if ((nbNalUnits <= 0) ||
+        (nbNalUnits >= ARSTREAM_H264_MAX_NAL_UNITS))
+    {
+        /* Not an Annex-B frame, or too many NAL units to be sure */
+        return 1;
+    }
+    for (i = 0; i < nbNalUnits; i++)
+    {
+        int type = ARSTREAM_H264_NALU_TYPE (reader->currentFrameBuffer[nalUnits[i].offset]);
+        if ((type >= ARSTREAM_H264_NALU_TYPE_SLICE) &&
+            (type <= ARSTREAM_H264_NALU_TYPE_IDR))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int ARSTREAM_Reader_AbandonLateFrame (ARSTREAM_Reader_t *reader, uint16_t frameNumber, struct timespec *frameStartTime, int *timeLeftMs)
+{
+    int retVal = 0;
+    struct timespec now;
+    *timeLeftMs = -1;
+    ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+    if (reader->maxFrameLatencyMs > 0)
+    {
+        ARSTREAM_Clock_GetTime (&now);
+        *timeLeftMs = reader->maxFrameLatencyMs - ARSAL_Time_ComputeTimespecMsTimeDiff (frameStartTime, &now);
+        if (*timeLeftMs <= 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Abandoning frame %d (incomplete after %d ms)", frameNumber, reader->maxFrameLatencyMs);
+            ARSTREAM_Reader_SendFeedback (reader, ARSTREAM_NETWORK_HEADERS_FEEDBACK_ABANDON_FRAME, frameNumber, 0);
+            retVal = 1;
+        }
+    }
+    ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    return retVal;
+}
+
+static void ARSTREAM_Reader_ClockSyncPeriodicRequest (ARSTREAM_Reader_t *reader)
+{
+    struct timespec now;
+    ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+    if (reader->clockSyncIntervalMs > 0)
+    {
+        ARSTREAM_Clock_GetTime (&now);
+        if (ARSAL_Time_ComputeTimespecMsTimeDiff (&(reader->lastClockSyncTime), &now) >= reader->clockSyncIntervalMs)
+        {
+            ARSTREAM_NetworkHeaders_ClockFrame_t sendPacket;
+            uint32_t high, low;
+            memset (&sendPacket, 0, sizeof (sendPacket));
+            ARSTREAM_NetworkHeaders_ControlHeaderInit (&(sendPacket.control), ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK);
+            ARSTREAM_ClockSync_WriteTimestamp (&high, &low, ARSTREAM_ClockSync_GetTimeUs ());
+            sendPacket.originateTimestampH = htodl (high);
+            sendPacket.originateTimestampL = htodl (low);
+            reader->transport.sendAck (reader->transport.context, (uint8_t *)&sendPacket, sizeof (sendPacket));
+            reader->lastClockSyncTime = now;
+        }
+    }
+    ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+}
+
+static void ARSTREAM_Reader_ClockSyncAnswer (ARSTREAM_Reader_t *reader, ARSTREAM_NetworkHeaders_ClockFrame_t *answer, uint64_t arrivalUs)
+{
+    uint64_t originateUs = ARSTREAM_ClockSync_ReadTimestamp (dtohl (answer->originateTimestampH), dtohl (answer->originateTimestampL));
+    uint64_t receiveUs = ARSTREAM_ClockSync_ReadTimestamp (dtohl (answer->receiveTimestampH), dtohl (answer->receiveTimestampL));
+    uint64_t transmitUs = ARSTREAM_ClockSync_ReadTimestamp (dtohl (answer->transmitTimestampH), dtohl (answer->transmitTimestampL));
+    ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+    ARSTREAM_ClockSync_AddSample (&(reader->clockSync), originateUs, receiveUs, transmitUs, arrivalUs);
+    ARSAL_PRINT (ARSAL_PRINT_VERBOSE, ARSTREAM_READER_TAG, "Clock offset %lld us (rtt %lld us)", (long long)reader->clockSync.refOffsetUs, (long long)reader->clockSync.rttUs);
+    ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+}
+
+static uint8_t* ARSTREAM_Reader_CallCallback (ARSTREAM_Reader_t *reader, eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity)
+{
+    uint8_t *retVal = NULL;
+
+    if (reader->jitterBufferEnabled == 0)
+    {
+        if (cause == ARSTREAM_READER_CAUSE_FRAME_COMPLETE)
+        {
+            reader->outputFrameInfos = reader->reassembledFrameInfos;
+        }
+        return reader->callback (cause, framePointer, frameSize, numberOfSkippedFrames, isFlushFrame, newBufferCapacity, reader->custom);
+    }
+
+    ARSAL_Mutex_Lock (&(reader->jitterBufferMutex));
+    switch (cause)
+    {
+    case ARSTREAM_READER_CAUSE_FRAME_COMPLETE:
+    {
+        uint32_t capacity = *newBufferCapacity;
+        retVal = ARSTREAM_JitterBuffer_GetBuffer (&(reader->jitterBuffer), &capacity);
+        if (retVal == NULL)
+        {
+            /* Keep the buffer for the next frame, this one is lost */
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Jitter buffer can not alloc memory, dropping frame %d", reader->reassembledFrameInfos.frameNumber);
+            reader->jitterBuffer.pendingSkippedFrames += 1 + numberOfSkippedFrames;
+            retVal = framePointer;
+        }
+        else
+        {
+            ARSTREAM_JitterBuffer_Frame_t frame;
+            frame.buffer = framePointer;
+            frame.capacity = *newBufferCapacity;
+            frame.size = frameSize;
+            frame.numberOfSkippedFrames = numberOfSkippedFrames;
+            frame.isFlushFrame = isFlushFrame;
+            frame.infos = reader->reassembledFrameInfos;
+            ARSTREAM_JitterBuffer_Push (&(reader->jitterBuffer), &frame, ARSTREAM_ClockSync_GetTimeUs ());
+            *newBufferCapacity = capacity;
+            ARSTREAM_Clock_CondSignal (&(reader->jitterBufferCond));
+        }
+        break;
+    }
+    case ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL:
+        retVal = ARSTREAM_JitterBuffer_GetBuffer (&(reader->jitterBuffer), newBufferCapacity);
+        if (retVal == NULL)
+        {
+            /* A zero capacity makes the data thread skip the frame */
+            retVal = framePointer;
+            *newBufferCapacity = 0;
+        }
+        reader->jitterBufferNewBuffer = retVal;
+        break;
+    case ARSTREAM_READER_CAUSE_COPY_COMPLETE:
+        /* The data thread updates outputFrameBufferSize after this call */
+        if (framePointer != reader->jitterBufferNewBuffer)
+        {
+            ARSTREAM_JitterBuffer_ReleaseBuffer (&(reader->jitterBuffer), framePointer, reader->outputFrameBufferSize);
+        }
+        reader->jitterBufferNewBuffer = NULL;
+        break;
+    case ARSTREAM_READER_CAUSE_CANCEL:
+    default:
+        /* The last buffer stays in outputFrameBuffer, and is freed by ARSTREAM_Reader_Delete */
+        break;
+    }
+    ARSAL_Mutex_Unlock (&(reader->jitterBufferMutex));
+    return retVal;
+}
+
+static int ARSTREAM_Reader_PlayoutFrame (ARSTREAM_Reader_t *reader, ARSTREAM_JitterBuffer_Frame_t *frame, int numberOfSkippedFrames)
+{
+    int skipFrame = 0;
+
+    while ((frame->size > reader->playoutFrameBufferSize) &&
+           (skipFrame == 0))
+    {
+        uint32_t newCapacity = frame->size;
+        uint32_t dummy;
+        uint8_t *newBuffer = reader->callback (ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL, reader->playoutFrameBuffer, 0, 0, 0, &newCapacity, reader->custom);
+        if (newCapacity < frame->size)
+        {
+            skipFrame = 1;
+        }
+        reader->callback (ARSTREAM_READER_CAUSE_COPY_COMPLETE, reader->playoutFrameBuffer, 0, 0, skipFrame, &dummy, reader->custom);
+        reader->playoutFrameBuffer = newBuffer;
+        reader->playoutFrameBufferSize = newCapacity;
+    }
+
+    if (skipFrame == 1)
+    {
+        return 0;
+    }
+
+    memcpy (reader->playoutFrameBuffer, frame->buffer, frame->size);
+    reader->outputFrameInfos = frame->infos;
+    reader->playoutFrameBuffer = reader->callback (ARSTREAM_READER_CAUSE_FRAME_COMPLETE, reader->playoutFrameBuffer, frame->size, frame->numberOfSkippedFrames + numberOfSkippedFrames, frame->isFlushFrame, &(reader->playoutFrameBufferSize), reader->custom);
+    return 1;
+}
+
+static void ARSTREAM_Reader_GrowFrameBuffer (ARSTREAM_Reader_t *reader, uint32_t endIndex, int *skipCurrentFrame)
+{
+    uint32_t filterEndIndex = endIndex;
+    if (reader->nbFilters > 0)
+    {
+        int i;
+        for (i = 0; i < reader->nbFilters; i++)
+        {
+            ARSTREAM_Filter_t *filter = reader->filters[i];
+            filterEndIndex = filter->getOutputSize(filter->context,
+                                                   filterEndIndex);
+        }
+    }
+
+    while (((endIndex > reader->currentFrameBufferSize) ||
+            (filterEndIndex > reader->outputFrameBufferSize)) &&
+           (*skipCurrentFrame == 0))
+    {
+        uint32_t nextFrameBufferSize = endIndex;
+        uint32_t dummy;
+        uint8_t *nextFrameBuffer;
+        // If we have at least a filter, chain resize the buffers
+        if (reader->nbFilters > 0)
+        {
+            ARSTREAM_Filter_t *firstFilter = reader->filters[0];
+            nextFrameBuffer = firstFilter->getBuffer(firstFilter->context,
+                                                     nextFrameBufferSize);
+            int i;
+            int finalOutputSize = firstFilter->getOutputSize(firstFilter->context,
+                                                             nextFrameBufferSize);
+            // Update final output size by requesting it from each filter
+            for (i = 1; i < reader->nbFilters; i++)
+            {
+                ARSTREAM_Filter_t *filter = reader->filters[i];
+                finalOutputSize = filter->getOutputSize(filter->context,
+                                                        finalOutputSize);
+            }
+
+            // Resize actual output buffer if needed
+            if ((uint32_t)finalOutputSize > reader->outputFrameBufferSize)
+            {
+                uint32_t newOutputSize = finalOutputSize;
+                uint8_t *tmpFrame = ARSTREAM_Reader_CallCallback (reader, ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL, reader->outputFrameBuffer, reader->currentFrameSize, 0, 0, &newOutputSize);
+                if (newOutputSize < (uint32_t)finalOutputSize)
+                {
+                    *skipCurrentFrame = 1;
+                }
+                ARSTREAM_Reader_CallCallback (reader, ARSTREAM_READER_CAUSE_COPY_COMPLETE, reader->outputFrameBuffer, reader->currentFrameSize, 0, *skipCurrentFrame, &dummy);
+                reader->outputFrameBuffer = tmpFrame;
+                reader->outputFrameBufferSize = finalOutputSize;
+            }
+
+            // Copy into new buffer
+            if (nextFrameBuffer != NULL)
+            {
+                memcpy(nextFrameBuffer, reader->currentFrameBuffer, reader->currentFrameSize);
+            }
+            else
+            {
+                *skipCurrentFrame = 1;
+            }
+            firstFilter->releaseBuffer(firstFilter->context,
+                                       reader->currentFrameBuffer);
+        }
+        // Else, direclty resize the output buffer (and copy)
+        else
+        {
+            nextFrameBuffer = ARSTREAM_Reader_CallCallback (reader, ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL, reader->outputFrameBuffer, reader->currentFrameSize, 0, 0, &nextFrameBufferSize);
+            if (nextFrameBufferSize >= reader->currentFrameSize && nextFrameBufferSize > 0)
+            {
+                memcpy (nextFrameBuffer, reader->currentFrameBuffer, reader->currentFrameSize);
+            }
+            else
+            {
+                *skipCurrentFrame = 1;
+            }
+            //TODO: Add "SKIP_FRAME"
+            ARSTREAM_Reader_CallCallback (reader, ARSTREAM_READER_CAUSE_COPY_COMPLETE, reader->outputFrameBuffer, reader->currentFrameSize, 0, *skipCurrentFrame, &dummy);
+            reader->outputFrameBuffer = nextFrameBuffer;
+            reader->outputFrameBufferSize = nextFrameBufferSize;
+        }
+        reader->currentFrameBuffer = nextFrameBuffer;
+        reader->currentFrameBufferSize = nextFrameBufferSize;
+    }
+}
+
+static void ARSTREAM_Reader_FrameComplete (ARSTREAM_Reader_t *reader, int nbMissedFrame, int isFlushFrame)
+{
+    // If we have filters, apply them !
+    if (reader->nbFilters > 0)
+    {
+        int i;
+        ARSTREAM_Filter_t *filter;
+        ARSTREAM_Filter_t *nextFilter;
+        uint8_t *inBuffer = reader->currentFrameBuffer;
+        int inSize = reader->currentFrameSize;
+        uint8_t *outBuffer;
+        int outSize;
+        int maxOutSize;
+        // Chain filters
+        for (i = 0; i < (reader->nbFilters - 1); i++)
+        {
+            filter = reader->filters[i];
+            nextFilter = reader->filters[i+1];
+            maxOutSize = filter->getOutputSize(filter->context,
+                                               inSize);
+            outBuffer = nextFilter->getBuffer(nextFilter->context,
+                                              maxOutSize);
+            outSize = filter->filterBuffer(filter->context,
+                                           inBuffer, inSize,
+                                           outBuffer, maxOutSize);
+            filter->releaseBuffer(filter->context,
+                                  inBuffer);
+            inBuffer = outBuffer;
+            inSize = outSize;
+        }
+        // Apply last filter
+        filter = reader->filters[reader->nbFilters-1];
+        outSize = filter->filterBuffer(filter->context,
+                                       inBuffer, inSize,
+                                       reader->outputFrameBuffer,
+                                       reader->outputFrameBufferSize);
+        filter->releaseBuffer(filter->context,
+                              inBuffer);
+        reader->outputFrameBuffer = ARSTREAM_Reader_CallCallback (reader, ARSTREAM_READER_CAUSE_FRAME_COMPLETE, reader->outputFrameBuffer, outSize, nbMissedFrame, isFlushFrame, &(reader->outputFrameBufferSize));
+        // Get a new buffer from first filter
+        filter = reader->filters[0];
+        reader->currentFrameBuffer = filter->getBuffer(filter->context,
+                                                       reader->currentFrameBufferSize);
+    }
+    // No filters, directly talk to the callback
+    else
+    {
+        reader->outputFrameBuffer = ARSTREAM_Reader_CallCallback (reader, ARSTREAM_READER_CAUSE_FRAME_COMPLETE, reader->currentFrameBuffer, reader->currentFrameSize, nbMissedFrame, isFlushFrame, &(reader->outputFrameBufferSize));
+        reader->currentFrameBuffer = reader->outputFrameBuffer;
+        reader->currentFrameBufferSize = reader->outputFrameBufferSize;
+    }
+}
+
+static void ARSTREAM_Reader_ProcessRtpPacket (ARSTREAM_Reader_t *reader, ARSTREAM_Rtp_Depacketizer_t *depacketizer, ARSTREAM_Rtp_Header_t *rtpHeader, uint8_t *packet)
+{
+    int skipCurrentFrame;
+
+    /* Late and duplicated packets are dropped first : their older timestamp must not end the current frame */
+    if (ARSTREAM_Rtp_DepacketizerIsLatePacket (depacketizer, rtpHeader) == 1)
+    {
+        reader->efficiency_nbTotal [reader->efficiency_index] ++;
+        return;
+    }
+
+    /* A new timestamp means that the marker packet of the previous frame was lost */
+    if ((depacketizer->hasFrame == 1) &&
+        (depacketizer->timestamp != rtpHeader->timestamp))
+    {
+        ARSTREAM_Reader_RtpFrameComplete (reader, depacketizer);
+    }
+    if (depacketizer->hasFrame == 0)
+    {
+        ARSTREAM_Rtp_DepacketizerStartFrame (depacketizer, rtpHeader->timestamp);
+        reader->currentFrameSize = 0;
+        reader->efficiency_index ++;
+        reader->efficiency_index %= ARSTREAM_READER_EFFICIENCY_AVERAGE_NB_FRAMES;
+        reader->efficiency_nbTotal [reader->efficiency_index] = 0;
+        reader->efficiency_nbUseful [reader->efficiency_index] = 0;
+    }
+    reader->efficiency_nbTotal [reader->efficiency_index] ++;
+    reader->efficiency_nbUseful [reader->efficiency_index] ++;
+
+    // Make room for the worst case depacketized size of this payload
+    skipCurrentFrame = depacketizer->isDropped;
+    ARSTREAM_Reader_GrowFrameBuffer (reader, reader->currentFrameSize + ARSTREAM_Rtp_MaxDepacketizedSize (rtpHeader->payloadSize), &skipCurrentFrame);
+    depacketizer->isDropped = skipCurrentFrame;
+    ARSTREAM_Rtp_DepacketizerAddPayload (depacketizer, rtpHeader, &packet[rtpHeader->payloadOffset], reader->currentFrameBuffer, &(reader->currentFrameSize));
+
+    if (rtpHeader->marker == 1)
+    {
+        ARSTREAM_Reader_RtpFrameComplete (reader, depacketizer);
+    }
+}
+
+static void ARSTREAM_Reader_RtpFrameComplete (ARSTREAM_Reader_t *reader, ARSTREAM_Rtp_Depacketizer_t *depacketizer)
+{
+    ARSTREAM_Rtp_DepacketizerEndFrame (depacketizer, &(reader->currentFrameSize));
+    if ((depacketizer->isDropped == 0) &&
+        (reader->currentFrameSize > 0))
+    {
+        /* Frame numbers follow the missed frames, as on the ARStream protocol */
+        int nbMissedFrame = ARSTREAM_Rtp_DepacketizerCompleteFrame (depacketizer);
+        depacketizer->frameNumber += nbMissedFrame;
+        reader->reassembledFrameInfos.frameNumber = depacketizer->frameNumber++;
+        reader->reassembledFrameInfos.isFlushFrame = depacketizer->hasIdr;
+        if (depacketizer->hasIdr == 1)
+        {
+            reader->reassembledFrameInfos.priority = ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME;
+        }
+        else if ((depacketizer->hasReferenceSlice == 1) ||
+                 (depacketizer->hasSlice == 0))
+        {
+            reader->reassembledFrameInfos.priority = ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+        }
+        else
+        {
+            reader->reassembledFrameInfos.priority = ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE;
+        }
+        // RTP timestamps are not linked to the sender clock
+        reader->reassembledFrameInfos.hasTimestamp = 0;
+        reader->reassembledFrameInfos.timestampUs = 0;
+        ARSTREAM_Reader_FeedbackFrameComplete (reader, reader->reassembledFrameInfos.frameNumber, nbMissedFrame, depacketizer->hasIdr, depacketizer->hadLoss);
+        if (ARSTREAM_Reader_StartupFrameComplete (reader, depacketizer->hasIdr, depacketizer->hasSlice) == 1)
+        {
+            ARSTREAM_Reader_FrameComplete (reader, depacketizer->nbSkippedFrames + nbMissedFrame, depacketizer->hasIdr);
+            depacketizer->nbSkippedFrames = 0;
+        }
+        else
+        {
+            depacketizer->nbSkippedFrames += nbMissedFrame + 1;
+        }
+    }
+    else
+    {
+        ARSTREAM_Rtp_DepacketizerIncompleteFrame (depacketizer);
+    }
+    reader->currentFrameSize = 0;
 }
 
 /*
@@ -173,19 +899,47 @@ void ARSTREAM_Reader_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
 }
 
 ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, ARSTREAM_Reader_FrameCompleteCallback_t callback, uint8_t *frameBuffer, uint32_t frameBufferSize, uint32_t maxFragmentSize, int32_t maxAckInterval, void *custom, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Reader_t *retReader = NULL;
+    ARSTREAM_Transport_t transport;
+    eARSTREAM_ERROR internalError = ARSTREAM_Transport_InitARNetwork (&transport, manager, dataBufferID, ackBufferID);
+    if (internalError != ARSTREAM_OK)
+    {
+        SET_WITH_CHECK (error, internalError);
+        return retReader;
+    }
+
+    retReader = ARSTREAM_Reader_NewWithTransport (&transport, callback, frameBuffer, frameBufferSize, maxFragmentSize, maxAckInterval, custom, error);
+    if (retReader == NULL)
+    {
+        ARSTREAM_Transport_Destroy (&transport);
+    }
+    else
+    {
+        retReader->ownsTransport = 1;
+    }
+    return retReader;
+}
+
+ARSTREAM_Reader_t* ARSTREAM_Reader_NewWithTransport (const ARSTREAM_Transport_t *transport, ARSTREAM_Reader_FrameCompleteCallback_t callback, uint8_t *frameBuffer, uint32_t frameBufferSize, uint32_t maxFragmentSize, int32_t maxAckInterval, void *custom, eARSTREAM_ERROR *error)
 {
     ARSTREAM_Reader_t *retReader = NULL;
     int ackPacketMutexWasInit = 0;
     int ackSendMutexWasInit = 0;
     int ackSendCondWasInit = 0;
+    int feedbackMutexWasInit = 0;
+    int jitterBufferMutexWasInit = 0;
+    int jitterBufferCondWasInit = 0;
     eARSTREAM_ERROR internalError = ARSTREAM_OK;
     /* ARGS Check */
-    if ((manager == NULL) ||
+    if ((transport == NULL) ||
+        (transport->receiveFragment == NULL) ||
+        (transport->sendAck == NULL) ||
         (callback == NULL) ||
         (frameBuffer == NULL) ||
         (frameBufferSize == 0) ||
         (maxFragmentSize == 0) ||
-        (maxAckInterval < -1))
+        (maxAckInterval < ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK))
     {
         SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
         return retReader;
@@ -201,13 +955,14 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
     /* Copy parameters */
     if (internalError == ARSTREAM_OK)
     {
-        retReader->manager = manager;
-        retReader->dataBufferID = dataBufferID;
-        retReader->ackBufferID = ackBufferID;
+        retReader->transport = *transport;
+        retReader->ownsTransport = 0;
         retReader->maxFragmentSize = maxFragmentSize;
         retReader->maxAckInterval = maxAckInterval;
         retReader->callback = callback;
         retReader->custom = custom;
+        retReader->packetizationMode = ARSTREAM_READER_PACKETIZATION_NATIVE;
+        retReader->startupMode = ARSTREAM_READER_STARTUP_FIRST_FRAME;
         retReader->outputFrameBufferSize = frameBufferSize;
         retReader->outputFrameBuffer = frameBuffer;
     }
@@ -249,6 +1004,42 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
             ackSendCondWasInit = 1;
         }
     }
+    if (internalError == ARSTREAM_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init (&(retReader->feedbackMutex));
+        if (mutexInitRet != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            feedbackMutexWasInit = 1;
+        }
+    }
+    if (internalError == ARSTREAM_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init (&(retReader->jitterBufferMutex));
+        if (mutexInitRet != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            jitterBufferMutexWasInit = 1;
+        }
+    }
+    if (internalError == ARSTREAM_OK)
+    {
+        int condInitRet = ARSAL_Cond_Init (&(retReader->jitterBufferCond));
+        if (condInitRet != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            jitterBufferCondWasInit = 1;
+        }
+    }
 
     /* Setup internal variables */
     if (internalError == ARSTREAM_OK)
@@ -257,9 +1048,19 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
         retReader->currentFrameBufferSize = 0;
         retReader->currentFrameBuffer = NULL;
         retReader->currentFrameSize = 0;
+        // No frame in progress : the first fragment always starts a new frame
+        ARSTREAM_NetworkHeaders_AckPacketReset (&(retReader->ackPacket));
+        retReader->ackPacket.frameNumber = UINT16_MAX;
+        retReader->outputFrameInfos.frameNumber = 0;
+        retReader->outputFrameInfos.isFlushFrame = 0;
+        retReader->outputFrameInfos.priority = ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+        retReader->outputFrameInfos.hasTimestamp = 0;
+        retReader->outputFrameInfos.timestampUs = 0;
+        retReader->reassembledFrameInfos = retReader->outputFrameInfos;
         retReader->threadsShouldStop = 0;
         retReader->dataThreadStarted = 0;
         retReader->ackThreadStarted = 0;
+        retReader->playoutThreadStarted = 0;
         retReader->efficiency_index = 0;
         for (i = 0; i < ARSTREAM_READER_EFFICIENCY_AVERAGE_NB_FRAMES; i++)
         {
@@ -268,6 +1069,34 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
         }
         retReader->filters = NULL;
         retReader->nbFilters = 0;
+        retReader->autoKeyframeRequest = 0;
+        retReader->receiverReportIntervalMs = 0;
+        retReader->waitingKeyframe = 0;
+        memset (&(retReader->lastKeyframeRequestTime), 0, sizeof (struct timespec));
+        retReader->waitingDecodableFrame = 0;
+        memset (&(retReader->startupTime), 0, sizeof (struct timespec));
+        retReader->timeToFirstPacketMs = -1;
+        retReader->timeToFirstFrameMs = -1;
+        retReader->timeToFirstDecodableFrameMs = -1;
+        retReader->nbDiscardedFrames = 0;
+        ARSTREAM_Clock_GetTime (&(retReader->lastReportTime));
+        retReader->hasLastFrameCompleteTime = 0;
+        retReader->lastInterArrivalUs = 0;
+        retReader->jitterUs16 = 0;
+        retReader->lastCompleteFrameNumber = 0;
+        retReader->highestFrameNumber = 0;
+        retReader->reportExpectedFrames = 0;
+        retReader->reportLostFrames = 0;
+        retReader->cumulativeLost = 0;
+        retReader->maxFrameLatencyMs = 0;
+        ARSTREAM_ClockSync_Init (&(retReader->clockSync));
+        retReader->clockSyncIntervalMs = 0;
+        memset (&(retReader->lastClockSyncTime), 0, sizeof (struct timespec));
+        retReader->jitterBufferEnabled = 0;
+        ARSTREAM_JitterBuffer_Init (&(retReader->jitterBuffer), 0, 0);
+        retReader->jitterBufferNewBuffer = NULL;
+        retReader->playoutFrameBufferSize = 0;
+        retReader->playoutFrameBuffer = NULL;
     }
 
     if ((internalError != ARSTREAM_OK) &&
@@ -277,13 +1106,25 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
         {
             ARSAL_Mutex_Destroy (&(retReader->ackPacketMutex));
         }
-        if (ackSendMutexWasInit == 1)
+        if (ackSendMutexWasInit == 1)
+        {
+            ARSAL_Mutex_Destroy (&(retReader->ackSendMutex));
+        }
+        if (ackSendCondWasInit == 1)
+        {
+            ARSAL_Cond_Destroy (&(retReader->ackSendCond));
+        }
+        if (feedbackMutexWasInit == 1)
+        {
+            ARSAL_Mutex_Destroy (&(retReader->feedbackMutex));
+        }
+        if (jitterBufferMutexWasInit == 1)
         {
-            ARSAL_Mutex_Destroy (&(retReader->ackSendMutex));
+            ARSAL_Mutex_Destroy (&(retReader->jitterBufferMutex));
         }
-        if (ackSendCondWasInit == 1)
+        if (jitterBufferCondWasInit == 1)
         {
-            ARSAL_Cond_Destroy (&(retReader->ackSendCond));
+            ARSAL_Cond_Destroy (&(retReader->jitterBufferCond));
         }
         free (retReader);
         retReader = NULL;
@@ -304,9 +1145,16 @@ void ARSTREAM_Reader_StopReader (ARSTREAM_Reader_t *reader)
         if (reader->ackThreadStarted == 1)
         {
             ARSAL_Mutex_Lock (&(reader->ackSendMutex));
-            ARSAL_Cond_Signal (&(reader->ackSendCond));
+            ARSTREAM_Clock_CondSignal (&(reader->ackSendCond));
             ARSAL_Mutex_Unlock (&(reader->ackSendMutex));
         }
+        /* Same for the playout thread, which may wait for a late playout time */
+        if (reader->playoutThreadStarted == 1)
+        {
+            ARSAL_Mutex_Lock (&(reader->jitterBufferMutex));
+            ARSTREAM_Clock_CondSignal (&(reader->jitterBufferCond));
+            ARSAL_Mutex_Unlock (&(reader->jitterBufferMutex));
+        }
     }
 }
 
@@ -318,7 +1166,8 @@ eARSTREAM_ERROR ARSTREAM_Reader_Delete (ARSTREAM_Reader_t **reader)
     {
         int canDelete = 0;
         if (((*reader)->dataThreadStarted == 0) &&
-            ((*reader)->ackThreadStarted == 0))
+            ((*reader)->ackThreadStarted == 0) &&
+            ((*reader)->playoutThreadStarted == 0))
         {
             canDelete = 1;
         }
@@ -328,7 +1177,19 @@ eARSTREAM_ERROR ARSTREAM_Reader_Delete (ARSTREAM_Reader_t **reader)
             ARSAL_Mutex_Destroy (&((*reader)->ackPacketMutex));
             ARSAL_Mutex_Destroy (&((*reader)->ackSendMutex));
             ARSAL_Cond_Destroy (&((*reader)->ackSendCond));
+            ARSAL_Mutex_Destroy (&((*reader)->feedbackMutex));
+            if ((*reader)->jitterBufferEnabled == 1)
+            {
+                free ((*reader)->outputFrameBuffer);
+            }
+            ARSTREAM_JitterBuffer_Free (&((*reader)->jitterBuffer));
+            ARSAL_Mutex_Destroy (&((*reader)->jitterBufferMutex));
+            ARSAL_Cond_Destroy (&((*reader)->jitterBufferCond));
             free ((*reader)->filters);
+            if ((*reader)->ownsTransport == 1)
+            {
+                ARSTREAM_Transport_Destroy (&((*reader)->transport));
+            }
             free (*reader);
             *reader = NULL;
             retVal = ARSTREAM_OK;
@@ -348,7 +1209,16 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
     int recvSize;
     uint16_t previousFNum = UINT16_MAX;
     int skipCurrentFrame = 0;
+    int currentFrameInProgress = 0;
+    uint16_t currentFrameNumber = 0;
+    struct timespec currentFrameStartTime;
+    int readTimeoutMs = ARSTREAM_READER_DATAREAD_TIMEOUT_MS;
+    int hasFrameTimestamp = 0;
+    uint16_t frameTimestampNumber = 0;
+    uint64_t frameTimestampUs = 0;
     int packetWasAlreadyAck = 0;
+    ARSTREAM_Rtp_Depacketizer_t depacketizer;
+    ARSTREAM_Rtp_Header_t rtpHeader;
     ARSTREAM_Reader_t *reader = (ARSTREAM_Reader_t *)ARSTREAM_Reader_t_Param;
     ARSTREAM_NetworkHeaders_DataHeader_t *header = NULL;
     int recvDataLen = reader->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
@@ -368,6 +1238,8 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
         return (void *)0;
     }
     header = (ARSTREAM_NetworkHeaders_DataHeader_t *)recvData;
+    ARSTREAM_Rtp_DepacketizerInit (&depacketizer);
+    ARSTREAM_Reader_StartupBegin (reader);
 
     ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Stream reader thread running");
     reader->dataThreadStarted = 1;
@@ -381,17 +1253,57 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
 
     while (reader->threadsShouldStop == 0)
     {
-        eARNETWORK_ERROR err = ARNETWORK_Manager_ReadDataWithTimeout (reader->manager, reader->dataBufferID, recvData, recvDataLen, &recvSize, ARSTREAM_READER_DATAREAD_TIMEOUT_MS);
-        if (ARNETWORK_OK != err)
+        eARSTREAM_ERROR err = reader->transport.receiveFragment (reader->transport.context, recvData, recvDataLen, &recvSize, readTimeoutMs);
+        uint64_t recvTimeUs = ARSTREAM_ClockSync_GetTimeUs ();
+        ARSTREAM_Reader_FeedbackPeriodicReport (reader);
+        ARSTREAM_Reader_ClockSyncPeriodicRequest (reader);
+        if (ARSTREAM_OK == err)
+        {
+            ARSTREAM_Reader_StartupPacketReceived (reader);
+        }
+        if (ARSTREAM_OK != err)
+        {
+            if (ARSTREAM_ERROR_TIMEOUT != err)
+            {
+                ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while reading stream data: %s", ARSTREAM_Error_ToString (err));
+            }
+        }
+        else if ((reader->packetizationMode == ARSTREAM_READER_PACKETIZATION_RTP_H264) &&
+                 (ARSTREAM_Rtp_ReadHeader (recvData, recvSize, &rtpHeader) == 1))
         {
-            if (ARNETWORK_ERROR_BUFFER_EMPTY != err)
+            ARSTREAM_Reader_ProcessRtpPacket (reader, &depacketizer, &rtpHeader, recvData);
+        }
+        else if ((header->fragmentsPerFrame == 0) &&
+                 ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_CLOCK_FRAME) != 0))
+        {
+            if (((uint32_t)recvSize == sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_ClockFrame_t)) &&
+                (ARSTREAM_NetworkHeaders_ControlFrameType (&recvData[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], sizeof (ARSTREAM_NetworkHeaders_ClockFrame_t)) == ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK))
+            {
+                ARSTREAM_Reader_ClockSyncAnswer (reader, (ARSTREAM_NetworkHeaders_ClockFrame_t *)&recvData[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], recvTimeUs);
+            }
+        }
+        else if ((header->fragmentsPerFrame == 0) &&
+                 ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FRAME_TIMESTAMP) != 0))
+        {
+            if ((uint32_t)recvSize == sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_FrameTimestamp_t))
             {
-                ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while reading stream data: %s", ARNETWORK_Error_ToString (err));
+                ARSTREAM_NetworkHeaders_FrameTimestamp_t *timestamp = (ARSTREAM_NetworkHeaders_FrameTimestamp_t *)&recvData[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)];
+                hasFrameTimestamp = 1;
+                frameTimestampNumber = header->frameNumber;
+                frameTimestampUs = ARSTREAM_ClockSync_ReadTimestamp (dtohl (timestamp->timestampH), dtohl (timestamp->timestampL));
             }
         }
+        else if (((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FRAGMENT_OFFSET) != 0) &&
+                 (((uint32_t)recvSize < sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t)) ||
+                  (dtohl (((ARSTREAM_NetworkHeaders_FragmentOffset_t *)&recvData[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)])->offset) >= reader->maxFragmentSize * ARSTREAM_NETWORK_HEADERS_MAX_FRAGMENTS_PER_FRAME)))
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Dropping a fragment with an invalid offset");
+        }
         else
         {
-            int cpIndex, cpSize, endIndex, filterEndIndex;
+            int cpIndex, cpSize, endIndex;
+            int dataOffset = sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
+            int isDecodableStart = 0;
             ARSAL_Mutex_Lock (&(reader->ackPacketMutex));
             if (header->frameNumber != reader->ackPacket.frameNumber)
             {
@@ -402,12 +1314,28 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
                 skipCurrentFrame = 0;
                 reader->currentFrameSize = 0;
                 reader->ackPacket.frameNumber = header->frameNumber;
+                currentFrameInProgress = 1;
+                currentFrameNumber = header->frameNumber;
+                ARSTREAM_Clock_GetTime (&currentFrameStartTime);
+                ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+                if ((int16_t)(header->frameNumber - reader->highestFrameNumber) > 0)
+                {
+                    reader->highestFrameNumber = header->frameNumber;
+                }
+                ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
                 uint32_t nackPackets = ARSTREAM_NetworkHeaders_AckPacketCountNotSet (&(reader->ackPacket), header->fragmentsPerFrame);
                 if (nackPackets != 0)
                 {
                     ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Dropping a frame (missing %d fragments)", nackPackets);
                 }
                 ARSTREAM_NetworkHeaders_AckPacketResetUpTo (&(reader->ackPacket), header->fragmentsPerFrame);
+                if ((reader->waitingDecodableFrame == 1) &&
+                    (((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0) ||
+                     (((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_VALID) != 0) &&
+                      (((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK) >> ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT) == ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME))))
+                {
+                    isDecodableStart = 1;
+                }
             }
             packetWasAlreadyAck = ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(reader->ackPacket), header->fragmentNumber);
             ARSTREAM_NetworkHeaders_AckPacketSetFlag (&(reader->ackPacket), header->fragmentNumber);
@@ -420,103 +1348,39 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
 
             ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
 
-            ARSAL_Mutex_Lock (&(reader->ackSendMutex));
-            ARSAL_Cond_Signal (&(reader->ackSendCond));
-            ARSAL_Mutex_Unlock (&(reader->ackSendMutex));
+            if (reader->maxAckInterval != ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK)
+            {
+                ARSAL_Mutex_Lock (&(reader->ackSendMutex));
+                ARSTREAM_Clock_CondSignal (&(reader->ackSendCond));
+                ARSAL_Mutex_Unlock (&(reader->ackSendMutex));
+            }
 
 
             cpIndex = reader->maxFragmentSize * header->fragmentNumber;
-            cpSize = recvSize - sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
+            if ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FRAGMENT_OFFSET) != 0)
+            {
+                // Variable size fragment, placed at its byte offset
+                ARSTREAM_NetworkHeaders_FragmentOffset_t *fragmentOffset = (ARSTREAM_NetworkHeaders_FragmentOffset_t *)&recvData[dataOffset];
+                cpIndex = dtohl (fragmentOffset->offset);
+                dataOffset += sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t);
+            }
+            cpSize = recvSize - dataOffset;
             endIndex = cpIndex + cpSize;
-            filterEndIndex = endIndex;
-            if (reader->nbFilters > 0)
+            if (isDecodableStart == 1)
             {
-                int i;
-                for (i = 0; i < reader->nbFilters; i++)
-                {
-                    ARSTREAM_Filter_t *filter = reader->filters[i];
-                    filterEndIndex = filter->getOutputSize(filter->context,
-                                                           filterEndIndex);
-                }
+                // Grow the buffer once for the whole keyframe we are waiting for
+                ARSTREAM_Reader_GrowFrameBuffer (reader, header->fragmentsPerFrame * reader->maxFragmentSize, &skipCurrentFrame);
             }
-
-            while ((((uint32_t)endIndex > reader->currentFrameBufferSize) ||
-                    ((uint32_t)filterEndIndex > reader->outputFrameBufferSize)) &&
-                   (skipCurrentFrame == 0) &&
-                   (packetWasAlreadyAck == 0))
+            if (packetWasAlreadyAck == 0)
             {
-                uint32_t nextFrameBufferSize = endIndex;
-                uint32_t dummy;
-                uint8_t *nextFrameBuffer;
-                // If we have at least a filter, chain resize the buffers
-                if (reader->nbFilters > 0)
-                {
-                    ARSTREAM_Filter_t *firstFilter = reader->filters[0];
-                    nextFrameBuffer = firstFilter->getBuffer(firstFilter->context,
-                                                             nextFrameBufferSize);
-                    int i;
-                    int finalOutputSize = firstFilter->getOutputSize(firstFilter->context,
-                                                                     nextFrameBufferSize);
-                    // Update final output size by requesting it from each filter
-                    for (i = 1; i < reader->nbFilters; i++)
-                    {
-                        ARSTREAM_Filter_t *filter = reader->filters[i];
-                        finalOutputSize = filter->getOutputSize(filter->context,
-                                                                finalOutputSize);
-                    }
-
-                    // Resize actual output buffer if needed
-                    if ((uint32_t)finalOutputSize > reader->outputFrameBufferSize)
-                    {
-                        uint32_t newOutputSize = finalOutputSize;
-                        uint8_t *tmpFrame = reader->callback (ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL, reader->outputFrameBuffer, reader->currentFrameSize, 0, 0, &newOutputSize, reader->custom);
-                        if (newOutputSize < (uint32_t)finalOutputSize)
-                        {
-                            skipCurrentFrame = 1;
-                        }
-                        reader->callback (ARSTREAM_READER_CAUSE_COPY_COMPLETE, reader->outputFrameBuffer, reader->currentFrameSize, 0, skipCurrentFrame, &dummy, reader->custom);
-                        reader->outputFrameBuffer = tmpFrame;
-                        reader->outputFrameBufferSize = finalOutputSize;
-                    }
-
-                    // Copy into new buffer
-                    if (nextFrameBuffer != NULL)
-                    {
-                        memcpy(nextFrameBuffer, reader->currentFrameBuffer, reader->currentFrameSize);
-                    }
-                    else
-                    {
-                        skipCurrentFrame = 1;
-                    }
-                    firstFilter->releaseBuffer(firstFilter->context,
-                                               reader->currentFrameBuffer);
-                }
-                // Else, direclty resize the output buffer (and copy)
-                else
-                {
-                    nextFrameBuffer = reader->callback (ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL, reader->outputFrameBuffer, reader->currentFrameSize, 0, 0, &nextFrameBufferSize, reader->custom);
-                    if (nextFrameBufferSize >= reader->currentFrameSize && nextFrameBufferSize > 0)
-                    {
-                        memcpy (nextFrameBuffer, reader->currentFrameBuffer, reader->currentFrameSize);
-                    }
-                    else
-                    {
-                        skipCurrentFrame = 1;
-                    }
-                    //TODO: Add "SKIP_FRAME"
-                    reader->callback (ARSTREAM_READER_CAUSE_COPY_COMPLETE, reader->outputFrameBuffer, reader->currentFrameSize, 0, skipCurrentFrame, &dummy, reader->custom);
-                    reader->outputFrameBuffer = nextFrameBuffer;
-                    reader->outputFrameBufferSize = nextFrameBufferSize;
-                }
-                reader->currentFrameBuffer = nextFrameBuffer;
-                reader->currentFrameBufferSize = nextFrameBufferSize;
+                ARSTREAM_Reader_GrowFrameBuffer (reader, endIndex, &skipCurrentFrame);
             }
 
             if (skipCurrentFrame == 0)
             {
                 if (packetWasAlreadyAck == 0)
                 {
-                    memcpy (&(reader->currentFrameBuffer)[cpIndex], &recvData[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], recvSize - sizeof (ARSTREAM_NetworkHeaders_DataHeader_t));
+                    memcpy (&(reader->currentFrameBuffer)[cpIndex], &recvData[dataOffset], cpSize);
                 }
 
                 if ((uint32_t)endIndex > reader->currentFrameSize)
@@ -530,6 +1394,8 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
                     if (header->frameNumber != previousFNum)
                     {
                         int nbMissedFrame = 0;
+                        int isKeyFrame;
+                        int hasSlice = 1;
                         int isFlushFrame = ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0) ? 1 : 0;
                         ARSAL_PRINT (ARSAL_PRINT_VERBOSE, ARSTREAM_READER_TAG, "Ack all in frame %d (isFlush : %d)", header->frameNumber, isFlushFrame);
                         if (header->frameNumber != previousFNum + 1)
@@ -539,65 +1405,58 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
                         }
                         previousFNum = header->frameNumber;
                         skipCurrentFrame = 1;
-                        // If we have filters, apply them !
-                        if (reader->nbFilters > 0)
+                        currentFrameInProgress = 0;
+                        reader->reassembledFrameInfos.frameNumber = header->frameNumber;
+                        reader->reassembledFrameInfos.isFlushFrame = isFlushFrame;
+                        if ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_VALID) != 0)
                         {
-                            int i;
-                            ARSTREAM_Filter_t *filter;
-                            ARSTREAM_Filter_t *nextFilter;
-                            uint8_t *inBuffer = reader->currentFrameBuffer;
-                            int inSize = reader->currentFrameSize;
-                            uint8_t *outBuffer;
-                            int outSize;
-                            int maxOutSize;
-                            // Chain filters
-                            for (i = 0; i < (reader->nbFilters - 1); i++)
-                            {
-                                filter = reader->filters[i];
-                                nextFilter = reader->filters[i+1];
-                                maxOutSize = filter->getOutputSize(filter->context,
-                                                                   inSize);
-                                outBuffer = nextFilter->getBuffer(nextFilter->context,
-                                                                  maxOutSize);
-                                outSize = filter->filterBuffer(filter->context,
-                                                               inBuffer, inSize,
-                                                               outBuffer, maxOutSize);
-                                filter->releaseBuffer(filter->context,
-                                                      inBuffer);
-                                inBuffer = outBuffer;
-                                inSize = outSize;
-                            }
-                            // Apply last filter
-                            filter = reader->filters[reader->nbFilters-1];
-                            outSize = filter->filterBuffer(filter->context,
-                                                           inBuffer, inSize,
-                                                           reader->outputFrameBuffer,
-                                                           reader->outputFrameBufferSize);
-                            filter->releaseBuffer(filter->context,
-                                                  inBuffer);
-                            reader->outputFrameBuffer = reader->callback (ARSTREAM_READER_CAUSE_FRAME_COMPLETE, reader->outputFrameBuffer, outSize, nbMissedFrame, isFlushFrame, &(reader->outputFrameBufferSize), reader->custom);
-                            // Get a new buffer from first filter
-                            filter = reader->filters[0];
-                            reader->currentFrameBuffer = filter->getBuffer(filter->context,
-                                                                           reader->currentFrameBufferSize);
+                            reader->reassembledFrameInfos.priority = (header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK) >> ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT;
                         }
-                        // No filters, directly talk to the callback
                         else
                         {
-                            reader->outputFrameBuffer = reader->callback (ARSTREAM_READER_CAUSE_FRAME_COMPLETE, reader->currentFrameBuffer, reader->currentFrameSize, nbMissedFrame, isFlushFrame, &(reader->outputFrameBufferSize), reader->custom);
-                            reader->currentFrameBuffer = reader->outputFrameBuffer;
-                            reader->currentFrameBufferSize = reader->outputFrameBufferSize;
+                            // Old senders only tell us about flush frames
+                            reader->reassembledFrameInfos.priority = (isFlushFrame == 1) ? ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME : ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+                        }
+                        reader->reassembledFrameInfos.hasTimestamp = ((hasFrameTimestamp == 1) && (frameTimestampNumber == header->frameNumber)) ? 1 : 0;
+                        reader->reassembledFrameInfos.timestampUs = (reader->reassembledFrameInfos.hasTimestamp == 1) ? frameTimestampUs : 0;
+                        isKeyFrame = ((isFlushFrame == 1) || (reader->reassembledFrameInfos.priority == ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME)) ? 1 : 0;
+                        ARSTREAM_Reader_FeedbackFrameComplete (reader, header->frameNumber, nbMissedFrame, isKeyFrame, 0);
+                        if ((reader->waitingDecodableFrame == 1) &&
+                            (isKeyFrame == 0))
+                        {
+                            hasSlice = ARSTREAM_Reader_CurrentFrameHasSlice (reader);
+                        }
+                        if (ARSTREAM_Reader_StartupFrameComplete (reader, isKeyFrame, hasSlice) == 1)
+                        {
+                            ARSTREAM_Reader_FrameComplete (reader, nbMissedFrame, isFlushFrame);
                         }
                     }
                 }
                 ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
             }
         }
+
+        /* Give up on frames which did not complete in time */
+        readTimeoutMs = ARSTREAM_READER_DATAREAD_TIMEOUT_MS;
+        if (currentFrameInProgress == 1)
+        {
+            int timeLeftMs;
+            if (ARSTREAM_Reader_AbandonLateFrame (reader, currentFrameNumber, &currentFrameStartTime, &timeLeftMs) == 1)
+            {
+                currentFrameInProgress = 0;
+                skipCurrentFrame = 1;
+            }
+            else if ((timeLeftMs >= 0) &&
+                     (timeLeftMs < readTimeoutMs))
+            {
+                readTimeoutMs = timeLeftMs + 1;
+            }
+        }
     }
 
     free (recvData);
 
-    reader->callback (ARSTREAM_READER_CAUSE_CANCEL, reader->outputFrameBuffer, reader->currentFrameSize, 0, 0, &(reader->outputFrameBufferSize), reader->custom);
+    ARSTREAM_Reader_CallCallback (reader, ARSTREAM_READER_CAUSE_CANCEL, reader->outputFrameBuffer, reader->currentFrameSize, 0, 0, &(reader->outputFrameBufferSize));
     if (reader->nbFilters > 0)
     {
         ARSTREAM_Filter_t *filter = reader->filters[0];
@@ -620,6 +1479,12 @@ void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param)
     ARSTREAM_Reader_t *reader = (ARSTREAM_Reader_t *)ARSTREAM_Reader_t_Param;
     memset(&sendPacket, 0, sizeof(sendPacket));
 
+    if (reader->maxAckInterval == ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Ack sender thread not needed, ACKs are disabled");
+        return (void *)0;
+    }
+
     ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Ack sender thread running");
     reader->ackThreadStarted = 1;
 
@@ -629,12 +1494,12 @@ void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param)
         ARSAL_Mutex_Lock (&(reader->ackSendMutex));
         if (reader->maxAckInterval <= 0)
         {
-            ARSAL_Cond_Wait (&(reader->ackSendCond), &(reader->ackSendMutex));
+            ARSTREAM_Clock_CondWait (&(reader->ackSendCond), &(reader->ackSendMutex), -1);
         }
         else
         {
-            int retval = ARSAL_Cond_Timedwait (&(reader->ackSendCond), &(reader->ackSendMutex), reader->maxAckInterval);
-            if (retval == -1 && errno == ETIMEDOUT)
+            int retval = ARSTREAM_Clock_CondWait (&(reader->ackSendCond), &(reader->ackSendMutex), reader->maxAckInterval);
+            if (retval == ETIMEDOUT)
             {
                 isPeriodicAck = 1;
             }
@@ -650,7 +1515,7 @@ void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param)
             sendPacket.highPacketsAck = htodll (reader->ackPacket.highPacketsAck);
             sendPacket.lowPacketsAck  = htodll (reader->ackPacket.lowPacketsAck);
             ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
-            ARNETWORK_Manager_SendData (reader->manager, reader->ackBufferID, (uint8_t *)&sendPacket, sizeof (sendPacket), NULL, ARSTREAM_Reader_NetworkCallback, 1);
+            reader->transport.sendAck (reader->transport.context, (uint8_t *)&sendPacket, sizeof (sendPacket));
         }
     }
 
@@ -659,6 +1524,65 @@ void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param)
     return (void *)0;
 }
 
+void* ARSTREAM_Reader_RunPlayoutThread (void *ARSTREAM_Reader_t_Param)
+{
+    ARSTREAM_Reader_t *reader = (ARSTREAM_Reader_t *)ARSTREAM_Reader_t_Param;
+    int numberOfSkippedFrames = 0;
+
+    /* Parameters check */
+    if (reader == NULL)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while starting %s, bad parameters", __FUNCTION__);
+        return (void *)0;
+    }
+
+    if (reader->jitterBufferEnabled == 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Jitter buffer is disabled, playout thread not needed");
+        return (void *)0;
+    }
+
+    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Playout thread running");
+    reader->playoutThreadStarted = 1;
+
+    ARSAL_Mutex_Lock (&(reader->jitterBufferMutex));
+    while (reader->threadsShouldStop == 0)
+    {
+        ARSTREAM_JitterBuffer_Frame_t frame;
+        uint64_t nowUs = ARSTREAM_ClockSync_GetTimeUs ();
+        uint64_t playoutTimeUs;
+        if (ARSTREAM_JitterBuffer_Pop (&(reader->jitterBuffer), nowUs, &frame) == 1)
+        {
+            ARSAL_Mutex_Unlock (&(reader->jitterBufferMutex));
+            if (ARSTREAM_Reader_PlayoutFrame (reader, &frame, numberOfSkippedFrames) == 1)
+            {
+                numberOfSkippedFrames = 0;
+            }
+            else
+            {
+                numberOfSkippedFrames += 1 + frame.numberOfSkippedFrames;
+            }
+            ARSAL_Mutex_Lock (&(reader->jitterBufferMutex));
+            ARSTREAM_JitterBuffer_ReleaseBuffer (&(reader->jitterBuffer), frame.buffer, frame.capacity);
+        }
+        else if (ARSTREAM_JitterBuffer_NextPlayoutTime (&(reader->jitterBuffer), &playoutTimeUs) == 1)
+        {
+            ARSTREAM_Clock_CondWait (&(reader->jitterBufferCond), &(reader->jitterBufferMutex), (int)((playoutTimeUs - nowUs + 999) / 1000));
+        }
+        else
+        {
+            ARSTREAM_Clock_CondWait (&(reader->jitterBufferCond), &(reader->jitterBufferMutex), ARSTREAM_READER_DATAREAD_TIMEOUT_MS);
+        }
+    }
+    ARSAL_Mutex_Unlock (&(reader->jitterBufferMutex));
+
+    reader->callback (ARSTREAM_READER_CAUSE_CANCEL, reader->playoutFrameBuffer, 0, 0, 0, &(reader->playoutFrameBufferSize), reader->custom);
+
+    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Playout thread ended");
+    reader->playoutThreadStarted = 0;
+    return (void *)0;
+}
+
 float ARSTREAM_Reader_GetEstimatedEfficiency (ARSTREAM_Reader_t *reader)
 {
     if (reader == NULL)
@@ -692,6 +1616,311 @@ float ARSTREAM_Reader_GetEstimatedEfficiency (ARSTREAM_Reader_t *reader)
     return retVal;
 }
 
+eARSTREAM_ERROR ARSTREAM_Reader_GetFrameInfos (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_FrameInfos_t *infos)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (infos == NULL))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        *infos = reader->outputFrameInfos;
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SetFeedback (ARSTREAM_Reader_t *reader, int autoKeyframeRequest, int receiverReportIntervalMs)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (receiverReportIntervalMs < 0))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        reader->autoKeyframeRequest = (autoKeyframeRequest != 0) ? 1 : 0;
+        reader->receiverReportIntervalMs = receiverReportIntervalMs;
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_RequestKeyframe (ARSTREAM_Reader_t *reader)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (reader == NULL)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        ARSTREAM_Reader_SendFeedback (reader, ARSTREAM_NETWORK_HEADERS_FEEDBACK_KEYFRAME_REQUEST, reader->lastCompleteFrameNumber, 0);
+        ARSTREAM_Clock_GetTime (&(reader->lastKeyframeRequestTime));
+        reader->waitingKeyframe = 1;
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SetMaximumFrameLatency (ARSTREAM_Reader_t *reader, int maxFrameLatencyMs)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (maxFrameLatencyMs < 0))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        reader->maxFrameLatencyMs = maxFrameLatencyMs;
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SetClockSyncInterval (ARSTREAM_Reader_t *reader, int intervalMs)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (intervalMs < 0))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        reader->clockSyncIntervalMs = intervalMs;
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_GetClockInfos (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_ClockInfos_t *infos)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (infos == NULL))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        infos->isSynchronized = reader->clockSync.isSynchronized;
+        infos->offsetUs = ARSTREAM_ClockSync_GetOffsetUs (&(reader->clockSync), ARSTREAM_ClockSync_GetTimeUs ());
+        infos->driftPpm = reader->clockSync.drift * 1000000.;
+        infos->rttUs = reader->clockSync.rttUs;
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SenderTimeToReaderTime (ARSTREAM_Reader_t *reader, uint64_t senderTimeUs, uint64_t *readerTimeUs)
+{
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (readerTimeUs == NULL))
+    {
+        retVal = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (retVal == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        if (reader->clockSync.isSynchronized == 1)
+        {
+            *readerTimeUs = ARSTREAM_ClockSync_SenderToReaderTime (&(reader->clockSync), senderTimeUs);
+        }
+        else
+        {
+            retVal = ARSTREAM_ERROR_NOT_SYNCHRONIZED;
+        }
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+    return retVal;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SetJitterBuffer (ARSTREAM_Reader_t *reader, int minDelayMs, int maxDelayMs)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    int enable = (maxDelayMs != 0) ? 1 : 0;
+    if ((reader == NULL) ||
+        (minDelayMs < 0) ||
+        (maxDelayMs < 0) ||
+        ((enable == 1) && (maxDelayMs < minDelayMs)))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        (enable == reader->jitterBufferEnabled))
+    {
+        // Only the limits change, which is allowed while running
+        if (enable == 1)
+        {
+            ARSAL_Mutex_Lock (&(reader->jitterBufferMutex));
+            ARSTREAM_JitterBuffer_SetLimits (&(reader->jitterBuffer), minDelayMs, maxDelayMs);
+            ARSAL_Mutex_Unlock (&(reader->jitterBufferMutex));
+        }
+    }
+    else if ((err == ARSTREAM_OK) &&
+             ((reader->dataThreadStarted != 0) ||
+              (reader->ackThreadStarted != 0) ||
+              (reader->playoutThreadStarted != 0)))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+    else if ((err == ARSTREAM_OK) &&
+             (enable == 1))
+    {
+        /* The application buffer moves to the playout thread, and the data
+         * thread reassembles frames in the jitter buffer own buffers */
+        uint32_t capacity = reader->outputFrameBufferSize;
+        uint8_t *buffer;
+        ARSTREAM_JitterBuffer_Init (&(reader->jitterBuffer), minDelayMs, maxDelayMs);
+        buffer = ARSTREAM_JitterBuffer_GetBuffer (&(reader->jitterBuffer), &capacity);
+        if (buffer == NULL)
+        {
+            err = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            reader->playoutFrameBuffer = reader->outputFrameBuffer;
+            reader->playoutFrameBufferSize = reader->outputFrameBufferSize;
+            reader->outputFrameBuffer = buffer;
+            reader->outputFrameBufferSize = capacity;
+            reader->jitterBufferEnabled = 1;
+
+            /* Clock exchanges make the sender send frame timestamps */
+            ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+            if (reader->clockSyncIntervalMs == 0)
+            {
+                reader->clockSyncIntervalMs = ARSTREAM_READER_JITTER_BUFFER_CLOCK_SYNC_INTERVAL_MS;
+            }
+            ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+        }
+    }
+    else if (err == ARSTREAM_OK)
+    {
+        free (reader->outputFrameBuffer);
+        ARSTREAM_JitterBuffer_Free (&(reader->jitterBuffer));
+        reader->outputFrameBuffer = reader->playoutFrameBuffer;
+        reader->outputFrameBufferSize = reader->playoutFrameBufferSize;
+        reader->playoutFrameBuffer = NULL;
+        reader->playoutFrameBufferSize = 0;
+        reader->jitterBufferEnabled = 0;
+    }
+    // No else : invalid parameters
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SetPacketizationMode (ARSTREAM_Reader_t *reader, eARSTREAM_READER_PACKETIZATION mode)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (mode < 0) ||
+        (mode >= ARSTREAM_READER_PACKETIZATION_MAX))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        ((reader->dataThreadStarted != 0) ||
+         (reader->ackThreadStarted != 0) ||
+         (reader->playoutThreadStarted != 0)))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        reader->packetizationMode = mode;
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SetStartupMode (ARSTREAM_Reader_t *reader, eARSTREAM_READER_STARTUP mode)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (mode < 0) ||
+        (mode >= ARSTREAM_READER_STARTUP_MAX))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        ((reader->dataThreadStarted != 0) ||
+         (reader->ackThreadStarted != 0) ||
+         (reader->playoutThreadStarted != 0)))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        reader->startupMode = mode;
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_GetJitterBufferInfos (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_JitterBufferInfos_t *infos)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (infos == NULL))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->jitterBufferMutex));
+        infos->isEnabled = reader->jitterBufferEnabled;
+        infos->targetDelayMs = (int)(ARSTREAM_JitterBuffer_GetTargetDelayUs (&(reader->jitterBuffer)) / 1000);
+        infos->nbWaitingFrames = reader->jitterBuffer.nbFrames;
+        infos->nbLateFrames = reader->jitterBuffer.nbLateFrames;
+        infos->nbSkippedFrames = reader->jitterBuffer.nbSkippedFrames;
+        ARSAL_Mutex_Unlock (&(reader->jitterBufferMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_GetStartupInfos (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_StartupInfos_t *infos)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((reader == NULL) ||
+        (infos == NULL))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(reader->feedbackMutex));
+        infos->timeToFirstPacketMs = reader->timeToFirstPacketMs;
+        infos->timeToFirstFrameMs = reader->timeToFirstFrameMs;
+        infos->timeToFirstDecodableFrameMs = reader->timeToFirstDecodableFrameMs;
+        infos->nbDiscardedFrames = reader->nbDiscardedFrames;
+        ARSAL_Mutex_Unlock (&(reader->feedbackMutex));
+    }
+    return err;
+}
+
 void* ARSTREAM_Reader_GetCustom (ARSTREAM_Reader_t *reader)
 {
     void *ret = NULL;
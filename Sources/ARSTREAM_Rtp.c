@@ -0,0 +1,455 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Rtp.c
+ * @brief RTP packetization of H.264 frames (RFC 6184, non-interleaved mode)
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_Rtp.h"
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_RTP_VERSION_MASK (0xC000)
+#define ARSTREAM_RTP_VERSION_2 (0x8000)
+#define ARSTREAM_RTP_PADDING_FLAG (0x2000)
+#define ARSTREAM_RTP_EXTENSION_FLAG (0x1000)
+#define ARSTREAM_RTP_CSRC_COUNT_MASK (0x0F00)
+#define ARSTREAM_RTP_CSRC_COUNT_SHIFT (8)
+#define ARSTREAM_RTP_MARKER_FLAG (0x0080)
+#define ARSTREAM_RTP_PAYLOAD_TYPE_MASK (0x007F)
+
+#define ARSTREAM_RTP_FU_START (0x80)
+#define ARSTREAM_RTP_FU_END (0x40)
+
+/**
+ * @brief Sequence number jumps larger than this are reordered or duplicated packets
+ */
+#define ARSTREAM_RTP_MAX_SEQ_JUMP (0x8000)
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Appends a start code and a NAL unit header to the frame, and updates the frame type
+ * @param depacketizer The depacketizer
+ * @param nalHeader The NAL unit header byte
+ * @param frame The frame buffer
+ * @param frameSize Pointer to the frame size, updated
+ */
+static void ARSTREAM_Rtp_DepacketizerStartNalUnit (ARSTREAM_Rtp_Depacketizer_t *depacketizer, uint8_t nalHeader, uint8_t *frame, uint32_t *frameSize);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_Rtp_DepacketizerStartNalUnit (ARSTREAM_Rtp_Depacketizer_t *depacketizer, uint8_t nalHeader, uint8_t *frame, uint32_t *frameSize)
+{
+    uint8_t type = ARSTREAM_H264_NALU_TYPE (nalHeader);
+    if ((type >= ARSTREAM_H264_NALU_TYPE_SLICE) &&
+        (type <= ARSTREAM_H264_NALU_TYPE_IDR))
+    {
+        depacketizer->hasSlice = 1;
+        if (ARSTREAM_H264_NALU_REF_IDC (nalHeader) != 0)
+        {
+            depacketizer->hasReferenceSlice = 1;
+        }
+        if (type == ARSTREAM_H264_NALU_TYPE_IDR)
+        {
+            depacketizer->hasIdr = 1;
+        }
+    }
+    frame[(*frameSize)++] = 0;
+    frame[(*frameSize)++] = 0;
+    frame[(*frameSize)++] = 0;
+    frame[(*frameSize)++] = 1;
+    frame[(*frameSize)++] = nalHeader;
+}
+
+/*
+ * Implementation
+ */
+
+void ARSTREAM_Rtp_PacketizerInit (ARSTREAM_Rtp_Packetizer_t *packetizer)
+{
+    memset (packetizer, 0, sizeof (*packetizer));
+    packetizer->seqNum = (uint16_t)rand ();
+}
+
+void ARSTREAM_Rtp_PacketizerSetFrame (ARSTREAM_Rtp_Packetizer_t *packetizer, const uint8_t *frame, uint32_t size, uint64_t timeUs)
+{
+    packetizer->frame = frame;
+    packetizer->timestamp = (uint32_t)((timeUs * ARSTREAM_RTP_CLOCK_RATE) / 1000000);
+    packetizer->nbNalUnits = ARSTREAM_H264_FindNalUnits (frame, size, packetizer->nalUnits, ARSTREAM_H264_MAX_NAL_UNITS);
+    if ((packetizer->nbNalUnits == 0) &&
+        (size > 0))
+    {
+        packetizer->nalUnits[0].offset = 0;
+        packetizer->nalUnits[0].size = size;
+        packetizer->nbNalUnits = 1;
+    }
+    packetizer->nalIndex = 0;
+    packetizer->fuOffset = 0;
+}
+
+int ARSTREAM_Rtp_PacketizerNext (ARSTREAM_Rtp_Packetizer_t *packetizer, uint8_t *packet, uint32_t maxPacketSize, uint32_t *packetSize)
+{
+    ARSTREAM_NetworkHeaders_DataHeader2_t *header = (ARSTREAM_NetworkHeaders_DataHeader2_t *)packet;
+    uint8_t *payload = &packet[sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t)];
+    uint32_t maxPayloadSize = maxPacketSize - sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t);
+    uint32_t payloadSize = 0;
+    ARSTREAM_H264_NalUnit_t *nal;
+    const uint8_t *nalData;
+    uint16_t flags;
+
+    if (packetizer->nalIndex >= packetizer->nbNalUnits)
+    {
+        return 0;
+    }
+    nal = &(packetizer->nalUnits[packetizer->nalIndex]);
+    nalData = &(packetizer->frame[nal->offset]);
+
+    if ((packetizer->fuOffset == 0) &&
+        (nal->size <= maxPayloadSize))
+    {
+        /* Aggregate as many following NAL units as possible */
+        int last = packetizer->nalIndex;
+        uint32_t stapSize = 1;
+        while ((last < packetizer->nbNalUnits) &&
+               (stapSize + 2 + packetizer->nalUnits[last].size <= maxPayloadSize))
+        {
+            stapSize += 2 + packetizer->nalUnits[last].size;
+            last++;
+        }
+
+        if (last - packetizer->nalIndex >= 2)
+        {
+            /* STAP-A : F is the OR, and NRI the maximum, of the aggregated NAL units */
+            uint8_t stapHeader = ARSTREAM_NETWORK_HEADERS2_NALU_TYPE_STAPA;
+            payloadSize = 1;
+            for (; packetizer->nalIndex < last; packetizer->nalIndex++)
+            {
+                nal = &(packetizer->nalUnits[packetizer->nalIndex]);
+                nalData = &(packetizer->frame[nal->offset]);
+                stapHeader |= nalData[0] & 0x80;
+                if ((nalData[0] & 0x60) > (stapHeader & 0x60))
+                {
+                    stapHeader = (stapHeader & ~0x60) | (nalData[0] & 0x60);
+                }
+                payload[payloadSize++] = (uint8_t)(nal->size >> 8);
+                payload[payloadSize++] = (uint8_t)(nal->size & 0xFF);
+                memcpy (&payload[payloadSize], nalData, nal->size);
+                payloadSize += nal->size;
+            }
+            payload[0] = stapHeader;
+        }
+        else
+        {
+            /* Single NAL unit packet */
+            memcpy (payload, nalData, nal->size);
+            payloadSize = nal->size;
+            packetizer->nalIndex++;
+        }
+    }
+    else
+    {
+        /* FU-A : the NAL unit header is rebuilt from the FU indicator and header */
+        uint32_t chunkSize;
+        uint8_t fuHeader = ARSTREAM_H264_NALU_TYPE (nalData[0]);
+        if (packetizer->fuOffset == 0)
+        {
+            packetizer->fuOffset = 1;
+            fuHeader |= ARSTREAM_RTP_FU_START;
+        }
+        chunkSize = nal->size - packetizer->fuOffset;
+        if (chunkSize > maxPayloadSize - 2)
+        {
+            chunkSize = maxPayloadSize - 2;
+        }
+        else
+        {
+            fuHeader |= ARSTREAM_RTP_FU_END;
+        }
+        payload[0] = (nalData[0] & 0xE0) | ARSTREAM_NETWORK_HEADERS2_NALU_TYPE_FUA;
+        payload[1] = fuHeader;
+        memcpy (&payload[2], &nalData[packetizer->fuOffset], chunkSize);
+        payloadSize = 2 + chunkSize;
+        packetizer->fuOffset += chunkSize;
+        if (packetizer->fuOffset >= nal->size)
+        {
+            packetizer->fuOffset = 0;
+            packetizer->nalIndex++;
+        }
+    }
+
+    flags = ARSTREAM_RTP_VERSION_2 | ARSTREAM_RTP_PAYLOAD_TYPE;
+    if (packetizer->nalIndex >= packetizer->nbNalUnits)
+    {
+        flags |= ARSTREAM_RTP_MARKER_FLAG;
+    }
+    header->flags = htons (flags);
+    header->seqNum = htons (packetizer->seqNum);
+    header->timestamp = htonl (packetizer->timestamp);
+    header->ssrc = htonl (ARSTREAM_NETWORK_HEADERS2_RTP_SSRC);
+    packetizer->seqNum++;
+
+    *packetSize = sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t) + payloadSize;
+    return 1;
+}
+
+int ARSTREAM_Rtp_ReadHeader (const uint8_t *packet, uint32_t size, ARSTREAM_Rtp_Header_t *header)
+{
+    const ARSTREAM_NetworkHeaders_DataHeader2_t *rtpHeader = (const ARSTREAM_NetworkHeaders_DataHeader2_t *)packet;
+    uint16_t flags;
+    uint32_t offset = sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t);
+
+    if (size < sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t))
+    {
+        return 0;
+    }
+    flags = ntohs (rtpHeader->flags);
+    if ((flags & ARSTREAM_RTP_VERSION_MASK) != ARSTREAM_RTP_VERSION_2)
+    {
+        return 0;
+    }
+
+    offset += 4 * ((flags & ARSTREAM_RTP_CSRC_COUNT_MASK) >> ARSTREAM_RTP_CSRC_COUNT_SHIFT);
+    if ((flags & ARSTREAM_RTP_EXTENSION_FLAG) != 0)
+    {
+        uint16_t extensionLength;
+        if (offset + 4 > size)
+        {
+            return 0;
+        }
+        extensionLength = ((uint16_t)packet[offset + 2] << 8) | packet[offset + 3];
+        offset += 4 + 4 * extensionLength;
+    }
+    if (offset >= size)
+    {
+        return 0;
+    }
+    header->payloadSize = size - offset;
+    if ((flags & ARSTREAM_RTP_PADDING_FLAG) != 0)
+    {
+        uint8_t padding = packet[size - 1];
+        if (padding >= header->payloadSize)
+        {
+            return 0;
+        }
+        header->payloadSize -= padding;
+    }
+
+    header->marker = ((flags & ARSTREAM_RTP_MARKER_FLAG) != 0) ? 1 : 0;
+    header->seqNum = ntohs (rtpHeader->seqNum);
+    header->timestamp = ntohl (rtpHeader->timestamp);
+    header->payloadOffset = offset;
+    return 1;
+}
+
+uint32_t ARSTREAM_Rtp_MaxDepacketizedSize (uint32_t payloadSize)
+{
+    /* Worst case is a STAP-A of 1 byte NAL units : 3 payload bytes become 5 frame bytes */
+    return 2 * payloadSize + 4;
+}
+
+void ARSTREAM_Rtp_DepacketizerInit (ARSTREAM_Rtp_Depacketizer_t *depacketizer)
+{
+    memset (depacketizer, 0, sizeof (*depacketizer));
+}
+
+void ARSTREAM_Rtp_DepacketizerStartFrame (ARSTREAM_Rtp_Depacketizer_t *depacketizer, uint32_t timestamp)
+{
+    depacketizer->hasFrame = 1;
+    depacketizer->timestamp = timestamp;
+    depacketizer->fuStarted = 0;
+    depacketizer->isDropped = 0;
+    depacketizer->hadLoss = 0;
+    depacketizer->hasIdr = 0;
+    depacketizer->hasReferenceSlice = 0;
+    depacketizer->hasSlice = 0;
+}
+
+int ARSTREAM_Rtp_DepacketizerIsLatePacket (const ARSTREAM_Rtp_Depacketizer_t *depacketizer, const ARSTREAM_Rtp_Header_t *header)
+{
+    int retVal = 0;
+    if ((depacketizer->hasSeqNum == 1) &&
+        ((uint16_t)(header->seqNum - depacketizer->expectedSeqNum) >= ARSTREAM_RTP_MAX_SEQ_JUMP))
+    {
+        retVal = 1;
+    }
+    return retVal;
+}
+
+void ARSTREAM_Rtp_DepacketizerAddPayload (ARSTREAM_Rtp_Depacketizer_t *depacketizer, ARSTREAM_Rtp_Header_t *header, const uint8_t *payload, uint8_t *frame, uint32_t *frameSize)
+{
+    uint8_t type;
+
+    if (depacketizer->hasSeqNum == 1)
+    {
+        uint16_t jump = header->seqNum - depacketizer->expectedSeqNum;
+        if (jump != 0)
+        {
+            depacketizer->nbLostPackets += jump;
+            depacketizer->hadLoss = 1;
+            if (depacketizer->fuStarted == 1)
+            {
+                *frameSize = depacketizer->fuStartOffset;
+                depacketizer->fuStarted = 0;
+            }
+        }
+    }
+    depacketizer->hasSeqNum = 1;
+    depacketizer->expectedSeqNum = header->seqNum + 1;
+    if (depacketizer->isDropped == 1)
+    {
+        /* The frame buffer could not grow, only follow the sequence numbers */
+        return;
+    }
+
+    type = ARSTREAM_H264_NALU_TYPE (payload[0]);
+    if (type == ARSTREAM_NETWORK_HEADERS2_NALU_TYPE_STAPA)
+    {
+        uint32_t offset = 1;
+        while (offset + 2 < header->payloadSize)
+        {
+            uint32_t nalSize = ((uint32_t)payload[offset] << 8) | payload[offset + 1];
+            offset += 2;
+            if ((nalSize == 0) ||
+                (offset + nalSize > header->payloadSize))
+            {
+                break;
+            }
+            ARSTREAM_Rtp_DepacketizerStartNalUnit (depacketizer, payload[offset], frame, frameSize);
+            memcpy (&frame[*frameSize], &payload[offset + 1], nalSize - 1);
+            *frameSize += nalSize - 1;
+            offset += nalSize;
+        }
+    }
+    else if (type == ARSTREAM_NETWORK_HEADERS2_NALU_TYPE_FUA)
+    {
+        uint8_t fuHeader;
+        if (header->payloadSize < 2)
+        {
+            return;
+        }
+        fuHeader = payload[1];
+        if ((fuHeader & ARSTREAM_RTP_FU_START) != 0)
+        {
+            if (depacketizer->fuStarted == 1)
+            {
+                /* The end of the previous NAL unit is missing */
+                *frameSize = depacketizer->fuStartOffset;
+            }
+            depacketizer->fuStarted = 1;
+            depacketizer->fuStartOffset = *frameSize;
+            ARSTREAM_Rtp_DepacketizerStartNalUnit (depacketizer, (payload[0] & 0xE0) | ARSTREAM_H264_NALU_TYPE (fuHeader), frame, frameSize);
+        }
+        if (depacketizer->fuStarted == 1)
+        {
+            memcpy (&frame[*frameSize], &payload[2], header->payloadSize - 2);
+            *frameSize += header->payloadSize - 2;
+            if ((fuHeader & ARSTREAM_RTP_FU_END) != 0)
+            {
+                depacketizer->fuStarted = 0;
+            }
+        }
+    }
+    else if ((type >= 1) &&
+             (type <= 23))
+    {
+        ARSTREAM_Rtp_DepacketizerStartNalUnit (depacketizer, payload[0], frame, frameSize);
+        memcpy (&frame[*frameSize], &payload[1], header->payloadSize - 1);
+        *frameSize += header->payloadSize - 1;
+    }
+}
+
+void ARSTREAM_Rtp_DepacketizerEndFrame (ARSTREAM_Rtp_Depacketizer_t *depacketizer, uint32_t *frameSize)
+{
+    if (depacketizer->fuStarted == 1)
+    {
+        *frameSize = depacketizer->fuStartOffset;
+        depacketizer->fuStarted = 0;
+    }
+    depacketizer->hasFrame = 0;
+}
+
+int ARSTREAM_Rtp_DepacketizerCompleteFrame (ARSTREAM_Rtp_Depacketizer_t *depacketizer)
+{
+    int retVal = depacketizer->nbIncompleteFrames;
+    if (depacketizer->hasCompleteFrame == 1)
+    {
+        uint32_t delta = depacketizer->timestamp - depacketizer->lastCompleteTimestamp;
+        if ((depacketizer->nbIncompleteFrames == 0) &&
+            (depacketizer->hadLoss == 0))
+        {
+            /* Nothing lost since the previous frame : measure the frame duration */
+            depacketizer->frameDuration = delta;
+        }
+        else if (depacketizer->frameDuration > 0)
+        {
+            uint32_t nbFrames = (delta + depacketizer->frameDuration / 2) / depacketizer->frameDuration;
+            /* Larger gaps are timestamp discontinuities, not losses */
+            if ((nbFrames > (uint32_t)retVal + 1) &&
+                (nbFrames <= ARSTREAM_RTP_MAX_SEQ_JUMP))
+            {
+                retVal = nbFrames - 1;
+            }
+        }
+    }
+    depacketizer->hasCompleteFrame = 1;
+    depacketizer->lastCompleteTimestamp = depacketizer->timestamp;
+    depacketizer->nbIncompleteFrames = 0;
+    return retVal;
+}
+
+void ARSTREAM_Rtp_DepacketizerIncompleteFrame (ARSTREAM_Rtp_Depacketizer_t *depacketizer)
+{
+    depacketizer->nbIncompleteFrames++;
+}
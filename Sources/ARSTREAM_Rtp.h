@@ -0,0 +1,233 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Rtp.h
+ * @brief RTP packetization of H.264 frames (RFC 6184, non-interleaved mode)
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_RTP_PRIVATE_H_
+#define _ARSTREAM_RTP_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_H264.h"
+#include "ARSTREAM_NetworkHeaders.h"
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief RTP payload type used for H.264 (dynamic range)
+ */
+#define ARSTREAM_RTP_PAYLOAD_TYPE (96)
+
+/**
+ * @brief RTP clock rate for video
+ */
+#define ARSTREAM_RTP_CLOCK_RATE (90000)
+
+/**
+ * @brief Smallest usable RTP payload size
+ */
+#define ARSTREAM_RTP_MIN_PAYLOAD_SIZE (64)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Decoded RTP header
+ */
+typedef struct {
+    int marker; /**< Marker bit (last packet of a frame) */
+    uint16_t seqNum; /**< Sequence number */
+    uint32_t timestamp; /**< Timestamp, in ARSTREAM_RTP_CLOCK_RATE units */
+    uint32_t payloadOffset; /**< Offset of the payload in the packet */
+    uint32_t payloadSize; /**< Size of the payload */
+} ARSTREAM_Rtp_Header_t;
+
+/**
+ * @brief Packetizer state (sender side)
+ */
+typedef struct {
+    uint16_t seqNum; /**< Sequence number of the next packet */
+    uint32_t timestamp; /**< Timestamp of the current frame */
+    const uint8_t *frame; /**< Current frame */
+    ARSTREAM_H264_NalUnit_t nalUnits [ARSTREAM_H264_MAX_NAL_UNITS]; /**< NAL units of the current frame */
+    int nbNalUnits; /**< Number of NAL units in the current frame */
+    int nalIndex; /**< Next NAL unit to send */
+    uint32_t fuOffset; /**< Offset of the next FU-A fragment in the current NAL unit (0 if not fragmenting) */
+} ARSTREAM_Rtp_Packetizer_t;
+
+/**
+ * @brief Depacketizer state (reader side)
+ * Frames are rebuilt in Annex-B format, with 4 bytes start codes. NAL units
+ * which lost a fragment are removed, so that the other slices of the frame
+ * can still be decoded.
+ */
+typedef struct {
+    int hasFrame; /**< Boolean-like flag telling if a frame is being rebuilt */
+    uint32_t timestamp; /**< Timestamp of the current frame */
+    int hasSeqNum; /**< Boolean-like flag telling if expectedSeqNum is valid */
+    uint16_t expectedSeqNum; /**< Sequence number of the next packet */
+    int fuStarted; /**< Boolean-like flag telling if a FU-A NAL unit is being rebuilt */
+    uint32_t fuStartOffset; /**< Offset of the FU-A NAL unit start code in the frame */
+    int isDropped; /**< Boolean-like flag telling if the current frame could not be stored */
+    int hadLoss; /**< Boolean-like flag telling if packets of the current frame were lost */
+    int hasIdr; /**< Boolean-like flag telling if the current frame holds an IDR slice */
+    int hasReferenceSlice; /**< Boolean-like flag telling if the current frame holds a reference slice */
+    int hasSlice; /**< Boolean-like flag telling if the current frame holds any slice */
+    uint32_t nbLostPackets; /**< Total number of lost packets */
+    uint16_t frameNumber; /**< Number of the next frame given to the application */
+    int nbSkippedFrames; /**< Complete frames skipped (reader startup) since the last frame given to the application */
+    int nbIncompleteFrames; /**< Frames which could not be rebuilt since the last complete frame */
+    int hasCompleteFrame; /**< Boolean-like flag telling if lastCompleteTimestamp is valid */
+    uint32_t lastCompleteTimestamp; /**< Timestamp of the last complete frame */
+    uint32_t frameDuration; /**< Timestamp increment between two consecutive frames, 0 until measured */
+} ARSTREAM_Rtp_Depacketizer_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Initializes a packetizer
+ * @param packetizer The packetizer
+ */
+void ARSTREAM_Rtp_PacketizerInit (ARSTREAM_Rtp_Packetizer_t *packetizer);
+
+/**
+ * @brief Sets the frame to packetize
+ * @param packetizer The packetizer
+ * @param frame The Annex-B frame (must stay valid until the last packet is built)
+ * @param size The frame size
+ * @param timeUs The frame time, in microseconds
+ * @note A frame without start code is sent as a single NAL unit
+ */
+void ARSTREAM_Rtp_PacketizerSetFrame (ARSTREAM_Rtp_Packetizer_t *packetizer, const uint8_t *frame, uint32_t size, uint64_t timeUs);
+
+/**
+ * @brief Builds the next packet of the current frame
+ * Small NAL units are aggregated in STAP-A packets, large ones are split
+ * in FU-A packets, and the last packet of the frame has the marker bit.
+ * @param packetizer The packetizer
+ * @param packet Buffer which will hold the packet
+ * @param maxPacketSize Size of the packet buffer (at least sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t) + ARSTREAM_RTP_MIN_PAYLOAD_SIZE)
+ * @param packetSize Pointer which will hold the packet size
+ * @return 1 if a packet was built, 0 if the frame was completely sent
+ */
+int ARSTREAM_Rtp_PacketizerNext (ARSTREAM_Rtp_Packetizer_t *packetizer, uint8_t *packet, uint32_t maxPacketSize, uint32_t *packetSize);
+
+/**
+ * @brief Decodes an RTP header
+ * @param packet The packet
+ * @param size The packet size
+ * @param header Pointer which will hold the decoded header
+ * @return 1 if the packet is a valid RTP packet, 0 otherwise
+ */
+int ARSTREAM_Rtp_ReadHeader (const uint8_t *packet, uint32_t size, ARSTREAM_Rtp_Header_t *header);
+
+/**
+ * @brief Gets the maximum size added to a frame by one packet payload
+ * @param payloadSize The payload size
+ * @return The maximum number of bytes added to the frame
+ */
+uint32_t ARSTREAM_Rtp_MaxDepacketizedSize (uint32_t payloadSize);
+
+/**
+ * @brief Initializes a depacketizer
+ * @param depacketizer The depacketizer
+ */
+void ARSTREAM_Rtp_DepacketizerInit (ARSTREAM_Rtp_Depacketizer_t *depacketizer);
+
+/**
+ * @brief Starts rebuilding a new frame
+ * @param depacketizer The depacketizer
+ * @param timestamp The timestamp of the new frame
+ */
+void ARSTREAM_Rtp_DepacketizerStartFrame (ARSTREAM_Rtp_Depacketizer_t *depacketizer, uint32_t timestamp);
+
+/**
+ * @brief Tells if a packet is late or duplicated, from its sequence number
+ * Such packets must be dropped before their timestamp is compared with the current frame one.
+ * @param depacketizer The depacketizer
+ * @param header The packet header
+ * @return 1 if the packet must be dropped, 0 otherwise
+ */
+int ARSTREAM_Rtp_DepacketizerIsLatePacket (const ARSTREAM_Rtp_Depacketizer_t *depacketizer, const ARSTREAM_Rtp_Header_t *header);
+
+/**
+ * @brief Adds a packet payload to the current frame
+ * @param depacketizer The depacketizer
+ * @warning Late packets must be dropped with ARSTREAM_Rtp_DepacketizerIsLatePacket before calling this function
+ * @param header The packet header
+ * @param payload The packet payload
+ * @param frame The frame buffer (must have ARSTREAM_Rtp_MaxDepacketizedSize (header->payloadSize) bytes available after *frameSize)
+ * @param frameSize Pointer to the frame size, updated
+ */
+void ARSTREAM_Rtp_DepacketizerAddPayload (ARSTREAM_Rtp_Depacketizer_t *depacketizer, ARSTREAM_Rtp_Header_t *header, const uint8_t *payload, uint8_t *frame, uint32_t *frameSize);
+
+/**
+ * @brief Ends the current frame, removing any incomplete NAL unit
+ * @param depacketizer The depacketizer
+ * @param frameSize Pointer to the frame size, updated
+ */
+void ARSTREAM_Rtp_DepacketizerEndFrame (ARSTREAM_Rtp_Depacketizer_t *depacketizer, uint32_t *frameSize);
+
+/**
+ * @brief Counts the frames missed before the current frame, which was successfully rebuilt
+ * The frames which could not be rebuilt are counted, and whole frames lost within a
+ * sequence number gap are estimated from the timestamps, with the frame duration
+ * measured between consecutive frames received without loss.
+ * @param depacketizer The depacketizer
+ * @return The number of frames missed since the previous complete frame
+ */
+int ARSTREAM_Rtp_DepacketizerCompleteFrame (ARSTREAM_Rtp_Depacketizer_t *depacketizer);
+
+/**
+ * @brief Records that the current frame could not be rebuilt
+ * @param depacketizer The depacketizer
+ */
+void ARSTREAM_Rtp_DepacketizerIncompleteFrame (ARSTREAM_Rtp_Depacketizer_t *depacketizer);
+
+#endif /* _ARSTREAM_RTP_PRIVATE_H_ */
@@ -43,6 +43,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #include <errno.h>
 
@@ -52,14 +53,20 @@
 
 #include "ARSTREAM_Buffers.h"
 #include "ARSTREAM_NetworkHeaders.h"
+#include "ARSTREAM_RateControl.h"
+#include "ARSTREAM_ClockSync.h"
+#include "ARSTREAM_Rtp.h"
+#include "ARSTREAM_H264.h"
 
 /*
  * ARSDK Headers
  */
 
 #include <libARStream/ARSTREAM_Sender.h>
+#include <libARStream/ARSTREAM_Clock.h>
 #include <libARSAL/ARSAL_Mutex.h>
 #include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Time.h>
 #include <libARSAL/ARSAL_Endianness.h>
 
 /*
@@ -72,43 +79,44 @@
 #define ARSTREAM_SENDER_TAG "ARSTREAM_Sender"
 
 /**
- * Configuration : Enable retries (0,1)
- * 0 -> Don't retry sending a frame (count on wifi retries)
- * 1 -> Retry frame sends after some times if the acknowledge didn't come
+ * Latency used when the network can't give us a valid value
  */
-#define ENABLE_RETRIES (1)
-
-/* Warning */
-#if ENABLE_RETRIES == 0
-#warning Retry is disabled in this build
-#endif
+#define ARSTREAM_SENDER_DEFAULT_ESTIMATED_LATENCY_MS (100)
 
 /**
- * Configuration : Enable acknowledge wait
- * 0 -> Consider all frames given to network as "sent"
- * 1 -> Wait for an ARSTREAM_Reader full acknowledge of a frame before trying the next frame
+ * Number of frames for the moving average of efficiency
  */
-#define ENABLE_ACK_WAIT (0)
+#define ARSTREAM_SENDER_EFFICIENCY_AVERAGE_NB_FRAMES (15)
 
-/* Warning */
-//#if ENABLE_ACK_WAIT == 0
-//#warning Ack wait is disabled in this build
-//#endif
+/**
+ * Number of previous frames to memorize
+ */
+#define ARSTREAM_SENDER_PREVIOUS_FRAME_NB_SAVE (10)
 
 /**
- * Latency used when the network can't give us a valid value
+ * Retransmission effort for each frame priority class, indexed by eARSTREAM_SENDER_FRAME_PRIORITY
+ * Only used for frames with a priority given by the application (or the frame classification)
+ * - MAX_RETRIES : Maximum number of retry rounds for a frame (-1 means "until replaced")
+ * - PROTECTED_RETRIES : Number of retry rounds during which a frame can not be
+ *   replaced by a frame of lower priority
  */
-#define ARSTREAM_SENDER_DEFAULT_ESTIMATED_LATENCY_MS (100)
+static const int ARSTREAM_SENDER_MAX_RETRIES [ARSTREAM_SENDER_FRAME_PRIORITY_MAX] = { 0, 1, -1, -1 };
+static const int ARSTREAM_SENDER_PROTECTED_RETRIES [ARSTREAM_SENDER_FRAME_PRIORITY_MAX] = { 0, 0, 1, 3 };
 
 /**
- * Number of frames for the moving average of efficiency
+ * Maximum number of NAL units kept with a queued frame
+ * Frames with this many NAL units or more are scanned again for the NAL aligned fragmentation
  */
-#define ARSTREAM_SENDER_EFFICIENCY_AVERAGE_NB_FRAMES (15)
+#define ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS (32)
 
 /**
- * Number of previous frames to memorize
+ * Content flags of a frame, set by ARSTREAM_Sender_InspectFrame
  */
-#define ARSTREAM_SENDER_PREVIOUS_FRAME_NB_SAVE (10)
+#define ARSTREAM_SENDER_FRAME_CONTENT_ANNEXB (0x01) // Frame starts with a start code (other flags are never set without this one)
+#define ARSTREAM_SENDER_FRAME_CONTENT_SLICE (0x02)
+#define ARSTREAM_SENDER_FRAME_CONTENT_REFERENCE_SLICE (0x04)
+#define ARSTREAM_SENDER_FRAME_CONTENT_IDR (0x08)
+#define ARSTREAM_SENDER_FRAME_CONTENT_PARAMETER_SETS (0x10)
 
 /**
  * Sets *PTR to VAL if PTR is not null
@@ -132,13 +140,35 @@ typedef struct {
     uint32_t frameSize;
     uint8_t *frameBuffer;
     int isHighPriority;
+    eARSTREAM_SENDER_FRAME_PRIORITY priority;
+    int hasPriority; // Priority was given by the application, or by the frame classification
+    struct timespec timestamp; // Time of the SendNewFrame call
+    int maxAgeMs; // ARSTREAM_SENDER_INFINITE_FRAME_AGE if the frame never expires
+    int nbNalUnits; // -1 if the NAL units of the frame are not known
+    const ARSTREAM_H264_NalUnit_t *nalUnits; // Stored out of line : in the queue slot of the frame, then in sender->nalUnits once popped
+    int contents; // ARSTREAM_SENDER_FRAME_CONTENT_xxx flags (0 if the frame was not inspected)
+    int isFromCache; // Frame is resent from the keyframe cache, which owns its buffer
 } ARSTREAM_Sender_Frame_t;
 
+/**
+ * Slots of the keyframe cache
+ */
+typedef enum {
+    ARSTREAM_SENDER_KEYFRAME_CACHE_PARAMETER_SETS = 0, // Latest frame with SPS/PPS but without IDR slice
+    ARSTREAM_SENDER_KEYFRAME_CACHE_KEYFRAME, // Latest IDR frame (or flush frame if the frames are not inspected)
+    ARSTREAM_SENDER_KEYFRAME_CACHE_MAX,
+} eARSTREAM_SENDER_KEYFRAME_CACHE;
+
+typedef struct {
+    ARSTREAM_Sender_Frame_t frame; // frame.frameBuffer is NULL if the slot is empty
+    int callbackPending; // The frame callback was delayed until the frame leaves the cache
+    eARSTREAM_SENDER_STATUS callbackStatus;
+} ARSTREAM_Sender_CachedFrame_t;
+
 struct ARSTREAM_Sender_t {
     /* Configuration on New */
-    ARNETWORK_Manager_t *manager;
-    int dataBufferID;
-    int ackBufferID;
+    ARSTREAM_Transport_t transport;
+    int ownsTransport; // The transport was created by ARSTREAM_Sender_New()
     ARSTREAM_Sender_FrameUpdateCallback_t callback;
     uint32_t maxNumberOfNextFrames;
     uint32_t maxFragmentSize;
@@ -148,17 +178,30 @@ struct ARSTREAM_Sender_t {
     /* Other configuration */
     int minRetryTimeMs;
     int maxRetryTimeMs;
+    int maxFrameAgeMs;
+    eARSTREAM_SENDER_RELIABILITY reliabilityMode;
+    int maxRetries;
+    eARSTREAM_SENDER_QUEUE_POLICY queuePolicy;
+    uint32_t decimationWatermark;
+    eARSTREAM_SENDER_PACKETIZATION packetizationMode;
+    eARSTREAM_SENDER_FRAGMENTATION fragmentationMode;
+    int autoClassification;
 
     /* Current frame storage */
     ARSTREAM_Sender_Frame_t currentFrame;
     int currentFrameNbFragments;
+    uint32_t currentFrameFragmentOffsets [ARSTREAM_NETWORK_HEADERS_MAX_FRAGMENTS_PER_FRAME + 1]; // Fragment i holds the bytes [offsets[i]; offsets[i+1][ of the frame
+    int currentFrameHasFragmentOffsets; // Fragments are sent with their byte offset
     int currentFrameCbWasCalled;
+    int currentFrameDropped; // Frame was cancelled before being acknowledged (expired, or abandoned by the reader)
+    int currentFrameNbRetries;
     ARSAL_Mutex_t packetsToSendMutex;
     ARSTREAM_NetworkHeaders_AckPacket_t packetsToSend;
 
     /* Acknowledge storage */
     ARSAL_Mutex_t ackMutex;
     ARSTREAM_NetworkHeaders_AckPacket_t ackPacket;
+    ARSTREAM_NetworkHeaders_AckPacket_t lostPackets; // Fragments of the current frame declared missing by the acknowledges
 
     /* Next frame storage */
     ARSAL_Mutex_t nextFrameMutex;
@@ -168,6 +211,7 @@ struct ARSTREAM_Sender_t {
     uint32_t indexGetNextFrame;
     uint32_t numberOfWaitingFrames;
     ARSTREAM_Sender_Frame_t *nextFrames;
+    ARSTREAM_H264_NalUnit_t *nextFramesNalUnits; // ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS entries per slot of nextFrames
 
     /* Previous frame storage (for LATE_ACKs) */
     int *previousFramesStatus;
@@ -186,6 +230,28 @@ struct ARSTREAM_Sender_t {
     /* Filters */
     ARSTREAM_Filter_t **filters;
     int nbFilters;
+
+    /* Congestion control (protected by ackMutex) */
+    ARSTREAM_RateControl_t rateControl;
+    ARSTREAM_Sender_TargetBitrateCallback_t targetBitrateCallback;
+
+    /* Reader feedback (protected by ackMutex) */
+    ARSTREAM_Sender_FeedbackCallback_t feedbackCallback;
+
+    /* Set by the ack thread, read by the data thread with or without ackMutex : only accessed atomically */
+    int readerHandlesControlFrames; // Reader sent clock or feedback frames, so it can receive frame timestamps
+
+    /* RTP packetization (data thread only) */
+    ARSTREAM_Rtp_Packetizer_t rtpPacketizer;
+
+    /* NAL aligned fragmentation (data thread only, holds the NAL units of the last popped frame) */
+    ARSTREAM_H264_NalUnit_t nalUnits [ARSTREAM_H264_MAX_NAL_UNITS];
+
+    /* Keyframe cache (slots are only changed by the data thread, callback fields are protected by keyframeCacheMutex) */
+    int keyframeCacheEnabled;
+    ARSAL_Mutex_t keyframeCacheMutex;
+    ARSTREAM_Sender_CachedFrame_t keyframeCache [ARSTREAM_SENDER_KEYFRAME_CACHE_MAX];
+    int keyframeCacheResendIndex; // Next slot to resend, ARSTREAM_SENDER_KEYFRAME_CACHE_MAX if no resend is pending (protected by nextFrameMutex)
 };
 
 typedef struct {
@@ -211,9 +277,198 @@ static void ARSTREAM_Sender_FlushQueue (ARSTREAM_Sender_t *sender);
  * @param size The frame size, in bytes
  * @param buffer Pointer to the buffer which contains the frame
  * @param wasFlushFrame Boolean-like (0/1) flag, active if the frame is added after a flush (high priority frame)
+ * @param priority Priority class of the frame
+ * @param hasPriority Boolean-like (0/1) flag, active if the priority was given by the application or by the frame classification
+ * @param maxAgeMs Maximum age of the frame (ARSTREAM_SENDER_INFINITE_FRAME_AGE if the frame never expires)
+ * @param contents ARSTREAM_SENDER_FRAME_CONTENT_xxx flags of the frame (0 if unknown)
+ * @param nalUnits NAL units of the frame (can be NULL if nbNalUnits is -1)
+ * @param nbNalUnits Number of NAL units in nalUnits (-1 if unknown)
  * @return the number of frames previously in queue (-1 if queue is full)
  */
-static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size, uint8_t *buffer, int wasFlushFrame);
+static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size, uint8_t *buffer, int wasFlushFrame, eARSTREAM_SENDER_FRAME_PRIORITY priority, int hasPriority, int maxAgeMs, int contents, const ARSTREAM_H264_NalUnit_t *nalUnits, int nbNalUnits);
+
+/**
+ * @brief Finds the NAL units of a frame and the types of its content
+ * @param buffer The frame
+ * @param size The frame size, in bytes
+ * @param contents Pointer which will hold the ARSTREAM_SENDER_FRAME_CONTENT_xxx flags of the frame
+ * @param nalUnits Array which will hold the NAL units of the frame (ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS entries)
+ * @return The number of NAL units saved in nalUnits (-1 if the frame is not in Annex-B format, or if they do not fit in the array)
+ * @note The array is also used as scratch space to scan frames with more NAL units, by chunks
+ */
+static int ARSTREAM_Sender_InspectFrame (uint8_t *buffer, uint32_t size, int *contents, ARSTREAM_H264_NalUnit_t *nalUnits);
+
+/**
+ * @brief Gets the ARSTREAM_SENDER_FRAME_CONTENT_xxx flags of a NAL unit
+ * @param nalHeader The header byte of the NAL unit
+ * @return The content flags of the NAL unit (without ARSTREAM_SENDER_FRAME_CONTENT_ANNEXB)
+ */
+static int ARSTREAM_Sender_NalUnitContents (uint8_t nalHeader);
+
+/**
+ * @brief Sets the flush flag and the priority class of a frame from its content
+ * @param contents ARSTREAM_SENDER_FRAME_CONTENT_xxx flags of the frame
+ * @param isFlushFrame Pointer to the flush flag, which is set for IDR frames (never cleared)
+ * @param priority Pointer to the priority class, which is left untouched if the frame is not in Annex-B format
+ */
+static void ARSTREAM_Sender_ClassifyFrame (int contents, int *isFlushFrame, eARSTREAM_SENDER_FRAME_PRIORITY *priority);
+
+/**
+ * @brief Saves a frame which is about to be sent in the keyframe cache, if it holds an IDR slice or parameter sets
+ * Frames replaced in the cache are given back to the application if their callback was already delayed
+ * @param sender The sender
+ * @param frame The new current frame
+ * @warning Must be called by the data thread
+ */
+static void ARSTREAM_Sender_UpdateKeyframeCache (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame);
+
+/**
+ * @brief Empties the keyframe cache, and gives the frames back to the application
+ * @param sender The sender
+ * @warning Must be called when the data thread is not running
+ */
+static void ARSTREAM_Sender_ClearKeyframeCache (ARSTREAM_Sender_t *sender);
+
+/**
+ * @brief Delays the callback of a frame which is held by the keyframe cache
+ * @param sender The sender
+ * @param status Status of the callback
+ * @param framePointer Pointer to the frame
+ * @return 1 if the callback must not be called now
+ * @return 0 if the frame is not in the keyframe cache
+ */
+static int ARSTREAM_Sender_HoldInKeyframeCache (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_STATUS status, uint8_t *framePointer);
+
+/**
+ * @brief Asks the data thread to resend the keyframe cache as soon as possible
+ * @param sender The sender
+ * @note Does nothing if the keyframe cache is disabled
+ */
+static void ARSTREAM_Sender_RequestKeyframeCacheResend (ARSTREAM_Sender_t *sender);
+
+/**
+ * @brief Pops the next frame to resend from the keyframe cache
+ * The first resent frame flushes the queue, unless the queue already holds a key frame (the resend is then cancelled)
+ * @param sender The sender
+ * @param newFrame Pointer in which the function will save the new frame infos
+ * @return 1 if a cached frame should be sent
+ * @return 0 if no resend is pending
+ * @warning Must be called within a sender->nextFrameMutex lock
+ */
+static int ARSTREAM_Sender_PopFromKeyframeCache (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *newFrame);
+
+/**
+ * @brief Moves a frame of the new frame queue to another slot, with its NAL units
+ * @param sender The sender
+ * @param dstIndex Index of the destination slot in nextFrames
+ * @param srcIndex Index of the frame to move in nextFrames
+ */
+static void ARSTREAM_Sender_MoveQueuedFrame (ARSTREAM_Sender_t *sender, uint32_t dstIndex, uint32_t srcIndex);
+
+/**
+ * @brief Cancel a frame in the new frame queue
+ * @param sender The sender
+ * @param position Position of the frame in the queue (0 is the next frame to send)
+ * @param status Status given to the callback for this frame
+ * @warning Must be called within a sender->nextFrameMutex lock
+ */
+static void ARSTREAM_Sender_RemoveFromQueue (ARSTREAM_Sender_t *sender, uint32_t position, eARSTREAM_SENDER_STATUS status);
+
+/**
+ * @brief Cancel the least valuable frame of the new frame queue
+ * The least valuable frame is the oldest frame of lowest priority. Flush frames are never cancelled.
+ * @param sender The sender
+ * @param maxPriority Only frames with a priority lower or equal to this value can be cancelled
+ * @return 1 if a frame was cancelled, 0 otherwise
+ * @warning Must be called within a sender->nextFrameMutex lock
+ */
+static int ARSTREAM_Sender_DropLeastValuableFrame (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_FRAME_PRIORITY maxPriority);
+
+/**
+ * @brief Apply the queue overflow policy to make room for a new frame
+ * @param sender The sender
+ * @param priority Priority class of the new frame
+ * @warning Must be called within a sender->nextFrameMutex lock
+ */
+static void ARSTREAM_Sender_ApplyQueuePolicy (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_FRAME_PRIORITY priority);
+
+/**
+ * @brief Gets the time left before a frame expires
+ * @param frame The frame to test
+ * @param now The current time
+ * @return The time left in ms (zero or negative if the frame is expired), or INT_MAX if the frame never expires
+ */
+static int ARSTREAM_Sender_FrameTimeLeftMs (ARSTREAM_Sender_Frame_t *frame, struct timespec *now);
+
+/**
+ * @brief Remove all expired frames from the new frame queue
+ * @param sender The sender
+ * @warning Must be called within a sender->nextFrameMutex lock
+ */
+static void ARSTREAM_Sender_RemoveExpiredFrames (ARSTREAM_Sender_t *sender);
+
+/**
+ * @brief Checks if a queued frame can replace the current frame
+ * @param sender The sender
+ * @param frame The next frame of the queue
+ * @return 1 if the frame can be sent now, 0 if the current frame should be kept
+ * @warning Must be called within a sender->nextFrameMutex lock
+ */
+static int ARSTREAM_Sender_CanReplaceCurrentFrame (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame);
+
+/**
+ * @brief Gets the maximum number of retry rounds for a frame
+ * @param sender The sender
+ * @param frame The frame
+ * @return The maximum number of retry rounds, or -1 if the frame should be retried until replaced
+ */
+static int ARSTREAM_Sender_GetMaxRetries (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame);
+
+/**
+ * @brief Sends all the fragments of a frame once, without any acknowledge bookkeeping
+ * This is the data path of the ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT mode
+ * @param sender The sender
+ * @param sendFragment Fragment buffer (must be at least maxFragmentSize + header size)
+ * @param frame The frame to send
+ */
+static void ARSTREAM_Sender_SendFrameOnce (ARSTREAM_Sender_t *sender, uint8_t *sendFragment, ARSTREAM_Sender_Frame_t *frame);
+
+/**
+ * @brief Sends a frame once as RTP packets aligned on its NAL units
+ * This is the data path of the ARSTREAM_SENDER_PACKETIZATION_RTP_H264 mode
+ * @param sender The sender
+ * @param sendFragment Packet buffer (must be at least maxFragmentSize + header size)
+ * @param frame The frame to send
+ */
+static void ARSTREAM_Sender_SendFrameRtp (ARSTREAM_Sender_t *sender, uint8_t *sendFragment, ARSTREAM_Sender_Frame_t *frame);
+
+/**
+ * @brief Cuts a frame in fragments, according to the fragmentation mode
+ * Fills currentFrameFragmentOffsets and currentFrameHasFragmentOffsets
+ * @param sender The sender
+ * @param frame The frame to cut
+ * @return The number of fragments of the frame
+ */
+static int ARSTREAM_Sender_ComputeFragments (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame);
+
+/**
+ * @brief Copies a fragment of the current frame (and its offset if needed) after the data header
+ * @param sender The sender
+ * @param sendFragment Fragment buffer, which starts with the data header
+ * @param frameBuffer The current frame data
+ * @param fragmentIndex Index of the fragment to copy
+ * @param fragmentSize Pointer which will hold the size of the fragment data
+ * @return The size of the packet to send
+ */
+static uint32_t ARSTREAM_Sender_FillFragment (ARSTREAM_Sender_t *sender, uint8_t *sendFragment, uint8_t *frameBuffer, int fragmentIndex, uint32_t *fragmentSize);
+
+/**
+ * @brief Ends the sending of a frame which is never retried
+ * @param sender The sender
+ * @param frame The frame which was sent
+ * @param nbPackets Number of packets used to send the frame
+ */
+static void ARSTREAM_Sender_FrameSentOnce (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame, int nbPackets);
 
 /**
  * @brief Pop a frame from the new frame queue
@@ -225,16 +480,25 @@ static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size,
 static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *newFrame);
 
 /**
- * @brief ARNETWORK_Manager_Callback_t for ARNETWORK_... calls
- * @param IoBufferId Unused as we always send on one unique buffer
- * @param dataPtr Unused as we don't need to free the memory
+ * @brief ARSTREAM_Transport_SendCallback_t for the fragments of the reliable mode
  * @param customData (ARSTREAM_Sender_NetworkCallbackParam_t *) Sender + fragment index
- * @param status Network information
- * @return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT
+ * @param status Fragment status
  *
- * @warning customData is a malloc'd pointer, and must be freed within this callback, during last call
+ * @warning customData is a malloc'd pointer, and is freed within this callback
  */
-eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Sender_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status);
+static void ARSTREAM_Sender_NetworkCallback (void *customData, eARSTREAM_TRANSPORT_SEND_STATUS status);
+
+/**
+ * @brief Drops the fragments which were not sent yet by the transport
+ * @param sender The sender
+ */
+static void ARSTREAM_Sender_FlushTransport (ARSTREAM_Sender_t *sender);
+
+/**
+ * @brief Sends the fragments buffered by the transport
+ * @param sender The sender
+ */
+static void ARSTREAM_Sender_SubmitTransport (ARSTREAM_Sender_t *sender);
 
 /**
  * @brief Signals that the current frame of the sender was acknowledged
@@ -262,56 +526,598 @@ static int ARSTREAM_Sender_SendLateAck (ARSTREAM_Sender_t *sender, uint16_t fram
  */
 static void ARSTREAM_Sender_CallCallback (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, int isCurrent);
 
+/**
+ * @brief Gives a frame back to the last filter, or to the application
+ * @param sender The sender
+ * @param status Why the call was made
+ * @param framePointer Pointer to the frame which was sent/cancelled
+ * @param frameSize Size, in bytes, of the frame
+ * @param isCurrent Boolean-like (0/1) flag, active if the frame was already filtered
+ */
+static void ARSTREAM_Sender_ReleaseFrame (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, int isCurrent);
+
+/**
+ * @brief Runs the congestion controller and notifies the application of significant target changes
+ * @param sender The sender
+ * @warning Must be called without ackMutex held
+ */
+static void ARSTREAM_Sender_UpdateRateControl (ARSTREAM_Sender_t *sender);
+
+/**
+ * @brief Decodes a feedback packet and gives it to the application
+ * @param sender The sender
+ * @param packet The feedback packet, in network endianness
+ * @warning Must be called without ackMutex held
+ */
+static void ARSTREAM_Sender_HandleFeedback (ARSTREAM_Sender_t *sender, ARSTREAM_NetworkHeaders_FeedbackPacket_t *packet);
+
+/**
+ * @brief Cancels the current frame after the reader abandoned it
+ * @param sender The sender
+ * @param frameNumber The number of the frame abandoned by the reader
+ * @warning Must be called without ackMutex held
+ */
+static void ARSTREAM_Sender_AbandonFrame (ARSTREAM_Sender_t *sender, uint16_t frameNumber);
+
+/**
+ * @brief Answers a clock frame sent by the reader
+ * @param sender The sender
+ * @param request The clock frame received, in network endianness
+ * @param receiveTimeUs The time when the clock frame was received
+ */
+static void ARSTREAM_Sender_AnswerClockFrame (ARSTREAM_Sender_t *sender, ARSTREAM_NetworkHeaders_ClockFrame_t *request, uint64_t receiveTimeUs);
+
+/**
+ * @brief Sends the timestamp of a frame to the reader
+ * @param sender The sender
+ * @param frame The frame whose timestamp should be sent
+ * @note Does nothing if the reader never sent any clock or feedback frame
+ */
+static void ARSTREAM_Sender_SendFrameTimestamp (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame);
+
 /*
  * Internal functions implementation
  */
 
-static void ARSTREAM_Sender_FlushQueue (ARSTREAM_Sender_t *sender)
+static void ARSTREAM_Sender_FlushQueue (ARSTREAM_Sender_t *sender)
+{
+    while (sender->numberOfWaitingFrames > 0)
+    {
+        ARSTREAM_Sender_Frame_t *nextFrame = &(sender->nextFrames [sender->indexGetNextFrame]);
+        ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_CANCEL, nextFrame->frameBuffer, nextFrame->frameSize, 0);
+        sender->indexGetNextFrame++;
+        sender->indexGetNextFrame %= sender->maxNumberOfNextFrames;
+        sender->numberOfWaitingFrames--;
+    }
+}
+
+static void ARSTREAM_Sender_MoveQueuedFrame (ARSTREAM_Sender_t *sender, uint32_t dstIndex, uint32_t srcIndex)
+{
+    ARSTREAM_Sender_Frame_t *dst = &(sender->nextFrames [dstIndex]);
+    ARSTREAM_H264_NalUnit_t *dstNalUnits = &(sender->nextFramesNalUnits [dstIndex * ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS]);
+    *dst = sender->nextFrames [srcIndex];
+    if (dst->nbNalUnits > 0)
+    {
+        memcpy (dstNalUnits, dst->nalUnits, dst->nbNalUnits * sizeof (ARSTREAM_H264_NalUnit_t));
+        dst->nalUnits = dstNalUnits;
+    }
+}
+
+static void ARSTREAM_Sender_RemoveFromQueue (ARSTREAM_Sender_t *sender, uint32_t position, eARSTREAM_SENDER_STATUS status)
+{
+    uint32_t i;
+    uint32_t index = (sender->indexGetNextFrame + position) % sender->maxNumberOfNextFrames;
+    ARSTREAM_Sender_Frame_t *frame = &(sender->nextFrames [index]);
+    ARSTREAM_Sender_CallCallback (sender, status, frame->frameBuffer, frame->frameSize, 0);
+    // Move all following frames one step towards the head of the queue
+    for (i = position; i + 1 < sender->numberOfWaitingFrames; i++)
+    {
+        uint32_t curr = (sender->indexGetNextFrame + i) % sender->maxNumberOfNextFrames;
+        uint32_t next = (curr + 1) % sender->maxNumberOfNextFrames;
+        ARSTREAM_Sender_MoveQueuedFrame (sender, curr, next);
+    }
+    sender->numberOfWaitingFrames--;
+    sender->indexAddNextFrame += sender->maxNumberOfNextFrames - 1;
+    sender->indexAddNextFrame %= sender->maxNumberOfNextFrames;
+}
+
+static int ARSTREAM_Sender_DropLeastValuableFrame (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_FRAME_PRIORITY maxPriority)
+{
+    int retVal = 0;
+    int found = 0;
+    uint32_t foundPosition = 0;
+    eARSTREAM_SENDER_FRAME_PRIORITY foundPriority = maxPriority;
+    uint32_t i;
+    for (i = 0; i < sender->numberOfWaitingFrames; i++)
+    {
+        ARSTREAM_Sender_Frame_t *frame = &(sender->nextFrames [(sender->indexGetNextFrame + i) % sender->maxNumberOfNextFrames]);
+        // Strictly lower priority only, so we keep the oldest frame on ties
+        if ((frame->isHighPriority == 0) &&
+            ((frame->priority < foundPriority) ||
+             ((found == 0) && (frame->priority == foundPriority))))
+        {
+            found = 1;
+            foundPosition = i;
+            foundPriority = frame->priority;
+        }
+    }
+    if (found == 1)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Dropping queued frame (priority %d)", foundPriority);
+        ARSTREAM_Sender_RemoveFromQueue (sender, foundPosition, ARSTREAM_SENDER_STATUS_FRAME_CANCEL);
+        retVal = 1;
+    }
+    return retVal;
+}
+
+static void ARSTREAM_Sender_ApplyQueuePolicy (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_FRAME_PRIORITY priority)
+{
+    uint32_t i;
+    switch (sender->queuePolicy)
+    {
+    case ARSTREAM_SENDER_QUEUE_POLICY_DROP_OLDEST:
+        for (i = 0; i < sender->numberOfWaitingFrames; i++)
+        {
+            ARSTREAM_Sender_Frame_t *frame = &(sender->nextFrames [(sender->indexGetNextFrame + i) % sender->maxNumberOfNextFrames]);
+            if (frame->isHighPriority == 0)
+            {
+                ARSTREAM_Sender_RemoveFromQueue (sender, i, ARSTREAM_SENDER_STATUS_FRAME_CANCEL);
+                break;
+            }
+        }
+        break;
+    case ARSTREAM_SENDER_QUEUE_POLICY_REPLACE_WITH_KEYFRAME:
+        if (priority == ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME)
+        {
+            i = 0;
+            while (i < sender->numberOfWaitingFrames)
+            {
+                ARSTREAM_Sender_Frame_t *frame = &(sender->nextFrames [(sender->indexGetNextFrame + i) % sender->maxNumberOfNextFrames]);
+                if (frame->priority < ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME)
+                {
+                    ARSTREAM_Sender_RemoveFromQueue (sender, i, ARSTREAM_SENDER_STATUS_FRAME_CANCEL);
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+        break;
+    case ARSTREAM_SENDER_QUEUE_POLICY_DROP_NEWEST:
+    default:
+        // Nothing to do, the new frame will be rejected
+        break;
+    }
+}
+
+static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size, uint8_t *buffer, int wasFlushFrame, eARSTREAM_SENDER_FRAME_PRIORITY priority, int hasPriority, int maxAgeMs, int contents, const ARSTREAM_H264_NalUnit_t *nalUnits, int nbNalUnits)
+{
+    int retVal;
+    int canAdd = 1;
+    ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+    retVal = sender->numberOfWaitingFrames;
+    if (sender->currentFrameCbWasCalled == 0)
+    {
+        retVal++;
+    }
+    if (wasFlushFrame == 1)
+    {
+        ARSTREAM_Sender_FlushQueue (sender);
+    }
+    /* Decimate non-reference frames above the watermark */
+    if (sender->decimationWatermark > 0)
+    {
+        while ((sender->numberOfWaitingFrames >= sender->decimationWatermark) &&
+               (ARSTREAM_Sender_DropLeastValuableFrame (sender, ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE) == 1))
+        {
+            // Loop until we go below the watermark, or have nothing to drop
+        }
+        if ((sender->numberOfWaitingFrames >= sender->decimationWatermark) &&
+            (priority <= ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE))
+        {
+            canAdd = 0;
+        }
+    }
+    if ((canAdd == 1) &&
+        (sender->numberOfWaitingFrames >= sender->maxNumberOfNextFrames))
+    {
+        ARSTREAM_Sender_ApplyQueuePolicy (sender, priority);
+    }
+    if ((canAdd == 1) &&
+        (sender->numberOfWaitingFrames < sender->maxNumberOfNextFrames))
+    {
+        ARSTREAM_Sender_Frame_t *nextFrame = &(sender->nextFrames [sender->indexAddNextFrame]);
+        sender->nextFrameNumber++;
+        nextFrame->frameNumber = sender->nextFrameNumber;
+        nextFrame->frameBuffer = buffer;
+        nextFrame->frameSize   = size;
+        nextFrame->isHighPriority = wasFlushFrame;
+        nextFrame->priority = priority;
+        nextFrame->hasPriority = hasPriority;
+        nextFrame->maxAgeMs = maxAgeMs;
+        nextFrame->contents = contents;
+        nextFrame->isFromCache = 0;
+        nextFrame->nbNalUnits = nbNalUnits;
+        nextFrame->nalUnits = NULL;
+        if (nbNalUnits > 0)
+        {
+            ARSTREAM_H264_NalUnit_t *slotNalUnits = &(sender->nextFramesNalUnits [sender->indexAddNextFrame * ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS]);
+            memcpy (slotNalUnits, nalUnits, nbNalUnits * sizeof (ARSTREAM_H264_NalUnit_t));
+            nextFrame->nalUnits = slotNalUnits;
+        }
+        ARSTREAM_Clock_GetTime (&(nextFrame->timestamp));
+
+        sender->indexAddNextFrame++;
+        sender->indexAddNextFrame %= sender->maxNumberOfNextFrames;
+
+        sender->numberOfWaitingFrames++;
+
+        ARSTREAM_Clock_CondSignal (&(sender->nextFrameCond));
+    }
+    else
+    {
+        retVal = -1;
+    }
+    ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
+    return retVal;
+}
+
+static int ARSTREAM_Sender_NalUnitContents (uint8_t nalHeader)
+{
+    int retVal = 0;
+    uint8_t nalType = ARSTREAM_H264_NALU_TYPE (nalHeader);
+    // Types 1 to 5 are slices (or slice data partitions)
+    if ((nalType >= ARSTREAM_H264_NALU_TYPE_SLICE) &&
+        (nalType <= ARSTREAM_H264_NALU_TYPE_IDR))
+    {
+        retVal |= ARSTREAM_SENDER_FRAME_CONTENT_SLICE;
+        if (ARSTREAM_H264_NALU_REF_IDC (nalHeader) != 0)
+        {
+            retVal |= ARSTREAM_SENDER_FRAME_CONTENT_REFERENCE_SLICE;
+        }
+        if (nalType == ARSTREAM_H264_NALU_TYPE_IDR)
+        {
+            retVal |= ARSTREAM_SENDER_FRAME_CONTENT_IDR;
+        }
+    }
+    else if ((nalType == ARSTREAM_H264_NALU_TYPE_SPS) ||
+             (nalType == ARSTREAM_H264_NALU_TYPE_PPS))
+    {
+        retVal |= ARSTREAM_SENDER_FRAME_CONTENT_PARAMETER_SETS;
+    }
+    // No else : SEI, AUD and other NAL units do not change the priority
+    return retVal;
+}
+
+static int ARSTREAM_Sender_InspectFrame (uint8_t *buffer, uint32_t size, int *contents, ARSTREAM_H264_NalUnit_t *nalUnits)
+{
+    uint32_t base = 0;
+    int nbNalUnits = ARSTREAM_H264_FindNalUnits (buffer, size, nalUnits, ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS);
+    int retVal = nbNalUnits;
+    int i;
+
+    *contents = 0;
+    if (nbNalUnits <= 0)
+    {
+        // Not an Annex-B frame, nothing to scan
+        retVal = -1;
+        nbNalUnits = 0;
+    }
+    else
+    {
+        *contents |= ARSTREAM_SENDER_FRAME_CONTENT_ANNEXB;
+    }
+
+    while (nbNalUnits > 0)
+    {
+        // When the array is full, its last NAL unit extends up to the end of the frame : scan again from its start code
+        int nbComplete = (nbNalUnits == ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS) ? nbNalUnits - 1 : nbNalUnits;
+        for (i = 0; i < nbComplete; i++)
+        {
+            *contents |= ARSTREAM_Sender_NalUnitContents (buffer [base + nalUnits[i].offset]);
+        }
+        if (nbComplete == nbNalUnits)
+        {
+            nbNalUnits = 0;
+        }
+        else
+        {
+            retVal = -1;
+            base += nalUnits[nbComplete].offset - 3;
+            nbNalUnits = ARSTREAM_H264_FindNalUnits (&buffer [base], size - base, nalUnits, ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS);
+        }
+    }
+    return retVal;
+}
+
+static void ARSTREAM_Sender_ClassifyFrame (int contents, int *isFlushFrame, eARSTREAM_SENDER_FRAME_PRIORITY *priority)
+{
+    if ((contents & ARSTREAM_SENDER_FRAME_CONTENT_ANNEXB) == 0)
+    {
+        // Not an Annex-B frame, keep the application parameters
+    }
+    else if ((contents & ARSTREAM_SENDER_FRAME_CONTENT_IDR) != 0)
+    {
+        *isFlushFrame = 1;
+        *priority = ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME;
+    }
+    else if ((contents & (ARSTREAM_SENDER_FRAME_CONTENT_REFERENCE_SLICE | ARSTREAM_SENDER_FRAME_CONTENT_PARAMETER_SETS)) != 0)
+    {
+        *priority = ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+    }
+    else if ((contents & ARSTREAM_SENDER_FRAME_CONTENT_SLICE) != 0)
+    {
+        *priority = ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE;
+    }
+    else
+    {
+        *priority = ARSTREAM_SENDER_FRAME_PRIORITY_DISPOSABLE;
+    }
+}
+
+static void ARSTREAM_Sender_UpdateKeyframeCache (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame)
+{
+    ARSTREAM_Sender_CachedFrame_t released [ARSTREAM_SENDER_KEYFRAME_CACHE_MAX];
+    int nbReleased = 0;
+    int slot = -1;
+    int i;
+
+    if ((sender->keyframeCacheEnabled == 0) ||
+        (frame->isFromCache == 1) ||
+        (frame->frameBuffer == NULL))
+    {
+        // Cache disabled, or nothing new to cache
+    }
+    else if (((frame->contents & ARSTREAM_SENDER_FRAME_CONTENT_IDR) != 0) ||
+        ((frame->contents == 0) &&
+         (frame->isHighPriority == 1)))
+    {
+        slot = ARSTREAM_SENDER_KEYFRAME_CACHE_KEYFRAME;
+    }
+    else if ((frame->contents & ARSTREAM_SENDER_FRAME_CONTENT_PARAMETER_SETS) != 0)
+    {
+        slot = ARSTREAM_SENDER_KEYFRAME_CACHE_PARAMETER_SETS;
+    }
+    // No else : other frames are not cached
+
+    if (slot >= 0)
+    {
+        ARSAL_Mutex_Lock (&(sender->keyframeCacheMutex));
+        for (i = 0; i < ARSTREAM_SENDER_KEYFRAME_CACHE_MAX; i++)
+        {
+            ARSTREAM_Sender_CachedFrame_t *cached = &(sender->keyframeCache [i]);
+            // A keyframe with its own parameter sets also replaces the cached parameter sets
+            if ((cached->frame.frameBuffer != NULL) &&
+                ((i == slot) ||
+                 ((slot == ARSTREAM_SENDER_KEYFRAME_CACHE_KEYFRAME) &&
+                  ((frame->contents & ARSTREAM_SENDER_FRAME_CONTENT_PARAMETER_SETS) != 0))))
+            {
+                released [nbReleased] = *cached;
+                nbReleased++;
+                cached->frame.frameBuffer = NULL;
+                cached->callbackPending = 0;
+            }
+        }
+        sender->keyframeCache [slot].frame = *frame;
+        // The NAL units are only kept until the next frame, cached frames are scanned again when resent
+        sender->keyframeCache [slot].frame.nbNalUnits = -1;
+        sender->keyframeCache [slot].frame.nalUnits = NULL;
+        sender->keyframeCache [slot].callbackPending = 0;
+        ARSAL_Mutex_Unlock (&(sender->keyframeCacheMutex));
+    }
+
+    // If the callback of a replaced frame was not called yet, it will be called normally
+    for (i = 0; i < nbReleased; i++)
+    {
+        if (released [i].callbackPending == 1)
+        {
+            ARSTREAM_Sender_ReleaseFrame (sender, released [i].callbackStatus, released [i].frame.frameBuffer, released [i].frame.frameSize, 1);
+        }
+    }
+}
+
+static void ARSTREAM_Sender_ClearKeyframeCache (ARSTREAM_Sender_t *sender)
+{
+    int i;
+    for (i = 0; i < ARSTREAM_SENDER_KEYFRAME_CACHE_MAX; i++)
+    {
+        ARSTREAM_Sender_CachedFrame_t *cached = &(sender->keyframeCache [i]);
+        if ((cached->frame.frameBuffer != NULL) &&
+            (cached->callbackPending == 1))
+        {
+            ARSTREAM_Sender_ReleaseFrame (sender, cached->callbackStatus, cached->frame.frameBuffer, cached->frame.frameSize, 1);
+        }
+        cached->frame.frameBuffer = NULL;
+        cached->callbackPending = 0;
+    }
+}
+
+static int ARSTREAM_Sender_HoldInKeyframeCache (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_STATUS status, uint8_t *framePointer)
+{
+    int retVal = 0;
+    int i;
+    if (sender->keyframeCacheEnabled == 1)
+    {
+        ARSAL_Mutex_Lock (&(sender->keyframeCacheMutex));
+        if ((sender->currentFrame.isFromCache == 1) &&
+            (sender->currentFrame.frameBuffer == framePointer))
+        {
+            // Resent frames are owned by the cache, the application already got (or will get) the callback of the original frame
+            retVal = 1;
+        }
+        for (i = 0; (i < ARSTREAM_SENDER_KEYFRAME_CACHE_MAX) && (retVal == 0); i++)
+        {
+            ARSTREAM_Sender_CachedFrame_t *cached = &(sender->keyframeCache [i]);
+            if (cached->frame.frameBuffer == framePointer)
+            {
+                cached->callbackPending = 1;
+                cached->callbackStatus = status;
+                retVal = 1;
+            }
+        }
+        ARSAL_Mutex_Unlock (&(sender->keyframeCacheMutex));
+    }
+    return retVal;
+}
+
+static void ARSTREAM_Sender_RequestKeyframeCacheResend (ARSTREAM_Sender_t *sender)
+{
+    if (sender->keyframeCacheEnabled == 1)
+    {
+        ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+        sender->keyframeCacheResendIndex = 0;
+        ARSTREAM_Clock_CondSignal (&(sender->nextFrameCond));
+        ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
+    }
+}
+
+static int ARSTREAM_Sender_PopFromKeyframeCache (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *newFrame)
+{
+    int retVal = 0;
+    int isFirst = 0;
+    if (sender->keyframeCacheResendIndex == 0)
+    {
+        int cacheIsEmpty = 1;
+        int queueHasKeyframe = 0;
+        uint32_t i;
+        for (i = 0; i < ARSTREAM_SENDER_KEYFRAME_CACHE_MAX; i++)
+        {
+            if (sender->keyframeCache [i].frame.frameBuffer != NULL)
+            {
+                cacheIsEmpty = 0;
+            }
+        }
+        for (i = 0; i < sender->numberOfWaitingFrames; i++)
+        {
+            if (sender->nextFrames [(sender->indexGetNextFrame + i) % sender->maxNumberOfNextFrames].priority == ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME)
+            {
+                queueHasKeyframe = 1;
+            }
+        }
+        if ((cacheIsEmpty == 1) ||
+            (queueHasKeyframe == 1))
+        {
+            sender->keyframeCacheResendIndex = ARSTREAM_SENDER_KEYFRAME_CACHE_MAX;
+        }
+        else
+        {
+            // Queued frames depend on frames the reader does not have
+            ARSTREAM_Sender_FlushQueue (sender);
+            isFirst = 1;
+        }
+    }
+    while ((retVal == 0) &&
+           (sender->keyframeCacheResendIndex < ARSTREAM_SENDER_KEYFRAME_CACHE_MAX))
+    {
+        ARSTREAM_Sender_Frame_t *cached = &(sender->keyframeCache [sender->keyframeCacheResendIndex].frame);
+        sender->keyframeCacheResendIndex++;
+        if (cached->frameBuffer != NULL)
+        {
+            *newFrame = *cached;
+            sender->nextFrameNumber++;
+            newFrame->frameNumber = sender->nextFrameNumber;
+            newFrame->isHighPriority = isFirst;
+            newFrame->priority = ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME;
+            newFrame->isFromCache = 1;
+            ARSTREAM_Clock_GetTime (&(newFrame->timestamp));
+            retVal = 1;
+        }
+    }
+    return retVal;
+}
+
+static int ARSTREAM_Sender_FrameTimeLeftMs (ARSTREAM_Sender_Frame_t *frame, struct timespec *now)
 {
-    while (sender->numberOfWaitingFrames > 0)
+    int retVal = INT_MAX;
+    if (frame->maxAgeMs != ARSTREAM_SENDER_INFINITE_FRAME_AGE)
     {
-        ARSTREAM_Sender_Frame_t *nextFrame = &(sender->nextFrames [sender->indexGetNextFrame]);
-        ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_CANCEL, nextFrame->frameBuffer, nextFrame->frameSize, 0);
-        sender->indexGetNextFrame++;
-        sender->indexGetNextFrame %= sender->maxNumberOfNextFrames;
-        sender->numberOfWaitingFrames--;
+        retVal = frame->maxAgeMs - ARSAL_Time_ComputeTimespecMsTimeDiff (&(frame->timestamp), now);
     }
+    return retVal;
 }
 
-static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size, uint8_t *buffer, int wasFlushFrame)
+static void ARSTREAM_Sender_RemoveExpiredFrames (ARSTREAM_Sender_t *sender)
 {
-    int retVal;
-    ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
-    retVal = sender->numberOfWaitingFrames;
-    if (sender->currentFrameCbWasCalled == 0)
+    struct timespec now;
+    uint32_t nbFrames = sender->numberOfWaitingFrames;
+    uint32_t readIndex = sender->indexGetNextFrame;
+    uint32_t writeIndex = sender->indexGetNextFrame;
+    uint32_t i;
+    ARSTREAM_Clock_GetTime (&now);
+    // Compact the queue in place, keeping the order of the remaining frames
+    for (i = 0; i < nbFrames; i++)
     {
-        retVal++;
+        ARSTREAM_Sender_Frame_t *frame = &(sender->nextFrames [readIndex]);
+        if (ARSTREAM_Sender_FrameTimeLeftMs (frame, &now) <= 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Frame %d expired in queue", frame->frameNumber);
+            ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_EXPIRED, frame->frameBuffer, frame->frameSize, 0);
+            sender->numberOfWaitingFrames--;
+        }
+        else
+        {
+            if (writeIndex != readIndex)
+            {
+                ARSTREAM_Sender_MoveQueuedFrame (sender, writeIndex, readIndex);
+            }
+            writeIndex++;
+            writeIndex %= sender->maxNumberOfNextFrames;
+        }
+        readIndex++;
+        readIndex %= sender->maxNumberOfNextFrames;
     }
-    if (wasFlushFrame == 1)
+    sender->indexAddNextFrame = writeIndex;
+}
+
+static int ARSTREAM_Sender_CanReplaceCurrentFrame (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame)
+{
+    int retVal = 1;
+    // Flush frames, or any frame once the current one is done, are always accepted.
+    // Before the first frame, the NULL current frame has nothing to protect
+    if ((frame->isHighPriority == 0) &&
+        (sender->currentFrameCbWasCalled == 0) &&
+        (sender->currentFrame.frameBuffer != NULL))
     {
-        ARSTREAM_Sender_FlushQueue (sender);
+        if (sender->reliabilityMode == ARSTREAM_SENDER_RELIABILITY_FULLY_RELIABLE)
+        {
+            retVal = 0;
+        }
+        // Keep retrying a more important frame for a few rounds before
+        // replacing it with a less important one. Frames without a priority
+        // are replaced right away, as they always were
+        else if ((sender->currentFrame.hasPriority != 0) &&
+                 (frame->priority < sender->currentFrame.priority) &&
+                 (sender->currentFrameNbRetries < ARSTREAM_SENDER_PROTECTED_RETRIES [sender->currentFrame.priority]))
+        {
+            retVal = 0;
+        }
     }
-    if (sender->numberOfWaitingFrames < sender->maxNumberOfNextFrames)
-    {
-        ARSTREAM_Sender_Frame_t *nextFrame = &(sender->nextFrames [sender->indexAddNextFrame]);
-        sender->nextFrameNumber++;
-        nextFrame->frameNumber = sender->nextFrameNumber;
-        nextFrame->frameBuffer = buffer;
-        nextFrame->frameSize   = size;
-        nextFrame->isHighPriority = wasFlushFrame;
-
-        sender->indexAddNextFrame++;
-        sender->indexAddNextFrame %= sender->maxNumberOfNextFrames;
-
-        sender->numberOfWaitingFrames++;
+    return retVal;
+}
 
-        ARSAL_Cond_Signal (&(sender->nextFrameCond));
-    }
-    else
+static int ARSTREAM_Sender_GetMaxRetries (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame)
+{
+    int retVal = -1;
+    switch (sender->reliabilityMode)
     {
+    case ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT:
+        retVal = 0;
+        break;
+    case ARSTREAM_SENDER_RELIABILITY_SEMI_RELIABLE:
+        // Frames without a priority are retried until replaced, as they always were
+        retVal = (frame->hasPriority != 0) ? ARSTREAM_SENDER_MAX_RETRIES [frame->priority] : -1;
+        if ((sender->maxRetries != ARSTREAM_SENDER_DEFAULT_MAX_RETRIES) &&
+            ((retVal < 0) || (retVal > sender->maxRetries)))
+        {
+            retVal = sender->maxRetries;
+        }
+        break;
+    case ARSTREAM_SENDER_RELIABILITY_FULLY_RELIABLE:
+    default:
         retVal = -1;
+        break;
     }
-    ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
     return retVal;
 }
 
@@ -319,29 +1125,30 @@ static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sen
 {
     int retVal = 0;
     int hadTimeout = 0;
+    int fromCache = 0;
     ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+    ARSTREAM_Sender_RemoveExpiredFrames (sender);
+    // Resends of the keyframe cache go before the queue
+    fromCache = ARSTREAM_Sender_PopFromKeyframeCache (sender, newFrame);
+    retVal = fromCache;
     // Check if a frame is ready and of good priority
-    if (sender->numberOfWaitingFrames > 0)
+    if ((retVal == 0) &&
+        (sender->numberOfWaitingFrames > 0) &&
+        (ARSTREAM_Sender_CanReplaceCurrentFrame (sender, &(sender->nextFrames [sender->indexGetNextFrame])) == 1))
     {
-#if ENABLE_ACK_WAIT == 1
-        ARSTREAM_Sender_Frame_t *frame = &(sender->nextFrames [sender->indexGetNextFrame]);
-        // Give the next frame only if :
-        // 1> It's an high priority frame
-        // 2> The previous frame was fully acknowledged
-        if ((frame->isHighPriority == 1) ||
-            (sender->currentFrameCbWasCalled == 1))
-#endif
-        {
-            retVal = 1;
-            sender->numberOfWaitingFrames--;
-        }
+        retVal = 1;
+        sender->numberOfWaitingFrames--;
     }
     // If not, wait for a frame ready event
     if (retVal == 0)
     {
         struct timespec start, end;
         int timewaited = 0;
-        int waitTime = ARNETWORK_Manager_GetEstimatedLatency (sender->manager);
+        int waitTime = -1;
+        if (sender->transport.getEstimatedLatency != NULL)
+        {
+            waitTime = sender->transport.getEstimatedLatency (sender->transport.context);
+        }
         if (waitTime < 0) // Unable to get latency
         {
             waitTime = ARSTREAM_SENDER_DEFAULT_ESTIMATED_LATENCY_MS;
@@ -351,40 +1158,50 @@ static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sen
             waitTime = sender->maxRetryTimeMs;
         if (waitTime < sender->minRetryTimeMs)
             waitTime = sender->minRetryTimeMs;
-#if ENABLE_RETRIES == 0
-        waitTime = 100000; // Put an extremely long wait time (100 sec) to simulate a "no retry" case
-#endif
+        if (sender->reliabilityMode == ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT)
+        {
+            waitTime = ARSTREAM_SENDER_INFINITE_TIME_BETWEEN_RETRIES; // Nothing to retry, just wait for the next frame
+        }
+        // Wake up in time to cancel the current frame if it expires
+        if ((sender->currentFrameCbWasCalled == 0) &&
+            (sender->currentFrameDropped == 0))
+        {
+            struct timespec now;
+            int timeLeft;
+            ARSTREAM_Clock_GetTime (&now);
+            timeLeft = ARSTREAM_Sender_FrameTimeLeftMs (&(sender->currentFrame), &now);
+            if (timeLeft < waitTime)
+            {
+                waitTime = (timeLeft > 0) ? timeLeft : 0;
+            }
+        }
 
         while ((retVal == 0) &&
                (hadTimeout == 0))
         {
-            ARSAL_Time_GetTime(&start);
-            int err = ARSAL_Cond_Timedwait (&(sender->nextFrameCond), &(sender->nextFrameMutex), waitTime - timewaited);
-            ARSAL_Time_GetTime(&end);
+            ARSTREAM_Clock_GetTime (&start);
+            int err = ARSTREAM_Clock_CondWait (&(sender->nextFrameCond), &(sender->nextFrameMutex), waitTime - timewaited);
+            ARSTREAM_Clock_GetTime (&end);
             timewaited += ARSAL_Time_ComputeTimespecMsTimeDiff (&start, &end);
             if (err == ETIMEDOUT)
             {
                 hadTimeout = 1;
             }
-            if (sender->numberOfWaitingFrames > 0)
+            ARSTREAM_Sender_RemoveExpiredFrames (sender);
+            fromCache = ARSTREAM_Sender_PopFromKeyframeCache (sender, newFrame);
+            retVal = fromCache;
+            if ((retVal == 0) &&
+                (sender->numberOfWaitingFrames > 0) &&
+                (ARSTREAM_Sender_CanReplaceCurrentFrame (sender, &(sender->nextFrames [sender->indexGetNextFrame])) == 1))
             {
-#if ENABLE_ACK_WAIT == 1
-                ARSTREAM_Sender_Frame_t *frame = &(sender->nextFrames [sender->indexGetNextFrame]);
-                // Give the next frame only if :
-                // 1> It's an high priority frame
-                // 2> The previous frame was fully acknowledged
-                if ((frame->isHighPriority == 1) ||
-                    (sender->currentFrameCbWasCalled == 1))
-#endif
-                {
-                    retVal = 1;
-                    sender->numberOfWaitingFrames--;
-                }
+                retVal = 1;
+                sender->numberOfWaitingFrames--;
             }
         }
     }
-    // If we got a new frame, apply filters then copy it
-    if (retVal == 1)
+    // If we got a new frame from the queue, apply filters then copy it
+    if ((retVal == 1) &&
+        (fromCache == 0))
     {
         ARSTREAM_Sender_Frame_t *frame = &(sender->nextFrames [sender->indexGetNextFrame]);
         sender->indexGetNextFrame++;
@@ -398,7 +1215,8 @@ static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sen
         uint8_t *outBuffer = NULL;
         int i;
         ARSTREAM_Filter_t *prevFilter = NULL;
-        for (i = 0; i < sender->nbFilters; i++)
+        // The dummy frame from ARSTREAM_Sender_StopSender has no buffer to filter
+        for (i = 0; (inBuffer != NULL) && (i < sender->nbFilters); i++)
         {
             ARSTREAM_Filter_t *filter = sender->filters[i];
             maxOutSize = filter->getOutputSize(filter->context,
@@ -427,20 +1245,34 @@ static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sen
             }
             inBuffer = outBuffer;
             inSize = outSize;
+            prevFilter = filter;
         }
         newFrame->frameNumber = frame->frameNumber;
         newFrame->frameBuffer = inBuffer;
         newFrame->frameSize   = inSize;
         newFrame->isHighPriority = frame->isHighPriority;
+        newFrame->priority = frame->priority;
+        newFrame->hasPriority = frame->hasPriority;
+        newFrame->timestamp = frame->timestamp;
+        newFrame->maxAgeMs = frame->maxAgeMs;
+        newFrame->contents = frame->contents;
+        newFrame->isFromCache = 0;
+        // Filters may change the bitstream, so the NAL units are only kept for unfiltered frames
+        // The queue slot may be reused as soon as the mutex is released, so the NAL units are copied to the data thread storage
+        newFrame->nbNalUnits = (sender->nbFilters == 0) ? frame->nbNalUnits : -1;
+        newFrame->nalUnits = NULL;
+        if (newFrame->nbNalUnits > 0)
+        {
+            memcpy (sender->nalUnits, frame->nalUnits, newFrame->nbNalUnits * sizeof (ARSTREAM_H264_NalUnit_t));
+            newFrame->nalUnits = sender->nalUnits;
+        }
     }
     ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
     return retVal;
 }
 
-eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Sender_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status)
+static void ARSTREAM_Sender_NetworkCallback (void *customData, eARSTREAM_TRANSPORT_SEND_STATUS status)
 {
-    eARNETWORK_MANAGER_CALLBACK_RETURN retVal = ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT;
-
     /* Get params */
     ARSTREAM_Sender_NetworkCallbackParam_t *cbParams = (ARSTREAM_Sender_NetworkCallbackParam_t *)customData;
 
@@ -453,13 +1285,9 @@ eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Sender_NetworkCallback (int IoBuffer
     /* Get frameNumber */
     uint32_t frameNumber = cbParams->frameNumber;
 
-    /* Remove "unused parameter" warnings */
-    (void)IoBufferId;
-    (void)dataPtr;
-
     switch (status)
     {
-    case ARNETWORK_MANAGER_CALLBACK_STATUS_SENT:
+    case ARSTREAM_TRANSPORT_SEND_STATUS_SENT:
         ARSAL_Mutex_Lock (&(sender->packetsToSendMutex));
         // Modify packetsToSend only if it refers to the frame we're sending
         if (frameNumber == sender->packetsToSend.frameNumber)
@@ -478,23 +1306,206 @@ eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Sender_NetworkCallback (int IoBuffer
         /* Free cbParams */
         free (cbParams);
         break;
-    case ARNETWORK_MANAGER_CALLBACK_STATUS_CANCEL:
+    case ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL:
         /* Free cbParams */
         free (cbParams);
         break;
     default:
         break;
     }
-    return retVal;
 }
 
+static void ARSTREAM_Sender_FlushTransport (ARSTREAM_Sender_t *sender)
+{
+    if (sender->transport.flush != NULL)
+    {
+        sender->transport.flush (sender->transport.context);
+    }
+}
+
+static void ARSTREAM_Sender_SubmitTransport (ARSTREAM_Sender_t *sender)
+{
+    if (sender->transport.submit != NULL)
+    {
+        sender->transport.submit (sender->transport.context);
+    }
+}
+
+
+static void ARSTREAM_Sender_SendFrameOnce (ARSTREAM_Sender_t *sender, uint8_t *sendFragment, ARSTREAM_Sender_Frame_t *frame)
+{
+    ARSTREAM_NetworkHeaders_DataHeader_t *header = (ARSTREAM_NetworkHeaders_DataHeader_t *)sendFragment;
+    uint16_t nbPackets;
+    uint16_t cnt;
+
+    sender->currentFrame = *frame;
+    nbPackets = ARSTREAM_Sender_ComputeFragments (sender, frame);
+    sender->currentFrameNbFragments = nbPackets;
+
+    header->frameNumber = frame->frameNumber;
+    header->frameFlags = 0;
+    header->frameFlags |= (frame->isHighPriority != 0) ? ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME : 0;
+    header->frameFlags |= (frame->priority << ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT) & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK;
+    header->frameFlags |= ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_VALID;
+    header->frameFlags |= (sender->currentFrameHasFragmentOffsets == 1) ? ARSTREAM_NETWORK_HEADERS_FLAG_FRAGMENT_OFFSET : 0;
+    header->fragmentsPerFrame = nbPackets;
+
+    ARSTREAM_Sender_SendFrameTimestamp (sender, frame);
+
+    for (cnt = 0; cnt < nbPackets; cnt++)
+    {
+        eARSTREAM_ERROR sendError = ARSTREAM_OK;
+        uint32_t currFragmentSize;
+        uint32_t packetSize = ARSTREAM_Sender_FillFragment (sender, sendFragment, frame->frameBuffer, cnt, &currFragmentSize);
+        sendError = sender->transport.sendFragment (sender->transport.context, sendFragment, packetSize, NULL, NULL);
+        if (sendError != ARSTREAM_OK)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the fragment ; error: %d : %s", sendError, ARSTREAM_Error_ToString(sendError));
+        }
+    }
+    ARSTREAM_Sender_SubmitTransport (sender);
+
+    ARSTREAM_Sender_FrameSentOnce (sender, frame, nbPackets);
+}
+
+static void ARSTREAM_Sender_SendFrameRtp (ARSTREAM_Sender_t *sender, uint8_t *sendFragment, ARSTREAM_Sender_Frame_t *frame)
+{
+    uint32_t maxPacketSize = sender->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
+    uint64_t timeUs = (uint64_t)frame->timestamp.tv_sec * 1000000 + (uint64_t)frame->timestamp.tv_nsec / 1000;
+    uint32_t packetSize;
+    int nbPackets = 0;
+
+    sender->currentFrame = *frame;
+
+    ARSTREAM_Rtp_PacketizerSetFrame (&(sender->rtpPacketizer), frame->frameBuffer, frame->frameSize, timeUs);
+    while (ARSTREAM_Rtp_PacketizerNext (&(sender->rtpPacketizer), sendFragment, maxPacketSize, &packetSize) == 1)
+    {
+        eARSTREAM_ERROR sendError = sender->transport.sendFragment (sender->transport.context, sendFragment, packetSize, NULL, NULL);
+        if (sendError != ARSTREAM_OK)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the RTP packet ; error: %d : %s", sendError, ARSTREAM_Error_ToString(sendError));
+        }
+        nbPackets++;
+    }
+    ARSTREAM_Sender_SubmitTransport (sender);
+    sender->currentFrameNbFragments = nbPackets;
+
+    ARSTREAM_Sender_FrameSentOnce (sender, frame, nbPackets);
+}
+
+static int ARSTREAM_Sender_ComputeFragments (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame)
+{
+    uint32_t maxFragSize = sender->maxFragmentSize;
+    uint32_t frameSize = frame->frameSize;
+    int nbPackets = 0;
+    int useOffsets = 0;
+
+    if ((sender->fragmentationMode == ARSTREAM_SENDER_FRAGMENTATION_NAL_ALIGNED) &&
+        (__atomic_load_n (&(sender->readerHandlesControlFrames), __ATOMIC_ACQUIRE) == 1) &&
+        (maxFragSize > sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t)))
+    {
+        uint32_t maxDataSize = maxFragSize - sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t);
+        const ARSTREAM_H264_NalUnit_t *nalUnits = frame->nalUnits;
+        int nbNalUnits = frame->nbNalUnits;
+        int nextNalUnit = 1;
+        uint32_t start = 0;
+
+        if (nbNalUnits < 0)
+        {
+            // Not scanned by the auto classification
+            nbNalUnits = ARSTREAM_H264_FindNalUnits (frame->frameBuffer, frameSize, sender->nalUnits, ARSTREAM_H264_MAX_NAL_UNITS);
+            nalUnits = sender->nalUnits;
+        }
+        useOffsets = (nbNalUnits > 0) ? 1 : 0;
+        while ((useOffsets == 1) &&
+               (start < frameSize))
+        {
+            uint32_t limit = start + maxDataSize;
+            uint32_t cut = limit;
+            if (nbPackets == (int)sender->maxNumberOfFragment)
+            {
+                // Too many fragments, fall back to fixed size fragments
+                useOffsets = 0;
+                break;
+            }
+            if (limit >= frameSize)
+            {
+                cut = frameSize;
+            }
+            else
+            {
+                // Cut before the last start code which fits in this fragment
+                // (the start code of a NAL unit begins where the previous NAL unit ends)
+                while ((nextNalUnit < nbNalUnits) &&
+                       (nalUnits[nextNalUnit-1].offset + nalUnits[nextNalUnit-1].size <= limit))
+                {
+                    uint32_t nalStart = nalUnits[nextNalUnit-1].offset + nalUnits[nextNalUnit-1].size;
+                    if (nalStart > start)
+                    {
+                        cut = nalStart;
+                    }
+                    nextNalUnit++;
+                }
+            }
+            sender->currentFrameFragmentOffsets [nbPackets] = start;
+            nbPackets++;
+            start = cut;
+        }
+    }
+
+    if (useOffsets == 0)
+    {
+        int i;
+        nbPackets = (frameSize + maxFragSize - 1) / maxFragSize;
+        for (i = 0; i < nbPackets; i++)
+        {
+            sender->currentFrameFragmentOffsets [i] = maxFragSize * i;
+        }
+    }
+    sender->currentFrameFragmentOffsets [nbPackets] = frameSize;
+    sender->currentFrameHasFragmentOffsets = useOffsets;
+    return nbPackets;
+}
+
+static uint32_t ARSTREAM_Sender_FillFragment (ARSTREAM_Sender_t *sender, uint8_t *sendFragment, uint8_t *frameBuffer, int fragmentIndex, uint32_t *fragmentSize)
+{
+    ARSTREAM_NetworkHeaders_DataHeader_t *header = (ARSTREAM_NetworkHeaders_DataHeader_t *)sendFragment;
+    uint32_t offset = sender->currentFrameFragmentOffsets [fragmentIndex];
+    uint32_t size = sender->currentFrameFragmentOffsets [fragmentIndex + 1] - offset;
+    uint32_t packetSize = sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
+
+    header->fragmentNumber = fragmentIndex;
+    if (sender->currentFrameHasFragmentOffsets == 1)
+    {
+        ARSTREAM_NetworkHeaders_FragmentOffset_t *fragmentOffset = (ARSTREAM_NetworkHeaders_FragmentOffset_t *)&sendFragment[packetSize];
+        fragmentOffset->offset = htodl (offset);
+        packetSize += sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t);
+    }
+    memcpy (&sendFragment[packetSize], &frameBuffer[offset], size);
+    *fragmentSize = size;
+    return packetSize + size;
+}
+
+static void ARSTREAM_Sender_FrameSentOnce (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame, int nbPackets)
+{
+    ARSAL_Mutex_Lock (&(sender->ackMutex));
+    sender->efficiency_index ++;
+    sender->efficiency_index %= ARSTREAM_SENDER_EFFICIENCY_AVERAGE_NB_FRAMES;
+    sender->efficiency_nbFragments [sender->efficiency_index] = nbPackets;
+    sender->efficiency_nbSent [sender->efficiency_index] = nbPackets;
+    ARSAL_Mutex_Unlock (&(sender->ackMutex));
+
+    // The network made a copy of the data, so the frame is no longer needed
+    ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_SENT, frame->frameBuffer, frame->frameSize, 1);
+    sender->currentFrameCbWasCalled = 1;
+}
 
 static void ARSTREAM_Sender_FrameWasAck (ARSTREAM_Sender_t *sender)
 {
     ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_SENT, sender->currentFrame.frameBuffer, sender->currentFrame.frameSize, 1);
     sender->currentFrameCbWasCalled = 1;
     ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
-    ARSAL_Cond_Signal (&(sender->nextFrameCond));
+    ARSTREAM_Clock_CondSignal (&(sender->nextFrameCond));
     ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
 }
 
@@ -520,23 +1531,195 @@ static void ARSTREAM_Sender_CallCallback (ARSTREAM_Sender_t *sender, eARSTREAM_S
     {
         needToCall = 0;
     }
+    // Frames held by the keyframe cache are released when they leave the cache
+    if ((needToCall == 1) &&
+        (isCurrent == 1) &&
+        (ARSTREAM_Sender_HoldInKeyframeCache (sender, status, framePointer) == 1))
+    {
+        needToCall = 0;
+    }
 
     if (needToCall == 1)
     {
-        // Release to filter if
-        //  - We are calling the callback on a current frame (i.e. not one in
-        //    the frame queue, which is not yet filtered !)
-        //  - We have at least one filter. Otherwise, the process buffer is
-        //    still the same as the one given in SendNewFrame
-        if (isCurrent && sender->nbFilters > 0)
+        ARSTREAM_Sender_ReleaseFrame (sender, status, framePointer, frameSize, isCurrent);
+    }
+}
+
+static void ARSTREAM_Sender_ReleaseFrame (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, int isCurrent)
+{
+    // Release to filter if
+    //  - We are calling the callback on a current frame (i.e. not one in
+    //    the frame queue, which is not yet filtered !)
+    //  - We have at least one filter. Otherwise, the process buffer is
+    //    still the same as the one given in SendNewFrame
+    if (isCurrent && sender->nbFilters > 0)
+    {
+        ARSTREAM_Filter_t *lastFilter = sender->filters[sender->nbFilters - 1];
+        lastFilter->releaseBuffer(lastFilter->context,
+                                  framePointer);
+    }
+    else
+    {
+        sender->callback(status, framePointer, frameSize, sender->custom);
+    }
+}
+
+static void ARSTREAM_Sender_UpdateRateControl (ARSTREAM_Sender_t *sender)
+{
+    struct timespec now;
+    int changed;
+    uint32_t targetBitrate;
+    ARSTREAM_Sender_TargetBitrateCallback_t callback;
+
+    ARSTREAM_Clock_GetTime (&now);
+    ARSAL_Mutex_Lock (&(sender->ackMutex));
+    changed = ARSTREAM_RateControl_Update (&(sender->rateControl), &now);
+    targetBitrate = ARSTREAM_RateControl_GetTargetBitrate (&(sender->rateControl));
+    callback = sender->targetBitrateCallback;
+    ARSAL_Mutex_Unlock (&(sender->ackMutex));
+
+    if (changed == 1)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Target bitrate changed to %u bits/s", targetBitrate);
+        if (callback != NULL)
         {
-            ARSTREAM_Filter_t *lastFilter = sender->filters[sender->nbFilters - 1];
-            lastFilter->releaseBuffer(lastFilter->context,
-                                      framePointer);
+            callback (targetBitrate, sender->custom);
         }
-        else
+    }
+}
+
+static void ARSTREAM_Sender_HandleFeedback (ARSTREAM_Sender_t *sender, ARSTREAM_NetworkHeaders_FeedbackPacket_t *packet)
+{
+    ARSTREAM_Sender_Feedback_t feedback;
+    ARSTREAM_Sender_FeedbackCallback_t callback = NULL;
+    int isForApplication = 1;
+
+    switch (packet->type)
+    {
+    case ARSTREAM_NETWORK_HEADERS_FEEDBACK_KEYFRAME_REQUEST:
+        feedback.type = ARSTREAM_SENDER_FEEDBACK_KEYFRAME_REQUEST;
+        /* The cached keyframe can be sent right now, the application still gets the request for a fresh one */
+        ARSTREAM_Sender_RequestKeyframeCacheResend (sender);
+        break;
+    case ARSTREAM_NETWORK_HEADERS_FEEDBACK_RECEIVER_REPORT:
+        feedback.type = ARSTREAM_SENDER_FEEDBACK_RECEIVER_REPORT;
+        break;
+    case ARSTREAM_NETWORK_HEADERS_FEEDBACK_ABANDON_FRAME:
+        /* Handled internally, the application is told through the frame callback */
+        ARSTREAM_Sender_AbandonFrame (sender, dtohs (packet->frameNumber));
+        isForApplication = 0;
+        break;
+    default:
+        ARSAL_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_SENDER_TAG, "Unknown feedback type %d", packet->type);
+        isForApplication = 0;
+        break;
+    }
+
+    if (isForApplication == 1)
+    {
+        feedback.lastCompleteFrameNumber = dtohs (packet->frameNumber);
+        feedback.highestFrameNumber = dtohs (packet->highestFrameNumber);
+        feedback.lossFraction = packet->fractionLost / 256.f;
+        feedback.cumulativeLost = dtohl (packet->cumulativeLost);
+        feedback.jitterUs = dtohl (packet->jitterUs);
+
+        ARSAL_Mutex_Lock (&(sender->ackMutex));
+        if (feedback.type == ARSTREAM_SENDER_FEEDBACK_RECEIVER_REPORT)
         {
-            sender->callback(status, framePointer, frameSize, sender->custom);
+            ARSTREAM_RateControl_ReceiverReport (&(sender->rateControl), packet->fractionLost);
+        }
+        callback = sender->feedbackCallback;
+        ARSAL_Mutex_Unlock (&(sender->ackMutex));
+    }
+
+    if (callback != NULL)
+    {
+        callback (&feedback, sender->custom);
+    }
+}
+
+static void ARSTREAM_Sender_AbandonFrame (ARSTREAM_Sender_t *sender, uint16_t frameNumber)
+{
+    int wasCancelled = 0;
+    ARSAL_Mutex_Lock (&(sender->ackMutex));
+    if ((sender->reliabilityMode != ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT) &&
+        (sender->ackPacket.frameNumber == frameNumber) &&
+        (sender->currentFrameCbWasCalled == 0))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Frame %d abandoned by the reader", frameNumber);
+        ARSTREAM_Sender_FlushTransport (sender);
+        ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_CANCEL, sender->currentFrame.frameBuffer, sender->currentFrame.frameSize, 1);
+        sender->currentFrameCbWasCalled = 1;
+        sender->currentFrameDropped = 1;
+        wasCancelled = 1;
+    }
+    ARSAL_Mutex_Unlock (&(sender->ackMutex));
+
+    /* Wake up the data thread, so that it can send a waiting frame right now */
+    if (wasCancelled == 1)
+    {
+        ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+        ARSTREAM_Clock_CondSignal (&(sender->nextFrameCond));
+        ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
+    }
+}
+
+static void ARSTREAM_Sender_AnswerClockFrame (ARSTREAM_Sender_t *sender, ARSTREAM_NetworkHeaders_ClockFrame_t *request, uint64_t receiveTimeUs)
+{
+    uint8_t answer [sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_ClockFrame_t)];
+    ARSTREAM_NetworkHeaders_DataHeader_t *header = (ARSTREAM_NetworkHeaders_DataHeader_t *)answer;
+    ARSTREAM_NetworkHeaders_ClockFrame_t *clock = (ARSTREAM_NetworkHeaders_ClockFrame_t *)&answer[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)];
+    uint32_t high, low;
+    eARSTREAM_ERROR sendError;
+
+    header->frameNumber = 0;
+    header->frameFlags = ARSTREAM_NETWORK_HEADERS_FLAG_CLOCK_FRAME;
+    header->fragmentNumber = 0;
+    header->fragmentsPerFrame = 0;
+
+    ARSTREAM_NetworkHeaders_ControlHeaderInit (&(clock->control), ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK);
+    /* Originate timestamp is sent back untouched */
+    clock->originateTimestampH = request->originateTimestampH;
+    clock->originateTimestampL = request->originateTimestampL;
+    ARSTREAM_ClockSync_WriteTimestamp (&high, &low, receiveTimeUs);
+    clock->receiveTimestampH = htodl (high);
+    clock->receiveTimestampL = htodl (low);
+    ARSTREAM_ClockSync_WriteTimestamp (&high, &low, ARSTREAM_ClockSync_GetTimeUs ());
+    clock->transmitTimestampH = htodl (high);
+    clock->transmitTimestampL = htodl (low);
+
+    sendError = sender->transport.sendFragment (sender->transport.context, answer, sizeof (answer), NULL, NULL);
+    if (sendError != ARSTREAM_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the clock frame ; error: %d : %s", sendError, ARSTREAM_Error_ToString(sendError));
+    }
+    ARSTREAM_Sender_SubmitTransport (sender);
+}
+
+static void ARSTREAM_Sender_SendFrameTimestamp (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame)
+{
+    uint8_t packet [sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_FrameTimestamp_t)];
+    ARSTREAM_NetworkHeaders_DataHeader_t *header = (ARSTREAM_NetworkHeaders_DataHeader_t *)packet;
+    ARSTREAM_NetworkHeaders_FrameTimestamp_t *timestamp = (ARSTREAM_NetworkHeaders_FrameTimestamp_t *)&packet[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)];
+    uint64_t timeUs = (uint64_t)frame->timestamp.tv_sec * 1000000 + (uint64_t)frame->timestamp.tv_nsec / 1000;
+    uint32_t high, low;
+    eARSTREAM_ERROR sendError;
+
+    if ((__atomic_load_n (&(sender->readerHandlesControlFrames), __ATOMIC_ACQUIRE) == 1) &&
+        (sender->packetizationMode == ARSTREAM_SENDER_PACKETIZATION_NATIVE))
+    {
+        header->frameNumber = frame->frameNumber;
+        header->frameFlags = ARSTREAM_NETWORK_HEADERS_FLAG_FRAME_TIMESTAMP;
+        header->fragmentNumber = 0;
+        header->fragmentsPerFrame = 0;
+        ARSTREAM_ClockSync_WriteTimestamp (&high, &low, timeUs);
+        timestamp->timestampH = htodl (high);
+        timestamp->timestampL = htodl (low);
+
+        sendError = sender->transport.sendFragment (sender->transport.context, packet, sizeof (packet), NULL, NULL);
+        if (sendError != ARSTREAM_OK)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the frame timestamp ; error: %d : %s", sendError, ARSTREAM_Error_ToString(sendError));
         }
     }
 }
@@ -556,17 +1739,44 @@ void ARSTREAM_Sender_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
 }
 
 ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, ARSTREAM_Sender_FrameUpdateCallback_t callback, uint32_t framesBufferSize, uint32_t maxFragmentSize, uint32_t maxNumberOfFragment,  void *custom, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Sender_t *retSender = NULL;
+    ARSTREAM_Transport_t transport;
+    eARSTREAM_ERROR internalError = ARSTREAM_Transport_InitARNetwork (&transport, manager, dataBufferID, ackBufferID);
+    if (internalError != ARSTREAM_OK)
+    {
+        SET_WITH_CHECK (error, internalError);
+        return retSender;
+    }
+
+    retSender = ARSTREAM_Sender_NewWithTransport (&transport, callback, framesBufferSize, maxFragmentSize, maxNumberOfFragment, custom, error);
+    if (retSender == NULL)
+    {
+        ARSTREAM_Transport_Destroy (&transport);
+    }
+    else
+    {
+        retSender->ownsTransport = 1;
+    }
+    return retSender;
+}
+
+ARSTREAM_Sender_t* ARSTREAM_Sender_NewWithTransport (const ARSTREAM_Transport_t *transport, ARSTREAM_Sender_FrameUpdateCallback_t callback, uint32_t framesBufferSize, uint32_t maxFragmentSize, uint32_t maxNumberOfFragment, void *custom, eARSTREAM_ERROR *error)
 {
     ARSTREAM_Sender_t *retSender = NULL;
     int packetsToSendMutexWasInit = 0;
     int ackMutexWasInit = 0;
     int nextFrameMutexWasInit = 0;
     int nextFrameCondWasInit = 0;
+    int keyframeCacheMutexWasInit = 0;
     int nextFramesArrayWasCreated = 0;
+    int nextFramesNalUnitsArrayWasCreated = 0;
     int previousFramesArrayWasCreated = 0;
     eARSTREAM_ERROR internalError = ARSTREAM_OK;
     /* ARGS Check */
-    if ((manager == NULL) ||
+    if ((transport == NULL) ||
+        (transport->sendFragment == NULL) ||
+        (transport->receiveAck == NULL) ||
         (callback == NULL) ||
         (maxFragmentSize == 0) ||
         (maxNumberOfFragment > ARSTREAM_NETWORK_HEADERS_MAX_FRAGMENTS_PER_FRAME))
@@ -585,9 +1795,8 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
     /* Copy parameters */
     if (internalError == ARSTREAM_OK)
     {
-        retSender->manager = manager;
-        retSender->dataBufferID = dataBufferID;
-        retSender->ackBufferID = ackBufferID;
+        retSender->transport = *transport;
+        retSender->ownsTransport = 0;
         retSender->callback = callback;
         retSender->custom = custom;
         retSender->maxNumberOfFragment = maxNumberOfFragment;
@@ -600,6 +1809,21 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
     {
         retSender->minRetryTimeMs = ARSTREAM_SENDER_DEFAULT_MINIMUM_TIME_BETWEEN_RETRIES_MS;
         retSender->maxRetryTimeMs = ARSTREAM_SENDER_DEFAULT_MAXIMUM_TIME_BETWEEN_RETRIES_MS;
+        retSender->maxFrameAgeMs = ARSTREAM_SENDER_INFINITE_FRAME_AGE;
+        ARSTREAM_NetworkHeaders_AckPacketReset (&(retSender->lostPackets));
+        retSender->reliabilityMode = ARSTREAM_SENDER_RELIABILITY_SEMI_RELIABLE;
+        retSender->maxRetries = ARSTREAM_SENDER_DEFAULT_MAX_RETRIES;
+        retSender->queuePolicy = ARSTREAM_SENDER_QUEUE_POLICY_DROP_NEWEST;
+        retSender->decimationWatermark = 0;
+        retSender->packetizationMode = ARSTREAM_SENDER_PACKETIZATION_NATIVE;
+        retSender->fragmentationMode = ARSTREAM_SENDER_FRAGMENTATION_FIXED;
+        retSender->autoClassification = 0;
+        retSender->keyframeCacheEnabled = 0;
+        ARSTREAM_Rtp_PacketizerInit (&(retSender->rtpPacketizer));
+        ARSTREAM_RateControl_Init (&(retSender->rateControl), ARSTREAM_SENDER_DEFAULT_MIN_TARGET_BITRATE, ARSTREAM_SENDER_DEFAULT_MAX_TARGET_BITRATE);
+        retSender->targetBitrateCallback = NULL;
+        retSender->feedbackCallback = NULL;
+        retSender->readerHandlesControlFrames = 0;
     }
 
     /* Setup internal mutexes/sems */
@@ -651,6 +1875,18 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
             nextFrameCondWasInit = 1;
         }
     }
+    if (internalError == ARSTREAM_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init (&(retSender->keyframeCacheMutex));
+        if (mutexInitRet != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            keyframeCacheMutexWasInit = 1;
+        }
+    }
 
     /* Allocate next frame storage */
     if (internalError == ARSTREAM_OK)
@@ -662,7 +1898,21 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
         }
         else
         {
-            nextFramesArrayWasCreated = 1;
+            nextFramesArrayWasCreated = 1;
+        }
+    }
+
+    /* Allocate next frame NAL units storage */
+    if (internalError == ARSTREAM_OK)
+    {
+        retSender->nextFramesNalUnits = malloc (framesBufferSize * ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS * sizeof (ARSTREAM_H264_NalUnit_t));
+        if (retSender->nextFramesNalUnits == NULL)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            nextFramesNalUnitsArrayWasCreated = 1;
         }
     }
 
@@ -688,8 +1938,17 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
         retSender->currentFrame.frameBuffer = NULL;
         retSender->currentFrame.frameSize   = 0;
         retSender->currentFrame.isHighPriority = 0;
+        retSender->currentFrame.priority = ARSTREAM_SENDER_FRAME_PRIORITY_DISPOSABLE;
+        retSender->currentFrame.hasPriority = 0;
+        retSender->currentFrame.maxAgeMs = ARSTREAM_SENDER_INFINITE_FRAME_AGE;
+        retSender->currentFrame.contents = 0;
+        retSender->currentFrame.isFromCache = 0;
         retSender->currentFrameNbFragments = 0;
+        retSender->currentFrameFragmentOffsets [0] = 0;
+        retSender->currentFrameHasFragmentOffsets = 0;
         retSender->currentFrameCbWasCalled = 0;
+        retSender->currentFrameDropped = 0;
+        retSender->currentFrameNbRetries = 0;
         retSender->nextFrameNumber = 0;
         retSender->indexAddNextFrame = 0;
         retSender->indexGetNextFrame = 0;
@@ -706,6 +1965,12 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
         }
         retSender->filters = NULL;
         retSender->nbFilters = 0;
+        for (i = 0; i < ARSTREAM_SENDER_KEYFRAME_CACHE_MAX; i++)
+        {
+            retSender->keyframeCache [i].frame.frameBuffer = NULL;
+            retSender->keyframeCache [i].callbackPending = 0;
+        }
+        retSender->keyframeCacheResendIndex = ARSTREAM_SENDER_KEYFRAME_CACHE_MAX;
     }
 
     if ((internalError != ARSTREAM_OK) &&
@@ -727,10 +1992,18 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
         {
             ARSAL_Cond_Destroy (&(retSender->nextFrameCond));
         }
+        if (keyframeCacheMutexWasInit == 1)
+        {
+            ARSAL_Mutex_Destroy (&(retSender->keyframeCacheMutex));
+        }
         if (nextFramesArrayWasCreated == 1)
         {
             free (retSender->nextFrames);
         }
+        if (nextFramesNalUnitsArrayWasCreated == 1)
+        {
+            free (retSender->nextFramesNalUnits);
+        }
         if (previousFramesArrayWasCreated == 1)
         {
             free (retSender->previousFramesStatus);
@@ -762,6 +2035,243 @@ eARSTREAM_ERROR ARSTREAM_Sender_SetTimeBetweenRetries (ARSTREAM_Sender_t *sender
     return err;
 }
 
+eARSTREAM_ERROR ARSTREAM_Sender_SetMaximumFrameAge (ARSTREAM_Sender_t *sender, int maxFrameAgeMs)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL ||
+        maxFrameAgeMs < 0)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        sender->maxFrameAgeMs = maxFrameAgeMs;
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetReliabilityMode (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_RELIABILITY mode, int maxRetries)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL ||
+        mode < 0 ||
+        mode >= ARSTREAM_SENDER_RELIABILITY_MAX ||
+        maxRetries < ARSTREAM_SENDER_DEFAULT_MAX_RETRIES)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        (sender->packetizationMode == ARSTREAM_SENDER_PACKETIZATION_RTP_H264) &&
+        (mode != ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        (sender->dataThreadStarted != 0 ||
+         sender->ackThreadStarted != 0))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        sender->reliabilityMode = mode;
+        sender->maxRetries = maxRetries;
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetPacketizationMode (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_PACKETIZATION mode)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL ||
+        mode < 0 ||
+        mode >= ARSTREAM_SENDER_PACKETIZATION_MAX)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        (mode == ARSTREAM_SENDER_PACKETIZATION_RTP_H264) &&
+        (sender->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) < sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t) + ARSTREAM_RTP_MIN_PAYLOAD_SIZE))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        (sender->dataThreadStarted != 0 ||
+         sender->ackThreadStarted != 0))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        sender->packetizationMode = mode;
+        if (mode == ARSTREAM_SENDER_PACKETIZATION_RTP_H264)
+        {
+            sender->reliabilityMode = ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT;
+        }
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetFragmentationMode (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_FRAGMENTATION mode)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL ||
+        mode < 0 ||
+        mode >= ARSTREAM_SENDER_FRAGMENTATION_MAX)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        (sender->dataThreadStarted != 0 ||
+         sender->ackThreadStarted != 0))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        sender->fragmentationMode = mode;
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetAutoClassification (ARSTREAM_Sender_t *sender, int enable)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL ||
+        (enable != 0 &&
+         enable != 1))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        sender->autoClassification = enable;
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetKeyframeCache (ARSTREAM_Sender_t *sender, int enable)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL ||
+        (enable != 0 &&
+         enable != 1))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((err == ARSTREAM_OK) &&
+        (sender->dataThreadStarted != 0 ||
+         sender->ackThreadStarted != 0))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        sender->keyframeCacheEnabled = enable;
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_ResendKeyframeCache (ARSTREAM_Sender_t *sender)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((sender == NULL) ||
+        (sender->keyframeCacheEnabled == 0))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSTREAM_Sender_RequestKeyframeCacheResend (sender);
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetQueuePolicy (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_QUEUE_POLICY policy, uint32_t decimationWatermark)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL ||
+        policy < 0 ||
+        policy >= ARSTREAM_SENDER_QUEUE_POLICY_MAX)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+        sender->queuePolicy = policy;
+        sender->decimationWatermark = decimationWatermark;
+        ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetTargetBitrateLimits (ARSTREAM_Sender_t *sender, uint32_t minBitrate, uint32_t maxBitrate)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL ||
+        minBitrate > maxBitrate)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(sender->ackMutex));
+        ARSTREAM_RateControl_SetLimits (&(sender->rateControl), minBitrate, maxBitrate);
+        ARSAL_Mutex_Unlock (&(sender->ackMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetTargetBitrateCallback (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_TargetBitrateCallback_t callback)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(sender->ackMutex));
+        sender->targetBitrateCallback = callback;
+        ARSAL_Mutex_Unlock (&(sender->ackMutex));
+    }
+    return err;
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SetFeedbackCallback (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_FeedbackCallback_t callback)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if (sender == NULL)
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(sender->ackMutex));
+        sender->feedbackCallback = callback;
+        ARSAL_Mutex_Unlock (&(sender->ackMutex));
+    }
+    return err;
+}
+
 void ARSTREAM_Sender_StopSender (ARSTREAM_Sender_t *sender)
 {
     if (sender != NULL)
@@ -773,7 +2283,7 @@ void ARSTREAM_Sender_StopSender (ARSTREAM_Sender_t *sender)
     // stop after sender->maxRetryTimeMs, instead of immediately. When this
     // time is set to ARSTREAM_SENDER_INFINITE_TIME_BETWEEN_RETRIES, it means
     // That the thread will be joinable 100 seconds after this call.
-    ARSTREAM_Sender_AddToQueue(sender, 0, NULL, 1);
+    ARSTREAM_Sender_AddToQueue(sender, 0, NULL, 1, ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME, 0, ARSTREAM_SENDER_INFINITE_FRAME_AGE, 0, NULL, -1);
 }
 
 eARSTREAM_ERROR ARSTREAM_Sender_Delete (ARSTREAM_Sender_t **sender)
@@ -794,13 +2304,20 @@ eARSTREAM_ERROR ARSTREAM_Sender_Delete (ARSTREAM_Sender_t **sender)
             ARSAL_Mutex_Lock (&((*sender)->nextFrameMutex));
             ARSTREAM_Sender_FlushQueue (*sender);
             ARSAL_Mutex_Unlock (&((*sender)->nextFrameMutex));
+            ARSTREAM_Sender_ClearKeyframeCache (*sender);
+            ARSAL_Mutex_Destroy (&((*sender)->keyframeCacheMutex));
             ARSAL_Mutex_Destroy (&((*sender)->packetsToSendMutex));
             ARSAL_Mutex_Destroy (&((*sender)->ackMutex));
             ARSAL_Mutex_Destroy (&((*sender)->nextFrameMutex));
             ARSAL_Cond_Destroy (&((*sender)->nextFrameCond));
             free ((*sender)->nextFrames);
+            free ((*sender)->nextFramesNalUnits);
             free ((*sender)->previousFramesStatus);
             free ((*sender)->filters);
+            if ((*sender)->ownsTransport == 1)
+            {
+                ARSTREAM_Transport_Destroy (&((*sender)->transport));
+            }
             free (*sender);
             *sender = NULL;
             retVal = ARSTREAM_OK;
@@ -815,14 +2332,48 @@ eARSTREAM_ERROR ARSTREAM_Sender_Delete (ARSTREAM_Sender_t **sender)
 }
 
 eARSTREAM_ERROR ARSTREAM_Sender_SendNewFrame (ARSTREAM_Sender_t *sender, uint8_t *frameBuffer, uint32_t frameSize, int flushPreviousFrames, int *nbPreviousFrames)
+{
+    ARSTREAM_Sender_FrameParams_t params;
+    ARSTREAM_Sender_FrameParamsDefaultInit (&params);
+    params.flushPreviousFrames = flushPreviousFrames;
+    return ARSTREAM_Sender_SendNewFrameWithParams (sender, frameBuffer, frameSize, &params, nbPreviousFrames);
+}
+
+void ARSTREAM_Sender_FrameParamsDefaultInit (ARSTREAM_Sender_FrameParams_t *params)
+{
+    if (params != NULL)
+    {
+        params->flushPreviousFrames = 0;
+        params->maxFrameAgeMs = ARSTREAM_SENDER_STREAM_FRAME_AGE;
+        params->priority = ARSTREAM_SENDER_FRAME_PRIORITY_DEFAULT;
+    }
+}
+
+eARSTREAM_ERROR ARSTREAM_Sender_SendNewFrameWithParams (ARSTREAM_Sender_t *sender, uint8_t *frameBuffer, uint32_t frameSize, const ARSTREAM_Sender_FrameParams_t *params, int *nbPreviousFrames)
 {
     eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    ARSTREAM_Sender_FrameParams_t defaultParams;
+    int maxAgeMs;
+    int isFlushFrame;
+    eARSTREAM_SENDER_FRAME_PRIORITY priority;
+    int hasPriority;
+    ARSTREAM_H264_NalUnit_t nalUnits [ARSTREAM_SENDER_MAX_FRAME_NAL_UNITS];
+    int nbNalUnits = -1;
+    int contents = 0;
+    if (params == NULL)
+    {
+        ARSTREAM_Sender_FrameParamsDefaultInit (&defaultParams);
+        params = &defaultParams;
+    }
     // Args check
     if ((sender == NULL) ||
         (frameBuffer == NULL) ||
         (frameSize == 0) ||
-        ((flushPreviousFrames != 0) &&
-         (flushPreviousFrames != 1)))
+        ((params->flushPreviousFrames != 0) &&
+         (params->flushPreviousFrames != 1)) ||
+        (params->maxFrameAgeMs < ARSTREAM_SENDER_STREAM_FRAME_AGE) ||
+        ((int)params->priority < ARSTREAM_SENDER_FRAME_PRIORITY_DEFAULT) ||
+        ((int)params->priority >= ARSTREAM_SENDER_FRAME_PRIORITY_MAX))
     {
         retVal = ARSTREAM_ERROR_BAD_PARAMETERS;
     }
@@ -834,7 +2385,23 @@ eARSTREAM_ERROR ARSTREAM_Sender_SendNewFrame (ARSTREAM_Sender_t *sender, uint8_t
 
     if (retVal == ARSTREAM_OK)
     {
-        int res = ARSTREAM_Sender_AddToQueue (sender, frameSize, frameBuffer, flushPreviousFrames);
+        maxAgeMs = (params->maxFrameAgeMs == ARSTREAM_SENDER_STREAM_FRAME_AGE) ? sender->maxFrameAgeMs : params->maxFrameAgeMs;
+        isFlushFrame = params->flushPreviousFrames;
+        hasPriority = ((int)params->priority != ARSTREAM_SENDER_FRAME_PRIORITY_DEFAULT) ? 1 : 0;
+        priority = (hasPriority == 1) ? params->priority : ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+        if ((sender->autoClassification == 1) ||
+            (sender->keyframeCacheEnabled == 1))
+        {
+            nbNalUnits = ARSTREAM_Sender_InspectFrame (frameBuffer, frameSize, &contents, nalUnits);
+        }
+        if (sender->autoClassification == 1)
+        {
+            ARSTREAM_Sender_ClassifyFrame (contents, &isFlushFrame, &priority);
+            hasPriority = ((contents & ARSTREAM_SENDER_FRAME_CONTENT_ANNEXB) != 0) ? 1 : hasPriority;
+        }
+        // Flush frames are always key frames
+        priority = (isFlushFrame == 1) ? ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME : priority;
+        int res = ARSTREAM_Sender_AddToQueue (sender, frameSize, frameBuffer, isFlushFrame, priority, hasPriority, maxAgeMs, contents, nalUnits, nbNalUnits);
         if (res < 0)
         {
             retVal = ARSTREAM_ERROR_QUEUE_FULL;
@@ -873,13 +2440,19 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
     uint16_t nbPackets = 0;
     uint16_t cnt;
     int numbersOfFragmentsSentForCurrentFrame = 0;
-    uint32_t lastFragmentSize = 0;
     ARSTREAM_NetworkHeaders_DataHeader_t *header = NULL;
     ARSTREAM_Sender_Frame_t nextFrame = {
         .frameNumber = 0,
         .frameSize = 0,
         .frameBuffer = NULL,
-        .isHighPriority = 0
+        .isHighPriority = 0,
+        .priority = ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE,
+        .hasPriority = 0,
+        .maxAgeMs = ARSTREAM_SENDER_INFINITE_FRAME_AGE,
+        .nbNalUnits = -1,
+        .nalUnits = NULL,
+        .contents = 0,
+        .isFromCache = 0
     };
     int firstFrame = 1;
 
@@ -905,6 +2478,7 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
     while (sender->threadsShouldStop == 0)
     {
         int waitRes;
+        int maxRetries;
         waitRes = ARSTREAM_Sender_PopFromQueue (sender, &nextFrame);
         // Check again if we should be stopping (after the wait).
         // If we're trying to send the dummy frame from ARSTREAM_Sender_StopSender
@@ -913,6 +2487,24 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
         {
             break;
         }
+        if (waitRes == 1)
+        {
+            ARSTREAM_Sender_UpdateKeyframeCache (sender, &nextFrame);
+        }
+        /* Best effort fast path : no acknowledge, no retries */
+        if (sender->reliabilityMode == ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT)
+        {
+            if ((waitRes == 1) &&
+                (sender->packetizationMode == ARSTREAM_SENDER_PACKETIZATION_RTP_H264))
+            {
+                ARSTREAM_Sender_SendFrameRtp (sender, sendFragment, &nextFrame);
+            }
+            else if (waitRes == 1)
+            {
+                ARSTREAM_Sender_SendFrameOnce (sender, sendFragment, &nextFrame);
+            }
+            continue;
+        }
         ARSAL_Mutex_Lock (&(sender->ackMutex));
         if (waitRes == 1)
         {
@@ -930,7 +2522,12 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             /* Cancel current frame if it was not already sent */
             /* Do not do it for the first "NULL" frame that is in the
              * ARStream Sender before any call to SendNewFrame */
-            if (sender->currentFrameCbWasCalled == 0 && firstFrame == 0)
+            if (sender->currentFrameDropped == 1)
+            {
+                /* Already cancelled, but a LATE_ACK is still possible */
+                previousWasAck = 0;
+            }
+            else if (sender->currentFrameCbWasCalled == 0 && firstFrame == 0)
             {
 #ifdef DEBUG
                 ARSTREAM_NetworkHeaders_AckPacketDump ("Cancel frame:", &(sender->ackPacket));
@@ -938,11 +2535,13 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
 #endif
 
                 previousWasAck = 0;
-                ARNETWORK_Manager_FlushInputBuffer (sender->manager, sender->dataBufferID);
+                ARSTREAM_Sender_FlushTransport (sender);
 
                 ARSTREAM_Sender_CallCallback(sender, ARSTREAM_SENDER_STATUS_FRAME_CANCEL, sender->currentFrame.frameBuffer, sender->currentFrame.frameSize, 1);
             }
             sender->currentFrameCbWasCalled = 0; // New frame
+            sender->currentFrameDropped = 0;
+            sender->currentFrameNbRetries = 0;
             firstFrame = 0;
 
             /* Save next frame data into current frame data */
@@ -950,6 +2549,11 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             sender->currentFrame.frameBuffer = nextFrame.frameBuffer;
             sender->currentFrame.frameSize   = nextFrame.frameSize;
             sender->currentFrame.isHighPriority = nextFrame.isHighPriority;
+            sender->currentFrame.priority = nextFrame.priority;
+            sender->currentFrame.hasPriority = nextFrame.hasPriority;
+            sender->currentFrame.timestamp = nextFrame.timestamp;
+            sender->currentFrame.maxAgeMs = nextFrame.maxAgeMs;
+            sender->currentFrame.isFromCache = nextFrame.isFromCache;
             sendSize = nextFrame.frameSize;
 
             sender->previousFramesStatus[sender->previousFrameIndex] = previousWasAck;
@@ -959,6 +2563,14 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             /* Reset ack packet - No packets are ack on the new frame */
             sender->ackPacket.frameNumber = sender->currentFrame.frameNumber;
             ARSTREAM_NetworkHeaders_AckPacketReset (&(sender->ackPacket));
+            ARSTREAM_NetworkHeaders_AckPacketReset (&(sender->lostPackets));
+
+            /* The ack delay of the new frame is measured from now */
+            {
+                struct timespec now;
+                ARSTREAM_Clock_GetTime (&now);
+                ARSTREAM_RateControl_FrameStarted (&(sender->rateControl), &now);
+            }
 
             /* Reset packetsToSend - update frame number */
             ARSAL_Mutex_Lock (&(sender->packetsToSendMutex));
@@ -970,35 +2582,53 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             header->frameNumber = sender->currentFrame.frameNumber;
             header->frameFlags = 0;
             header->frameFlags |= (sender->currentFrame.isHighPriority != 0) ? ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME : 0;
+            header->frameFlags |= (sender->currentFrame.priority << ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT) & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK;
+            header->frameFlags |= ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_VALID;
 
-            /* Compute number of fragments / size of the last fragment */
-            if (0 < sendSize)
-            {
-                uint32_t maxFragSize = sender->maxFragmentSize;
-                lastFragmentSize = maxFragSize;
-                nbPackets = sendSize / maxFragSize;
-                if (sendSize % maxFragSize)
-                {
-                    nbPackets++;
-                    lastFragmentSize = sendSize % maxFragSize;
-                }
-            }
+            /* Compute fragments */
+            nbPackets = ARSTREAM_Sender_ComputeFragments (sender, &nextFrame);
+            header->frameFlags |= (sender->currentFrameHasFragmentOffsets == 1) ? ARSTREAM_NETWORK_HEADERS_FLAG_FRAGMENT_OFFSET : 0;
             sender->currentFrameNbFragments = nbPackets;
 
+            /* Let the reader schedule the frame playout */
+            ARSTREAM_Sender_SendFrameTimestamp (sender, &(sender->currentFrame));
+
             ARSAL_PRINT (ARSAL_PRINT_VERBOSE, ARSTREAM_SENDER_TAG, "New frame has size %d (=%d packets)", sendSize, nbPackets);
         }
+        else if ((sender->currentFrameCbWasCalled == 0) &&
+                 (firstFrame == 0))
+        {
+            /* No new frame, check if the current one is still worth sending */
+            struct timespec now;
+            sender->currentFrameNbRetries++;
+            ARSTREAM_Clock_GetTime (&now);
+            if (ARSTREAM_Sender_FrameTimeLeftMs (&(sender->currentFrame), &now) <= 0)
+            {
+                ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Frame %d expired while sending", sender->currentFrame.frameNumber);
+                ARSTREAM_Sender_FlushTransport (sender);
+                ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_EXPIRED, sender->currentFrame.frameBuffer, sender->currentFrame.frameSize, 1);
+                sender->currentFrameCbWasCalled = 1;
+                sender->currentFrameDropped = 1;
+            }
+        }
         ARSAL_Mutex_Unlock (&(sender->ackMutex));
         /* END OF NEW FRAME BLOCK */
 
-        /* Flag all non-ack packets as "packet to send" */
+        /* Flag all non-ack packets as "packet to send" (none if the frame expired, or has no retry left) */
         ARSAL_Mutex_Lock (&(sender->packetsToSendMutex));
         ARSAL_Mutex_Lock (&(sender->ackMutex));
         ARSTREAM_NetworkHeaders_AckPacketReset (&(sender->packetsToSend));
-        for (cnt = 0; cnt < nbPackets; cnt++)
+        maxRetries = ARSTREAM_Sender_GetMaxRetries (sender, &(sender->currentFrame));
+        if ((sender->currentFrameDropped == 0) &&
+            ((maxRetries < 0) ||
+             (sender->currentFrameNbRetries <= maxRetries)))
         {
-            if (0 == ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->ackPacket), cnt))
+            for (cnt = 0; cnt < nbPackets; cnt++)
             {
-                ARSTREAM_NetworkHeaders_AckPacketSetFlag (&(sender->packetsToSend), cnt);
+                if (0 == ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->ackPacket), cnt))
+                {
+                    ARSTREAM_NetworkHeaders_AckPacketSetFlag (&(sender->packetsToSend), cnt);
+                }
             }
         }
 
@@ -1007,22 +2637,26 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
         {
             if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->packetsToSend), cnt))
             {
-                eARNETWORK_ERROR netError = ARNETWORK_OK;
-                uint32_t maxFragSize = sender->maxFragmentSize;
+                eARSTREAM_ERROR sendError = ARSTREAM_OK;
+                uint32_t currFragmentSize;
+                uint32_t packetSize;
                 numbersOfFragmentsSentForCurrentFrame ++;
-                int currFragmentSize = (cnt == nbPackets-1) ? lastFragmentSize : maxFragSize;
-                header->fragmentNumber = cnt;
                 header->fragmentsPerFrame = nbPackets;
-                memcpy (&sendFragment[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], &(sender->currentFrame.frameBuffer)[maxFragSize*cnt], currFragmentSize);
+                packetSize = ARSTREAM_Sender_FillFragment (sender, sendFragment, sender->currentFrame.frameBuffer, cnt, &currFragmentSize);
                 ARSTREAM_Sender_NetworkCallbackParam_t *cbParams = malloc (sizeof (ARSTREAM_Sender_NetworkCallbackParam_t));
                 cbParams->sender = sender;
                 cbParams->fragmentIndex = cnt;
                 cbParams->frameNumber = sender->packetsToSend.frameNumber;
                 ARSAL_Mutex_Unlock (&(sender->packetsToSendMutex));
-                netError = ARNETWORK_Manager_SendData (sender->manager, sender->dataBufferID, sendFragment, currFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t), (void *)cbParams, ARSTREAM_Sender_NetworkCallback, 1);
-                if (netError != ARNETWORK_OK)
+                sendError = sender->transport.sendFragment (sender->transport.context, sendFragment, packetSize, (void *)cbParams, ARSTREAM_Sender_NetworkCallback);
+                if (sendError != ARSTREAM_OK)
                 {
-                    ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the fragment ; error: %d : %s", netError, ARNETWORK_Error_ToString(netError));
+                    ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the fragment ; error: %d : %s", sendError, ARSTREAM_Error_ToString(sendError));
+                    free (cbParams);
+                }
+                else
+                {
+                    ARSTREAM_RateControl_DataSent (&(sender->rateControl), currFragmentSize);
                 }
 
                 ARSAL_Mutex_Lock (&(sender->packetsToSendMutex));
@@ -1030,6 +2664,9 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
         }
         ARSAL_Mutex_Unlock (&(sender->ackMutex));
         ARSAL_Mutex_Unlock (&(sender->packetsToSendMutex));
+        ARSTREAM_Sender_SubmitTransport (sender);
+
+        ARSTREAM_Sender_UpdateRateControl (sender);
     }
     /* END OF PROCESS LOOP */
 
@@ -1058,6 +2695,7 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
 void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param)
 {
     ARSTREAM_NetworkHeaders_AckPacket_t recvPacket;
+    uint8_t recvBuffer [ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE];
     int recvSize;
     ARSTREAM_Sender_t *sender = (ARSTREAM_Sender_t *)ARSTREAM_Sender_t_Param;
 
@@ -1068,20 +2706,55 @@ void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param)
 
     while (sender->threadsShouldStop == 0)
     {
-        eARNETWORK_ERROR err = ARNETWORK_Manager_ReadDataWithTimeout (sender->manager, sender->ackBufferID, (uint8_t *)&recvPacket, sizeof (recvPacket), &recvSize, 1000);
-        if (ARNETWORK_OK != err)
+        eARSTREAM_ERROR err = sender->transport.receiveAck (sender->transport.context, recvBuffer, sizeof (recvBuffer), &recvSize, 1000);
+        uint64_t recvTimeUs = ARSTREAM_ClockSync_GetTimeUs ();
+        uint8_t controlType = (ARSTREAM_OK == err) ? ARSTREAM_NetworkHeaders_ControlFrameType (recvBuffer, recvSize) : ARSTREAM_NETWORK_HEADERS_CONTROL_NONE;
+        if (ARSTREAM_OK != err)
+        {
+            if (ARSTREAM_ERROR_TIMEOUT != err)
+            {
+                ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while reading ACK data: %s", ARSTREAM_Error_ToString (err));
+            }
+        }
+        else if ((controlType == ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK) &&
+                 (recvSize != sizeof (ARSTREAM_NetworkHeaders_ClockFrame_t)))
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Read %d octets of clock frame, expected %zu", recvSize, sizeof (ARSTREAM_NetworkHeaders_ClockFrame_t));
+        }
+        else if (controlType == ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK)
+        {
+            if (__atomic_exchange_n (&(sender->readerHandlesControlFrames), 1, __ATOMIC_ACQ_REL) == 0)
+            {
+                /* First control frame : the reader just joined the stream */
+                ARSTREAM_Sender_RequestKeyframeCacheResend (sender);
+            }
+            ARSTREAM_Sender_AnswerClockFrame (sender, (ARSTREAM_NetworkHeaders_ClockFrame_t *)recvBuffer, recvTimeUs);
+        }
+        else if ((controlType == ARSTREAM_NETWORK_HEADERS_CONTROL_FEEDBACK) &&
+                 (recvSize != sizeof (ARSTREAM_NetworkHeaders_FeedbackPacket_t)))
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Read %d octets of feedback, expected %zu", recvSize, sizeof (ARSTREAM_NetworkHeaders_FeedbackPacket_t));
+        }
+        else if (controlType == ARSTREAM_NETWORK_HEADERS_CONTROL_FEEDBACK)
         {
-            if (ARNETWORK_ERROR_BUFFER_EMPTY != err)
+            if (__atomic_exchange_n (&(sender->readerHandlesControlFrames), 1, __ATOMIC_ACQ_REL) == 0)
             {
-                ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while reading ACK data: %s", ARNETWORK_Error_ToString (err));
+                /* First control frame : the reader just joined the stream */
+                ARSTREAM_Sender_RequestKeyframeCacheResend (sender);
             }
+            ARSTREAM_Sender_HandleFeedback (sender, (ARSTREAM_NetworkHeaders_FeedbackPacket_t *)recvBuffer);
         }
         else if (recvSize != sizeof (recvPacket))
         {
             ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Read %d octets, expected %zu", recvSize, sizeof (recvPacket));
         }
+        else if (sender->reliabilityMode == ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT)
+        {
+            /* Acknowledges are not used in best effort mode */
+        }
         else
         {
+            memcpy (&recvPacket, recvBuffer, sizeof (recvPacket));
             /* Switch recvPacket endianness */
             recvPacket.frameNumber = dtohs (recvPacket.frameNumber);
             recvPacket.highPacketsAck = dtohll (recvPacket.highPacketsAck);
@@ -1091,6 +2764,46 @@ void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param)
             ARSAL_Mutex_Lock (&(sender->ackMutex));
             if (sender->ackPacket.frameNumber == recvPacket.frameNumber)
             {
+                /* Feed the congestion controller with the newly acknowledged fragments */
+                ARSTREAM_NetworkHeaders_AckPacket_t newPacket = recvPacket;
+                int nbFragments = sender->currentFrameNbFragments;
+                uint32_t ackedBytes = 0;
+                uint32_t nbAcked = 0;
+                uint32_t nbLost = 0;
+                int highestAck = -1;
+                struct timespec now;
+                int i;
+                ARSTREAM_NetworkHeaders_AckPacketUnsetFlags (&newPacket, &(sender->ackPacket));
+                for (i = 0; i < nbFragments; i++)
+                {
+                    if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&newPacket, i) == 1)
+                    {
+                        ackedBytes += sender->currentFrameFragmentOffsets [i+1] - sender->currentFrameFragmentOffsets [i];
+                        if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->lostPackets), i) == 0)
+                        {
+                            nbAcked++;
+                        }
+                    }
+                    if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&recvPacket, i) == 1)
+                    {
+                        highestAck = i;
+                    }
+                }
+                /* Fragments are sent in order : the ones missing below the highest acknowledged fragment are lost */
+                for (i = 0; i < highestAck; i++)
+                {
+                    if ((ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&recvPacket, i) == 0) &&
+                        (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->ackPacket), i) == 0) &&
+                        (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->lostPackets), i) == 0))
+                    {
+                        ARSTREAM_NetworkHeaders_AckPacketSetFlag (&(sender->lostPackets), i);
+                        nbLost++;
+                    }
+                }
+                ARSTREAM_Clock_GetTime (&now);
+                ARSTREAM_RateControl_AckReceived (&(sender->rateControl), ackedBytes, &now);
+                ARSTREAM_RateControl_FragmentsAcked (&(sender->rateControl), nbAcked, nbLost);
+
                 ARSTREAM_NetworkHeaders_AckPacketSetFlags (&(sender->ackPacket), &recvPacket);
                 if ((sender->currentFrameCbWasCalled == 0) &&
                     (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&(sender->ackPacket), sender->currentFrameNbFragments) == 1))
@@ -1103,6 +2816,8 @@ void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param)
                 ARSTREAM_Sender_SendLateAck (sender, recvPacket.frameNumber);
             }
             ARSAL_Mutex_Unlock (&(sender->ackMutex));
+
+            ARSTREAM_Sender_UpdateRateControl (sender);
         }
     }
 
@@ -1144,6 +2859,18 @@ float ARSTREAM_Sender_GetEstimatedEfficiency (ARSTREAM_Sender_t *sender)
     return retVal;
 }
 
+uint32_t ARSTREAM_Sender_GetTargetBitrate (ARSTREAM_Sender_t *sender)
+{
+    uint32_t retVal = 0;
+    if (sender != NULL)
+    {
+        ARSAL_Mutex_Lock (&(sender->ackMutex));
+        retVal = ARSTREAM_RateControl_GetTargetBitrate (&(sender->rateControl));
+        ARSAL_Mutex_Unlock (&(sender->ackMutex));
+    }
+    return retVal;
+}
+
 void* ARSTREAM_Sender_GetCustom (ARSTREAM_Sender_t *sender)
 {
     void *ret = NULL;
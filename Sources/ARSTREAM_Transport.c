@@ -0,0 +1,278 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Transport.c
+ * @brief Transport layer used by the ARSTREAM_Sender_t and ARSTREAM_Reader_t
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Private Headers
+ */
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_TRANSPORT_TAG "ARSTREAM_Transport"
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Context of an ARNetwork transport
+ */
+typedef struct {
+    ARNETWORK_Manager_t *manager;
+    int dataBufferID;
+    int ackBufferID;
+} ARSTREAM_Transport_ARNetworkContext_t;
+
+/**
+ * @brief Custom data given to ARNetwork for a fragment with a send callback
+ */
+typedef struct {
+    ARSTREAM_Transport_SendCallback_t callback;
+    void *customData;
+} ARSTREAM_Transport_ARNetworkCallbackParam_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief ARNETWORK_Manager_Callback_t for the ARNetwork transport
+ * Forwards the SENT and CANCEL statuses to the ARSTREAM_Transport_SendCallback_t of the fragment, if any
+ * @param IoBufferId Unused
+ * @param dataPtr Unused
+ * @param customData An ARSTREAM_Transport_ARNetworkCallbackParam_t, or NULL
+ * @param status The fragment status
+ * @return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT
+ */
+static eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Transport_ARNetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status);
+
+/**
+ * @brief Reads an IOBuffer of the ARNetwork transport
+ * @param context The ARNetwork transport context
+ * @param bufferID The IOBuffer to read
+ * @param data The read buffer
+ * @param maxSize The read buffer size
+ * @param size Pointer which will hold the read size
+ * @param timeoutMs Maximum wait time
+ * @return ARSTREAM_OK, ARSTREAM_ERROR_TIMEOUT or ARSTREAM_ERROR_TRANSPORT
+ */
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkRead (ARSTREAM_Transport_ARNetworkContext_t *context, int bufferID, uint8_t *data, int maxSize, int *size, int timeoutMs);
+
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkSendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkReceiveFragment (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkSendAck (void *context, uint8_t *data, int size);
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkReceiveAck (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static void ARSTREAM_Transport_ARNetworkFlush (void *context);
+static int ARSTREAM_Transport_ARNetworkGetEstimatedLatency (void *context);
+static void ARSTREAM_Transport_ARNetworkDestroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Transport_ARNetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status)
+{
+    ARSTREAM_Transport_ARNetworkCallbackParam_t *cbParams = (ARSTREAM_Transport_ARNetworkCallbackParam_t *)customData;
+
+    /* Remove "unused parameter" warnings */
+    (void)IoBufferId;
+    (void)dataPtr;
+
+    if (cbParams == NULL)
+    {
+        return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT;
+    }
+
+    switch (status)
+    {
+    case ARNETWORK_MANAGER_CALLBACK_STATUS_SENT:
+        cbParams->callback (cbParams->customData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+        free (cbParams);
+        break;
+    case ARNETWORK_MANAGER_CALLBACK_STATUS_CANCEL:
+        cbParams->callback (cbParams->customData, ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+        free (cbParams);
+        break;
+    default:
+        break;
+    }
+    return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT;
+}
+
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkRead (ARSTREAM_Transport_ARNetworkContext_t *context, int bufferID, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    eARNETWORK_ERROR err = ARNETWORK_Manager_ReadDataWithTimeout (context->manager, bufferID, data, maxSize, size, timeoutMs);
+    if (err == ARNETWORK_ERROR_BUFFER_EMPTY)
+    {
+        return ARSTREAM_ERROR_TIMEOUT;
+    }
+    else if (err != ARNETWORK_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_TAG, "Error while reading buffer %d: %s", bufferID, ARNETWORK_Error_ToString (err));
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkSendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    ARSTREAM_Transport_ARNetworkContext_t *ctx = (ARSTREAM_Transport_ARNetworkContext_t *)context;
+    ARSTREAM_Transport_ARNetworkCallbackParam_t *cbParams = NULL;
+    eARNETWORK_ERROR err;
+
+    if (callback != NULL)
+    {
+        cbParams = malloc (sizeof (ARSTREAM_Transport_ARNetworkCallbackParam_t));
+        if (cbParams == NULL)
+        {
+            return ARSTREAM_ERROR_ALLOC;
+        }
+        cbParams->callback = callback;
+        cbParams->customData = customData;
+    }
+
+    err = ARNETWORK_Manager_SendData (ctx->manager, ctx->dataBufferID, data, size, (void *)cbParams, ARSTREAM_Transport_ARNetworkCallback, 1);
+    if (err != ARNETWORK_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_TAG, "Error while sending a fragment: %s", ARNETWORK_Error_ToString (err));
+        free (cbParams);
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkReceiveFragment (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    ARSTREAM_Transport_ARNetworkContext_t *ctx = (ARSTREAM_Transport_ARNetworkContext_t *)context;
+    return ARSTREAM_Transport_ARNetworkRead (ctx, ctx->dataBufferID, data, maxSize, size, timeoutMs);
+}
+
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkSendAck (void *context, uint8_t *data, int size)
+{
+    ARSTREAM_Transport_ARNetworkContext_t *ctx = (ARSTREAM_Transport_ARNetworkContext_t *)context;
+    eARNETWORK_ERROR err = ARNETWORK_Manager_SendData (ctx->manager, ctx->ackBufferID, data, size, NULL, ARSTREAM_Transport_ARNetworkCallback, 1);
+    if (err != ARNETWORK_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_TAG, "Error while sending an ack: %s", ARNETWORK_Error_ToString (err));
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_Transport_ARNetworkReceiveAck (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    ARSTREAM_Transport_ARNetworkContext_t *ctx = (ARSTREAM_Transport_ARNetworkContext_t *)context;
+    return ARSTREAM_Transport_ARNetworkRead (ctx, ctx->ackBufferID, data, maxSize, size, timeoutMs);
+}
+
+static void ARSTREAM_Transport_ARNetworkFlush (void *context)
+{
+    ARSTREAM_Transport_ARNetworkContext_t *ctx = (ARSTREAM_Transport_ARNetworkContext_t *)context;
+    ARNETWORK_Manager_FlushInputBuffer (ctx->manager, ctx->dataBufferID);
+}
+
+static int ARSTREAM_Transport_ARNetworkGetEstimatedLatency (void *context)
+{
+    ARSTREAM_Transport_ARNetworkContext_t *ctx = (ARSTREAM_Transport_ARNetworkContext_t *)context;
+    return ARNETWORK_Manager_GetEstimatedLatency (ctx->manager);
+}
+
+static void ARSTREAM_Transport_ARNetworkDestroy (void *context)
+{
+    free (context);
+}
+
+/*
+ * Implementation
+ */
+
+eARSTREAM_ERROR ARSTREAM_Transport_InitARNetwork (ARSTREAM_Transport_t *transport, ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID)
+{
+    ARSTREAM_Transport_ARNetworkContext_t *ctx;
+    if ((transport == NULL) ||
+        (manager == NULL))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    ctx = malloc (sizeof (ARSTREAM_Transport_ARNetworkContext_t));
+    if (ctx == NULL)
+    {
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    ctx->manager = manager;
+    ctx->dataBufferID = dataBufferID;
+    ctx->ackBufferID = ackBufferID;
+
+    transport->sendFragment = ARSTREAM_Transport_ARNetworkSendFragment;
+    transport->submit = NULL;
+    transport->receiveFragment = ARSTREAM_Transport_ARNetworkReceiveFragment;
+    transport->sendAck = ARSTREAM_Transport_ARNetworkSendAck;
+    transport->receiveAck = ARSTREAM_Transport_ARNetworkReceiveAck;
+    transport->flush = ARSTREAM_Transport_ARNetworkFlush;
+    transport->getEstimatedLatency = ARSTREAM_Transport_ARNetworkGetEstimatedLatency;
+    transport->destroy = ARSTREAM_Transport_ARNetworkDestroy;
+    transport->context = ctx;
+    return ARSTREAM_OK;
+}
+
+void ARSTREAM_Transport_Destroy (ARSTREAM_Transport_t *transport)
+{
+    if (transport == NULL)
+    {
+        return;
+    }
+    if (transport->destroy != NULL)
+    {
+        transport->destroy (transport->context);
+    }
+    memset (transport, 0, sizeof (ARSTREAM_Transport_t));
+}
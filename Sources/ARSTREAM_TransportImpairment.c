@@ -0,0 +1,761 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_TransportImpairment.c
+ * @brief Transport wrapper emulating packet loss, delay, reordering, duplication and bandwidth limits
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARStream/ARSTREAM_Clock.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_TRANSPORT_IMPAIRMENT_TAG "ARSTREAM_TransportImpairment"
+
+/**
+ * @brief Maximum number of delayed packets : newer packets are dropped as queue drops
+ */
+#define ARSTREAM_TRANSPORT_IMPAIRMENT_MAX_PENDING (65536)
+
+/**
+ * @brief Maximum number of due packets sent by the thread between two submits
+ */
+#define ARSTREAM_TRANSPORT_IMPAIRMENT_BATCH_SIZE (64)
+
+/**
+ * @brief Wait of the thread when no packet is delayed (a new head packet wakes it up)
+ */
+#define ARSTREAM_TRANSPORT_IMPAIRMENT_IDLE_WAIT_MS (100)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Kind of a packet : each kind has its own random streams
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_FRAGMENT = 0,
+    ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_ACK,
+    ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_MAX,
+} eARSTREAM_TRANSPORT_IMPAIRMENT_KIND;
+
+/**
+ * @brief Random draws of one packet
+ * All the draws are made for each packet, whatever the parameters, so that two
+ * configurations with the same seed see the same losses for the same packets.
+ */
+typedef struct {
+    int lost;
+    double jitter; // In [-1, 1]
+    int reordered;
+    int duplicated;
+} ARSTREAM_TransportImpairment_Draws_t;
+
+/**
+ * @brief Delayed packet
+ */
+typedef struct {
+    uint64_t dueUs;
+    uint64_t order; // Tie-break between packets due at the same time (FIFO)
+    eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind;
+    int size;
+    uint8_t data [];
+} ARSTREAM_TransportImpairment_Packet_t;
+
+/**
+ * @brief Context of an impairment transport
+ * Everything after the mutex is protected by it.
+ */
+typedef struct {
+    ARSTREAM_Transport_t inner;
+    ARSTREAM_Transport_ImpairmentParams_t params;
+    int passThrough; // No packet is ever delayed
+
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t cond;
+    uint64_t rng [ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_MAX];
+    int badState [ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_MAX];
+    uint64_t linkFreeUs; // Time at which the bandwidth limited link is idle
+    ARSTREAM_TransportImpairment_Packet_t **heap; // Min-heap on (dueUs, order)
+    int heapSize;
+    int heapCapacity;
+    uint64_t nextOrder;
+    ARSTREAM_Transport_ImpairmentStats_t stats;
+    int threadStarted;
+    int threadShouldStop;
+} ARSTREAM_TransportImpairment_Context_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Gets the next value of a xorshift64* random stream
+ */
+static uint64_t ARSTREAM_TransportImpairment_Random (uint64_t *state);
+
+/**
+ * @brief Gets a random value in [0, 1[
+ */
+static double ARSTREAM_TransportImpairment_RandomUnit (uint64_t *state);
+
+/**
+ * @brief Makes the random draws of a packet
+ * @note Must be called with the mutex locked
+ */
+static void ARSTREAM_TransportImpairment_Draw (ARSTREAM_TransportImpairment_Context_t *ctx, eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind, ARSTREAM_TransportImpairment_Draws_t *draws);
+
+/**
+ * @brief Compares two delayed packets
+ * @return 1 if a must be sent before b
+ */
+static int ARSTREAM_TransportImpairment_IsBefore (const ARSTREAM_TransportImpairment_Packet_t *a, const ARSTREAM_TransportImpairment_Packet_t *b);
+
+/**
+ * @brief Adds a copy of a packet to the heap
+ * @note Must be called with the mutex locked
+ * @return 1 if added, 0 if the heap is full or on allocation error
+ */
+static int ARSTREAM_TransportImpairment_Push (ARSTREAM_TransportImpairment_Context_t *ctx, eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind, const uint8_t *data, int size, uint64_t dueUs);
+
+/**
+ * @brief Removes the first packet of the heap
+ * @note Must be called with the mutex locked, on a non empty heap
+ */
+static ARSTREAM_TransportImpairment_Packet_t* ARSTREAM_TransportImpairment_Pop (ARSTREAM_TransportImpairment_Context_t *ctx);
+
+/**
+ * @brief Restores the heap order below a position
+ */
+static void ARSTREAM_TransportImpairment_SiftDown (ARSTREAM_TransportImpairment_Context_t *ctx, int pos);
+
+/**
+ * @brief Gives a packet to the inner transport
+ */
+static void ARSTREAM_TransportImpairment_SendInner (ARSTREAM_TransportImpairment_Context_t *ctx, eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+
+/**
+ * @brief Applies the impairments to an outgoing packet
+ */
+static void ARSTREAM_TransportImpairment_Send (ARSTREAM_TransportImpairment_Context_t *ctx, eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+
+static eARSTREAM_ERROR ARSTREAM_TransportImpairment_SendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+static void ARSTREAM_TransportImpairment_Submit (void *context);
+static eARSTREAM_ERROR ARSTREAM_TransportImpairment_ReceiveFragment (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_TransportImpairment_SendAck (void *context, uint8_t *data, int size);
+static eARSTREAM_ERROR ARSTREAM_TransportImpairment_ReceiveAck (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static void ARSTREAM_TransportImpairment_Flush (void *context);
+static int ARSTREAM_TransportImpairment_GetEstimatedLatency (void *context);
+static void ARSTREAM_TransportImpairment_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static uint64_t ARSTREAM_TransportImpairment_Random (uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static double ARSTREAM_TransportImpairment_RandomUnit (uint64_t *state)
+{
+    return (double)(ARSTREAM_TransportImpairment_Random (state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void ARSTREAM_TransportImpairment_Draw (ARSTREAM_TransportImpairment_Context_t *ctx, eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind, ARSTREAM_TransportImpairment_Draws_t *draws)
+{
+    const ARSTREAM_Transport_ImpairmentParams_t *params = &(ctx->params);
+    uint64_t *state = &(ctx->rng[kind]);
+    double transition = ARSTREAM_TransportImpairment_RandomUnit (state);
+    double loss = ARSTREAM_TransportImpairment_RandomUnit (state);
+    double jitter = ARSTREAM_TransportImpairment_RandomUnit (state);
+    double reorder = ARSTREAM_TransportImpairment_RandomUnit (state);
+    double duplicate = ARSTREAM_TransportImpairment_RandomUnit (state);
+
+    switch (params->lossModel)
+    {
+    case ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_BERNOULLI:
+        draws->lost = (loss < params->lossRate) ? 1 : 0;
+        break;
+    case ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_GILBERT_ELLIOTT:
+        if (ctx->badState[kind] == 0)
+        {
+            ctx->badState[kind] = (transition < params->goodToBadRate) ? 1 : 0;
+        }
+        else
+        {
+            ctx->badState[kind] = (transition < params->badToGoodRate) ? 0 : 1;
+        }
+        draws->lost = (loss < ((ctx->badState[kind] == 1) ? params->badLossRate : params->goodLossRate)) ? 1 : 0;
+        break;
+    default:
+        draws->lost = 0;
+        break;
+    }
+    draws->jitter = 2.0 * jitter - 1.0;
+    draws->reordered = (reorder < params->reorderRate) ? 1 : 0;
+    draws->duplicated = (duplicate < params->duplicateRate) ? 1 : 0;
+}
+
+static int ARSTREAM_TransportImpairment_IsBefore (const ARSTREAM_TransportImpairment_Packet_t *a, const ARSTREAM_TransportImpairment_Packet_t *b)
+{
+    if (a->dueUs != b->dueUs)
+    {
+        return (a->dueUs < b->dueUs) ? 1 : 0;
+    }
+    return (a->order < b->order) ? 1 : 0;
+}
+
+static int ARSTREAM_TransportImpairment_Push (ARSTREAM_TransportImpairment_Context_t *ctx, eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind, const uint8_t *data, int size, uint64_t dueUs)
+{
+    ARSTREAM_TransportImpairment_Packet_t *packet;
+    int pos;
+
+    if (ctx->heapSize >= ARSTREAM_TRANSPORT_IMPAIRMENT_MAX_PENDING)
+    {
+        return 0;
+    }
+    if (ctx->heapSize == ctx->heapCapacity)
+    {
+        int newCapacity = (ctx->heapCapacity == 0) ? 256 : (2 * ctx->heapCapacity);
+        ARSTREAM_TransportImpairment_Packet_t **newHeap = realloc (ctx->heap, newCapacity * sizeof (ARSTREAM_TransportImpairment_Packet_t *));
+        if (newHeap == NULL)
+        {
+            return 0;
+        }
+        ctx->heap = newHeap;
+        ctx->heapCapacity = newCapacity;
+    }
+    packet = malloc (sizeof (ARSTREAM_TransportImpairment_Packet_t) + size);
+    if (packet == NULL)
+    {
+        return 0;
+    }
+    packet->dueUs = dueUs;
+    packet->order = ctx->nextOrder++;
+    packet->kind = kind;
+    packet->size = size;
+    memcpy (packet->data, data, size);
+
+    /* Sift up */
+    pos = ctx->heapSize++;
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (ARSTREAM_TransportImpairment_IsBefore (packet, ctx->heap[parent]) == 0)
+        {
+            break;
+        }
+        ctx->heap[pos] = ctx->heap[parent];
+        pos = parent;
+    }
+    ctx->heap[pos] = packet;
+    return 1;
+}
+
+static void ARSTREAM_TransportImpairment_SiftDown (ARSTREAM_TransportImpairment_Context_t *ctx, int pos)
+{
+    ARSTREAM_TransportImpairment_Packet_t *packet = ctx->heap[pos];
+    for (;;)
+    {
+        int child = 2 * pos + 1;
+        if (child >= ctx->heapSize)
+        {
+            break;
+        }
+        if ((child + 1 < ctx->heapSize) &&
+            (ARSTREAM_TransportImpairment_IsBefore (ctx->heap[child + 1], ctx->heap[child]) == 1))
+        {
+            child++;
+        }
+        if (ARSTREAM_TransportImpairment_IsBefore (ctx->heap[child], packet) == 0)
+        {
+            break;
+        }
+        ctx->heap[pos] = ctx->heap[child];
+        pos = child;
+    }
+    ctx->heap[pos] = packet;
+}
+
+static ARSTREAM_TransportImpairment_Packet_t* ARSTREAM_TransportImpairment_Pop (ARSTREAM_TransportImpairment_Context_t *ctx)
+{
+    ARSTREAM_TransportImpairment_Packet_t *first = ctx->heap[0];
+    ctx->heapSize--;
+    if (ctx->heapSize > 0)
+    {
+        ctx->heap[0] = ctx->heap[ctx->heapSize];
+        ARSTREAM_TransportImpairment_SiftDown (ctx, 0);
+    }
+    return first;
+}
+
+static void ARSTREAM_TransportImpairment_SendInner (ARSTREAM_TransportImpairment_Context_t *ctx, eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    eARSTREAM_ERROR err;
+    if (kind == ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_ACK)
+    {
+        err = ctx->inner.sendAck (ctx->inner.context, data, size);
+    }
+    else
+    {
+        err = ctx->inner.sendFragment (ctx->inner.context, data, size, customData, callback);
+    }
+    if (err != ARSTREAM_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_TRANSPORT_IMPAIRMENT_TAG, "Inner transport failed to send a packet: %s", ARSTREAM_Error_ToString (err));
+        if (callback != NULL)
+        {
+            callback (customData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+        }
+    }
+}
+
+static void ARSTREAM_TransportImpairment_Send (ARSTREAM_TransportImpairment_Context_t *ctx, eARSTREAM_TRANSPORT_IMPAIRMENT_KIND kind, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    const ARSTREAM_Transport_ImpairmentParams_t *params = &(ctx->params);
+    ARSTREAM_TransportImpairment_Draws_t draws;
+    uint64_t nowUs, dueUs;
+    int64_t delayUs;
+    int wakeUp = 0;
+    int nbCopies, i;
+
+    ARSAL_Mutex_Lock (&(ctx->mutex));
+    ctx->stats.nbPackets++;
+    ARSTREAM_TransportImpairment_Draw (ctx, kind, &draws);
+    if (draws.lost == 1)
+    {
+        ctx->stats.nbLost++;
+        ARSAL_Mutex_Unlock (&(ctx->mutex));
+        /* Lost on the wire : the packet left the sender */
+        if (callback != NULL)
+        {
+            callback (customData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+        }
+        return;
+    }
+    nbCopies = (draws.duplicated == 1) ? 2 : 1;
+    if (draws.duplicated == 1)
+    {
+        ctx->stats.nbDuplicated++;
+    }
+
+    if (ctx->passThrough == 1)
+    {
+        ARSAL_Mutex_Unlock (&(ctx->mutex));
+        /* The duplicate first : the callback may release the data */
+        if (nbCopies == 2)
+        {
+            ARSTREAM_TransportImpairment_SendInner (ctx, kind, data, size, NULL, NULL);
+        }
+        ARSTREAM_TransportImpairment_SendInner (ctx, kind, data, size, customData, callback);
+        return;
+    }
+
+    nowUs = ARSTREAM_Clock_GetTimeUs ();
+    dueUs = nowUs;
+    if (params->bandwidthKbps > 0)
+    {
+        uint64_t startUs = (ctx->linkFreeUs > nowUs) ? ctx->linkFreeUs : nowUs;
+        if (startUs - nowUs > (uint64_t)params->queueLimitMs * 1000)
+        {
+            ctx->stats.nbQueueDropped++;
+            nbCopies = 0;
+        }
+        else
+        {
+            /* bits * 1000 / kbps = microseconds on the link */
+            ctx->linkFreeUs = startUs + ((uint64_t)size * 8 * 1000) / params->bandwidthKbps;
+            dueUs = ctx->linkFreeUs;
+        }
+    }
+    delayUs = (int64_t)params->delayMs * 1000 + (int64_t)(draws.jitter * params->jitterMs * 1000);
+    if (delayUs > 0)
+    {
+        dueUs += delayUs;
+    }
+    if ((nbCopies > 0) &&
+        (draws.reordered == 1))
+    {
+        ctx->stats.nbReordered++;
+        dueUs += (uint64_t)params->reorderDelayMs * 1000;
+    }
+    for (i = 0; i < nbCopies; i++)
+    {
+        if (ARSTREAM_TransportImpairment_Push (ctx, kind, data, size, dueUs) == 0)
+        {
+            ctx->stats.nbQueueDropped++;
+        }
+        else if (ctx->heap[0]->order == ctx->nextOrder - 1)
+        {
+            /* New first packet : the thread may sleep until a later time */
+            wakeUp = 1;
+        }
+    }
+    if (wakeUp == 1)
+    {
+        ARSTREAM_Clock_CondSignal (&(ctx->cond));
+    }
+    ARSAL_Mutex_Unlock (&(ctx->mutex));
+
+    if (callback != NULL)
+    {
+        callback (customData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+    }
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportImpairment_SendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx = (ARSTREAM_TransportImpairment_Context_t *)context;
+    if ((data == NULL) ||
+        (size < 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    ARSTREAM_TransportImpairment_Send (ctx, ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_FRAGMENT, data, size, customData, callback);
+    return ARSTREAM_OK;
+}
+
+static void ARSTREAM_TransportImpairment_Submit (void *context)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx = (ARSTREAM_TransportImpairment_Context_t *)context;
+    if (ctx->inner.submit != NULL)
+    {
+        ctx->inner.submit (ctx->inner.context);
+    }
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportImpairment_ReceiveFragment (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx = (ARSTREAM_TransportImpairment_Context_t *)context;
+    return ctx->inner.receiveFragment (ctx->inner.context, data, maxSize, size, timeoutMs);
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportImpairment_SendAck (void *context, uint8_t *data, int size)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx = (ARSTREAM_TransportImpairment_Context_t *)context;
+    if ((data == NULL) ||
+        (size < 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    ARSTREAM_TransportImpairment_Send (ctx, ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_ACK, data, size, NULL, NULL);
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportImpairment_ReceiveAck (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx = (ARSTREAM_TransportImpairment_Context_t *)context;
+    return ctx->inner.receiveAck (ctx->inner.context, data, maxSize, size, timeoutMs);
+}
+
+static void ARSTREAM_TransportImpairment_Flush (void *context)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx = (ARSTREAM_TransportImpairment_Context_t *)context;
+    int i, kept = 0;
+
+    /* Drop the delayed fragments (their callbacks were already called), keep the acks */
+    ARSAL_Mutex_Lock (&(ctx->mutex));
+    for (i = 0; i < ctx->heapSize; i++)
+    {
+        if (ctx->heap[i]->kind == ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_FRAGMENT)
+        {
+            free (ctx->heap[i]);
+        }
+        else
+        {
+            ctx->heap[kept++] = ctx->heap[i];
+        }
+    }
+    ctx->heapSize = kept;
+    for (i = kept / 2 - 1; i >= 0; i--)
+    {
+        ARSTREAM_TransportImpairment_SiftDown (ctx, i);
+    }
+    ARSAL_Mutex_Unlock (&(ctx->mutex));
+
+    if (ctx->inner.flush != NULL)
+    {
+        ctx->inner.flush (ctx->inner.context);
+    }
+}
+
+static int ARSTREAM_TransportImpairment_GetEstimatedLatency (void *context)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx = (ARSTREAM_TransportImpairment_Context_t *)context;
+    int latency = ctx->inner.getEstimatedLatency (ctx->inner.context);
+    if (latency < 0)
+    {
+        return latency;
+    }
+    return latency + ctx->params.delayMs;
+}
+
+static void ARSTREAM_TransportImpairment_Destroy (void *context)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx = (ARSTREAM_TransportImpairment_Context_t *)context;
+    int i;
+
+    if (ctx == NULL)
+    {
+        return;
+    }
+    if (ctx->threadStarted == 1)
+    {
+        /* Freeing would crash the thread : leak instead */
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_IMPAIRMENT_TAG, "Destroying an impairment transport while its thread is running, call ARSTREAM_Transport_StopImpairment() and join the thread first");
+        return;
+    }
+    for (i = 0; i < ctx->heapSize; i++)
+    {
+        free (ctx->heap[i]);
+    }
+    free (ctx->heap);
+    ARSAL_Cond_Destroy (&(ctx->cond));
+    ARSAL_Mutex_Destroy (&(ctx->mutex));
+    ARSTREAM_Transport_Destroy (&(ctx->inner));
+    free (ctx);
+}
+
+/*
+ * Implementation
+ */
+
+void ARSTREAM_Transport_ImpairmentParamsDefaultInit (ARSTREAM_Transport_ImpairmentParams_t *params)
+{
+    if (params != NULL)
+    {
+        memset (params, 0, sizeof (ARSTREAM_Transport_ImpairmentParams_t));
+        params->lossModel = ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_NONE;
+        params->queueLimitMs = ARSTREAM_TRANSPORT_IMPAIRMENT_DEFAULT_QUEUE_LIMIT_MS;
+    }
+}
+
+eARSTREAM_ERROR ARSTREAM_Transport_InitImpairment (ARSTREAM_Transport_t *transport, const ARSTREAM_Transport_t *inner, const ARSTREAM_Transport_ImpairmentParams_t *params)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx;
+    uint64_t seed;
+    int i;
+
+    /* ARGS Check */
+    if ((transport == NULL) ||
+        (inner == NULL) ||
+        ((inner->sendFragment == NULL) && (inner->sendAck == NULL)) ||
+        (params == NULL) ||
+        (params->lossModel < 0) ||
+        (params->lossModel >= ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_MAX) ||
+        /* Written to also reject NaN */
+        !((params->lossRate >= 0.0) && (params->lossRate <= 1.0)) ||
+        !((params->goodToBadRate >= 0.0) && (params->goodToBadRate <= 1.0)) ||
+        !((params->badToGoodRate >= 0.0) && (params->badToGoodRate <= 1.0)) ||
+        !((params->goodLossRate >= 0.0) && (params->goodLossRate <= 1.0)) ||
+        !((params->badLossRate >= 0.0) && (params->badLossRate <= 1.0)) ||
+        !((params->reorderRate >= 0.0) && (params->reorderRate <= 1.0)) ||
+        !((params->duplicateRate >= 0.0) && (params->duplicateRate <= 1.0)) ||
+        (params->delayMs < 0) ||
+        (params->jitterMs < 0) ||
+        (params->reorderDelayMs < 0) ||
+        (params->bandwidthKbps < 0) ||
+        (params->queueLimitMs < 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    ctx = calloc (1, sizeof (ARSTREAM_TransportImpairment_Context_t));
+    if (ctx == NULL)
+    {
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    if (ARSAL_Mutex_Init (&(ctx->mutex)) != 0)
+    {
+        free (ctx);
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    if (ARSAL_Cond_Init (&(ctx->cond)) != 0)
+    {
+        ARSAL_Mutex_Destroy (&(ctx->mutex));
+        free (ctx);
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    ctx->inner = *inner;
+    ctx->params = *params;
+    ctx->passThrough = ((params->delayMs == 0) &&
+                        (params->jitterMs == 0) &&
+                        ((params->reorderRate == 0.0) || (params->reorderDelayMs == 0)) &&
+                        (params->bandwidthKbps == 0)) ? 1 : 0;
+
+    /* One splitmix64 seeded stream per packet kind */
+    seed = params->seed;
+    for (i = 0; i < ARSTREAM_TRANSPORT_IMPAIRMENT_KIND_MAX; i++)
+    {
+        uint64_t z;
+        seed += 0x9E3779B97F4A7C15ULL;
+        z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        ctx->rng[i] = (z != 0) ? z : 1;
+    }
+
+    /* inner may be transport itself : it was copied above */
+    transport->sendFragment = (ctx->inner.sendFragment != NULL) ? ARSTREAM_TransportImpairment_SendFragment : NULL;
+    transport->submit = ARSTREAM_TransportImpairment_Submit;
+    transport->receiveFragment = (ctx->inner.receiveFragment != NULL) ? ARSTREAM_TransportImpairment_ReceiveFragment : NULL;
+    transport->sendAck = (ctx->inner.sendAck != NULL) ? ARSTREAM_TransportImpairment_SendAck : NULL;
+    transport->receiveAck = (ctx->inner.receiveAck != NULL) ? ARSTREAM_TransportImpairment_ReceiveAck : NULL;
+    transport->flush = ARSTREAM_TransportImpairment_Flush;
+    transport->getEstimatedLatency = (ctx->inner.getEstimatedLatency != NULL) ? ARSTREAM_TransportImpairment_GetEstimatedLatency : NULL;
+    transport->destroy = ARSTREAM_TransportImpairment_Destroy;
+    transport->context = ctx;
+    return ARSTREAM_OK;
+}
+
+void* ARSTREAM_Transport_RunImpairmentThread (void *ARSTREAM_Transport_t_Param)
+{
+    ARSTREAM_Transport_t *transport = (ARSTREAM_Transport_t *)ARSTREAM_Transport_t_Param;
+    ARSTREAM_TransportImpairment_Context_t *ctx;
+    ARSTREAM_TransportImpairment_Packet_t *batch [ARSTREAM_TRANSPORT_IMPAIRMENT_BATCH_SIZE];
+
+    if ((transport == NULL) ||
+        (transport->destroy != ARSTREAM_TransportImpairment_Destroy) ||
+        (transport->context == NULL))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_IMPAIRMENT_TAG, "Bad parameter, not an impairment transport");
+        return (void *)0;
+    }
+    /* Keep the context : ARSTREAM_Transport_Destroy() clears the transport */
+    ctx = (ARSTREAM_TransportImpairment_Context_t *)transport->context;
+
+    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_TRANSPORT_IMPAIRMENT_TAG, "Impairment thread running");
+    ARSAL_Mutex_Lock (&(ctx->mutex));
+    ctx->threadStarted = 1;
+    while (ctx->threadShouldStop == 0)
+    {
+        uint64_t nowUs = ARSTREAM_Clock_GetTimeUs ();
+        int nbDue = 0;
+        int i;
+
+        while ((ctx->heapSize > 0) &&
+               (ctx->heap[0]->dueUs <= nowUs) &&
+               (nbDue < ARSTREAM_TRANSPORT_IMPAIRMENT_BATCH_SIZE))
+        {
+            batch[nbDue++] = ARSTREAM_TransportImpairment_Pop (ctx);
+        }
+
+        if (nbDue > 0)
+        {
+            ARSAL_Mutex_Unlock (&(ctx->mutex));
+            for (i = 0; i < nbDue; i++)
+            {
+                ARSTREAM_TransportImpairment_SendInner (ctx, batch[i]->kind, batch[i]->data, batch[i]->size, NULL, NULL);
+                free (batch[i]);
+            }
+            if (ctx->inner.submit != NULL)
+            {
+                ctx->inner.submit (ctx->inner.context);
+            }
+            ARSAL_Mutex_Lock (&(ctx->mutex));
+        }
+        else if (ctx->heapSize > 0)
+        {
+            /* Round up : waking up early would only spin */
+            int waitMs = (int)((ctx->heap[0]->dueUs - nowUs + 999) / 1000);
+            ARSTREAM_Clock_CondWait (&(ctx->cond), &(ctx->mutex), waitMs);
+        }
+        else
+        {
+            ARSTREAM_Clock_CondWait (&(ctx->cond), &(ctx->mutex), ARSTREAM_TRANSPORT_IMPAIRMENT_IDLE_WAIT_MS);
+        }
+    }
+    ctx->threadStarted = 0;
+    ARSAL_Mutex_Unlock (&(ctx->mutex));
+    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_TRANSPORT_IMPAIRMENT_TAG, "Impairment thread ended");
+
+    return (void *)0;
+}
+
+void ARSTREAM_Transport_StopImpairment (ARSTREAM_Transport_t *transport)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx;
+    if ((transport == NULL) ||
+        (transport->destroy != ARSTREAM_TransportImpairment_Destroy) ||
+        (transport->context == NULL))
+    {
+        return;
+    }
+    ctx = (ARSTREAM_TransportImpairment_Context_t *)transport->context;
+    ARSAL_Mutex_Lock (&(ctx->mutex));
+    ctx->threadShouldStop = 1;
+    ARSTREAM_Clock_CondSignal (&(ctx->cond));
+    ARSAL_Mutex_Unlock (&(ctx->mutex));
+}
+
+eARSTREAM_ERROR ARSTREAM_Transport_GetImpairmentStats (const ARSTREAM_Transport_t *transport, ARSTREAM_Transport_ImpairmentStats_t *stats)
+{
+    ARSTREAM_TransportImpairment_Context_t *ctx;
+
+    /* ARGS Check */
+    if ((transport == NULL) ||
+        (transport->destroy != ARSTREAM_TransportImpairment_Destroy) ||
+        (transport->context == NULL) ||
+        (stats == NULL))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    ctx = (ARSTREAM_TransportImpairment_Context_t *)transport->context;
+    ARSAL_Mutex_Lock (&(ctx->mutex));
+    *stats = ctx->stats;
+    ARSAL_Mutex_Unlock (&(ctx->mutex));
+    return ARSTREAM_OK;
+}
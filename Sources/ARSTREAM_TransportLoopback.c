@@ -0,0 +1,497 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_TransportLoopback.c
+ * @brief In-process transport between a sender and a reader, through lock-free queues
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_Buffers.h"
+#include "ARSTREAM_NetworkHeaders.h"
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARStream/ARSTREAM_Clock.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_TRANSPORT_LOOPBACK_TAG "ARSTREAM_TransportLoopback"
+
+/**
+ * @brief Maximum number of slots of a queue
+ */
+#define ARSTREAM_TRANSPORT_LOOPBACK_MAX_SLOTS (65536)
+
+/**
+ * @brief Padding between the producer and consumer indexes, to avoid false sharing
+ */
+#define ARSTREAM_TRANSPORT_LOOPBACK_CACHE_LINE (64)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Slot of a queue
+ * sequence is the ticket of the slot : equal to the position when the slot is
+ * free for the producer of this position, to the position + 1 once filled.
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t size;
+    uint8_t *data;
+} ARSTREAM_TransportLoopback_Cell_t;
+
+/**
+ * @brief Bounded multi-producer / single-consumer lock-free queue (one per direction)
+ * The mutex and condition are only used by a consumer which has to sleep.
+ */
+typedef struct {
+    ARSTREAM_TransportLoopback_Cell_t *cells;
+    uint8_t *buffers;
+    uint32_t mask;
+    uint32_t enqueuePos;
+    uint8_t pad1 [ARSTREAM_TRANSPORT_LOOPBACK_CACHE_LINE - sizeof (uint32_t)];
+    uint32_t dequeuePos; // Consumer only
+    int consumerWaiting;
+    uint8_t pad2 [ARSTREAM_TRANSPORT_LOOPBACK_CACHE_LINE - sizeof (uint32_t) - sizeof (int)];
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t cond;
+    int mutexWasInit;
+    int condWasInit;
+    ARSTREAM_Transport_LoopbackStats_t stats; // Updated atomically
+} ARSTREAM_TransportLoopback_Queue_t;
+
+struct ARSTREAM_TransportLoopback_Pair_t;
+
+/**
+ * @brief Context of one transport of the pair
+ */
+typedef struct {
+    struct ARSTREAM_TransportLoopback_Pair_t *pair;
+    eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION outDirection;
+} ARSTREAM_TransportLoopback_Side_t;
+
+/**
+ * @brief Shared state of a transport pair
+ */
+typedef struct ARSTREAM_TransportLoopback_Pair_t {
+    ARSTREAM_TransportLoopback_Queue_t queues [ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX];
+    ARSTREAM_TransportLoopback_Side_t sides [ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX];
+    uint32_t slotSize;
+    ARSTREAM_Transport_LoopbackHook_t hook;
+    void *hookCustomData;
+    int refCount; // Number of transports not destroyed yet
+} ARSTREAM_TransportLoopback_Pair_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Initializes a queue
+ * @return ARSTREAM_OK or ARSTREAM_ERROR_ALLOC
+ */
+static eARSTREAM_ERROR ARSTREAM_TransportLoopback_QueueInit (ARSTREAM_TransportLoopback_Queue_t *queue, uint32_t nbSlots, uint32_t slotSize);
+
+/**
+ * @brief Releases a queue (also a partially initialized one)
+ */
+static void ARSTREAM_TransportLoopback_QueueDestroy (ARSTREAM_TransportLoopback_Queue_t *queue);
+
+/**
+ * @brief Copies a packet into a queue
+ * @return 1 if queued, 0 if the queue is full
+ */
+static int ARSTREAM_TransportLoopback_Enqueue (ARSTREAM_TransportLoopback_Queue_t *queue, const uint8_t *data, int size);
+
+/**
+ * @brief Copies the first packet out of a queue
+ * @return 1 if a packet was read, 0 if the queue is empty, -1 if the packet is larger than maxSize (it is dropped)
+ */
+static int ARSTREAM_TransportLoopback_Dequeue (ARSTREAM_TransportLoopback_Queue_t *queue, uint8_t *data, int maxSize, int *size);
+
+/**
+ * @brief Sends a packet in the out direction of a side
+ */
+static void ARSTREAM_TransportLoopback_Send (ARSTREAM_TransportLoopback_Side_t *side, const uint8_t *data, int size);
+
+static eARSTREAM_ERROR ARSTREAM_TransportLoopback_SendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+static eARSTREAM_ERROR ARSTREAM_TransportLoopback_ReceivePacket (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_TransportLoopback_SendAck (void *context, uint8_t *data, int size);
+static int ARSTREAM_TransportLoopback_GetEstimatedLatency (void *context);
+static void ARSTREAM_TransportLoopback_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static eARSTREAM_ERROR ARSTREAM_TransportLoopback_QueueInit (ARSTREAM_TransportLoopback_Queue_t *queue, uint32_t nbSlots, uint32_t slotSize)
+{
+    uint32_t i;
+
+    queue->cells = calloc (nbSlots, sizeof (ARSTREAM_TransportLoopback_Cell_t));
+    queue->buffers = malloc ((size_t)nbSlots * slotSize);
+    if ((queue->cells == NULL) ||
+        (queue->buffers == NULL))
+    {
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    if (ARSAL_Mutex_Init (&(queue->mutex)) != 0)
+    {
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    queue->mutexWasInit = 1;
+    if (ARSAL_Cond_Init (&(queue->cond)) != 0)
+    {
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    queue->condWasInit = 1;
+
+    for (i = 0; i < nbSlots; i++)
+    {
+        queue->cells[i].sequence = i;
+        queue->cells[i].data = &(queue->buffers[(size_t)i * slotSize]);
+    }
+    queue->mask = nbSlots - 1;
+    return ARSTREAM_OK;
+}
+
+static void ARSTREAM_TransportLoopback_QueueDestroy (ARSTREAM_TransportLoopback_Queue_t *queue)
+{
+    if (queue->condWasInit == 1)
+    {
+        ARSAL_Cond_Destroy (&(queue->cond));
+    }
+    if (queue->mutexWasInit == 1)
+    {
+        ARSAL_Mutex_Destroy (&(queue->mutex));
+    }
+    free (queue->cells);
+    free (queue->buffers);
+}
+
+static int ARSTREAM_TransportLoopback_Enqueue (ARSTREAM_TransportLoopback_Queue_t *queue, const uint8_t *data, int size)
+{
+    ARSTREAM_TransportLoopback_Cell_t *cell;
+    uint32_t pos = __atomic_load_n (&(queue->enqueuePos), __ATOMIC_RELAXED);
+
+    /* Claim a position */
+    for (;;)
+    {
+        int32_t diff;
+        cell = &(queue->cells[pos & queue->mask]);
+        diff = (int32_t)(__atomic_load_n (&(cell->sequence), __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n (&(queue->enqueuePos), &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = __atomic_load_n (&(queue->enqueuePos), __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy (cell->data, data, size);
+    cell->size = size;
+    /* Sequentially consistent, paired with the consumerWaiting store of the consumer */
+    __atomic_store_n (&(cell->sequence), pos + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n (&(queue->consumerWaiting), __ATOMIC_SEQ_CST) != 0)
+    {
+        ARSAL_Mutex_Lock (&(queue->mutex));
+        ARSTREAM_Clock_CondSignal (&(queue->cond));
+        ARSAL_Mutex_Unlock (&(queue->mutex));
+    }
+    return 1;
+}
+
+static int ARSTREAM_TransportLoopback_Dequeue (ARSTREAM_TransportLoopback_Queue_t *queue, uint8_t *data, int maxSize, int *size)
+{
+    uint32_t pos = queue->dequeuePos;
+    ARSTREAM_TransportLoopback_Cell_t *cell = &(queue->cells[pos & queue->mask]);
+    int retVal = 1;
+
+    if (__atomic_load_n (&(cell->sequence), __ATOMIC_SEQ_CST) != pos + 1)
+    {
+        return 0;
+    }
+    if (cell->size > (uint32_t)maxSize)
+    {
+        retVal = -1;
+    }
+    else
+    {
+        memcpy (data, cell->data, cell->size);
+        *size = cell->size;
+    }
+    /* Free the slot for the producer of the next lap */
+    __atomic_store_n (&(cell->sequence), pos + queue->mask + 1, __ATOMIC_RELEASE);
+    queue->dequeuePos = pos + 1;
+    return retVal;
+}
+
+static void ARSTREAM_TransportLoopback_Send (ARSTREAM_TransportLoopback_Side_t *side, const uint8_t *data, int size)
+{
+    ARSTREAM_TransportLoopback_Pair_t *pair = side->pair;
+    ARSTREAM_TransportLoopback_Queue_t *queue = &(pair->queues[side->outDirection]);
+
+    if ((pair->hook != NULL) &&
+        (pair->hook (pair->hookCustomData, side->outDirection, data, size) == 0))
+    {
+        __atomic_fetch_add (&(queue->stats.nbHookDropped), 1, __ATOMIC_RELAXED);
+    }
+    else if (ARSTREAM_TransportLoopback_Enqueue (queue, data, size) == 0)
+    {
+        __atomic_fetch_add (&(queue->stats.nbOverflowDropped), 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_fetch_add (&(queue->stats.nbPackets), 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add (&(queue->stats.nbBytes), (uint64_t)size, __ATOMIC_RELAXED);
+    }
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportLoopback_SendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    ARSTREAM_TransportLoopback_Side_t *side = (ARSTREAM_TransportLoopback_Side_t *)context;
+    if ((size < 0) ||
+        ((uint32_t)size > side->pair->slotSize))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    ARSTREAM_TransportLoopback_Send (side, data, size);
+    if (callback != NULL)
+    {
+        callback (customData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportLoopback_ReceivePacket (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    ARSTREAM_TransportLoopback_Side_t *side = (ARSTREAM_TransportLoopback_Side_t *)context;
+    eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION inDirection = (side->outDirection == ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_DATA) ? ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_ACK : ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_DATA;
+    ARSTREAM_TransportLoopback_Queue_t *queue = &(side->pair->queues[inDirection]);
+    int ret = ARSTREAM_TransportLoopback_Dequeue (queue, data, maxSize, size);
+
+    if (ret == 0)
+    {
+        int waitRet = 0;
+        /* Announce the wait, then check again : a producer signals after publishing if it sees the flag */
+        ARSAL_Mutex_Lock (&(queue->mutex));
+        __atomic_store_n (&(queue->consumerWaiting), 1, __ATOMIC_SEQ_CST);
+        ret = ARSTREAM_TransportLoopback_Dequeue (queue, data, maxSize, size);
+        /* A signal can be stale (sent for a packet read by the check above) : wait again */
+        while ((ret == 0) &&
+               (waitRet == 0))
+        {
+            waitRet = ARSTREAM_Clock_CondWait (&(queue->cond), &(queue->mutex), timeoutMs);
+            ret = ARSTREAM_TransportLoopback_Dequeue (queue, data, maxSize, size);
+        }
+        __atomic_store_n (&(queue->consumerWaiting), 0, __ATOMIC_RELAXED);
+        ARSAL_Mutex_Unlock (&(queue->mutex));
+    }
+
+    if (ret == 0)
+    {
+        return ARSTREAM_ERROR_TIMEOUT;
+    }
+    else if (ret < 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_LOOPBACK_TAG, "Dropping a packet larger than the %d bytes buffer", maxSize);
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportLoopback_SendAck (void *context, uint8_t *data, int size)
+{
+    return ARSTREAM_TransportLoopback_SendFragment (context, data, size, NULL, NULL);
+}
+
+static int ARSTREAM_TransportLoopback_GetEstimatedLatency (void *context)
+{
+    (void)context;
+    return 0;
+}
+
+static void ARSTREAM_TransportLoopback_Destroy (void *context)
+{
+    ARSTREAM_TransportLoopback_Side_t *side = (ARSTREAM_TransportLoopback_Side_t *)context;
+    ARSTREAM_TransportLoopback_Pair_t *pair;
+    int i;
+
+    if (side == NULL)
+    {
+        return;
+    }
+    pair = side->pair;
+    /* The pair is freed with its last transport */
+    if (__atomic_sub_fetch (&(pair->refCount), 1, __ATOMIC_ACQ_REL) > 0)
+    {
+        return;
+    }
+    for (i = 0; i < ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX; i++)
+    {
+        ARSTREAM_TransportLoopback_QueueDestroy (&(pair->queues[i]));
+    }
+    free (pair);
+}
+
+/*
+ * Implementation
+ */
+
+void ARSTREAM_Transport_LoopbackParamsDefaultInit (ARSTREAM_Transport_LoopbackParams_t *params)
+{
+    if (params != NULL)
+    {
+        params->maxFragmentSize = 0;
+        params->nbSlots = ARSTREAM_TRANSPORT_LOOPBACK_DEFAULT_NB_SLOTS;
+        params->hook = NULL;
+        params->hookCustomData = NULL;
+    }
+}
+
+eARSTREAM_ERROR ARSTREAM_Transport_InitLoopback (ARSTREAM_Transport_t *senderTransport, ARSTREAM_Transport_t *readerTransport, const ARSTREAM_Transport_LoopbackParams_t *params)
+{
+    ARSTREAM_TransportLoopback_Pair_t *pair;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    ARSTREAM_Transport_t *transports [ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX];
+    int i;
+
+    /* ARGS Check */
+    if ((senderTransport == NULL) ||
+        (readerTransport == NULL) ||
+        (params == NULL) ||
+        (params->maxFragmentSize == 0) ||
+        (params->maxFragmentSize > UINT32_MAX / 2) ||
+        (params->nbSlots <= 0) ||
+        (params->nbSlots > ARSTREAM_TRANSPORT_LOOPBACK_MAX_SLOTS) ||
+        ((params->nbSlots & (params->nbSlots - 1)) != 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    pair = calloc (1, sizeof (ARSTREAM_TransportLoopback_Pair_t));
+    if (pair == NULL)
+    {
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    pair->slotSize = params->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t);
+    if (pair->slotSize < ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE)
+    {
+        pair->slotSize = ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE;
+    }
+    pair->hook = params->hook;
+    pair->hookCustomData = params->hookCustomData;
+    pair->refCount = ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX;
+
+    for (i = 0; (internalError == ARSTREAM_OK) && (i < ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX); i++)
+    {
+        internalError = ARSTREAM_TransportLoopback_QueueInit (&(pair->queues[i]), params->nbSlots, pair->slotSize);
+    }
+    if (internalError != ARSTREAM_OK)
+    {
+        for (i = 0; i < ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX; i++)
+        {
+            ARSTREAM_TransportLoopback_QueueDestroy (&(pair->queues[i]));
+        }
+        free (pair);
+        return internalError;
+    }
+
+    /* The sender writes the data direction, the reader the ack direction */
+    transports[ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_DATA] = senderTransport;
+    transports[ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_ACK] = readerTransport;
+    for (i = 0; i < ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX; i++)
+    {
+        pair->sides[i].pair = pair;
+        pair->sides[i].outDirection = i;
+        transports[i]->sendFragment = ARSTREAM_TransportLoopback_SendFragment;
+        transports[i]->submit = NULL;
+        transports[i]->receiveFragment = ARSTREAM_TransportLoopback_ReceivePacket;
+        transports[i]->sendAck = ARSTREAM_TransportLoopback_SendAck;
+        transports[i]->receiveAck = ARSTREAM_TransportLoopback_ReceivePacket;
+        transports[i]->flush = NULL;
+        transports[i]->getEstimatedLatency = ARSTREAM_TransportLoopback_GetEstimatedLatency;
+        transports[i]->destroy = ARSTREAM_TransportLoopback_Destroy;
+        transports[i]->context = &(pair->sides[i]);
+    }
+    return ARSTREAM_OK;
+}
+
+eARSTREAM_ERROR ARSTREAM_Transport_GetLoopbackStats (const ARSTREAM_Transport_t *transport, eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION direction, ARSTREAM_Transport_LoopbackStats_t *stats)
+{
+    ARSTREAM_TransportLoopback_Queue_t *queue;
+
+    /* ARGS Check */
+    if ((transport == NULL) ||
+        (transport->destroy != ARSTREAM_TransportLoopback_Destroy) ||
+        (transport->context == NULL) ||
+        (direction < 0) ||
+        (direction >= ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_MAX) ||
+        (stats == NULL))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    queue = &(((ARSTREAM_TransportLoopback_Side_t *)transport->context)->pair->queues[direction]);
+    stats->nbPackets = __atomic_load_n (&(queue->stats.nbPackets), __ATOMIC_RELAXED);
+    stats->nbBytes = __atomic_load_n (&(queue->stats.nbBytes), __ATOMIC_RELAXED);
+    stats->nbHookDropped = __atomic_load_n (&(queue->stats.nbHookDropped), __ATOMIC_RELAXED);
+    stats->nbOverflowDropped = __atomic_load_n (&(queue->stats.nbOverflowDropped), __ATOMIC_RELAXED);
+    return ARSTREAM_OK;
+}
@@ -0,0 +1,574 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_TransportShm.c
+ * @brief Shared memory transport, for a sender and a reader on the same host
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+
+#if defined(__linux__)
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#define ARSTREAM_TRANSPORT_SHM_AVAILABLE (1)
+#endif
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_Buffers.h"
+#include "ARSTREAM_NetworkHeaders.h"
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_TRANSPORT_SHM_TAG "ARSTREAM_TransportShm"
+
+/**
+ * @brief Identifies an ARStream shared memory ("ARSM")
+ */
+#define ARSTREAM_TRANSPORT_SHM_MAGIC (0x4152534D)
+
+/**
+ * @brief Version of the shared memory layout
+ */
+#define ARSTREAM_TRANSPORT_SHM_VERSION (1)
+
+/**
+ * @brief Alignment of the ring indexes and slots, to avoid false sharing between the processes
+ */
+#define ARSTREAM_TRANSPORT_SHM_CACHE_LINE (64)
+
+/**
+ * @brief Maximum number of slots of a ring
+ */
+#define ARSTREAM_TRANSPORT_SHM_MAX_SLOTS (65536)
+
+/**
+ * @brief Index of the sender to reader ring
+ */
+#define ARSTREAM_TRANSPORT_SHM_RING_DATA (0)
+
+/**
+ * @brief Index of the reader to sender ring
+ */
+#define ARSTREAM_TRANSPORT_SHM_RING_ACK (1)
+
+#define ARSTREAM_TRANSPORT_SHM_ALIGN(size) (((size) + ARSTREAM_TRANSPORT_SHM_CACHE_LINE - 1) & ~((size_t)ARSTREAM_TRANSPORT_SHM_CACHE_LINE - 1))
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Indexes of a single producer / single consumer ring (in shared memory)
+ * Indexes are free running, the slot of an index is (index & (nbSlots - 1)).
+ */
+typedef struct {
+    uint32_t head; // Next slot to read, written by the consumer
+    uint8_t pad1 [ARSTREAM_TRANSPORT_SHM_CACHE_LINE - sizeof (uint32_t)];
+    uint32_t tail; // Next slot to write, written by the producer. Futex word of the consumer
+    uint32_t consumerWaiting; // Boolean-like flag set by the consumer before it sleeps on tail
+    uint32_t nbDropped; // Packets dropped because the ring was full
+    uint8_t pad2 [ARSTREAM_TRANSPORT_SHM_CACHE_LINE - 3 * sizeof (uint32_t)];
+} ARSTREAM_TransportShm_Ring_t;
+
+/**
+ * @brief Header of the shared memory, followed by the slots of both rings
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotSize; // Maximum packet size
+    uint32_t slotStride; // Distance between two slots
+    uint32_t nbSlots [2];
+    uint64_t slotsOffset [2];
+    uint64_t totalSize;
+    uint8_t pad [ARSTREAM_TRANSPORT_SHM_CACHE_LINE - 6 * sizeof (uint32_t) - 3 * sizeof (uint64_t)];
+    ARSTREAM_TransportShm_Ring_t rings [2];
+} ARSTREAM_TransportShm_Shared_t;
+
+/**
+ * @brief Header of a slot
+ */
+typedef struct {
+    uint32_t size;
+    uint32_t reserved;
+} ARSTREAM_TransportShm_Slot_t;
+
+/**
+ * @brief Context of a shared memory transport (local to one process)
+ */
+typedef struct {
+    uint8_t *base; // Mapping of the shared memory
+    size_t size;
+    ARSTREAM_TransportShm_Shared_t *shared;
+    int outRing; // Ring written by this side
+    int inRing; // Ring read by this side (only by the receiving thread)
+    ARSAL_Mutex_t outMutex; // Several threads of this side can send
+    int outMutexWasInit;
+} ARSTREAM_TransportShm_t;
+
+#ifdef ARSTREAM_TRANSPORT_SHM_AVAILABLE
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Waits until the futex word is no longer equal to val, or the timeout expires
+ */
+static int ARSTREAM_TransportShm_FutexWait (uint32_t *addr, uint32_t val, int timeoutMs);
+
+/**
+ * @brief Wakes up the waiters of a futex word
+ */
+static void ARSTREAM_TransportShm_FutexWake (uint32_t *addr);
+
+/**
+ * @brief Gets a slot of a ring
+ */
+static ARSTREAM_TransportShm_Slot_t *ARSTREAM_TransportShm_GetSlot (ARSTREAM_TransportShm_t *shm, int ring, uint32_t index);
+
+/**
+ * @brief Maps a shared memory and allocates the context
+ * @param fd The shared memory file descriptor
+ * @param size The shared memory size
+ * @param side The side of the stream using this transport
+ * @param[out] error The error
+ * @return The context, or NULL on error
+ */
+static ARSTREAM_TransportShm_t *ARSTREAM_TransportShm_Map (int fd, size_t size, eARSTREAM_TRANSPORT_SHM_SIDE side, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Sets the transport functions
+ */
+static void ARSTREAM_TransportShm_SetFunctions (ARSTREAM_Transport_t *transport, ARSTREAM_TransportShm_t *shm);
+
+/**
+ * @brief Writes a packet in the out ring
+ * @param shm The transport context
+ * @param data The packet
+ * @param size The packet size
+ * @return ARSTREAM_OK (even if the packet was dropped because the ring is full) or ARSTREAM_ERROR_BAD_PARAMETERS
+ */
+static eARSTREAM_ERROR ARSTREAM_TransportShm_Write (ARSTREAM_TransportShm_t *shm, uint8_t *data, int size);
+
+/**
+ * @brief Reads a packet from the in ring, waiting for it if needed
+ * @param shm The transport context
+ * @param data The read buffer
+ * @param maxSize The read buffer size
+ * @param size Pointer which will hold the read size
+ * @param timeoutMs Maximum wait time
+ * @return ARSTREAM_OK, ARSTREAM_ERROR_TIMEOUT or ARSTREAM_ERROR_TRANSPORT
+ */
+static eARSTREAM_ERROR ARSTREAM_TransportShm_Read (ARSTREAM_TransportShm_t *shm, uint8_t *data, int maxSize, int *size, int timeoutMs);
+
+static eARSTREAM_ERROR ARSTREAM_TransportShm_SendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+static eARSTREAM_ERROR ARSTREAM_TransportShm_ReceivePacket (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_TransportShm_SendAck (void *context, uint8_t *data, int size);
+static int ARSTREAM_TransportShm_GetEstimatedLatency (void *context);
+static void ARSTREAM_TransportShm_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static int ARSTREAM_TransportShm_FutexWait (uint32_t *addr, uint32_t val, int timeoutMs)
+{
+    struct timespec ts;
+    ts.tv_sec = timeoutMs / 1000;
+    ts.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    /* Not FUTEX_PRIVATE_FLAG : the word is shared between processes */
+    return (int)syscall (SYS_futex, addr, FUTEX_WAIT, val, &ts, NULL, 0);
+}
+
+static void ARSTREAM_TransportShm_FutexWake (uint32_t *addr)
+{
+    syscall (SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static ARSTREAM_TransportShm_Slot_t *ARSTREAM_TransportShm_GetSlot (ARSTREAM_TransportShm_t *shm, int ring, uint32_t index)
+{
+    uint32_t slot = index & (shm->shared->nbSlots[ring] - 1);
+    return (ARSTREAM_TransportShm_Slot_t *)&(shm->base[shm->shared->slotsOffset[ring] + (uint64_t)slot * shm->shared->slotStride]);
+}
+
+static ARSTREAM_TransportShm_t *ARSTREAM_TransportShm_Map (int fd, size_t size, eARSTREAM_TRANSPORT_SHM_SIDE side, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_TransportShm_t *shm = calloc (1, sizeof (ARSTREAM_TransportShm_t));
+    void *base;
+    if (shm == NULL)
+    {
+        *error = ARSTREAM_ERROR_ALLOC;
+        return NULL;
+    }
+    if (ARSAL_Mutex_Init (&(shm->outMutex)) != 0)
+    {
+        free (shm);
+        *error = ARSTREAM_ERROR_ALLOC;
+        return NULL;
+    }
+    shm->outMutexWasInit = 1;
+
+    base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_SHM_TAG, "Unable to map the shared memory: %s", strerror (errno));
+        ARSTREAM_TransportShm_Destroy (shm);
+        *error = ARSTREAM_ERROR_TRANSPORT;
+        return NULL;
+    }
+    shm->base = base;
+    shm->size = size;
+    shm->shared = (ARSTREAM_TransportShm_Shared_t *)base;
+    shm->outRing = (side == ARSTREAM_TRANSPORT_SHM_SIDE_SENDER) ? ARSTREAM_TRANSPORT_SHM_RING_DATA : ARSTREAM_TRANSPORT_SHM_RING_ACK;
+    shm->inRing = (side == ARSTREAM_TRANSPORT_SHM_SIDE_SENDER) ? ARSTREAM_TRANSPORT_SHM_RING_ACK : ARSTREAM_TRANSPORT_SHM_RING_DATA;
+    *error = ARSTREAM_OK;
+    return shm;
+}
+
+static void ARSTREAM_TransportShm_SetFunctions (ARSTREAM_Transport_t *transport, ARSTREAM_TransportShm_t *shm)
+{
+    transport->sendFragment = ARSTREAM_TransportShm_SendFragment;
+    transport->submit = NULL;
+    transport->receiveFragment = ARSTREAM_TransportShm_ReceivePacket;
+    transport->sendAck = ARSTREAM_TransportShm_SendAck;
+    transport->receiveAck = ARSTREAM_TransportShm_ReceivePacket;
+    transport->flush = NULL;
+    transport->getEstimatedLatency = ARSTREAM_TransportShm_GetEstimatedLatency;
+    transport->destroy = ARSTREAM_TransportShm_Destroy;
+    transport->context = shm;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportShm_Write (ARSTREAM_TransportShm_t *shm, uint8_t *data, int size)
+{
+    ARSTREAM_TransportShm_Ring_t *ring = &(shm->shared->rings[shm->outRing]);
+    ARSTREAM_TransportShm_Slot_t *slot;
+    uint32_t head, tail;
+
+    if ((size < 0) ||
+        ((uint32_t)size > shm->shared->slotSize))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    ARSAL_Mutex_Lock (&(shm->outMutex));
+    tail = ring->tail;
+    head = __atomic_load_n (&(ring->head), __ATOMIC_ACQUIRE);
+    if (tail - head >= shm->shared->nbSlots[shm->outRing])
+    {
+        /* The peer is late (or not attached yet) : drop, like a full socket buffer */
+        __atomic_fetch_add (&(ring->nbDropped), 1, __ATOMIC_RELAXED);
+        ARSAL_Mutex_Unlock (&(shm->outMutex));
+        return ARSTREAM_OK;
+    }
+    slot = ARSTREAM_TransportShm_GetSlot (shm, shm->outRing, tail);
+    memcpy (&(slot[1]), data, size);
+    slot->size = size;
+    /* Sequentially consistent, paired with the consumerWaiting store of the reader */
+    __atomic_store_n (&(ring->tail), tail + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n (&(ring->consumerWaiting), __ATOMIC_SEQ_CST) != 0)
+    {
+        ARSTREAM_TransportShm_FutexWake (&(ring->tail));
+    }
+    ARSAL_Mutex_Unlock (&(shm->outMutex));
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportShm_Read (ARSTREAM_TransportShm_t *shm, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    ARSTREAM_TransportShm_Ring_t *ring = &(shm->shared->rings[shm->inRing]);
+    ARSTREAM_TransportShm_Slot_t *slot;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    uint32_t head = ring->head;
+
+    if (__atomic_load_n (&(ring->tail), __ATOMIC_ACQUIRE) == head)
+    {
+        /* Announce the wait, then check again before sleeping : the writer checks the flag after publishing */
+        __atomic_store_n (&(ring->consumerWaiting), 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n (&(ring->tail), __ATOMIC_SEQ_CST) == head)
+        {
+            ARSTREAM_TransportShm_FutexWait (&(ring->tail), head, timeoutMs);
+        }
+        __atomic_store_n (&(ring->consumerWaiting), 0, __ATOMIC_RELAXED);
+        if (__atomic_load_n (&(ring->tail), __ATOMIC_ACQUIRE) == head)
+        {
+            return ARSTREAM_ERROR_TIMEOUT;
+        }
+    }
+
+    slot = ARSTREAM_TransportShm_GetSlot (shm, shm->inRing, head);
+    if ((slot->size > shm->shared->slotSize) ||
+        (slot->size > (uint32_t)maxSize))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_SHM_TAG, "Dropping a %u bytes packet, larger than the %d bytes buffer", slot->size, maxSize);
+        retVal = ARSTREAM_ERROR_TRANSPORT;
+    }
+    else
+    {
+        memcpy (data, &(slot[1]), slot->size);
+        *size = slot->size;
+    }
+    __atomic_store_n (&(ring->head), head + 1, __ATOMIC_RELEASE);
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportShm_SendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    eARSTREAM_ERROR retVal = ARSTREAM_TransportShm_Write ((ARSTREAM_TransportShm_t *)context, data, size);
+    if ((retVal == ARSTREAM_OK) &&
+        (callback != NULL))
+    {
+        callback (customData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportShm_ReceivePacket (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    return ARSTREAM_TransportShm_Read ((ARSTREAM_TransportShm_t *)context, data, maxSize, size, timeoutMs);
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportShm_SendAck (void *context, uint8_t *data, int size)
+{
+    return ARSTREAM_TransportShm_Write ((ARSTREAM_TransportShm_t *)context, data, size);
+}
+
+static int ARSTREAM_TransportShm_GetEstimatedLatency (void *context)
+{
+    /* No network : answers only wait for the peer threads */
+    (void)context;
+    return 0;
+}
+
+static void ARSTREAM_TransportShm_Destroy (void *context)
+{
+    ARSTREAM_TransportShm_t *shm = (ARSTREAM_TransportShm_t *)context;
+    if (shm == NULL)
+    {
+        return;
+    }
+    if (shm->base != NULL)
+    {
+        munmap (shm->base, shm->size);
+    }
+    if (shm->outMutexWasInit == 1)
+    {
+        ARSAL_Mutex_Destroy (&(shm->outMutex));
+    }
+    free (shm);
+}
+
+#endif /* ARSTREAM_TRANSPORT_SHM_AVAILABLE */
+
+/*
+ * Implementation
+ */
+
+void ARSTREAM_Transport_ShmParamsDefaultInit (ARSTREAM_Transport_ShmParams_t *params)
+{
+    if (params != NULL)
+    {
+        params->maxFragmentSize = 0;
+        params->nbDataSlots = ARSTREAM_TRANSPORT_SHM_DEFAULT_NB_DATA_SLOTS;
+        params->nbAckSlots = ARSTREAM_TRANSPORT_SHM_DEFAULT_NB_ACK_SLOTS;
+    }
+}
+
+eARSTREAM_ERROR ARSTREAM_Transport_InitShmCreate (ARSTREAM_Transport_t *transport, const ARSTREAM_Transport_ShmParams_t *params, eARSTREAM_TRANSPORT_SHM_SIDE side, int *fd)
+{
+#ifdef ARSTREAM_TRANSPORT_SHM_AVAILABLE
+    ARSTREAM_TransportShm_t *shm;
+    ARSTREAM_TransportShm_Shared_t *shared;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    uint64_t slotSize, slotStride, totalSize;
+    int shmFd;
+
+    /* ARGS Check */
+    if ((transport == NULL) ||
+        (params == NULL) ||
+        (fd == NULL) ||
+        (params->maxFragmentSize == 0) ||
+        (params->nbDataSlots <= 0) ||
+        (params->nbDataSlots > ARSTREAM_TRANSPORT_SHM_MAX_SLOTS) ||
+        ((params->nbDataSlots & (params->nbDataSlots - 1)) != 0) ||
+        (params->nbAckSlots <= 0) ||
+        (params->nbAckSlots > ARSTREAM_TRANSPORT_SHM_MAX_SLOTS) ||
+        ((params->nbAckSlots & (params->nbAckSlots - 1)) != 0) ||
+        (side < 0) ||
+        (side >= ARSTREAM_TRANSPORT_SHM_SIDE_MAX))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    slotSize = (uint64_t)params->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t);
+    if (slotSize < ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE)
+    {
+        slotSize = ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE;
+    }
+    slotStride = ARSTREAM_TRANSPORT_SHM_ALIGN (sizeof (ARSTREAM_TransportShm_Slot_t) + slotSize);
+    totalSize = ARSTREAM_TRANSPORT_SHM_ALIGN (sizeof (ARSTREAM_TransportShm_Shared_t)) + (uint64_t)(params->nbDataSlots + params->nbAckSlots) * slotStride;
+    if ((slotSize > UINT32_MAX) ||
+        (totalSize > SIZE_MAX))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    shmFd = (int)syscall (SYS_memfd_create, "arstream", 0);
+    if (shmFd < 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_SHM_TAG, "Unable to create the shared memory: %s", strerror (errno));
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+    if (ftruncate (shmFd, (off_t)totalSize) != 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_SHM_TAG, "Unable to size the shared memory to %" PRIu64 " bytes: %s", totalSize, strerror (errno));
+        close (shmFd);
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    shm = ARSTREAM_TransportShm_Map (shmFd, (size_t)totalSize, side, &internalError);
+    if (shm == NULL)
+    {
+        close (shmFd);
+        return internalError;
+    }
+
+    /* The memfd is zero filled : only the layout has to be written */
+    shared = shm->shared;
+    shared->slotSize = (uint32_t)slotSize;
+    shared->slotStride = (uint32_t)slotStride;
+    shared->nbSlots[ARSTREAM_TRANSPORT_SHM_RING_DATA] = params->nbDataSlots;
+    shared->nbSlots[ARSTREAM_TRANSPORT_SHM_RING_ACK] = params->nbAckSlots;
+    shared->slotsOffset[ARSTREAM_TRANSPORT_SHM_RING_DATA] = ARSTREAM_TRANSPORT_SHM_ALIGN (sizeof (ARSTREAM_TransportShm_Shared_t));
+    shared->slotsOffset[ARSTREAM_TRANSPORT_SHM_RING_ACK] = shared->slotsOffset[ARSTREAM_TRANSPORT_SHM_RING_DATA] + (uint64_t)params->nbDataSlots * slotStride;
+    shared->totalSize = totalSize;
+    shared->version = ARSTREAM_TRANSPORT_SHM_VERSION;
+    __atomic_store_n (&(shared->magic), ARSTREAM_TRANSPORT_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    ARSTREAM_TransportShm_SetFunctions (transport, shm);
+    *fd = shmFd;
+    return ARSTREAM_OK;
+#else
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_SHM_TAG, "Shared memory transport is not available on this platform");
+    return ARSTREAM_ERROR_TRANSPORT;
+#endif
+}
+
+eARSTREAM_ERROR ARSTREAM_Transport_InitShmAttach (ARSTREAM_Transport_t *transport, int fd, eARSTREAM_TRANSPORT_SHM_SIDE side)
+{
+#ifdef ARSTREAM_TRANSPORT_SHM_AVAILABLE
+    ARSTREAM_TransportShm_t *shm;
+    ARSTREAM_TransportShm_Shared_t *shared;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    struct stat st;
+    int ring;
+
+    /* ARGS Check */
+    if ((transport == NULL) ||
+        (fd < 0) ||
+        (side < 0) ||
+        (side >= ARSTREAM_TRANSPORT_SHM_SIDE_MAX))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    if (fstat (fd, &st) != 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_SHM_TAG, "Unable to get the shared memory size: %s", strerror (errno));
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    if ((uint64_t)st.st_size < sizeof (ARSTREAM_TransportShm_Shared_t))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    shm = ARSTREAM_TransportShm_Map (fd, (size_t)st.st_size, side, &internalError);
+    if (shm == NULL)
+    {
+        return internalError;
+    }
+
+    /* Check the layout written by the creator */
+    shared = shm->shared;
+    if ((__atomic_load_n (&(shared->magic), __ATOMIC_ACQUIRE) != ARSTREAM_TRANSPORT_SHM_MAGIC) ||
+        (shared->version != ARSTREAM_TRANSPORT_SHM_VERSION) ||
+        (shared->totalSize != (uint64_t)st.st_size) ||
+        (shared->slotStride < sizeof (ARSTREAM_TransportShm_Slot_t) + shared->slotSize))
+    {
+        internalError = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    for (ring = 0; (internalError == ARSTREAM_OK) && (ring < 2); ring++)
+    {
+        uint32_t nbSlots = shared->nbSlots[ring];
+        if ((nbSlots == 0) ||
+            ((nbSlots & (nbSlots - 1)) != 0) ||
+            (shared->slotsOffset[ring] + (uint64_t)nbSlots * shared->slotStride > shared->totalSize))
+        {
+            internalError = ARSTREAM_ERROR_BAD_PARAMETERS;
+        }
+    }
+    if (internalError != ARSTREAM_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_SHM_TAG, "The file descriptor is not a valid ARStream shared memory");
+        ARSTREAM_TransportShm_Destroy (shm);
+        return internalError;
+    }
+
+    ARSTREAM_TransportShm_SetFunctions (transport, shm);
+    return ARSTREAM_OK;
+#else
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_SHM_TAG, "Shared memory transport is not available on this platform");
+    return ARSTREAM_ERROR_TRANSPORT;
+#endif
+}
@@ -0,0 +1,1348 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_TransportUdp.c
+ * @brief Raw UDP transport, with batched system calls
+ * @date 10/17/2026
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // sendmmsg() / recvmmsg()
+#endif
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_Buffers.h"
+#include "ARSTREAM_NetworkHeaders.h"
+#include "ARSTREAM_Uring.h"
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Socket.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_TRANSPORT_UDP_TAG "ARSTREAM_TransportUdp"
+
+#if defined(__linux__)
+#define ARSTREAM_TRANSPORT_UDP_HAVE_MMSG (1)
+#define ARSTREAM_TRANSPORT_UDP_HAVE_OFFLOAD (1)
+#ifndef SOL_UDP
+#define SOL_UDP (17)
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT (103)
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO (104)
+#endif
+#endif
+
+/**
+ * @brief Maximum number of packets in one segmentation offload send (UDP_MAX_SEGMENTS of the kernel)
+ */
+#define ARSTREAM_TRANSPORT_UDP_GSO_MAX_SEGMENTS (64)
+
+/**
+ * @brief Maximum number of bytes in one segmentation offload send (largest IPv4 UDP payload)
+ */
+#define ARSTREAM_TRANSPORT_UDP_GSO_MAX_BYTES (65507)
+
+/**
+ * @brief Size of a receive slot when receive offload is enabled (one coalesced datagram)
+ */
+#define ARSTREAM_TRANSPORT_UDP_GRO_SLOT_SIZE (65536)
+
+/**
+ * @brief Maximum number of receive slots when receive offload is enabled
+ */
+#define ARSTREAM_TRANSPORT_UDP_GRO_MAX_SLOTS (8)
+
+/**
+ * @brief Size of the ancillary data buffer of a message (one UDP_SEGMENT or UDP_GRO value)
+ */
+#define ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE (CMSG_SPACE (sizeof (int)))
+
+/**
+ * @brief Alignment of the receive slots
+ * The io_uring engine reads a struct io_uring_recvmsg_out and a struct sockaddr_in at the start of each slot
+ */
+#define ARSTREAM_TRANSPORT_UDP_SLOT_ALIGNMENT (8)
+
+/**
+ * @brief Buffer group of the io_uring receive buffers
+ */
+#define ARSTREAM_TRANSPORT_UDP_URING_BUF_GROUP (0)
+
+/**
+ * @brief user_data of the io_uring multishot receive request
+ */
+#define ARSTREAM_TRANSPORT_UDP_URING_RECV_ID (1)
+
+/**
+ * @brief user_data of the io_uring request which cancels the multishot receive
+ */
+#define ARSTREAM_TRANSPORT_UDP_URING_CANCEL_ID (2)
+
+/**
+ * @brief Maximum wait time for the completion of the cancelled io_uring requests on destroy
+ */
+#define ARSTREAM_TRANSPORT_UDP_URING_CANCEL_TIMEOUT_MS (1000)
+
+/*
+ * Types
+ */
+
+#ifdef ARSTREAM_TRANSPORT_UDP_HAVE_MMSG
+typedef struct mmsghdr ARSTREAM_TransportUdp_Msg_t;
+#else
+/**
+ * @brief Same layout as the Linux struct mmsghdr
+ */
+typedef struct {
+    struct msghdr msg_hdr;
+    unsigned int msg_len;
+} ARSTREAM_TransportUdp_Msg_t;
+#endif
+
+/**
+ * @brief Send callback of a buffered packet
+ */
+typedef struct {
+    ARSTREAM_Transport_SendCallback_t callback;
+    void *customData;
+} ARSTREAM_TransportUdp_SendCallbackParam_t;
+
+/**
+ * @brief Context of an UDP transport
+ */
+typedef struct {
+    int socket;
+    uint32_t slotSize; // Size of the send packet slots
+    int batchSize;
+    int estimatedLatencyMs;
+
+    /* Peer address and send batch (protected by sendMutex) */
+    ARSAL_Mutex_t sendMutex;
+    int sendMutexWasInit;
+    struct sockaddr_in remoteAddr;
+    int hasRemoteAddr;
+    int remoteAddrIsFixed;
+    int segmentationOffload; // UDP_SEGMENT is used, cleared if the system rejects it
+    uint8_t *sendSlots;
+    struct iovec *sendIovecs; // One per packet
+    ARSTREAM_TransportUdp_SendCallbackParam_t *sendCallbacks; // One per packet
+    int nbSendPackets;
+    ARSTREAM_TransportUdp_Msg_t *sendMsgs; // One per system call message, built on submit
+    int *sendMsgFirstPacket; // Index of the first packet of each message
+    uint8_t *sendControls;
+
+    /* Received burst (receiving thread only) */
+    int receiveOffload; // UDP_GRO is enabled
+    uint32_t recvSlotSize; // Payload size of the receive slots
+    uint32_t recvHeadroom; // Room before the payload of each receive slot (io_uring message header)
+    uint32_t recvSlotStride; // Distance between two receive slots, a multiple of ARSTREAM_TRANSPORT_UDP_SLOT_ALIGNMENT
+    int nbRecvSlots;
+    uint8_t *recvSlots;
+    struct iovec *recvIovecs;
+    struct sockaddr_in *recvAddrs;
+    uint8_t *recvControls;
+    ARSTREAM_TransportUdp_Msg_t *recvMsgs;
+    int nbRecvMsgs;
+    int recvIndex;
+
+    /* Current received message (receiving thread only) */
+    uint8_t *recvPayload; // NULL if none
+    uint32_t recvPayloadLen;
+    struct sockaddr_in *recvFrom; // NULL if unknown
+    uint32_t recvOffset; // Offset of the next packet in the current message
+    uint32_t recvSegmentSize; // Size of the packets coalesced in the current message
+
+#ifdef ARSTREAM_URING_AVAILABLE
+    /* io_uring engine */
+    int sendUring; // sendRing is used (protected by sendMutex)
+    ARSTREAM_Uring_t sendRing;
+    int sendInFlight; // Send requests whose completion was not read yet (protected by sendMutex)
+    int recvUring; // recvRing is used (receiving thread only)
+    ARSTREAM_Uring_t recvRing;
+    struct msghdr recvTemplate; // Name and control sizes of the multishot receive
+    int recvArmed; // The multishot receive is pending
+    int recvBufId; // Buffer of the current message
+#endif
+} ARSTREAM_TransportUdp_t;
+
+/*
+ * Internal functions declarations
+ */
+
+#ifndef ARSTREAM_TRANSPORT_UDP_HAVE_MMSG
+/**
+ * @brief sendmmsg() replacement, with one sendmsg() call per packet
+ */
+static int sendmmsg (int sockfd, ARSTREAM_TransportUdp_Msg_t *msgvec, unsigned int vlen, int flags);
+
+/**
+ * @brief recvmmsg() replacement, with one recvmsg() call per packet
+ */
+static int recvmmsg (int sockfd, ARSTREAM_TransportUdp_Msg_t *msgvec, unsigned int vlen, int flags, struct timespec *timeout);
+#endif
+
+/**
+ * @brief Builds the messages for the buffered packets, starting at firstPacket
+ * With segmentation offload, runs of packets of the same size (the last one may be shorter)
+ * are grouped in one message, which the kernel splits back into packets.
+ * @param udp The transport context
+ * @param firstPacket Index of the first packet to send
+ * @return The number of messages
+ * @warning Must be called with sendMutex held
+ */
+static int ARSTREAM_TransportUdp_BuildSendMsgs (ARSTREAM_TransportUdp_t *udp, int firstPacket);
+
+/**
+ * @brief Sends messages with the configured engine
+ * @param udp The transport context
+ * @param nbMsgs Number of messages in sendMsgs
+ * @return The number of messages sent (in order), or -1 with errno set if none was sent
+ * @warning Must be called with sendMutex held
+ */
+static int ARSTREAM_TransportUdp_SendMsgs (ARSTREAM_TransportUdp_t *udp, int nbMsgs);
+
+/**
+ * @brief Sends the buffered packets, then calls their callbacks
+ * @param udp The transport context
+ * @warning Must be called with sendMutex held
+ */
+static void ARSTREAM_TransportUdp_SubmitLocked (ARSTREAM_TransportUdp_t *udp);
+
+/**
+ * @brief Gets the size of the packets coalesced by the kernel in a received message
+ * @param udp The transport context
+ * @param hdr The received message header (only the control part is used)
+ * @param len The received message size
+ * @return The segment size, or the message size if it was not coalesced
+ */
+static uint32_t ARSTREAM_TransportUdp_GetSegmentSize (ARSTREAM_TransportUdp_t *udp, struct msghdr *hdr, uint32_t len);
+
+/**
+ * @brief Sets the next received message as the current one (recvmmsg() engine)
+ * @param udp The transport context
+ * @param timeoutMs Maximum wait time
+ * @return ARSTREAM_OK, ARSTREAM_ERROR_TIMEOUT or ARSTREAM_ERROR_TRANSPORT
+ */
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_ReadMessageSyscalls (ARSTREAM_TransportUdp_t *udp, int timeoutMs);
+
+/**
+ * @brief Releases the current received message
+ * @param udp The transport context
+ */
+static void ARSTREAM_TransportUdp_ReleaseMessage (ARSTREAM_TransportUdp_t *udp);
+
+#ifdef ARSTREAM_URING_AVAILABLE
+/**
+ * @brief Sends messages as a chain of linked io_uring requests, and waits for their completion
+ * @see ARSTREAM_TransportUdp_SendMsgs()
+ */
+static int ARSTREAM_TransportUdp_SendMsgsUring (ARSTREAM_TransportUdp_t *udp, int nbMsgs);
+
+/**
+ * @brief Queues the multishot receive request on recvRing
+ * @param udp The transport context
+ * @return 0 on success, or a negative errno value
+ */
+static int ARSTREAM_TransportUdp_ArmUringReceive (ARSTREAM_TransportUdp_t *udp);
+
+/**
+ * @brief Sets the next received message as the current one (io_uring engine)
+ * @see ARSTREAM_TransportUdp_ReadMessageSyscalls()
+ */
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_ReadMessageUring (ARSTREAM_TransportUdp_t *udp, int timeoutMs);
+
+/**
+ * @brief Sets up the io_uring rings, and gives the receive slots to the kernel
+ * @param udp The transport context
+ * @return 0 on success, or a negative errno value
+ */
+static int ARSTREAM_TransportUdp_InitUring (ARSTREAM_TransportUdp_t *udp);
+
+/**
+ * @brief Cancels the pending io_uring requests, and waits until the kernel no longer uses the socket and the buffers
+ * Closing a ring only cancels its requests asynchronously : the socket port and the receive slots
+ * could still be in use after the ring is closed.
+ * @param udp The transport context
+ * @warning The transport must no longer be used by any other thread
+ */
+static void ARSTREAM_TransportUdp_StopUring (ARSTREAM_TransportUdp_t *udp);
+#endif
+
+/**
+ * @brief Returns the next packet of the received burst, reading a new burst if needed
+ * @param udp The transport context
+ * @param data The read buffer
+ * @param maxSize The read buffer size
+ * @param size Pointer which will hold the read size
+ * @param timeoutMs Maximum wait time
+ * @return ARSTREAM_OK, ARSTREAM_ERROR_TIMEOUT or ARSTREAM_ERROR_TRANSPORT
+ */
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_Receive (ARSTREAM_TransportUdp_t *udp, uint8_t *data, int maxSize, int *size, int timeoutMs);
+
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_SendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+static void ARSTREAM_TransportUdp_Submit (void *context);
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_ReceivePacket (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_SendAck (void *context, uint8_t *data, int size);
+static void ARSTREAM_TransportUdp_Flush (void *context);
+static int ARSTREAM_TransportUdp_GetEstimatedLatency (void *context);
+static void ARSTREAM_TransportUdp_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+#ifndef ARSTREAM_TRANSPORT_UDP_HAVE_MMSG
+static int sendmmsg (int sockfd, ARSTREAM_TransportUdp_Msg_t *msgvec, unsigned int vlen, int flags)
+{
+    unsigned int i;
+    for (i = 0; i < vlen; i++)
+    {
+        ssize_t ret = sendmsg (sockfd, &(msgvec[i].msg_hdr), flags);
+        if (ret < 0)
+        {
+            return (i == 0) ? -1 : (int)i;
+        }
+        msgvec[i].msg_len = ret;
+    }
+    return vlen;
+}
+
+static int recvmmsg (int sockfd, ARSTREAM_TransportUdp_Msg_t *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+    unsigned int i;
+    (void)timeout;
+    for (i = 0; i < vlen; i++)
+    {
+        ssize_t ret = recvmsg (sockfd, &(msgvec[i].msg_hdr), flags);
+        if (ret < 0)
+        {
+            return (i == 0) ? -1 : (int)i;
+        }
+        msgvec[i].msg_len = ret;
+    }
+    return vlen;
+}
+#endif
+
+static int ARSTREAM_TransportUdp_BuildSendMsgs (ARSTREAM_TransportUdp_t *udp, int firstPacket)
+{
+    int nbMsgs = 0;
+    int i = firstPacket;
+
+    while (i < udp->nbSendPackets)
+    {
+        ARSTREAM_TransportUdp_Msg_t *msg = &(udp->sendMsgs[nbMsgs]);
+        size_t segmentSize = udp->sendIovecs[i].iov_len;
+        size_t totalSize = segmentSize;
+        int next = i + 1;
+
+        if (udp->segmentationOffload == 1)
+        {
+            while ((next < udp->nbSendPackets) &&
+                   (next - i < ARSTREAM_TRANSPORT_UDP_GSO_MAX_SEGMENTS) &&
+                   (udp->sendIovecs[next].iov_len <= segmentSize) &&
+                   (totalSize + udp->sendIovecs[next].iov_len <= ARSTREAM_TRANSPORT_UDP_GSO_MAX_BYTES))
+            {
+                totalSize += udp->sendIovecs[next].iov_len;
+                next++;
+                if (udp->sendIovecs[next - 1].iov_len < segmentSize)
+                {
+                    /* Only the last segment can be shorter */
+                    break;
+                }
+            }
+        }
+
+        msg->msg_hdr.msg_name = &(udp->remoteAddr);
+        msg->msg_hdr.msg_namelen = sizeof (udp->remoteAddr);
+        msg->msg_hdr.msg_iov = &(udp->sendIovecs[i]);
+        msg->msg_hdr.msg_iovlen = next - i;
+        msg->msg_hdr.msg_control = NULL;
+        msg->msg_hdr.msg_controllen = 0;
+        msg->msg_hdr.msg_flags = 0;
+#ifdef ARSTREAM_TRANSPORT_UDP_HAVE_OFFLOAD
+        if (next - i > 1)
+        {
+            struct cmsghdr *cmsg;
+            uint16_t gsoSize = segmentSize;
+            msg->msg_hdr.msg_control = &(udp->sendControls[nbMsgs * ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE]);
+            msg->msg_hdr.msg_controllen = CMSG_SPACE (sizeof (uint16_t));
+            cmsg = CMSG_FIRSTHDR (&(msg->msg_hdr));
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN (sizeof (uint16_t));
+            memcpy (CMSG_DATA (cmsg), &gsoSize, sizeof (uint16_t));
+        }
+#endif
+        udp->sendMsgFirstPacket[nbMsgs] = i;
+        nbMsgs++;
+        i = next;
+    }
+    return nbMsgs;
+}
+
+static int ARSTREAM_TransportUdp_SendMsgs (ARSTREAM_TransportUdp_t *udp, int nbMsgs)
+{
+#ifdef ARSTREAM_URING_AVAILABLE
+    if (udp->sendUring == 1)
+    {
+        return ARSTREAM_TransportUdp_SendMsgsUring (udp, nbMsgs);
+    }
+#endif
+    return sendmmsg (udp->socket, udp->sendMsgs, nbMsgs, 0);
+}
+
+static void ARSTREAM_TransportUdp_SubmitLocked (ARSTREAM_TransportUdp_t *udp)
+{
+    int nbSent = 0; // Number of packets sent
+    int i;
+
+    while (nbSent < udp->nbSendPackets)
+    {
+        int nbMsgs = ARSTREAM_TransportUdp_BuildSendMsgs (udp, nbSent);
+        int ret = ARSTREAM_TransportUdp_SendMsgs (udp, nbMsgs);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if ((udp->segmentationOffload == 1) &&
+                ((errno == EIO) || (errno == EINVAL) || (errno == ENOPROTOOPT) || (errno == EOPNOTSUPP)))
+            {
+                /* The device or the path MTU do not allow segmentation offload */
+                ARSAL_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_TRANSPORT_UDP_TAG, "Segmentation offload rejected (%s), disabling it", strerror (errno));
+                udp->segmentationOffload = 0;
+                continue;
+            }
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Error while sending %d packets: %s", udp->nbSendPackets - nbSent, strerror (errno));
+            break;
+        }
+        nbSent = (ret < nbMsgs) ? udp->sendMsgFirstPacket[ret] : udp->nbSendPackets;
+    }
+
+    for (i = 0; i < udp->nbSendPackets; i++)
+    {
+        if (udp->sendCallbacks[i].callback != NULL)
+        {
+            udp->sendCallbacks[i].callback (udp->sendCallbacks[i].customData, (i < nbSent) ? ARSTREAM_TRANSPORT_SEND_STATUS_SENT : ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+        }
+    }
+    udp->nbSendPackets = 0;
+}
+
+static uint32_t ARSTREAM_TransportUdp_GetSegmentSize (ARSTREAM_TransportUdp_t *udp, struct msghdr *hdr, uint32_t len)
+{
+    uint32_t segmentSize = len;
+#ifdef ARSTREAM_TRANSPORT_UDP_HAVE_OFFLOAD
+    if (udp->receiveOffload == 1)
+    {
+        struct cmsghdr *cmsg;
+        for (cmsg = CMSG_FIRSTHDR (hdr); cmsg != NULL; cmsg = CMSG_NXTHDR (hdr, cmsg))
+        {
+            if ((cmsg->cmsg_level == SOL_UDP) &&
+                (cmsg->cmsg_type == UDP_GRO))
+            {
+                int groSize;
+                memcpy (&groSize, CMSG_DATA (cmsg), sizeof (int));
+                if (groSize > 0)
+                {
+                    segmentSize = groSize;
+                }
+                break;
+            }
+        }
+    }
+#else
+    (void)udp;
+    (void)hdr;
+#endif
+    return segmentSize;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_ReadMessageSyscalls (ARSTREAM_TransportUdp_t *udp, int timeoutMs)
+{
+    ARSTREAM_TransportUdp_Msg_t *msg;
+
+    if (udp->recvIndex >= udp->nbRecvMsgs)
+    {
+        struct pollfd pfd;
+        int ret;
+        int i;
+
+        pfd.fd = udp->socket;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        ret = poll (&pfd, 1, timeoutMs);
+        if (ret == 0)
+        {
+            return ARSTREAM_ERROR_TIMEOUT;
+        }
+        else if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                return ARSTREAM_ERROR_TIMEOUT;
+            }
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Error while waiting for data: %s", strerror (errno));
+            return ARSTREAM_ERROR_TRANSPORT;
+        }
+
+        /* Drain the socket */
+        for (i = 0; i < udp->nbRecvSlots; i++)
+        {
+            udp->recvMsgs[i].msg_hdr.msg_namelen = sizeof (struct sockaddr_in);
+            udp->recvMsgs[i].msg_hdr.msg_controllen = (udp->recvControls != NULL) ? ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE : 0;
+            udp->recvMsgs[i].msg_hdr.msg_flags = 0;
+        }
+        ret = recvmmsg (udp->socket, udp->recvMsgs, udp->nbRecvSlots, MSG_DONTWAIT, NULL);
+        if (ret <= 0)
+        {
+            if ((ret == 0) ||
+                (errno == EAGAIN) ||
+                (errno == EWOULDBLOCK) ||
+                (errno == EINTR))
+            {
+                return ARSTREAM_ERROR_TIMEOUT;
+            }
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Error while reading data: %s", strerror (errno));
+            return ARSTREAM_ERROR_TRANSPORT;
+        }
+        udp->nbRecvMsgs = ret;
+        udp->recvIndex = 0;
+    }
+
+    msg = &(udp->recvMsgs[udp->recvIndex]);
+    if ((msg->msg_hdr.msg_flags & MSG_TRUNC) != 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Dropping a packet larger than the %u bytes slots", udp->recvSlotSize);
+        udp->recvIndex++;
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+    udp->recvPayload = msg->msg_hdr.msg_iov[0].iov_base;
+    udp->recvPayloadLen = msg->msg_len;
+    udp->recvFrom = &(udp->recvAddrs[udp->recvIndex]);
+    udp->recvSegmentSize = ARSTREAM_TransportUdp_GetSegmentSize (udp, &(msg->msg_hdr), msg->msg_len);
+    return ARSTREAM_OK;
+}
+
+static void ARSTREAM_TransportUdp_ReleaseMessage (ARSTREAM_TransportUdp_t *udp)
+{
+#ifdef ARSTREAM_URING_AVAILABLE
+    if (udp->recvUring == 1)
+    {
+        /* Give the buffer back to the kernel */
+        ARSTREAM_Uring_AddBuffer (&(udp->recvRing), &(udp->recvSlots[udp->recvBufId * udp->recvSlotStride]), udp->recvSlotStride, udp->recvBufId);
+        ARSTREAM_Uring_CommitBuffers (&(udp->recvRing));
+    }
+    else
+#endif
+    {
+        udp->recvIndex++;
+    }
+    udp->recvPayload = NULL;
+    udp->recvOffset = 0;
+}
+
+#ifdef ARSTREAM_URING_AVAILABLE
+static int ARSTREAM_TransportUdp_SendMsgsUring (ARSTREAM_TransportUdp_t *udp, int nbMsgs)
+{
+    int nbSent = nbMsgs;
+    int error = 0;
+    int ret;
+    int i;
+
+    for (i = 0; i < nbMsgs; i++)
+    {
+        /* The ring has batchSize entries, and is empty between two calls */
+        struct io_uring_sqe *sqe = ARSTREAM_Uring_GetSqe (&(udp->sendRing));
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = udp->socket;
+        sqe->addr = (uint64_t)(uintptr_t)&(udp->sendMsgs[i].msg_hdr);
+        sqe->len = 1;
+        sqe->user_data = i;
+        if (i < nbMsgs - 1)
+        {
+            /* Keep the packets order, and stop at the first error */
+            sqe->flags = IOSQE_IO_LINK;
+        }
+    }
+    ret = ARSTREAM_Uring_Submit (&(udp->sendRing), nbMsgs);
+    if (ret < 0)
+    {
+        errno = -ret;
+        return -1;
+    }
+    udp->sendInFlight = nbMsgs;
+
+    for (i = 0; i < nbMsgs; i++)
+    {
+        struct io_uring_cqe *cqe;
+        ret = ARSTREAM_Uring_WaitCqe (&(udp->sendRing), &cqe, -1);
+        if (ret == -EINTR)
+        {
+            i--;
+            continue;
+        }
+        else if (ret < 0)
+        {
+            errno = -ret;
+            return -1;
+        }
+        /* The requests after a failed one complete with -ECANCELED */
+        if ((cqe->res < 0) &&
+            ((int)cqe->user_data < nbSent))
+        {
+            nbSent = (int)cqe->user_data;
+            error = -cqe->res;
+        }
+        ARSTREAM_Uring_CqeSeen (&(udp->sendRing));
+        udp->sendInFlight--;
+    }
+
+    if (nbSent == 0)
+    {
+        errno = error;
+        return -1;
+    }
+    return nbSent;
+}
+
+static int ARSTREAM_TransportUdp_ArmUringReceive (ARSTREAM_TransportUdp_t *udp)
+{
+    struct io_uring_sqe *sqe = ARSTREAM_Uring_GetSqe (&(udp->recvRing));
+    int ret;
+    if (sqe == NULL)
+    {
+        return -EBUSY;
+    }
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = udp->socket;
+    sqe->addr = (uint64_t)(uintptr_t)&(udp->recvTemplate);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = ARSTREAM_TRANSPORT_UDP_URING_BUF_GROUP;
+    sqe->user_data = ARSTREAM_TRANSPORT_UDP_URING_RECV_ID;
+    ret = ARSTREAM_Uring_Submit (&(udp->recvRing), 0);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    udp->recvArmed = 1;
+    return 0;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_ReadMessageUring (ARSTREAM_TransportUdp_t *udp, int timeoutMs)
+{
+    for (;;)
+    {
+        struct io_uring_cqe *cqe;
+        struct io_uring_recvmsg_out *out;
+        struct msghdr controlHdr;
+        uint8_t *buffer;
+        int res;
+        unsigned flags;
+        int ret;
+
+        /* The request is armed from the receiving thread, which then runs its completions */
+        if (udp->recvArmed == 0)
+        {
+            ret = ARSTREAM_TransportUdp_ArmUringReceive (udp);
+            if (ret < 0)
+            {
+                ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Unable to queue the receive request: %s", strerror (-ret));
+                return ARSTREAM_ERROR_TRANSPORT;
+            }
+        }
+
+        ret = ARSTREAM_Uring_WaitCqe (&(udp->recvRing), &cqe, timeoutMs);
+        if ((ret == -ETIME) ||
+            (ret == -EINTR))
+        {
+            return ARSTREAM_ERROR_TIMEOUT;
+        }
+        else if (ret < 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Error while waiting for data: %s", strerror (-ret));
+            return ARSTREAM_ERROR_TRANSPORT;
+        }
+        res = cqe->res;
+        flags = cqe->flags;
+        ARSTREAM_Uring_CqeSeen (&(udp->recvRing));
+        if ((flags & IORING_CQE_F_MORE) == 0)
+        {
+            udp->recvArmed = 0;
+        }
+
+        if (res == -ENOBUFS)
+        {
+            /* All the buffers were used, and were given back since : re-arm */
+            continue;
+        }
+        else if (res == -EINVAL)
+        {
+            /* Multishot receive needs Linux 6.0 */
+            ARSAL_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_TRANSPORT_UDP_TAG, "io_uring multishot receive is not supported, using system calls");
+            ARSTREAM_Uring_Destroy (&(udp->recvRing));
+            udp->recvUring = 0;
+            return ARSTREAM_TransportUdp_ReadMessageSyscalls (udp, timeoutMs);
+        }
+        else if (res < 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Error while reading data: %s", strerror (-res));
+            return ARSTREAM_ERROR_TRANSPORT;
+        }
+        else if ((flags & IORING_CQE_F_BUFFER) == 0)
+        {
+            continue;
+        }
+
+        udp->recvBufId = flags >> IORING_CQE_BUFFER_SHIFT;
+        buffer = &(udp->recvSlots[udp->recvBufId * udp->recvSlotStride]);
+        out = (struct io_uring_recvmsg_out *)buffer;
+        if ((out->flags & MSG_TRUNC) != 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Dropping a packet larger than the %u bytes slots", udp->recvSlotSize);
+            ARSTREAM_TransportUdp_ReleaseMessage (udp);
+            return ARSTREAM_ERROR_TRANSPORT;
+        }
+
+        /* Buffer layout : header, name (recvTemplate.msg_namelen), control (recvTemplate.msg_controllen), payload */
+        memset (&controlHdr, 0, sizeof (controlHdr));
+        controlHdr.msg_control = buffer + sizeof (struct io_uring_recvmsg_out) + udp->recvTemplate.msg_namelen;
+        controlHdr.msg_controllen = out->controllen;
+        udp->recvPayload = buffer + sizeof (struct io_uring_recvmsg_out) + udp->recvTemplate.msg_namelen + udp->recvTemplate.msg_controllen;
+        udp->recvPayloadLen = out->payloadlen;
+        udp->recvFrom = (out->namelen >= sizeof (struct sockaddr_in)) ? (struct sockaddr_in *)(buffer + sizeof (struct io_uring_recvmsg_out)) : NULL;
+        udp->recvSegmentSize = ARSTREAM_TransportUdp_GetSegmentSize (udp, &controlHdr, out->payloadlen);
+        return ARSTREAM_OK;
+    }
+}
+
+static int ARSTREAM_TransportUdp_InitUring (ARSTREAM_TransportUdp_t *udp)
+{
+    int ret;
+    int i;
+
+    ret = ARSTREAM_Uring_Init (&(udp->sendRing), udp->batchSize, 2 * udp->batchSize);
+    if (ret == 0)
+    {
+        ret = ARSTREAM_Uring_Init (&(udp->recvRing), 4, 2 * udp->nbRecvSlots);
+    }
+    if (ret == 0)
+    {
+        ret = ARSTREAM_Uring_SetupBufRing (&(udp->recvRing), ARSTREAM_TRANSPORT_UDP_URING_BUF_GROUP, udp->nbRecvSlots);
+    }
+    if (ret == 0)
+    {
+        for (i = 0; i < udp->nbRecvSlots; i++)
+        {
+            ARSTREAM_Uring_AddBuffer (&(udp->recvRing), &(udp->recvSlots[i * udp->recvSlotStride]), udp->recvSlotStride, i);
+        }
+        ARSTREAM_Uring_CommitBuffers (&(udp->recvRing));
+        memset (&(udp->recvTemplate), 0, sizeof (udp->recvTemplate));
+        udp->recvTemplate.msg_namelen = sizeof (struct sockaddr_in);
+        udp->recvTemplate.msg_controllen = (udp->receiveOffload == 1) ? ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE : 0;
+    }
+    return ret;
+}
+
+static void ARSTREAM_TransportUdp_StopUring (ARSTREAM_TransportUdp_t *udp)
+{
+    struct io_uring_cqe *cqe;
+    int ret = 0;
+
+    /* The multishot receive ends with a completion without IORING_CQE_F_MORE */
+    if ((udp->recvUring == 1) &&
+        (udp->recvArmed == 1))
+    {
+        struct io_uring_sqe *sqe = ARSTREAM_Uring_GetSqe (&(udp->recvRing));
+        if (sqe != NULL)
+        {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = ARSTREAM_TRANSPORT_UDP_URING_RECV_ID;
+            sqe->user_data = ARSTREAM_TRANSPORT_UDP_URING_CANCEL_ID;
+            ret = ARSTREAM_Uring_Submit (&(udp->recvRing), 0);
+        }
+        else
+        {
+            ret = -EBUSY;
+        }
+    }
+    while ((udp->recvUring == 1) &&
+           (udp->recvArmed == 1) &&
+           (ret >= 0))
+    {
+        ret = ARSTREAM_Uring_WaitCqe (&(udp->recvRing), &cqe, ARSTREAM_TRANSPORT_UDP_URING_CANCEL_TIMEOUT_MS);
+        if (ret == 0)
+        {
+            if ((cqe->user_data == ARSTREAM_TRANSPORT_UDP_URING_RECV_ID) &&
+                ((cqe->flags & IORING_CQE_F_MORE) == 0))
+            {
+                udp->recvArmed = 0;
+            }
+            ARSTREAM_Uring_CqeSeen (&(udp->recvRing));
+        }
+        else if (ret == -EINTR)
+        {
+            ret = 0;
+        }
+    }
+    if (ret < 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Unable to cancel the receive request: %s", strerror (-ret));
+    }
+
+    /* Send requests are only left pending when waiting for their completion failed */
+    ret = 0;
+    while ((udp->sendUring == 1) &&
+           (udp->sendInFlight > 0) &&
+           (ret >= 0))
+    {
+        ret = ARSTREAM_Uring_WaitCqe (&(udp->sendRing), &cqe, ARSTREAM_TRANSPORT_UDP_URING_CANCEL_TIMEOUT_MS);
+        if (ret == 0)
+        {
+            ARSTREAM_Uring_CqeSeen (&(udp->sendRing));
+            udp->sendInFlight--;
+        }
+        else if (ret == -EINTR)
+        {
+            ret = 0;
+        }
+    }
+    if (ret < 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Unable to complete the send requests: %s", strerror (-ret));
+    }
+
+    /* Unregisters the buffer ring, then closes the rings */
+    ARSTREAM_Uring_Destroy (&(udp->sendRing));
+    ARSTREAM_Uring_Destroy (&(udp->recvRing));
+    udp->sendUring = 0;
+    udp->recvUring = 0;
+}
+#endif
+
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_Receive (ARSTREAM_TransportUdp_t *udp, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    struct sockaddr_in fromAddr;
+    int hasFromAddr;
+    uint32_t packetSize;
+
+    if (udp->recvPayload == NULL)
+    {
+        eARSTREAM_ERROR err;
+#ifdef ARSTREAM_URING_AVAILABLE
+        if (udp->recvUring == 1)
+        {
+            err = ARSTREAM_TransportUdp_ReadMessageUring (udp, timeoutMs);
+        }
+        else
+#endif
+        {
+            err = ARSTREAM_TransportUdp_ReadMessageSyscalls (udp, timeoutMs);
+        }
+        if (err != ARSTREAM_OK)
+        {
+            return err;
+        }
+        udp->recvOffset = 0;
+    }
+    hasFromAddr = (udp->recvFrom != NULL) ? 1 : 0;
+    if (hasFromAddr == 1)
+    {
+        fromAddr = *(udp->recvFrom);
+    }
+
+    /* Split the coalesced packets */
+    packetSize = udp->recvPayloadLen - udp->recvOffset;
+    if (packetSize > udp->recvSegmentSize)
+    {
+        packetSize = udp->recvSegmentSize;
+    }
+    if (packetSize > (uint32_t)maxSize)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Dropping a %u bytes packet, larger than the %d bytes buffer", packetSize, maxSize);
+    }
+    else
+    {
+        memcpy (data, &(udp->recvPayload[udp->recvOffset]), packetSize);
+        *size = packetSize;
+    }
+    udp->recvOffset += packetSize;
+    if (udp->recvOffset >= udp->recvPayloadLen)
+    {
+        ARSTREAM_TransportUdp_ReleaseMessage (udp);
+    }
+    if (packetSize > (uint32_t)maxSize)
+    {
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    /* Answer the peer which sent the last packet. Only this thread writes remoteAddr */
+    if ((hasFromAddr == 1) &&
+        (udp->remoteAddrIsFixed == 0) &&
+        ((udp->hasRemoteAddr == 0) ||
+         (udp->remoteAddr.sin_addr.s_addr != fromAddr.sin_addr.s_addr) ||
+         (udp->remoteAddr.sin_port != fromAddr.sin_port)))
+    {
+        ARSAL_Mutex_Lock (&(udp->sendMutex));
+        udp->remoteAddr = fromAddr;
+        udp->hasRemoteAddr = 1;
+        ARSAL_Mutex_Unlock (&(udp->sendMutex));
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_SendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    ARSTREAM_TransportUdp_t *udp = (ARSTREAM_TransportUdp_t *)context;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    int index;
+
+    if ((size <= 0) ||
+        ((uint32_t)size > udp->slotSize))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    ARSAL_Mutex_Lock (&(udp->sendMutex));
+    if (udp->hasRemoteAddr == 0)
+    {
+        retVal = ARSTREAM_ERROR_TRANSPORT;
+    }
+    else
+    {
+        if (udp->nbSendPackets == udp->batchSize)
+        {
+            ARSTREAM_TransportUdp_SubmitLocked (udp);
+        }
+        index = udp->nbSendPackets++;
+        memcpy (&(udp->sendSlots[index * udp->slotSize]), data, size);
+        udp->sendIovecs[index].iov_len = size;
+        udp->sendCallbacks[index].callback = callback;
+        udp->sendCallbacks[index].customData = customData;
+    }
+    ARSAL_Mutex_Unlock (&(udp->sendMutex));
+    return retVal;
+}
+
+static void ARSTREAM_TransportUdp_Submit (void *context)
+{
+    ARSTREAM_TransportUdp_t *udp = (ARSTREAM_TransportUdp_t *)context;
+    ARSAL_Mutex_Lock (&(udp->sendMutex));
+    if (udp->nbSendPackets > 0)
+    {
+        ARSTREAM_TransportUdp_SubmitLocked (udp);
+    }
+    ARSAL_Mutex_Unlock (&(udp->sendMutex));
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_ReceivePacket (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    return ARSTREAM_TransportUdp_Receive ((ARSTREAM_TransportUdp_t *)context, data, maxSize, size, timeoutMs);
+}
+
+static eARSTREAM_ERROR ARSTREAM_TransportUdp_SendAck (void *context, uint8_t *data, int size)
+{
+    ARSTREAM_TransportUdp_t *udp = (ARSTREAM_TransportUdp_t *)context;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+
+    ARSAL_Mutex_Lock (&(udp->sendMutex));
+    if (udp->hasRemoteAddr == 0)
+    {
+        /* No packet received yet, nobody to answer to */
+        retVal = ARSTREAM_ERROR_TRANSPORT;
+    }
+    else if (sendto (udp->socket, data, size, 0, (struct sockaddr *)&(udp->remoteAddr), sizeof (udp->remoteAddr)) < 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Error while sending an ack: %s", strerror (errno));
+        retVal = ARSTREAM_ERROR_TRANSPORT;
+    }
+    ARSAL_Mutex_Unlock (&(udp->sendMutex));
+    return retVal;
+}
+
+static void ARSTREAM_TransportUdp_Flush (void *context)
+{
+    ARSTREAM_TransportUdp_t *udp = (ARSTREAM_TransportUdp_t *)context;
+    int i;
+
+    ARSAL_Mutex_Lock (&(udp->sendMutex));
+    for (i = 0; i < udp->nbSendPackets; i++)
+    {
+        if (udp->sendCallbacks[i].callback != NULL)
+        {
+            udp->sendCallbacks[i].callback (udp->sendCallbacks[i].customData, ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+        }
+    }
+    udp->nbSendPackets = 0;
+    ARSAL_Mutex_Unlock (&(udp->sendMutex));
+}
+
+static int ARSTREAM_TransportUdp_GetEstimatedLatency (void *context)
+{
+    /* The socket knows nothing of the link : the application tells it */
+    return ((ARSTREAM_TransportUdp_t *)context)->estimatedLatencyMs;
+}
+
+static void ARSTREAM_TransportUdp_Destroy (void *context)
+{
+    ARSTREAM_TransportUdp_t *udp = (ARSTREAM_TransportUdp_t *)context;
+    if (udp == NULL)
+    {
+        return;
+    }
+#ifdef ARSTREAM_URING_AVAILABLE
+    /* The kernel must be done with the socket and the buffers before they are released */
+    ARSTREAM_TransportUdp_StopUring (udp);
+#endif
+    if (udp->socket >= 0)
+    {
+        ARSAL_Socket_Close (udp->socket);
+    }
+    if (udp->sendMutexWasInit == 1)
+    {
+        ARSAL_Mutex_Destroy (&(udp->sendMutex));
+    }
+    free (udp->sendSlots);
+    free (udp->sendIovecs);
+    free (udp->sendCallbacks);
+    free (udp->sendMsgs);
+    free (udp->sendMsgFirstPacket);
+    free (udp->sendControls);
+    free (udp->recvSlots);
+    free (udp->recvIovecs);
+    free (udp->recvAddrs);
+    free (udp->recvControls);
+    free (udp->recvMsgs);
+    free (udp);
+}
+
+/*
+ * Implementation
+ */
+
+void ARSTREAM_Transport_UdpParamsDefaultInit (ARSTREAM_Transport_UdpParams_t *params)
+{
+    if (params != NULL)
+    {
+        params->localAddress = NULL;
+        params->localPort = 0;
+        params->remoteAddress = NULL;
+        params->remotePort = 0;
+        params->maxFragmentSize = 0;
+        params->batchSize = ARSTREAM_TRANSPORT_UDP_DEFAULT_BATCH_SIZE;
+        params->socketBufferSize = 0;
+        params->offload = 1;
+        params->ioEngine = ARSTREAM_TRANSPORT_UDP_IO_ENGINE_SYSCALLS;
+        params->estimatedLatencyMs = -1;
+    }
+}
+
+eARSTREAM_ERROR ARSTREAM_Transport_InitUdp (ARSTREAM_Transport_t *transport, const ARSTREAM_Transport_UdpParams_t *params)
+{
+    ARSTREAM_TransportUdp_t *udp = NULL;
+    struct sockaddr_in localAddr;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    int i;
+
+    /* ARGS Check */
+    if ((transport == NULL) ||
+        (params == NULL) ||
+        (params->maxFragmentSize == 0) ||
+        (params->batchSize <= 0) ||
+        (params->batchSize > ARSTREAM_TRANSPORT_UDP_MAX_BATCH_SIZE) ||
+        (params->localPort < 0) ||
+        (params->localPort > 65535) ||
+        ((params->remoteAddress != NULL) &&
+         ((params->remotePort <= 0) || (params->remotePort > 65535))) ||
+        (params->socketBufferSize < 0) ||
+        (params->ioEngine < 0) ||
+        (params->ioEngine >= ARSTREAM_TRANSPORT_UDP_IO_ENGINE_MAX) ||
+        (params->estimatedLatencyMs < -1))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    memset (&localAddr, 0, sizeof (localAddr));
+    localAddr.sin_family = AF_INET;
+    localAddr.sin_port = htons (params->localPort);
+    localAddr.sin_addr.s_addr = htonl (INADDR_ANY);
+    if ((params->localAddress != NULL) &&
+        (inet_pton (AF_INET, params->localAddress, &(localAddr.sin_addr)) != 1))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    /* Alloc context */
+    udp = calloc (1, sizeof (ARSTREAM_TransportUdp_t));
+    if (udp == NULL)
+    {
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    udp->socket = -1;
+#ifdef ARSTREAM_URING_AVAILABLE
+    udp->sendRing.fd = -1;
+    udp->recvRing.fd = -1;
+#endif
+    udp->batchSize = params->batchSize;
+    udp->estimatedLatencyMs = params->estimatedLatencyMs;
+    udp->slotSize = params->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t);
+    if (udp->slotSize < ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE)
+    {
+        udp->slotSize = ARSTREAM_BUFFERS_ACK_BUFFER_COPY_MAX_SIZE;
+    }
+
+    memset (&(udp->remoteAddr), 0, sizeof (udp->remoteAddr));
+    udp->remoteAddr.sin_family = AF_INET;
+    if (params->remoteAddress != NULL)
+    {
+        udp->remoteAddr.sin_port = htons (params->remotePort);
+        if (inet_pton (AF_INET, params->remoteAddress, &(udp->remoteAddr.sin_addr)) != 1)
+        {
+            internalError = ARSTREAM_ERROR_BAD_PARAMETERS;
+        }
+        udp->hasRemoteAddr = 1;
+        udp->remoteAddrIsFixed = 1;
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Mutex_Init (&(udp->sendMutex)) != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            udp->sendMutexWasInit = 1;
+        }
+    }
+
+    /* Open the socket */
+    if (internalError == ARSTREAM_OK)
+    {
+        udp->socket = ARSAL_Socket_Create (AF_INET, SOCK_DGRAM, 0);
+        if (udp->socket < 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Unable to create the socket: %s", strerror (errno));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+    if ((internalError == ARSTREAM_OK) &&
+        (params->socketBufferSize > 0))
+    {
+        int bufferSize = params->socketBufferSize;
+        if ((ARSAL_Socket_Setsockopt (udp->socket, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof (bufferSize)) != 0) ||
+            (ARSAL_Socket_Setsockopt (udp->socket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof (bufferSize)) != 0))
+        {
+            ARSAL_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_TRANSPORT_UDP_TAG, "Unable to set the socket buffer size: %s", strerror (errno));
+        }
+    }
+    if ((internalError == ARSTREAM_OK) &&
+        (ARSAL_Socket_Bind (udp->socket, (struct sockaddr *)&localAddr, sizeof (localAddr)) != 0))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_TRANSPORT_UDP_TAG, "Unable to bind the socket to port %d: %s", params->localPort, strerror (errno));
+        internalError = ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    /* Check the offloads support */
+#ifdef ARSTREAM_TRANSPORT_UDP_HAVE_OFFLOAD
+    if ((internalError == ARSTREAM_OK) &&
+        (params->offload == 1))
+    {
+        int value = 0;
+        socklen_t valueLen = sizeof (value);
+        if (getsockopt (udp->socket, SOL_UDP, UDP_SEGMENT, &value, &valueLen) == 0)
+        {
+            udp->segmentationOffload = 1;
+        }
+        value = 1;
+        if (ARSAL_Socket_Setsockopt (udp->socket, SOL_UDP, UDP_GRO, &value, sizeof (value)) == 0)
+        {
+            udp->receiveOffload = 1;
+        }
+        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_TRANSPORT_UDP_TAG, "Segmentation offload: %d, receive offload: %d", udp->segmentationOffload, udp->receiveOffload);
+    }
+#endif
+
+    /* Alloc packet slots */
+    if (internalError == ARSTREAM_OK)
+    {
+        udp->recvSlotSize = udp->slotSize;
+        udp->nbRecvSlots = udp->batchSize;
+        if (udp->receiveOffload == 1)
+        {
+            /* Fewer, larger slots, as each one can hold many coalesced packets */
+            udp->recvSlotSize = ARSTREAM_TRANSPORT_UDP_GRO_SLOT_SIZE;
+            if (udp->nbRecvSlots > ARSTREAM_TRANSPORT_UDP_GRO_MAX_SLOTS)
+            {
+                udp->nbRecvSlots = ARSTREAM_TRANSPORT_UDP_GRO_MAX_SLOTS;
+            }
+            udp->recvControls = malloc (udp->nbRecvSlots * ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE);
+            if (udp->recvControls == NULL)
+            {
+                internalError = ARSTREAM_ERROR_ALLOC;
+            }
+        }
+        if (params->ioEngine == ARSTREAM_TRANSPORT_UDP_IO_ENGINE_IO_URING)
+        {
+#ifdef ARSTREAM_URING_AVAILABLE
+            /* The kernel writes a message header, the source address and the control data before each payload */
+            int nbSlots = 1;
+            while (nbSlots < udp->nbRecvSlots)
+            {
+                nbSlots <<= 1;
+            }
+            udp->nbRecvSlots = nbSlots;
+            udp->recvHeadroom = sizeof (struct io_uring_recvmsg_out) + sizeof (struct sockaddr_in);
+            if (udp->receiveOffload == 1)
+            {
+                udp->recvHeadroom += ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE;
+            }
+            udp->recvHeadroom = (udp->recvHeadroom + ARSTREAM_TRANSPORT_UDP_SLOT_ALIGNMENT - 1) & ~(ARSTREAM_TRANSPORT_UDP_SLOT_ALIGNMENT - 1);
+            udp->sendUring = 1;
+            udp->recvUring = 1;
+#else
+            ARSAL_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_TRANSPORT_UDP_TAG, "io_uring is not available on this platform, using system calls");
+#endif
+        }
+        udp->sendSlots = malloc (udp->batchSize * udp->slotSize);
+        udp->sendIovecs = calloc (udp->batchSize, sizeof (struct iovec));
+        udp->sendCallbacks = calloc (udp->batchSize, sizeof (ARSTREAM_TransportUdp_SendCallbackParam_t));
+        udp->sendMsgs = calloc (udp->batchSize, sizeof (ARSTREAM_TransportUdp_Msg_t));
+        udp->sendMsgFirstPacket = calloc (udp->batchSize, sizeof (int));
+        udp->sendControls = malloc (udp->batchSize * ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE);
+        udp->recvSlotStride = (udp->recvHeadroom + udp->recvSlotSize + ARSTREAM_TRANSPORT_UDP_SLOT_ALIGNMENT - 1) & ~(ARSTREAM_TRANSPORT_UDP_SLOT_ALIGNMENT - 1);
+        udp->recvSlots = malloc (udp->nbRecvSlots * udp->recvSlotStride);
+        udp->recvIovecs = calloc (udp->nbRecvSlots, sizeof (struct iovec));
+        udp->recvAddrs = calloc (udp->nbRecvSlots, sizeof (struct sockaddr_in));
+        udp->recvMsgs = calloc (udp->nbRecvSlots, sizeof (ARSTREAM_TransportUdp_Msg_t));
+        if ((udp->sendSlots == NULL) ||
+            (udp->sendIovecs == NULL) ||
+            (udp->sendCallbacks == NULL) ||
+            (udp->sendMsgs == NULL) ||
+            (udp->sendMsgFirstPacket == NULL) ||
+            (udp->sendControls == NULL) ||
+            (udp->recvSlots == NULL) ||
+            (udp->recvIovecs == NULL) ||
+            (udp->recvAddrs == NULL) ||
+            (udp->recvMsgs == NULL))
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+    }
+
+    /* Preset the buffers, only lengths change afterwards */
+    if (internalError == ARSTREAM_OK)
+    {
+        for (i = 0; i < udp->batchSize; i++)
+        {
+            udp->sendIovecs[i].iov_base = &(udp->sendSlots[i * udp->slotSize]);
+        }
+        for (i = 0; i < udp->nbRecvSlots; i++)
+        {
+            udp->recvIovecs[i].iov_base = &(udp->recvSlots[i * udp->recvSlotStride + udp->recvHeadroom]);
+            udp->recvIovecs[i].iov_len = udp->recvSlotSize;
+            udp->recvMsgs[i].msg_hdr.msg_name = &(udp->recvAddrs[i]);
+            udp->recvMsgs[i].msg_hdr.msg_namelen = sizeof (struct sockaddr_in);
+            udp->recvMsgs[i].msg_hdr.msg_iov = &(udp->recvIovecs[i]);
+            udp->recvMsgs[i].msg_hdr.msg_iovlen = 1;
+            if (udp->recvControls != NULL)
+            {
+                udp->recvMsgs[i].msg_hdr.msg_control = &(udp->recvControls[i * ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE]);
+                udp->recvMsgs[i].msg_hdr.msg_controllen = ARSTREAM_TRANSPORT_UDP_CONTROL_SIZE;
+            }
+        }
+    }
+
+#ifdef ARSTREAM_URING_AVAILABLE
+    if ((internalError == ARSTREAM_OK) &&
+        (udp->sendUring == 1))
+    {
+        int ret = ARSTREAM_TransportUdp_InitUring (udp);
+        if (ret < 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_TRANSPORT_UDP_TAG, "io_uring is not available (%s), using system calls", strerror (-ret));
+            ARSTREAM_Uring_Destroy (&(udp->sendRing));
+            ARSTREAM_Uring_Destroy (&(udp->recvRing));
+            udp->sendUring = 0;
+            udp->recvUring = 0;
+        }
+    }
+#endif
+
+    if (internalError != ARSTREAM_OK)
+    {
+        ARSTREAM_TransportUdp_Destroy (udp);
+        return internalError;
+    }
+
+    transport->sendFragment = ARSTREAM_TransportUdp_SendFragment;
+    transport->submit = ARSTREAM_TransportUdp_Submit;
+    transport->receiveFragment = ARSTREAM_TransportUdp_ReceivePacket;
+    transport->sendAck = ARSTREAM_TransportUdp_SendAck;
+    transport->receiveAck = ARSTREAM_TransportUdp_ReceivePacket;
+    transport->flush = ARSTREAM_TransportUdp_Flush;
+    transport->getEstimatedLatency = ARSTREAM_TransportUdp_GetEstimatedLatency;
+    transport->destroy = ARSTREAM_TransportUdp_Destroy;
+    transport->context = udp;
+    return ARSTREAM_OK;
+}
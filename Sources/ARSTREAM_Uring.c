@@ -0,0 +1,287 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Uring.c
+ * @brief Minimal io_uring wrapper (raw system calls, no liburing)
+ * @date 10/17/2026
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_Uring.h"
+
+#ifdef ARSTREAM_URING_AVAILABLE
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_URING_LOAD_ACQUIRE(p) __atomic_load_n ((p), __ATOMIC_ACQUIRE)
+#define ARSTREAM_URING_STORE_RELEASE(p, v) __atomic_store_n ((p), (v), __ATOMIC_RELEASE)
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief io_uring_enter() system call
+ */
+static int ARSTREAM_Uring_Enter (int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize);
+
+/*
+ * Internal functions implementation
+ */
+
+static int ARSTREAM_Uring_Enter (int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize)
+{
+    return (int)syscall (__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize);
+}
+
+/*
+ * Implementation
+ */
+
+int ARSTREAM_Uring_Init (ARSTREAM_Uring_t *ring, unsigned nbEntries, unsigned nbCqEntries)
+{
+    struct io_uring_params params;
+    uint8_t *ringPtr;
+    size_t ringSize;
+    unsigned i;
+
+    memset (ring, 0, sizeof (ARSTREAM_Uring_t));
+    ring->fd = -1;
+    ring->bufGroup = -1;
+
+    memset (&params, 0, sizeof (params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = nbCqEntries;
+    ring->fd = (int)syscall (__NR_io_uring_setup, nbEntries, &params);
+    if (ring->fd < 0)
+    {
+        ring->fd = -1;
+        return -errno;
+    }
+    /* Single mapping of both queues (Linux 5.4) and waits with a timeout (Linux 5.11) */
+    if (((params.features & IORING_FEAT_SINGLE_MMAP) == 0) ||
+        ((params.features & IORING_FEAT_EXT_ARG) == 0))
+    {
+        return -ENOSYS;
+    }
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof (struct io_uring_cqe);
+    ringSize = (ring->sqRingSize > ring->cqRingSize) ? ring->sqRingSize : ring->cqRingSize;
+    ringPtr = mmap (NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ringPtr == MAP_FAILED)
+    {
+        return -errno;
+    }
+    ring->sqRingPtr = ringPtr;
+    ring->sqRingSize = ringSize;
+    ring->cqRingPtr = ringPtr;
+    ring->cqRingSize = ringSize;
+
+    ring->sqesSize = params.sq_entries * sizeof (struct io_uring_sqe);
+    ring->sqes = mmap (NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        ring->sqes = NULL;
+        return -errno;
+    }
+
+    ring->sqHead = (unsigned *)(ringPtr + params.sq_off.head);
+    ring->sqTail = (unsigned *)(ringPtr + params.sq_off.tail);
+    ring->sqMask = *(unsigned *)(ringPtr + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)(ringPtr + params.sq_off.array);
+    ring->sqeTail = *(ring->sqTail);
+    ring->cqHead = (unsigned *)(ringPtr + params.cq_off.head);
+    ring->cqTail = (unsigned *)(ringPtr + params.cq_off.tail);
+    ring->cqMask = *(unsigned *)(ringPtr + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(ringPtr + params.cq_off.cqes);
+
+    /* Entries are always used in order : the indirection array is the identity */
+    for (i = 0; i < params.sq_entries; i++)
+    {
+        ring->sqArray[i] = i;
+    }
+    return 0;
+}
+
+void ARSTREAM_Uring_Destroy (ARSTREAM_Uring_t *ring)
+{
+    if (ring->bufRing != NULL)
+    {
+        if (ring->bufGroup >= 0)
+        {
+            struct io_uring_buf_reg reg;
+            memset (&reg, 0, sizeof (reg));
+            reg.bgid = ring->bufGroup;
+            syscall (__NR_io_uring_register, ring->fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        }
+        munmap (ring->bufRing, ring->bufRingSize);
+    }
+    if (ring->sqes != NULL)
+    {
+        munmap (ring->sqes, ring->sqesSize);
+    }
+    if (ring->sqRingPtr != NULL)
+    {
+        munmap (ring->sqRingPtr, ring->sqRingSize);
+    }
+    if (ring->fd >= 0)
+    {
+        close (ring->fd);
+    }
+    memset (ring, 0, sizeof (ARSTREAM_Uring_t));
+    ring->fd = -1;
+    ring->bufGroup = -1;
+}
+
+struct io_uring_sqe *ARSTREAM_Uring_GetSqe (ARSTREAM_Uring_t *ring)
+{
+    struct io_uring_sqe *sqe;
+    unsigned head = ARSTREAM_URING_LOAD_ACQUIRE (ring->sqHead);
+    if (ring->sqeTail - head > ring->sqMask)
+    {
+        return NULL;
+    }
+    sqe = &(ring->sqes[ring->sqeTail & ring->sqMask]);
+    ring->sqeTail++;
+    memset (sqe, 0, sizeof (struct io_uring_sqe));
+    return sqe;
+}
+
+int ARSTREAM_Uring_Submit (ARSTREAM_Uring_t *ring, unsigned waitNr)
+{
+    unsigned toSubmit = ring->sqeTail - *(ring->sqTail);
+    unsigned flags = (waitNr > 0) ? IORING_ENTER_GETEVENTS : 0;
+    int ret;
+
+    ARSTREAM_URING_STORE_RELEASE (ring->sqTail, ring->sqeTail);
+    do
+    {
+        ret = ARSTREAM_Uring_Enter (ring->fd, toSubmit, waitNr, flags, NULL, 0);
+    } while ((ret < 0) && (errno == EINTR));
+    return (ret < 0) ? -errno : ret;
+}
+
+int ARSTREAM_Uring_WaitCqe (ARSTREAM_Uring_t *ring, struct io_uring_cqe **cqe, int timeoutMs)
+{
+    for (;;)
+    {
+        struct __kernel_timespec ts;
+        struct io_uring_getevents_arg arg;
+        unsigned head = *(ring->cqHead);
+        if (head != ARSTREAM_URING_LOAD_ACQUIRE (ring->cqTail))
+        {
+            *cqe = &(ring->cqes[head & ring->cqMask]);
+            return 0;
+        }
+
+        memset (&arg, 0, sizeof (arg));
+        if (timeoutMs >= 0)
+        {
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = (timeoutMs % 1000) * 1000000LL;
+            arg.ts = (uint64_t)(uintptr_t)&ts;
+        }
+        if (ARSTREAM_Uring_Enter (ring->fd, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof (arg)) < 0)
+        {
+            return -errno;
+        }
+    }
+}
+
+void ARSTREAM_Uring_CqeSeen (ARSTREAM_Uring_t *ring)
+{
+    ARSTREAM_URING_STORE_RELEASE (ring->cqHead, *(ring->cqHead) + 1);
+}
+
+int ARSTREAM_Uring_SetupBufRing (ARSTREAM_Uring_t *ring, uint16_t bufGroup, unsigned nbBuffers)
+{
+    struct io_uring_buf_reg reg;
+    void *bufRing;
+
+    ring->bufRingSize = nbBuffers * sizeof (struct io_uring_buf);
+    bufRing = mmap (NULL, ring->bufRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (bufRing == MAP_FAILED)
+    {
+        return -errno;
+    }
+    ring->bufRing = bufRing;
+    ring->bufRingMask = nbBuffers - 1;
+    ring->bufRingTail = 0;
+
+    memset (&reg, 0, sizeof (reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)bufRing;
+    reg.ring_entries = nbBuffers;
+    reg.bgid = bufGroup;
+    if (syscall (__NR_io_uring_register, ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0)
+    {
+        return -errno;
+    }
+    ring->bufGroup = bufGroup;
+    return 0;
+}
+
+void ARSTREAM_Uring_AddBuffer (ARSTREAM_Uring_t *ring, void *addr, unsigned len, uint16_t bufId)
+{
+    struct io_uring_buf *buf = &(ring->bufRing->bufs[ring->bufRingTail & ring->bufRingMask]);
+    buf->addr = (uint64_t)(uintptr_t)addr;
+    buf->len = len;
+    buf->bid = bufId;
+    ring->bufRingTail++;
+}
+
+void ARSTREAM_Uring_CommitBuffers (ARSTREAM_Uring_t *ring)
+{
+    ARSTREAM_URING_STORE_RELEASE (&(ring->bufRing->tail), ring->bufRingTail);
+}
+
+#endif /* ARSTREAM_URING_AVAILABLE */
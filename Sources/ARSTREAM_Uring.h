@@ -0,0 +1,190 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Uring.h
+ * @brief Minimal io_uring wrapper (raw system calls, no liburing)
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_URING_PRIVATE_H_
+#define _ARSTREAM_URING_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+#include <stddef.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#endif
+
+/*
+ * Private Headers
+ */
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Defined when the io_uring features used by ARStream (provided buffer rings,
+ * multishot receive, waits with a timeout) are known by the system headers
+ * The running kernel may still lack them : ARSTREAM_Uring_Init() or the first
+ * request will then fail, and the caller must fall back to plain system calls.
+ */
+#if defined(__linux__) && defined(IORING_RECV_MULTISHOT) && defined(IORING_ENTER_EXT_ARG)
+#define ARSTREAM_URING_AVAILABLE (1)
+#endif
+
+#ifdef ARSTREAM_URING_AVAILABLE
+
+/*
+ * Types
+ */
+
+/**
+ * @brief An io_uring instance, with an optional provided buffer ring
+ * A ring must only be used by one thread at a time.
+ */
+typedef struct {
+    int fd; /**< Ring file descriptor, -1 if not initialized */
+
+    /* Submission queue */
+    void *sqRingPtr;
+    size_t sqRingSize;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned sqMask;
+    unsigned *sqArray;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+    unsigned sqeTail; /**< Local tail, published to the kernel on submit */
+
+    /* Completion queue */
+    void *cqRingPtr; /**< Same as sqRingPtr with IORING_FEAT_SINGLE_MMAP */
+    size_t cqRingSize;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned cqMask;
+    struct io_uring_cqe *cqes;
+
+    /* Provided buffer ring */
+    struct io_uring_buf_ring *bufRing;
+    size_t bufRingSize;
+    unsigned bufRingMask;
+    uint16_t bufRingTail; /**< Local tail, published by ARSTREAM_Uring_CommitBuffers() */
+    int bufGroup; /**< Buffer group id, -1 if no buffer ring */
+} ARSTREAM_Uring_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Creates an io_uring instance
+ * @param ring The ring to initialize
+ * @param nbEntries Number of submission queue entries
+ * @param nbCqEntries Number of completion queue entries (at least nbEntries)
+ * @return 0 on success, or a negative errno value
+ * @note On failure, the ring is left in a state where ARSTREAM_Uring_Destroy() can be called
+ */
+int ARSTREAM_Uring_Init (ARSTREAM_Uring_t *ring, unsigned nbEntries, unsigned nbCqEntries);
+
+/**
+ * @brief Releases an io_uring instance and its buffer ring
+ * @param ring The ring to release
+ */
+void ARSTREAM_Uring_Destroy (ARSTREAM_Uring_t *ring);
+
+/**
+ * @brief Gets a free submission queue entry
+ * @param ring The ring
+ * @return A zeroed entry, or NULL if the submission queue is full
+ */
+struct io_uring_sqe *ARSTREAM_Uring_GetSqe (ARSTREAM_Uring_t *ring);
+
+/**
+ * @brief Submits the pending entries, then optionally waits for completions
+ * @param ring The ring
+ * @param waitNr Number of completions to wait for
+ * @return The number of submitted entries, or a negative errno value
+ */
+int ARSTREAM_Uring_Submit (ARSTREAM_Uring_t *ring, unsigned waitNr);
+
+/**
+ * @brief Gets the next completion, waiting for it if needed
+ * @param ring The ring
+ * @param cqe Pointer which will hold the completion
+ * @param timeoutMs Maximum wait time, or -1 to wait forever
+ * @return 0 on success, -ETIME on timeout, or a negative errno value
+ * @note The completion must be released with ARSTREAM_Uring_CqeSeen()
+ */
+int ARSTREAM_Uring_WaitCqe (ARSTREAM_Uring_t *ring, struct io_uring_cqe **cqe, int timeoutMs);
+
+/**
+ * @brief Releases the completion returned by ARSTREAM_Uring_WaitCqe()
+ * @param ring The ring
+ */
+void ARSTREAM_Uring_CqeSeen (ARSTREAM_Uring_t *ring);
+
+/**
+ * @brief Registers a provided buffer ring, from which receive requests pick their buffers
+ * @param ring The ring
+ * @param bufGroup The buffer group id
+ * @param nbBuffers Number of buffers (a power of two, up to 32768)
+ * @return 0 on success, or a negative errno value
+ */
+int ARSTREAM_Uring_SetupBufRing (ARSTREAM_Uring_t *ring, uint16_t bufGroup, unsigned nbBuffers);
+
+/**
+ * @brief Gives a buffer to the provided buffer ring
+ * The buffer is only visible to the kernel after ARSTREAM_Uring_CommitBuffers()
+ * @param ring The ring
+ * @param addr The buffer
+ * @param len The buffer size
+ * @param bufId The buffer id, reported in the completions which use this buffer
+ */
+void ARSTREAM_Uring_AddBuffer (ARSTREAM_Uring_t *ring, void *addr, unsigned len, uint16_t bufId);
+
+/**
+ * @brief Publishes the buffers added by ARSTREAM_Uring_AddBuffer()
+ * @param ring The ring
+ */
+void ARSTREAM_Uring_CommitBuffers (ARSTREAM_Uring_t *ring);
+
+#endif /* ARSTREAM_URING_AVAILABLE */
+
+#endif /* _ARSTREAM_URING_PRIVATE_H_ */
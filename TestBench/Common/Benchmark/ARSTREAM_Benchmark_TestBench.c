@@ -0,0 +1,833 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Benchmark_TestBench.c
+ * @brief End-to-end benchmark of sender/reader pairs over in-process, shared memory, UDP and ARNetwork links
+ * @date 10/17/2026
+ */
+
+/*
+ * System Headers
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Time.h>
+#include <libARStream/ARSTREAM_Sender.h>
+#include <libARStream/ARSTREAM_Reader.h>
+#include <libARStream/ARSTREAM_Transport.h>
+
+#include "ARSTREAM_Benchmark_TestBench.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "ARSTREAM_Benchmark_TB"
+
+#define DEFAULT_DURATION_MS (2000)
+#define SMOKE_DURATION_MS (1000)
+#define DRAIN_TIME_MS (500)
+
+#define MAX_NB_FRAG (128)
+#define MAX_NB_FILTERS (8)
+#define NB_BUFFERS (32)
+
+#define I_FRAME_EVERY_N (30)
+
+/**
+ * @brief Frame header written by the fake encoder : frame number and send time
+ */
+#define FRAME_HEADER_SIZE (12)
+
+/**
+ * @brief Ports of the links over 127.0.0.1
+ */
+#define UDP_READER_PORT (47350)
+#define UDP_SENDER_PORT (47351)
+#define ARNETWORK_READER_PORT (47360)
+#define ARNETWORK_SENDER_PORT (47361)
+#define ARNETWORK_DATA_BUFFER_ID (125)
+#define ARNETWORK_ACK_BUFFER_ID (13)
+#define ARNETWORK_RECV_TIMEOUT_S (1)
+
+#define NB_ELEMENTS(array) ((int)(sizeof (array) / sizeof ((array)[0])))
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Link between the sender and the reader
+ */
+typedef enum {
+    ARSTREAM_BENCHMARKTB_LINK_LOOPBACK = 0, // In-process lock-free queues
+    ARSTREAM_BENCHMARKTB_LINK_SHM, // Shared memory rings
+    ARSTREAM_BENCHMARKTB_LINK_UDP, // UDP over 127.0.0.1, sendmmsg() / recvmmsg()
+    ARSTREAM_BENCHMARKTB_LINK_UDP_OFFLOAD, // UDP over 127.0.0.1, with segmentation and receive offload
+    ARSTREAM_BENCHMARKTB_LINK_UDP_IO_URING, // UDP over 127.0.0.1, io_uring engine
+    ARSTREAM_BENCHMARKTB_LINK_ARNETWORK, // ARNetwork managers over 127.0.0.1 (the ARSTREAM_Sender_New() transport)
+    ARSTREAM_BENCHMARKTB_LINK_MAX,
+} eARSTREAM_BENCHMARKTB_LINK;
+
+/**
+ * @brief One point of the sweep
+ */
+typedef struct {
+    eARSTREAM_BENCHMARKTB_LINK link;
+    int frameSize;
+    int fragmentSize;
+    int fps;
+    double lossPercent;
+    int nbFilters;
+} ARSTREAM_BenchmarkTb_Config_t;
+
+/**
+ * @brief Resources of a link, other than the transports
+ */
+typedef struct {
+    int shmFd; // -1 if none
+    ARNETWORKAL_Manager_t *alManagers [2]; // Sender side, reader side
+    ARNETWORK_Manager_t *managers [2];
+    pthread_t threads [4];
+    int nbThreads;
+} ARSTREAM_BenchmarkTb_Link_t;
+
+/**
+ * @brief State and results of one run
+ */
+typedef struct {
+    ARSTREAM_BenchmarkTb_Config_t config;
+
+    pthread_mutex_t mutex; // Protects the buffers flags
+    uint8_t *buffers [NB_BUFFERS];
+    int bufferIsFree [NB_BUFFERS];
+    uint8_t *readerBuffer;
+
+    ARSTREAM_Filter_t filters [MAX_NB_FILTERS];
+
+    uint32_t nbEncoded;
+    uint32_t nbSubmitted;
+    uint64_t nbSubmittedFragments;
+    uint32_t nbAcked;
+    uint32_t nbCancelled;
+
+    /* Reader thread only */
+    uint32_t nbReceived;
+    uint64_t nbReceivedBytes;
+    uint32_t *latenciesUs;
+    int maxLatencies;
+} ARSTREAM_BenchmarkTb_Run_t;
+
+/**
+ * @brief Counters of a finished run, checked by the smoke mode
+ */
+typedef struct {
+    uint32_t nbSubmitted;
+    uint32_t nbAcked;
+    uint32_t nbCancelled;
+    uint32_t nbReceived;
+} ARSTREAM_BenchmarkTb_Result_t;
+
+/*
+ * Globals
+ */
+
+/* Sweep values : by default each dimension is swept around the first (baseline) value */
+static const eARSTREAM_BENCHMARKTB_LINK links [] = {
+    ARSTREAM_BENCHMARKTB_LINK_LOOPBACK,
+    ARSTREAM_BENCHMARKTB_LINK_SHM,
+    ARSTREAM_BENCHMARKTB_LINK_UDP,
+    ARSTREAM_BENCHMARKTB_LINK_UDP_OFFLOAD,
+    ARSTREAM_BENCHMARKTB_LINK_UDP_IO_URING,
+    ARSTREAM_BENCHMARKTB_LINK_ARNETWORK,
+};
+static const int frameSizes [] = { 16000, 4000, 64000 };
+static const int fragmentSizes [] = { 1000, 1400, 4000 };
+static const int fpsValues [] = { 30, 15, 60 };
+static const double lossPercents [] = { 0.0, 1.0, 5.0 };
+static const int nbFiltersValues [] = { 0, 2, 8 };
+
+static const char *linkNames [ARSTREAM_BENCHMARKTB_LINK_MAX] = {
+    "loopback",
+    "shm",
+    "udp",
+    "udp_offload",
+    "udp_io_uring",
+    "arnetwork",
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Print the parameters of the application
+ */
+static void ARSTREAM_BenchmarkTb_PrintUsage (const char *appName);
+
+/**
+ * @brief Gets a time in microseconds
+ */
+static uint64_t ARSTREAM_BenchmarkTb_TimeUs (clockid_t clockId);
+
+/**
+ * @brief Copy filter : the cost of a filter stage is one buffer allocation and one copy
+ */
+static uint8_t* ARSTREAM_BenchmarkTb_FilterGetBuffer (void *context, int size);
+static int ARSTREAM_BenchmarkTb_FilterGetOutputSize (void *context, int inputSize);
+static int ARSTREAM_BenchmarkTb_FilterBuffer (void *context, uint8_t *input, int inSize, uint8_t *output, int outSize);
+static void ARSTREAM_BenchmarkTb_FilterReleaseBuffer (void *context, uint8_t *buffer);
+
+/**
+ * @see ARSTREAM_Sender.h
+ */
+static void ARSTREAM_BenchmarkTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
+
+/**
+ * @see ARSTREAM_Reader.h
+ */
+static uint8_t* ARSTREAM_BenchmarkTb_FrameCompleteCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom);
+
+/**
+ * @brief Comparison function for qsort
+ */
+static int ARSTREAM_BenchmarkTb_CompareLatencies (const void *a, const void *b);
+
+/**
+ * @brief Gets a percentile of the sorted latencies, in milliseconds
+ */
+static double ARSTREAM_BenchmarkTb_Percentile (const ARSTREAM_BenchmarkTb_Run_t *run, double percentile);
+
+/**
+ * @brief Sets up the sender and reader transports of a link
+ * @param link The link resources, to release with ARSTREAM_BenchmarkTb_CloseLink() even on failure
+ * @return ARSTREAM_OK, or the error of the failed setup step
+ */
+static eARSTREAM_ERROR ARSTREAM_BenchmarkTb_OpenLink (ARSTREAM_BenchmarkTb_Link_t *link, const ARSTREAM_BenchmarkTb_Config_t *config, ARSTREAM_Transport_t *senderTransport, ARSTREAM_Transport_t *readerTransport);
+
+/**
+ * @brief Releases the resources of a link, once its transports were destroyed
+ */
+static void ARSTREAM_BenchmarkTb_CloseLink (ARSTREAM_BenchmarkTb_Link_t *link);
+
+/**
+ * @brief Runs one configuration and prints its CSV line
+ * @param[out] result Counters of the run, may be NULL
+ * @return 0, or -1 on error
+ */
+static int ARSTREAM_BenchmarkTb_Run (const ARSTREAM_BenchmarkTb_Config_t *config, int durationMs, ARSTREAM_BenchmarkTb_Result_t *result);
+
+/**
+ * @brief Runs the baseline configuration for a short time on each local link, with loss and filters, and checks its counters
+ * The ARNetwork link is only run by the sweep.
+ * @return 0 if all checks passed, 1 otherwise
+ */
+static int ARSTREAM_BenchmarkTb_Smoke (void);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_BenchmarkTb_PrintUsage (const char *appName)
+{
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Usage : %s [durationMs [full]]", appName);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        %s --smoke", appName);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        durationMs -> streaming time of each configuration (default %d)", DEFAULT_DURATION_MS);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        full       -> run all the combinations instead of one dimension at a time");
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        --smoke    -> short checked run of the baseline with loss and filters (%d ms) on each link but ARNetwork", SMOKE_DURATION_MS);
+}
+
+static uint64_t ARSTREAM_BenchmarkTb_TimeUs (clockid_t clockId)
+{
+    struct timespec ts;
+    clock_gettime (clockId, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint8_t* ARSTREAM_BenchmarkTb_FilterGetBuffer (void *context, int size)
+{
+    (void)context;
+    return malloc (size);
+}
+
+static int ARSTREAM_BenchmarkTb_FilterGetOutputSize (void *context, int inputSize)
+{
+    (void)context;
+    return inputSize;
+}
+
+static int ARSTREAM_BenchmarkTb_FilterBuffer (void *context, uint8_t *input, int inSize, uint8_t *output, int outSize)
+{
+    int cpSize = (inSize < outSize) ? inSize : outSize;
+    (void)context;
+    memcpy (output, input, cpSize);
+    return cpSize;
+}
+
+static void ARSTREAM_BenchmarkTb_FilterReleaseBuffer (void *context, uint8_t *buffer)
+{
+    (void)context;
+    free (buffer);
+}
+
+static void ARSTREAM_BenchmarkTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom)
+{
+    ARSTREAM_BenchmarkTb_Run_t *run = (ARSTREAM_BenchmarkTb_Run_t *)custom;
+    int i;
+    (void)frameSize;
+
+    pthread_mutex_lock (&(run->mutex));
+    switch (status)
+    {
+    case ARSTREAM_SENDER_STATUS_FRAME_SENT:
+        run->nbAcked++;
+        break;
+    case ARSTREAM_SENDER_STATUS_FRAME_CANCEL:
+    case ARSTREAM_SENDER_STATUS_FRAME_EXPIRED:
+        run->nbCancelled++;
+        break;
+    default:
+        break;
+    }
+    for (i = 0; i < NB_BUFFERS; i++)
+    {
+        if (run->buffers[i] == framePointer)
+        {
+            run->bufferIsFree[i] = 1;
+        }
+    }
+    pthread_mutex_unlock (&(run->mutex));
+}
+
+static uint8_t* ARSTREAM_BenchmarkTb_FrameCompleteCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom)
+{
+    ARSTREAM_BenchmarkTb_Run_t *run = (ARSTREAM_BenchmarkTb_Run_t *)custom;
+    (void)numberOfSkippedFrames;
+    (void)isFlushFrame;
+
+    if ((cause == ARSTREAM_READER_CAUSE_FRAME_COMPLETE) &&
+        (frameSize >= FRAME_HEADER_SIZE))
+    {
+        uint64_t sendTimeUs;
+        memcpy (&sendTimeUs, framePointer + sizeof (uint32_t), sizeof (sendTimeUs));
+        if (run->nbReceived < (uint32_t)run->maxLatencies)
+        {
+            run->latenciesUs[run->nbReceived] = (uint32_t)(ARSTREAM_BenchmarkTb_TimeUs (CLOCK_MONOTONIC) - sendTimeUs);
+            run->nbReceived++;
+        }
+        run->nbReceivedBytes += frameSize;
+    }
+    /* The frame is consumed here : the same buffer can hold the next one */
+    *newBufferCapacity = run->config.frameSize;
+    return run->readerBuffer;
+}
+
+static int ARSTREAM_BenchmarkTb_CompareLatencies (const void *a, const void *b)
+{
+    uint32_t la = *(const uint32_t *)a;
+    uint32_t lb = *(const uint32_t *)b;
+    return (la > lb) - (la < lb);
+}
+
+static double ARSTREAM_BenchmarkTb_Percentile (const ARSTREAM_BenchmarkTb_Run_t *run, double percentile)
+{
+    int index;
+    if (run->nbReceived == 0)
+    {
+        return -1.0;
+    }
+    index = (int)(percentile * run->nbReceived);
+    if (index >= (int)run->nbReceived)
+    {
+        index = run->nbReceived - 1;
+    }
+    return run->latenciesUs[index] / 1000.0;
+}
+
+static eARSTREAM_ERROR ARSTREAM_BenchmarkTb_OpenLink (ARSTREAM_BenchmarkTb_Link_t *link, const ARSTREAM_BenchmarkTb_Config_t *config, ARSTREAM_Transport_t *senderTransport, ARSTREAM_Transport_t *readerTransport)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    ARSTREAM_Transport_LoopbackParams_t loopbackParams;
+    ARSTREAM_Transport_ShmParams_t shmParams;
+    ARSTREAM_Transport_UdpParams_t udpParams;
+    ARNETWORK_IOBufferParam_t dataParams, ackParams;
+    int i;
+
+    memset (link, 0, sizeof (*link));
+    link->shmFd = -1;
+    memset (senderTransport, 0, sizeof (*senderTransport));
+    memset (readerTransport, 0, sizeof (*readerTransport));
+
+    switch (config->link)
+    {
+    case ARSTREAM_BENCHMARKTB_LINK_LOOPBACK:
+        ARSTREAM_Transport_LoopbackParamsDefaultInit (&loopbackParams);
+        loopbackParams.maxFragmentSize = config->fragmentSize;
+        err = ARSTREAM_Transport_InitLoopback (senderTransport, readerTransport, &loopbackParams);
+        break;
+    case ARSTREAM_BENCHMARKTB_LINK_SHM:
+        ARSTREAM_Transport_ShmParamsDefaultInit (&shmParams);
+        shmParams.maxFragmentSize = config->fragmentSize;
+        err = ARSTREAM_Transport_InitShmCreate (senderTransport, &shmParams, ARSTREAM_TRANSPORT_SHM_SIDE_SENDER, &(link->shmFd));
+        if (err == ARSTREAM_OK)
+        {
+            err = ARSTREAM_Transport_InitShmAttach (readerTransport, link->shmFd, ARSTREAM_TRANSPORT_SHM_SIDE_READER);
+        }
+        break;
+    case ARSTREAM_BENCHMARKTB_LINK_UDP:
+    case ARSTREAM_BENCHMARKTB_LINK_UDP_OFFLOAD:
+    case ARSTREAM_BENCHMARKTB_LINK_UDP_IO_URING:
+        /* The reader answers to the address of the received packets */
+        ARSTREAM_Transport_UdpParamsDefaultInit (&udpParams);
+        udpParams.maxFragmentSize = config->fragmentSize;
+        udpParams.offload = (config->link == ARSTREAM_BENCHMARKTB_LINK_UDP_OFFLOAD) ? 1 : 0;
+        udpParams.ioEngine = (config->link == ARSTREAM_BENCHMARKTB_LINK_UDP_IO_URING) ? ARSTREAM_TRANSPORT_UDP_IO_ENGINE_IO_URING : ARSTREAM_TRANSPORT_UDP_IO_ENGINE_SYSCALLS;
+        udpParams.estimatedLatencyMs = 0;
+        udpParams.localPort = UDP_READER_PORT;
+        err = ARSTREAM_Transport_InitUdp (readerTransport, &udpParams);
+        if (err == ARSTREAM_OK)
+        {
+            udpParams.localPort = UDP_SENDER_PORT;
+            udpParams.remoteAddress = "127.0.0.1";
+            udpParams.remotePort = UDP_READER_PORT;
+            err = ARSTREAM_Transport_InitUdp (senderTransport, &udpParams);
+        }
+        break;
+    case ARSTREAM_BENCHMARKTB_LINK_ARNETWORK:
+        ARSTREAM_Sender_InitStreamDataBuffer (&dataParams, ARNETWORK_DATA_BUFFER_ID, config->fragmentSize, MAX_NB_FRAG);
+        ARSTREAM_Sender_InitStreamAckBuffer (&ackParams, ARNETWORK_ACK_BUFFER_ID);
+        for (i = 0; (err == ARSTREAM_OK) && (i < 2); i++)
+        {
+            eARNETWORKAL_ERROR alError = ARNETWORKAL_OK;
+            eARNETWORK_ERROR netError = ARNETWORK_OK;
+            /* Index 0 is the sender side : it sends the data buffer and receives the ack buffer */
+            link->alManagers[i] = ARNETWORKAL_Manager_New (&alError);
+            if (alError == ARNETWORKAL_OK)
+            {
+                alError = ARNETWORKAL_Manager_InitWifiNetwork (link->alManagers[i], "127.0.0.1",
+                                                               (i == 0) ? ARNETWORK_READER_PORT : ARNETWORK_SENDER_PORT,
+                                                               (i == 0) ? ARNETWORK_SENDER_PORT : ARNETWORK_READER_PORT,
+                                                               ARNETWORK_RECV_TIMEOUT_S);
+            }
+            if (alError == ARNETWORKAL_OK)
+            {
+                link->managers[i] = ARNETWORK_Manager_New (link->alManagers[i],
+                                                           1, (i == 0) ? &dataParams : &ackParams,
+                                                           1, (i == 0) ? &ackParams : &dataParams,
+                                                           0, NULL, NULL, &netError);
+            }
+            if ((alError != ARNETWORKAL_OK) ||
+                (netError != ARNETWORK_OK) ||
+                (link->managers[i] == NULL))
+            {
+                ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create the ARNetwork managers : %s / %s", ARNETWORKAL_Error_ToString (alError), ARNETWORK_Error_ToString (netError));
+                err = ARSTREAM_ERROR_TRANSPORT;
+            }
+            else
+            {
+                pthread_create (&(link->threads[link->nbThreads++]), NULL, ARNETWORK_Manager_SendingThreadRun, link->managers[i]);
+                pthread_create (&(link->threads[link->nbThreads++]), NULL, ARNETWORK_Manager_ReceivingThreadRun, link->managers[i]);
+            }
+        }
+        if (err == ARSTREAM_OK)
+        {
+            err = ARSTREAM_Transport_InitARNetwork (senderTransport, link->managers[0], ARNETWORK_DATA_BUFFER_ID, ARNETWORK_ACK_BUFFER_ID);
+        }
+        if (err == ARSTREAM_OK)
+        {
+            err = ARSTREAM_Transport_InitARNetwork (readerTransport, link->managers[1], ARNETWORK_DATA_BUFFER_ID, ARNETWORK_ACK_BUFFER_ID);
+        }
+        break;
+    default:
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+        break;
+    }
+    return err;
+}
+
+static void ARSTREAM_BenchmarkTb_CloseLink (ARSTREAM_BenchmarkTb_Link_t *link)
+{
+    int i;
+    for (i = 0; i < 2; i++)
+    {
+        if (link->managers[i] != NULL)
+        {
+            ARNETWORK_Manager_Stop (link->managers[i]);
+        }
+    }
+    for (i = 0; i < link->nbThreads; i++)
+    {
+        pthread_join (link->threads[i], NULL);
+    }
+    for (i = 0; i < 2; i++)
+    {
+        if (link->managers[i] != NULL)
+        {
+            ARNETWORK_Manager_Delete (&(link->managers[i]));
+        }
+        if (link->alManagers[i] != NULL)
+        {
+            ARNETWORKAL_Manager_CloseWifiNetwork (link->alManagers[i]);
+            ARNETWORKAL_Manager_Delete (&(link->alManagers[i]));
+        }
+    }
+    if (link->shmFd >= 0)
+    {
+        close (link->shmFd);
+        link->shmFd = -1;
+    }
+}
+
+static int ARSTREAM_BenchmarkTb_Run (const ARSTREAM_BenchmarkTb_Config_t *config, int durationMs, ARSTREAM_BenchmarkTb_Result_t *result)
+{
+    ARSTREAM_BenchmarkTb_Run_t run;
+    ARSTREAM_Transport_t senderTransport, readerTransport;
+    ARSTREAM_BenchmarkTb_Link_t link;
+    ARSTREAM_Transport_ImpairmentParams_t impairmentParams;
+    ARSTREAM_Transport_ImpairmentStats_t impairmentStats;
+    ARSTREAM_Sender_t *sender = NULL;
+    ARSTREAM_Reader_t *reader = NULL;
+    pthread_t threads [7];
+    eARSTREAM_ERROR err;
+    uint64_t startUs, cpuStartUs, cpuUs, elapsedUs;
+    uint64_t frameIntervalUs = 1000000 / config->fps;
+    uint32_t frameNumber;
+    int nbFrames = (int)((uint64_t)durationMs * config->fps / 1000);
+    int nbFragmentsPerFrame = (config->frameSize + config->fragmentSize - 1) / config->fragmentSize;
+    int retVal = 0;
+    int i;
+
+    memset (&run, 0, sizeof (run));
+    run.config = *config;
+    pthread_mutex_init (&(run.mutex), NULL);
+    for (i = 0; i < NB_BUFFERS; i++)
+    {
+        run.buffers[i] = calloc (1, config->frameSize);
+        run.bufferIsFree[i] = 1;
+    }
+    run.readerBuffer = malloc (config->frameSize);
+    run.maxLatencies = nbFrames;
+    run.latenciesUs = malloc ((nbFrames + 1) * sizeof (uint32_t));
+    for (i = 0; i < config->nbFilters; i++)
+    {
+        run.filters[i].getBuffer = ARSTREAM_BenchmarkTb_FilterGetBuffer;
+        run.filters[i].getOutputSize = ARSTREAM_BenchmarkTb_FilterGetOutputSize;
+        run.filters[i].filterBuffer = ARSTREAM_BenchmarkTb_FilterBuffer;
+        run.filters[i].releaseBuffer = ARSTREAM_BenchmarkTb_FilterReleaseBuffer;
+        run.filters[i].context = &run;
+    }
+
+    /* Link, with random loss in both directions */
+    err = ARSTREAM_BenchmarkTb_OpenLink (&link, config, &senderTransport, &readerTransport);
+    ARSTREAM_Transport_ImpairmentParamsDefaultInit (&impairmentParams);
+    impairmentParams.lossModel = ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_BERNOULLI;
+    impairmentParams.lossRate = config->lossPercent / 100.0;
+    if (err == ARSTREAM_OK)
+    {
+        impairmentParams.seed = 1;
+        err = ARSTREAM_Transport_InitImpairment (&senderTransport, &senderTransport, &impairmentParams);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        impairmentParams.seed = 2;
+        err = ARSTREAM_Transport_InitImpairment (&readerTransport, &readerTransport, &impairmentParams);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        sender = ARSTREAM_Sender_NewWithTransport (&senderTransport, ARSTREAM_BenchmarkTb_FrameUpdateCallback, NB_BUFFERS, config->fragmentSize, MAX_NB_FRAG, &run, &err);
+    }
+    for (i = 0; (err == ARSTREAM_OK) && (i < config->nbFilters); i++)
+    {
+        err = ARSTREAM_Sender_AddFilter (sender, &(run.filters[i]));
+    }
+    if (err == ARSTREAM_OK)
+    {
+        reader = ARSTREAM_Reader_NewWithTransport (&readerTransport, ARSTREAM_BenchmarkTb_FrameCompleteCallback, run.readerBuffer, config->frameSize, config->fragmentSize, ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT, &run, &err);
+    }
+    if ((err != ARSTREAM_OK) ||
+        (run.readerBuffer == NULL) ||
+        (run.latenciesUs == NULL))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to set up the run : %s", ARSTREAM_Error_ToString (err));
+        retVal = -1;
+    }
+
+    if (retVal == 0)
+    {
+        cpuStartUs = ARSTREAM_BenchmarkTb_TimeUs (CLOCK_PROCESS_CPUTIME_ID);
+        startUs = ARSTREAM_BenchmarkTb_TimeUs (CLOCK_MONOTONIC);
+        pthread_create (&threads[0], NULL, ARSTREAM_Transport_RunImpairmentThread, &senderTransport);
+        pthread_create (&threads[1], NULL, ARSTREAM_Transport_RunImpairmentThread, &readerTransport);
+        pthread_create (&threads[2], NULL, ARSTREAM_Reader_RunDataThread, reader);
+        pthread_create (&threads[3], NULL, ARSTREAM_Reader_RunAckThread, reader);
+        pthread_create (&threads[4], NULL, ARSTREAM_Reader_RunPlayoutThread, reader);
+        pthread_create (&threads[5], NULL, ARSTREAM_Sender_RunDataThread, sender);
+        pthread_create (&threads[6], NULL, ARSTREAM_Sender_RunAckThread, sender);
+
+        /* Fake encoder, paced on the monotonic clock */
+        for (frameNumber = 0; frameNumber < (uint32_t)nbFrames; frameNumber++)
+        {
+            int bufferIndex = frameNumber % NB_BUFFERS;
+            int isFree;
+            uint64_t nowUs;
+
+            pthread_mutex_lock (&(run.mutex));
+            isFree = run.bufferIsFree[bufferIndex];
+            run.bufferIsFree[bufferIndex] = 0;
+            pthread_mutex_unlock (&(run.mutex));
+            run.nbEncoded++;
+            if (isFree == 1)
+            {
+                uint8_t *buffer = run.buffers[bufferIndex];
+                int isKeyframe = ((frameNumber % I_FRAME_EVERY_N) == 0) ? 1 : 0;
+                int nbPrevious;
+                nowUs = ARSTREAM_BenchmarkTb_TimeUs (CLOCK_MONOTONIC);
+                memcpy (buffer, &frameNumber, sizeof (frameNumber));
+                memcpy (buffer + sizeof (frameNumber), &nowUs, sizeof (nowUs));
+                if (ARSTREAM_Sender_SendNewFrame (sender, buffer, config->frameSize, isKeyframe, &nbPrevious) == ARSTREAM_OK)
+                {
+                    run.nbSubmitted++;
+                    run.nbSubmittedFragments += nbFragmentsPerFrame;
+                }
+                else
+                {
+                    pthread_mutex_lock (&(run.mutex));
+                    run.bufferIsFree[bufferIndex] = 1;
+                    pthread_mutex_unlock (&(run.mutex));
+                }
+            }
+
+            nowUs = ARSTREAM_BenchmarkTb_TimeUs (CLOCK_MONOTONIC);
+            if (startUs + (frameNumber + 1) * frameIntervalUs > nowUs)
+            {
+                usleep (startUs + (frameNumber + 1) * frameIntervalUs - nowUs);
+            }
+        }
+        usleep (1000 * DRAIN_TIME_MS);
+
+        ARSTREAM_Sender_StopSender (sender);
+        ARSTREAM_Reader_StopReader (reader);
+        ARSTREAM_Transport_StopImpairment (&senderTransport);
+        ARSTREAM_Transport_StopImpairment (&readerTransport);
+        for (i = 0; i < NB_ELEMENTS (threads); i++)
+        {
+            pthread_join (threads[i], NULL);
+        }
+        cpuUs = ARSTREAM_BenchmarkTb_TimeUs (CLOCK_PROCESS_CPUTIME_ID) - cpuStartUs;
+        elapsedUs = (uint64_t)nbFrames * frameIntervalUs;
+
+        ARSTREAM_Transport_GetImpairmentStats (&senderTransport, &impairmentStats);
+        qsort (run.latenciesUs, run.nbReceived, sizeof (uint32_t), ARSTREAM_BenchmarkTb_CompareLatencies);
+        printf ("%s,%d,%d,%d,%.1f,%d,%u,%u,%u,%u,%.1f,%.3f,%.3f,%.3f,%.1f,%.4f\n",
+                linkNames[config->link], config->frameSize, config->fragmentSize, config->fps, config->lossPercent, config->nbFilters,
+                run.nbSubmitted, run.nbAcked, run.nbCancelled, run.nbReceived,
+                run.nbReceivedBytes * 8.0 / (elapsedUs / 1000.0),
+                ARSTREAM_BenchmarkTb_Percentile (&run, 0.50),
+                ARSTREAM_BenchmarkTb_Percentile (&run, 0.99),
+                ARSTREAM_BenchmarkTb_Percentile (&run, 0.999),
+                (run.nbEncoded > 0) ? ((double)cpuUs / run.nbEncoded) : 0.0,
+                (run.nbSubmittedFragments > 0) ? ((double)impairmentStats.nbPackets / run.nbSubmittedFragments - 1.0) : 0.0);
+        fflush (stdout);
+        if (result != NULL)
+        {
+            result->nbSubmitted = run.nbSubmitted;
+            result->nbAcked = run.nbAcked;
+            result->nbCancelled = run.nbCancelled;
+            result->nbReceived = run.nbReceived;
+        }
+    }
+
+    ARSTREAM_Sender_Delete (&sender);
+    ARSTREAM_Reader_Delete (&reader);
+    ARSTREAM_Transport_Destroy (&senderTransport);
+    ARSTREAM_Transport_Destroy (&readerTransport);
+    ARSTREAM_BenchmarkTb_CloseLink (&link);
+    for (i = 0; i < NB_BUFFERS; i++)
+    {
+        free (run.buffers[i]);
+    }
+    free (run.readerBuffer);
+    free (run.latenciesUs);
+    pthread_mutex_destroy (&(run.mutex));
+    return retVal;
+}
+
+static int ARSTREAM_BenchmarkTb_Smoke (void)
+{
+    ARSTREAM_BenchmarkTb_Config_t config;
+    ARSTREAM_BenchmarkTb_Result_t result;
+    uint32_t nbFrames;
+    int nbFailed = 0;
+    int i;
+
+    /* Baseline, with the second loss and filters values : the impairment seeds are fixed */
+    config.frameSize = frameSizes[0];
+    config.fragmentSize = fragmentSizes[0];
+    config.fps = fpsValues[0];
+    config.lossPercent = lossPercents[1];
+    config.nbFilters = nbFiltersValues[1];
+    nbFrames = (uint32_t)(SMOKE_DURATION_MS * config.fps / 1000);
+
+    printf ("link,frameSize,fragmentSize,fps,lossPercent,nbFilters,framesSubmitted,framesAcked,framesCancelled,framesReceived,throughputKbps,latencyP50Ms,latencyP99Ms,latencyP999Ms,cpuUsPerFrame,retransmissionOverhead\n");
+    for (i = 0; i < NB_ELEMENTS (links); i++)
+    {
+        config.link = links[i];
+        if (config.link == ARSTREAM_BENCHMARKTB_LINK_ARNETWORK)
+        {
+            continue;
+        }
+        if (ARSTREAM_BenchmarkTb_Run (&config, SMOKE_DURATION_MS, &result) != 0)
+        {
+            printf ("FAIL smoke %s : run error\n", linkNames[config.link]);
+            nbFailed++;
+            continue;
+        }
+
+        if ((result.nbSubmitted == 0) ||
+            (result.nbSubmitted > nbFrames))
+        {
+            printf ("FAIL smoke %s : %u frames submitted for %u encoded\n", linkNames[config.link], result.nbSubmitted, nbFrames);
+            nbFailed++;
+        }
+        /* After the drain time, every submitted frame got exactly one callback */
+        if (result.nbAcked + result.nbCancelled != result.nbSubmitted)
+        {
+            printf ("FAIL smoke %s : %u acked + %u cancelled != %u submitted\n", linkNames[config.link], result.nbAcked, result.nbCancelled, result.nbSubmitted);
+            nbFailed++;
+        }
+        if ((result.nbReceived == 0) ||
+            (result.nbReceived > result.nbSubmitted))
+        {
+            printf ("FAIL smoke %s : %u frames received for %u submitted\n", linkNames[config.link], result.nbReceived, result.nbSubmitted);
+            nbFailed++;
+        }
+    }
+
+    if (nbFailed == 0)
+    {
+        printf ("PASS smoke\n");
+    }
+    return (nbFailed == 0) ? 0 : 1;
+}
+
+/*
+ * Implementation
+ */
+
+int ARSTREAM_Benchmark_TestBenchMain (int argc, char *argv[])
+{
+    int durationMs = DEFAULT_DURATION_MS;
+    int full = 0;
+    int retVal = 0;
+    ARSTREAM_BenchmarkTb_Config_t config;
+    int a, b, c, d, e, l;
+
+    if ((argc == 2) &&
+        (strcmp (argv[1], "--smoke") == 0))
+    {
+        return ARSTREAM_BenchmarkTb_Smoke ();
+    }
+    if (argc > 3)
+    {
+        ARSTREAM_BenchmarkTb_PrintUsage (argv[0]);
+        return 1;
+    }
+    if (argc > 1)
+    {
+        durationMs = atoi (argv[1]);
+    }
+    if (argc > 2)
+    {
+        if (strcmp (argv[2], "full") != 0)
+        {
+            ARSTREAM_BenchmarkTb_PrintUsage (argv[0]);
+            return 1;
+        }
+        full = 1;
+    }
+    if (durationMs <= 0)
+    {
+        ARSTREAM_BenchmarkTb_PrintUsage (argv[0]);
+        return 1;
+    }
+
+    printf ("link,frameSize,fragmentSize,fps,lossPercent,nbFilters,framesSubmitted,framesAcked,framesCancelled,framesReceived,throughputKbps,latencyP50Ms,latencyP99Ms,latencyP999Ms,cpuUsPerFrame,retransmissionOverhead\n");
+    for (l = 0; l < NB_ELEMENTS (links); l++)
+    {
+        for (a = 0; a < NB_ELEMENTS (frameSizes); a++)
+        {
+            for (b = 0; b < NB_ELEMENTS (fragmentSizes); b++)
+            {
+                for (c = 0; c < NB_ELEMENTS (fpsValues); c++)
+                {
+                    for (d = 0; d < NB_ELEMENTS (lossPercents); d++)
+                    {
+                        for (e = 0; e < NB_ELEMENTS (nbFiltersValues); e++)
+                        {
+                            /* One dimension at a time : at most one index away from the baseline */
+                            if ((full == 0) &&
+                                ((l != 0) + (a != 0) + (b != 0) + (c != 0) + (d != 0) + (e != 0) > 1))
+                            {
+                                continue;
+                            }
+                            config.link = links[l];
+                            config.frameSize = frameSizes[a];
+                            config.fragmentSize = fragmentSizes[b];
+                            config.fps = fpsValues[c];
+                            config.lossPercent = lossPercents[d];
+                            config.nbFilters = nbFiltersValues[e];
+                            if ((config.frameSize + config.fragmentSize - 1) / config.fragmentSize > MAX_NB_FRAG)
+                            {
+                                continue;
+                            }
+                            if (ARSTREAM_BenchmarkTb_Run (&config, durationMs, NULL) != 0)
+                            {
+                                retVal = 1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return retVal;
+}
@@ -224,6 +224,7 @@ void ARSTREAM_MP4SenderTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, u
         ARSTREAM_MP4Sender_PercentOk = (100.f * nbOk) / (1.f * nbSent);
         break;
     case ARSTREAM_SENDER_STATUS_FRAME_CANCEL:
+    case ARSTREAM_SENDER_STATUS_FRAME_EXPIRED:
         ARSTREAM_MP4SenderTb_SetBufferFree (framePointer);
         ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Cancelled a frame of size %u", frameSize);
         nbSent++;
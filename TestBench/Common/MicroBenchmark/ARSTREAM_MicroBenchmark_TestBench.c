@@ -0,0 +1,947 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_MicroBenchmark_TestBench.c
+ * @brief Microbenchmarks of the per fragment primitives of the library
+ * @date 10/17/2026
+ */
+
+/*
+ * System Headers
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Private Headers
+ */
+
+/* Built with the library sources in the include path, for the wire format */
+#include "ARSTREAM_NetworkHeaders.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARStream/ARSTREAM_Sender.h>
+#include <libARStream/ARSTREAM_Reader.h>
+#include <libARStream/ARSTREAM_Transport.h>
+
+#include "ARSTREAM_MicroBenchmark_TestBench.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "ARSTREAM_MicroBenchmark_TB"
+
+#define DEFAULT_MIN_TIME_MS (200)
+
+/**
+ * @brief Smoke run : short measures, and a nominal CPU frequency instead of the calibration
+ */
+#define SMOKE_MIN_TIME_MS (10)
+#define SMOKE_CPU_MHZ (1000.0)
+
+#define FRAGMENT_SIZE (1000)
+#define NB_FRAGMENTS (64)
+#define FRAME_SIZE (FRAGMENT_SIZE * NB_FRAGMENTS)
+#define PACKET_SIZE (sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + FRAGMENT_SIZE)
+
+#define NB_FLAGS (ARSTREAM_NETWORK_HEADERS_MAX_FRAGMENTS_PER_FRAME)
+
+/**
+ * @brief Number of frames in the sender queue
+ */
+#define QUEUE_DEPTH (16)
+
+#define MAX_NB_FILTERS (4)
+
+/**
+ * @brief Number of dependent additions used to estimate the CPU frequency
+ */
+#define CALIBRATION_NB_ADDS (200000000)
+
+/**
+ * @brief Time given to a threaded path to make progress before it is considered stuck
+ */
+#define STALL_TIMEOUT_S (2)
+
+#define NB_ELEMENTS(array) ((int)(sizeof (array) / sizeof ((array)[0])))
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Shared state of the microbenchmarks
+ */
+typedef struct {
+    uint8_t *frame; // Frame given to the sender, and source of the copies
+    uint8_t *sendFragment; // Packet being built, as in the sender data thread
+    uint8_t *packets; // All the packets of one frame, as received by a reader
+    uint8_t *reassembly; // Frame being reassembled, as in the reader data thread
+    uint8_t *filterBuffer; // Output of the dispatch only filters (never written)
+    ARSTREAM_NetworkHeaders_AckPacket_t ackPacket;
+    volatile uint32_t sink; // Keeps the compiler from removing the primitives calls
+
+    /* Threaded paths */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t nbDone; // Frames submitted to the null transport, or completed by the reader
+    uint32_t nbReplayFrames; // Number of frames the replay transport gives to the reader
+    uint32_t replayFrameIndex; // Data thread only
+    uint32_t replayFragmentIndex; // Data thread only
+    ARSTREAM_Filter_t filters [MAX_NB_FILTERS];
+} ARSTREAM_MicroBenchmarkTb_t;
+
+/**
+ * @brief One microbenchmark
+ */
+typedef struct {
+    const char *name;
+    /** Runs nbIterations iterations of the benchmark, returns 0 on success */
+    int (*run)(ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+    int param;
+    uint32_t opsPerIteration;
+    uint32_t bytesPerIteration; // 0 if the primitive does not move data
+    double nsPerOp; // Result
+} ARSTREAM_MicroBenchmarkTb_Bench_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Print the parameters of the application
+ */
+static void ARSTREAM_MicroBenchmarkTb_PrintUsage (const char *appName);
+
+/**
+ * @brief Gets the monotonic time in nanoseconds
+ */
+static uint64_t ARSTREAM_MicroBenchmarkTb_TimeNs (void);
+
+/**
+ * @brief Estimates the CPU frequency from a chain of dependent additions (one per cycle)
+ * @return The estimated frequency, in MHz
+ */
+static double ARSTREAM_MicroBenchmarkTb_EstimateCpuMHz (void);
+
+/**
+ * @brief Runs a benchmark for at least minTimeMs, and stores its result
+ * @return The number of iterations of the timed run, or 0 on error
+ */
+static uint32_t ARSTREAM_MicroBenchmarkTb_Measure (ARSTREAM_MicroBenchmarkTb_t *tb, ARSTREAM_MicroBenchmarkTb_Bench_t *bench, int minTimeMs);
+
+/**
+ * @brief Ack bitfield benchmarks : one operation per fragment index of a full frame
+ */
+static int ARSTREAM_MicroBenchmarkTb_AckSetFlag (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+static int ARSTREAM_MicroBenchmarkTb_AckFlagIsSet (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+static int ARSTREAM_MicroBenchmarkTb_AckAllFlagsSet (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+static int ARSTREAM_MicroBenchmarkTb_AckCountNotSet (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+static int ARSTREAM_MicroBenchmarkTb_AckResetUpTo (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+static int ARSTREAM_MicroBenchmarkTb_AckUnsetFlags (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+
+/**
+ * @brief Fills the sender frames queue, then flushes it, without any thread running
+ */
+static int ARSTREAM_MicroBenchmarkTb_QueueAddFlush (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+
+/**
+ * @brief Builds all the packets of a frame, as the sender data thread does
+ */
+static int ARSTREAM_MicroBenchmarkTb_FragmentCopy (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+
+/**
+ * @brief Runs a frame through a chain of dispatch only filters, as the sender data thread does
+ */
+static int ARSTREAM_MicroBenchmarkTb_FilterDispatch (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+
+/**
+ * @brief Reassembles all the packets of a frame, as the reader data thread does
+ */
+static int ARSTREAM_MicroBenchmarkTb_ReassemblyCopy (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+
+/**
+ * @brief Sends frames through a best effort sender data thread over a null transport
+ * @param param Number of dispatch only filters, negative for one fragment frames without filter
+ */
+static int ARSTREAM_MicroBenchmarkTb_SenderPath (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+
+/**
+ * @brief Gives prebuilt frames to a reader data thread through a replay transport
+ */
+static int ARSTREAM_MicroBenchmarkTb_ReaderPath (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param);
+
+/**
+ * @brief Waits until the threaded path completed nbFrames frames
+ * @return 0, or -1 if the path stopped making progress
+ */
+static int ARSTREAM_MicroBenchmarkTb_WaitDone (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbFrames);
+
+/**
+ * @brief Null transport : packets are only counted, nothing is ever received
+ */
+static eARSTREAM_ERROR ARSTREAM_MicroBenchmarkTb_NullSendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+static void ARSTREAM_MicroBenchmarkTb_NullSubmit (void *context);
+static eARSTREAM_ERROR ARSTREAM_MicroBenchmarkTb_NullReceive (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+
+/**
+ * @brief Replay transport : gives the prebuilt packets in a loop, with increasing frame numbers
+ */
+static eARSTREAM_ERROR ARSTREAM_MicroBenchmarkTb_ReplayReceiveFragment (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_MicroBenchmarkTb_ReplaySendAck (void *context, uint8_t *data, int size);
+
+/**
+ * @brief Dispatch only filter : no allocation, no copy
+ */
+static uint8_t* ARSTREAM_MicroBenchmarkTb_FilterGetBuffer (void *context, int size);
+static int ARSTREAM_MicroBenchmarkTb_FilterGetOutputSize (void *context, int inputSize);
+static int ARSTREAM_MicroBenchmarkTb_FilterBuffer (void *context, uint8_t *input, int inSize, uint8_t *output, int outSize);
+static void ARSTREAM_MicroBenchmarkTb_FilterReleaseBuffer (void *context, uint8_t *buffer);
+
+/**
+ * @see ARSTREAM_Sender.h
+ */
+static void ARSTREAM_MicroBenchmarkTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
+
+/**
+ * @see ARSTREAM_Reader.h
+ */
+static uint8_t* ARSTREAM_MicroBenchmarkTb_FrameCompleteCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_MicroBenchmarkTb_PrintUsage (const char *appName)
+{
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Usage : %s [minTimeMs [cpuMHz]]", appName);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        %s --smoke", appName);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        minTimeMs -> minimum duration of each measure (default %d)", DEFAULT_MIN_TIME_MS);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        cpuMHz    -> CPU frequency used for bytes per cycle (default : estimated)");
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        --smoke   -> short run of all the benchmarks (%d ms each), checked", SMOKE_MIN_TIME_MS);
+}
+
+static uint64_t ARSTREAM_MicroBenchmarkTb_TimeNs (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static double ARSTREAM_MicroBenchmarkTb_EstimateCpuMHz (void)
+{
+    uint64_t startNs, elapsedNs;
+    uint32_t value = 0;
+    uint32_t i;
+
+    startNs = ARSTREAM_MicroBenchmarkTb_TimeNs ();
+    for (i = 0; i < CALIBRATION_NB_ADDS; i += 4)
+    {
+        /* The empty asm statements keep each addition in the dependency chain */
+        value += i;
+        __asm__ __volatile__ ("" : "+r" (value));
+        value += i;
+        __asm__ __volatile__ ("" : "+r" (value));
+        value += i;
+        __asm__ __volatile__ ("" : "+r" (value));
+        value += i;
+        __asm__ __volatile__ ("" : "+r" (value));
+    }
+    elapsedNs = ARSTREAM_MicroBenchmarkTb_TimeNs () - startNs;
+    return (elapsedNs > 0) ? ((double)CALIBRATION_NB_ADDS * 1000.0 / elapsedNs) : 0.0;
+}
+
+static uint32_t ARSTREAM_MicroBenchmarkTb_Measure (ARSTREAM_MicroBenchmarkTb_t *tb, ARSTREAM_MicroBenchmarkTb_Bench_t *bench, int minTimeMs)
+{
+    uint64_t minTimeNs = (uint64_t)minTimeMs * 1000000;
+    uint64_t startNs, elapsedNs;
+    uint64_t nbIterations = 1;
+
+    for (;;)
+    {
+        startNs = ARSTREAM_MicroBenchmarkTb_TimeNs ();
+        if (bench->run (tb, (uint32_t)nbIterations, bench->param) != 0)
+        {
+            return 0;
+        }
+        elapsedNs = ARSTREAM_MicroBenchmarkTb_TimeNs () - startNs;
+        if ((elapsedNs >= minTimeNs) ||
+            (nbIterations >= UINT32_MAX / 2))
+        {
+            break;
+        }
+        /* Aim slightly above the minimum time, growing at most 100 times per step */
+        if (elapsedNs * 100 < minTimeNs)
+        {
+            nbIterations *= 100;
+        }
+        else
+        {
+            nbIterations = nbIterations * minTimeNs * 12 / (elapsedNs * 10) + 1;
+        }
+        if (nbIterations > UINT32_MAX / 2)
+        {
+            nbIterations = UINT32_MAX / 2;
+        }
+    }
+    bench->nsPerOp = (double)elapsedNs / ((double)nbIterations * bench->opsPerIteration);
+    return (uint32_t)nbIterations;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_AckSetFlag (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    uint32_t it;
+    int i;
+    (void)param;
+    for (it = 0; it < nbIterations; it++)
+    {
+        for (i = 0; i < NB_FLAGS; i++)
+        {
+            ARSTREAM_NetworkHeaders_AckPacketSetFlag (&(tb->ackPacket), i);
+        }
+    }
+    tb->sink = (uint32_t)tb->ackPacket.lowPacketsAck;
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_AckFlagIsSet (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    uint32_t it, nbSet = 0;
+    int i;
+    (void)param;
+    for (it = 0; it < nbIterations; it++)
+    {
+        for (i = 0; i < NB_FLAGS; i++)
+        {
+            nbSet += ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(tb->ackPacket), i);
+        }
+    }
+    tb->sink = nbSet;
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_AckAllFlagsSet (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    uint32_t it, nbAll = 0;
+    int i;
+    (void)param;
+    for (it = 0; it < nbIterations; it++)
+    {
+        for (i = 1; i <= NB_FLAGS; i++)
+        {
+            nbAll += ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&(tb->ackPacket), i);
+        }
+    }
+    tb->sink = nbAll;
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_AckCountNotSet (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    uint32_t it, nbNotSet = 0;
+    int i;
+    (void)param;
+    for (it = 0; it < nbIterations; it++)
+    {
+        for (i = 1; i <= NB_FLAGS; i++)
+        {
+            nbNotSet += ARSTREAM_NetworkHeaders_AckPacketCountNotSet (&(tb->ackPacket), i);
+        }
+    }
+    tb->sink = nbNotSet;
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_AckResetUpTo (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    uint32_t it;
+    int i;
+    (void)param;
+    for (it = 0; it < nbIterations; it++)
+    {
+        for (i = 0; i < NB_FLAGS; i++)
+        {
+            ARSTREAM_NetworkHeaders_AckPacketResetUpTo (&(tb->ackPacket), i);
+        }
+    }
+    tb->sink = (uint32_t)tb->ackPacket.highPacketsAck;
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_AckUnsetFlags (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    ARSTREAM_NetworkHeaders_AckPacket_t toSend;
+    ARSTREAM_NetworkHeaders_AckPacket_t allToSend;
+    uint32_t it, nbEmpty = 0;
+    int i;
+    (void)param;
+    /* Acks of half of the fragments, received while all the fragments were to send */
+    ARSTREAM_NetworkHeaders_AckPacketResetUpTo (&allToSend, NB_FLAGS);
+    ARSTREAM_NetworkHeaders_AckPacketReset (&(tb->ackPacket));
+    for (i = 0; i < NB_FLAGS; i += 2)
+    {
+        ARSTREAM_NetworkHeaders_AckPacketSetFlag (&(tb->ackPacket), i);
+    }
+    for (it = 0; it < nbIterations; it++)
+    {
+        for (i = 0; i < NB_FLAGS; i++)
+        {
+            toSend = allToSend;
+            nbEmpty += ARSTREAM_NetworkHeaders_AckPacketUnsetFlags (&toSend, &(tb->ackPacket));
+        }
+    }
+    tb->sink = nbEmpty + (uint32_t)toSend.lowPacketsAck;
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_QueueAddFlush (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_t *sender;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    uint32_t it;
+    int i;
+    (void)param;
+
+    memset (&transport, 0, sizeof (transport));
+    transport.sendFragment = ARSTREAM_MicroBenchmarkTb_NullSendFragment;
+    transport.receiveAck = ARSTREAM_MicroBenchmarkTb_NullReceive;
+    transport.context = tb;
+    sender = ARSTREAM_Sender_NewWithTransport (&transport, ARSTREAM_MicroBenchmarkTb_FrameUpdateCallback, QUEUE_DEPTH, FRAGMENT_SIZE, NB_FLAGS, tb, &err);
+    for (it = 0; (err == ARSTREAM_OK) && (it < nbIterations); it++)
+    {
+        for (i = 0; (err == ARSTREAM_OK) && (i < QUEUE_DEPTH); i++)
+        {
+            err = ARSTREAM_Sender_SendNewFrame (sender, tb->frame, FRAME_SIZE, 0, NULL);
+        }
+        if (err == ARSTREAM_OK)
+        {
+            err = ARSTREAM_Sender_FlushFramesQueue (sender);
+        }
+    }
+    ARSTREAM_Sender_Delete (&sender);
+    if (err != ARSTREAM_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Sender queue error : %s", ARSTREAM_Error_ToString (err));
+        return -1;
+    }
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_FragmentCopy (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    ARSTREAM_NetworkHeaders_DataHeader_t *header = (ARSTREAM_NetworkHeaders_DataHeader_t *)tb->sendFragment;
+    uint32_t it;
+    int i;
+    (void)param;
+    for (it = 0; it < nbIterations; it++)
+    {
+        header->frameNumber = (uint16_t)it;
+        header->fragmentsPerFrame = NB_FRAGMENTS;
+        for (i = 0; i < NB_FRAGMENTS; i++)
+        {
+            header->fragmentNumber = i;
+            memcpy (&(tb->sendFragment)[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], &(tb->frame)[i * FRAGMENT_SIZE], FRAGMENT_SIZE);
+            /* Like a transport reading the packet */
+            tb->sink = tb->sendFragment[PACKET_SIZE - 1];
+        }
+    }
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_FilterDispatch (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    uint32_t it;
+    int i;
+    (void)param;
+    for (it = 0; it < nbIterations; it++)
+    {
+        uint8_t *inBuffer = tb->frame;
+        int inSize = FRAME_SIZE;
+        ARSTREAM_Filter_t *prevFilter = NULL;
+        for (i = 0; i < MAX_NB_FILTERS; i++)
+        {
+            ARSTREAM_Filter_t *filter = &(tb->filters[i]);
+            int maxOutSize = filter->getOutputSize (filter->context, inSize);
+            uint8_t *outBuffer = filter->getBuffer (filter->context, maxOutSize);
+            int outSize = filter->filterBuffer (filter->context, inBuffer, inSize, outBuffer, maxOutSize);
+            if (prevFilter != NULL)
+            {
+                prevFilter->releaseBuffer (prevFilter->context, inBuffer);
+            }
+            inBuffer = outBuffer;
+            inSize = outSize;
+            prevFilter = filter;
+        }
+        prevFilter->releaseBuffer (prevFilter->context, inBuffer);
+        tb->sink = inSize;
+    }
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_ReassemblyCopy (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    uint32_t it, nbComplete = 0;
+    int i;
+    (void)param;
+    for (it = 0; it < nbIterations; it++)
+    {
+        ARSTREAM_NetworkHeaders_AckPacketResetUpTo (&(tb->ackPacket), NB_FRAGMENTS);
+        for (i = 0; i < NB_FRAGMENTS; i++)
+        {
+            uint8_t *packet = &(tb->packets)[i * PACKET_SIZE];
+            ARSTREAM_NetworkHeaders_DataHeader_t *header = (ARSTREAM_NetworkHeaders_DataHeader_t *)packet;
+            if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(tb->ackPacket), header->fragmentNumber) == 0)
+            {
+                ARSTREAM_NetworkHeaders_AckPacketSetFlag (&(tb->ackPacket), header->fragmentNumber);
+                memcpy (&(tb->reassembly)[header->fragmentNumber * FRAGMENT_SIZE], &packet[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], FRAGMENT_SIZE);
+            }
+            nbComplete += ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&(tb->ackPacket), header->fragmentsPerFrame);
+        }
+    }
+    tb->sink = nbComplete + tb->reassembly[FRAME_SIZE - 1];
+    return 0;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_SenderPath (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_t *sender;
+    pthread_t dataThread;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    uint32_t frameSize = (param < 0) ? FRAGMENT_SIZE : FRAME_SIZE;
+    int nbFilters = (param < 0) ? 0 : param;
+    uint32_t it;
+    int retVal = 0;
+    int i;
+
+    memset (&transport, 0, sizeof (transport));
+    transport.sendFragment = ARSTREAM_MicroBenchmarkTb_NullSendFragment;
+    transport.submit = ARSTREAM_MicroBenchmarkTb_NullSubmit;
+    transport.receiveAck = ARSTREAM_MicroBenchmarkTb_NullReceive;
+    transport.context = tb;
+    tb->nbDone = 0;
+    sender = ARSTREAM_Sender_NewWithTransport (&transport, ARSTREAM_MicroBenchmarkTb_FrameUpdateCallback, QUEUE_DEPTH, FRAGMENT_SIZE, NB_FLAGS, tb, &err);
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Sender_SetReliabilityMode (sender, ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT, 0);
+    }
+    for (i = 0; (err == ARSTREAM_OK) && (i < nbFilters); i++)
+    {
+        err = ARSTREAM_Sender_AddFilter (sender, &(tb->filters[i]));
+    }
+    if (err != ARSTREAM_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create the sender : %s", ARSTREAM_Error_ToString (err));
+        ARSTREAM_Sender_Delete (&sender);
+        return -1;
+    }
+
+    pthread_create (&dataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+    for (it = 0; (retVal == 0) && (it < nbIterations); it++)
+    {
+        /* Keep the queue half full, so that the data thread never waits for a frame */
+        if (ARSTREAM_MicroBenchmarkTb_WaitDone (tb, (it >= QUEUE_DEPTH / 2) ? (it - QUEUE_DEPTH / 2) : 0) != 0)
+        {
+            retVal = -1;
+        }
+        else if (ARSTREAM_Sender_SendNewFrame (sender, tb->frame, frameSize, 0, NULL) != ARSTREAM_OK)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to send a frame");
+            retVal = -1;
+        }
+    }
+    if ((retVal == 0) &&
+        (ARSTREAM_MicroBenchmarkTb_WaitDone (tb, nbIterations) != 0))
+    {
+        retVal = -1;
+    }
+    ARSTREAM_Sender_StopSender (sender);
+    pthread_join (dataThread, NULL);
+    ARSTREAM_Sender_Delete (&sender);
+    return retVal;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_ReaderPath (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbIterations, int param)
+{
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Reader_t *reader;
+    pthread_t dataThread;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    int retVal;
+    (void)param;
+
+    memset (&transport, 0, sizeof (transport));
+    transport.receiveFragment = ARSTREAM_MicroBenchmarkTb_ReplayReceiveFragment;
+    transport.sendAck = ARSTREAM_MicroBenchmarkTb_ReplaySendAck;
+    transport.context = tb;
+    tb->nbDone = 0;
+    tb->nbReplayFrames = nbIterations;
+    tb->replayFrameIndex = 0;
+    tb->replayFragmentIndex = 0;
+    reader = ARSTREAM_Reader_NewWithTransport (&transport, ARSTREAM_MicroBenchmarkTb_FrameCompleteCallback, tb->reassembly, FRAME_SIZE, FRAGMENT_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK, tb, &err);
+    if (err != ARSTREAM_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create the reader : %s", ARSTREAM_Error_ToString (err));
+        return -1;
+    }
+
+    pthread_create (&dataThread, NULL, ARSTREAM_Reader_RunDataThread, reader);
+    retVal = ARSTREAM_MicroBenchmarkTb_WaitDone (tb, nbIterations);
+    ARSTREAM_Reader_StopReader (reader);
+    pthread_join (dataThread, NULL);
+    ARSTREAM_Reader_Delete (&reader);
+    return retVal;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_WaitDone (ARSTREAM_MicroBenchmarkTb_t *tb, uint32_t nbFrames)
+{
+    int retVal = 0;
+    pthread_mutex_lock (&(tb->mutex));
+    while ((retVal == 0) &&
+           (tb->nbDone < nbFrames))
+    {
+        uint32_t nbDoneBefore = tb->nbDone;
+        struct timespec deadline;
+        clock_gettime (CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += STALL_TIMEOUT_S;
+        pthread_cond_timedwait (&(tb->cond), &(tb->mutex), &deadline);
+        if ((tb->nbDone == nbDoneBefore) &&
+            (tb->nbDone < nbFrames))
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Stuck after %u of %u frames", tb->nbDone, nbFrames);
+            retVal = -1;
+        }
+    }
+    pthread_mutex_unlock (&(tb->mutex));
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_MicroBenchmarkTb_NullSendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    ARSTREAM_MicroBenchmarkTb_t *tb = (ARSTREAM_MicroBenchmarkTb_t *)context;
+    tb->sink = data[size - 1];
+    if (callback != NULL)
+    {
+        callback (customData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+    }
+    return ARSTREAM_OK;
+}
+
+static void ARSTREAM_MicroBenchmarkTb_NullSubmit (void *context)
+{
+    ARSTREAM_MicroBenchmarkTb_t *tb = (ARSTREAM_MicroBenchmarkTb_t *)context;
+    /* The best effort sender submits once per frame */
+    pthread_mutex_lock (&(tb->mutex));
+    tb->nbDone++;
+    pthread_cond_signal (&(tb->cond));
+    pthread_mutex_unlock (&(tb->mutex));
+}
+
+static eARSTREAM_ERROR ARSTREAM_MicroBenchmarkTb_NullReceive (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    (void)context;
+    (void)data;
+    (void)maxSize;
+    (void)size;
+    usleep (1000 * timeoutMs);
+    return ARSTREAM_ERROR_TIMEOUT;
+}
+
+static eARSTREAM_ERROR ARSTREAM_MicroBenchmarkTb_ReplayReceiveFragment (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    ARSTREAM_MicroBenchmarkTb_t *tb = (ARSTREAM_MicroBenchmarkTb_t *)context;
+    ARSTREAM_NetworkHeaders_DataHeader_t *header = (ARSTREAM_NetworkHeaders_DataHeader_t *)data;
+
+    if ((tb->replayFrameIndex >= tb->nbReplayFrames) ||
+        (maxSize < (int)PACKET_SIZE))
+    {
+        usleep (1000 * ((timeoutMs < 10) ? timeoutMs : 10));
+        return ARSTREAM_ERROR_TIMEOUT;
+    }
+    /* The copy a socket would do */
+    memcpy (data, &(tb->packets)[tb->replayFragmentIndex * PACKET_SIZE], PACKET_SIZE);
+    header->frameNumber = (uint16_t)(tb->replayFrameIndex + 1);
+    *size = PACKET_SIZE;
+    tb->replayFragmentIndex++;
+    if (tb->replayFragmentIndex == NB_FRAGMENTS)
+    {
+        tb->replayFragmentIndex = 0;
+        tb->replayFrameIndex++;
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_MicroBenchmarkTb_ReplaySendAck (void *context, uint8_t *data, int size)
+{
+    (void)context;
+    (void)data;
+    (void)size;
+    return ARSTREAM_OK;
+}
+
+static uint8_t* ARSTREAM_MicroBenchmarkTb_FilterGetBuffer (void *context, int size)
+{
+    ARSTREAM_MicroBenchmarkTb_t *tb = (ARSTREAM_MicroBenchmarkTb_t *)context;
+    (void)size;
+    return tb->filterBuffer;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_FilterGetOutputSize (void *context, int inputSize)
+{
+    (void)context;
+    return inputSize;
+}
+
+static int ARSTREAM_MicroBenchmarkTb_FilterBuffer (void *context, uint8_t *input, int inSize, uint8_t *output, int outSize)
+{
+    (void)context;
+    (void)input;
+    (void)output;
+    return (inSize < outSize) ? inSize : outSize;
+}
+
+static void ARSTREAM_MicroBenchmarkTb_FilterReleaseBuffer (void *context, uint8_t *buffer)
+{
+    (void)context;
+    (void)buffer;
+}
+
+static void ARSTREAM_MicroBenchmarkTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom)
+{
+    /* All the frames share the same buffer, which is never released */
+    (void)status;
+    (void)framePointer;
+    (void)frameSize;
+    (void)custom;
+}
+
+static uint8_t* ARSTREAM_MicroBenchmarkTb_FrameCompleteCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom)
+{
+    ARSTREAM_MicroBenchmarkTb_t *tb = (ARSTREAM_MicroBenchmarkTb_t *)custom;
+    (void)framePointer;
+    (void)numberOfSkippedFrames;
+    (void)isFlushFrame;
+
+    if ((cause == ARSTREAM_READER_CAUSE_FRAME_COMPLETE) &&
+        (frameSize == FRAME_SIZE))
+    {
+        pthread_mutex_lock (&(tb->mutex));
+        tb->nbDone++;
+        pthread_cond_signal (&(tb->cond));
+        pthread_mutex_unlock (&(tb->mutex));
+    }
+    *newBufferCapacity = FRAME_SIZE;
+    return tb->reassembly;
+}
+
+/*
+ * Implementation
+ */
+
+int ARSTREAM_MicroBenchmark_TestBenchMain (int argc, char *argv[])
+{
+    ARSTREAM_MicroBenchmarkTb_Bench_t benches [] = {
+        { "ack_set_flag",        ARSTREAM_MicroBenchmarkTb_AckSetFlag,     0, NB_FLAGS,     0,             0.0 },
+        { "ack_flag_is_set",     ARSTREAM_MicroBenchmarkTb_AckFlagIsSet,   0, NB_FLAGS,     0,             0.0 },
+        { "ack_all_flags_set",   ARSTREAM_MicroBenchmarkTb_AckAllFlagsSet, 0, NB_FLAGS,     0,             0.0 },
+        { "ack_count_not_set",   ARSTREAM_MicroBenchmarkTb_AckCountNotSet, 0, NB_FLAGS,     0,             0.0 },
+        { "ack_reset_up_to",     ARSTREAM_MicroBenchmarkTb_AckResetUpTo,   0, NB_FLAGS,     0,             0.0 },
+        { "ack_unset_flags",     ARSTREAM_MicroBenchmarkTb_AckUnsetFlags,  0, NB_FLAGS,     0,             0.0 },
+        { "queue_add_flush",     ARSTREAM_MicroBenchmarkTb_QueueAddFlush,  0, QUEUE_DEPTH,  0,             0.0 },
+        { "fragment_copy",       ARSTREAM_MicroBenchmarkTb_FragmentCopy,   0, NB_FRAGMENTS, FRAME_SIZE,    0.0 },
+        { "filter_dispatch",     ARSTREAM_MicroBenchmarkTb_FilterDispatch, 0, MAX_NB_FILTERS, 0,           0.0 },
+        { "reassembly_copy",     ARSTREAM_MicroBenchmarkTb_ReassemblyCopy, 0, NB_FRAGMENTS, FRAME_SIZE,    0.0 },
+        { "sender_path_1frag",   ARSTREAM_MicroBenchmarkTb_SenderPath,    -1, 1,            FRAGMENT_SIZE, 0.0 },
+        { "sender_path",         ARSTREAM_MicroBenchmarkTb_SenderPath,     0, 1,            FRAME_SIZE,    0.0 },
+        { "sender_path_filters", ARSTREAM_MicroBenchmarkTb_SenderPath,     MAX_NB_FILTERS, 1, FRAME_SIZE,  0.0 },
+        { "reader_path",         ARSTREAM_MicroBenchmarkTb_ReaderPath,     0, 1,            FRAME_SIZE,    0.0 },
+    };
+    ARSTREAM_MicroBenchmarkTb_t tb;
+    int minTimeMs = DEFAULT_MIN_TIME_MS;
+    double cpuMHz = 0.0;
+    int smoke = 0;
+    int retVal = 0;
+    int i;
+
+    if ((argc == 2) &&
+        (strcmp (argv[1], "--smoke") == 0))
+    {
+        smoke = 1;
+        minTimeMs = SMOKE_MIN_TIME_MS;
+        cpuMHz = SMOKE_CPU_MHZ;
+    }
+    else if (argc > 3)
+    {
+        ARSTREAM_MicroBenchmarkTb_PrintUsage (argv[0]);
+        return 1;
+    }
+    else
+    {
+        if (argc > 1)
+        {
+            minTimeMs = atoi (argv[1]);
+        }
+        if (argc > 2)
+        {
+            cpuMHz = atof (argv[2]);
+        }
+    }
+    if ((minTimeMs <= 0) ||
+        (cpuMHz < 0.0))
+    {
+        ARSTREAM_MicroBenchmarkTb_PrintUsage (argv[0]);
+        return 1;
+    }
+    if (cpuMHz == 0.0)
+    {
+        cpuMHz = ARSTREAM_MicroBenchmarkTb_EstimateCpuMHz ();
+    }
+
+    memset (&tb, 0, sizeof (tb));
+    pthread_mutex_init (&(tb.mutex), NULL);
+    pthread_cond_init (&(tb.cond), NULL);
+    tb.frame = malloc (FRAME_SIZE);
+    tb.sendFragment = malloc (PACKET_SIZE);
+    tb.packets = malloc (NB_FRAGMENTS * PACKET_SIZE);
+    tb.reassembly = malloc (FRAME_SIZE);
+    tb.filterBuffer = malloc (FRAME_SIZE);
+    if ((tb.frame == NULL) ||
+        (tb.sendFragment == NULL) ||
+        (tb.packets == NULL) ||
+        (tb.reassembly == NULL) ||
+        (tb.filterBuffer == NULL))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to alloc the buffers");
+        retVal = 1;
+    }
+
+    if (retVal == 0)
+    {
+        /* Frame contents and packets of a keyframe, as sent by a native sender */
+        for (i = 0; i < FRAME_SIZE; i++)
+        {
+            tb.frame[i] = (uint8_t)(i * 7);
+        }
+        memset (tb.filterBuffer, 0, FRAME_SIZE);
+        for (i = 0; i < NB_FRAGMENTS; i++)
+        {
+            ARSTREAM_NetworkHeaders_DataHeader_t *header = (ARSTREAM_NetworkHeaders_DataHeader_t *)&(tb.packets)[i * PACKET_SIZE];
+            header->frameNumber = 1;
+            header->frameFlags = ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME |
+                ((ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME << ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT) & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK) |
+                ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_VALID;
+            header->fragmentNumber = i;
+            header->fragmentsPerFrame = NB_FRAGMENTS;
+            memcpy (&(tb.packets)[i * PACKET_SIZE + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], &(tb.frame)[i * FRAGMENT_SIZE], FRAGMENT_SIZE);
+        }
+        for (i = 0; i < MAX_NB_FILTERS; i++)
+        {
+            tb.filters[i].getBuffer = ARSTREAM_MicroBenchmarkTb_FilterGetBuffer;
+            tb.filters[i].getOutputSize = ARSTREAM_MicroBenchmarkTb_FilterGetOutputSize;
+            tb.filters[i].filterBuffer = ARSTREAM_MicroBenchmarkTb_FilterBuffer;
+            tb.filters[i].releaseBuffer = ARSTREAM_MicroBenchmarkTb_FilterReleaseBuffer;
+            tb.filters[i].context = &tb;
+        }
+
+        printf ("# cpuMHz=%.0f frameSize=%d fragmentSize=%d\n", cpuMHz, FRAME_SIZE, FRAGMENT_SIZE);
+        printf ("name,iterations,opsPerIteration,nsPerOp,bytesPerOp,bytesPerCycle\n");
+        for (i = 0; i < NB_ELEMENTS (benches); i++)
+        {
+            ARSTREAM_MicroBenchmarkTb_Bench_t *bench = &benches[i];
+            uint32_t nbIterations = ARSTREAM_MicroBenchmarkTb_Measure (&tb, bench, minTimeMs);
+            if (nbIterations == 0)
+            {
+                ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "%s failed", bench->name);
+                retVal = 1;
+                continue;
+            }
+            if (bench->bytesPerIteration > 0)
+            {
+                double bytesPerOp = (double)bench->bytesPerIteration / bench->opsPerIteration;
+                printf ("%s,%u,%u,%.2f,%.0f,%.3f\n", bench->name, nbIterations, bench->opsPerIteration, bench->nsPerOp,
+                        bytesPerOp, bytesPerOp * 1000.0 / (bench->nsPerOp * cpuMHz));
+            }
+            else
+            {
+                printf ("%s,%u,%u,%.2f,0,\n", bench->name, nbIterations, bench->opsPerIteration, bench->nsPerOp);
+            }
+            fflush (stdout);
+        }
+    }
+
+    if ((retVal == 0) &&
+        (smoke == 1))
+    {
+        int nbFailed = 0;
+        for (i = 0; i < NB_ELEMENTS (benches); i++)
+        {
+            if (!(benches[i].nsPerOp > 0.0))
+            {
+                printf ("FAIL smoke : %s measured %.2f ns per op\n", benches[i].name, benches[i].nsPerOp);
+                nbFailed++;
+            }
+        }
+        /* The reader path reassembled the replayed packets in tb.reassembly */
+        if (memcmp (tb.reassembly, tb.frame, FRAME_SIZE) != 0)
+        {
+            printf ("FAIL smoke : the reader path reassembled a different frame\n");
+            nbFailed++;
+        }
+        if (nbFailed == 0)
+        {
+            printf ("PASS smoke\n");
+        }
+        else
+        {
+            retVal = 1;
+        }
+    }
+
+    free (tb.frame);
+    free (tb.sendFragment);
+    free (tb.packets);
+    free (tb.reassembly);
+    free (tb.filterBuffer);
+    pthread_cond_destroy (&(tb.cond));
+    pthread_mutex_destroy (&(tb.mutex));
+    return retVal;
+}
@@ -376,10 +376,14 @@ int ARSTREAM_ReaderTb_StartStreamTest (ARNETWORK_Manager_t *manager, const char
     }
 
     ARSTREAM_ReaderTB_AddFilters();
+    ARSTREAM_Reader_SetFeedback (g_Reader, 1, 1000);
+    ARSTREAM_Reader_SetClockSyncInterval (g_Reader, 1000);
+    ARSTREAM_Reader_SetJitterBuffer (g_Reader, 10, 150);
 
-    pthread_t streamsend, streamread;
+    pthread_t streamsend, streamread, streamplayout;
     pthread_create (&streamsend, NULL, ARSTREAM_Reader_RunDataThread, g_Reader);
     pthread_create (&streamread, NULL, ARSTREAM_Reader_RunAckThread, g_Reader);
+    pthread_create (&streamplayout, NULL, ARSTREAM_Reader_RunPlayoutThread, g_Reader);
 
     /* USER CODE */
 
@@ -391,6 +395,7 @@ int ARSTREAM_ReaderTb_StartStreamTest (ARNETWORK_Manager_t *manager, const char
 
     ARSTREAM_Reader_StopReader (g_Reader);
 
+    pthread_join (streamplayout, NULL);
     pthread_join (streamread, NULL);
     pthread_join (streamsend, NULL);
 
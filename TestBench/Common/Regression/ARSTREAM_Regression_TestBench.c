@@ -0,0 +1,2110 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Regression_TestBench.c
+ * @brief Regression checks of the library bug fixes
+ * @date 10/17/2026
+ */
+
+/*
+ * System Headers
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Private Headers
+ */
+
+/* Built with the library sources in the include path, for the internal primitives */
+#include "ARSTREAM_NetworkHeaders.h"
+#include "ARSTREAM_H264.h"
+#include "ARSTREAM_JitterBuffer.h"
+#include "ARSTREAM_RateControl.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARStream/ARSTREAM_Reader.h>
+#include <libARStream/ARSTREAM_Sender.h>
+#include <libARStream/ARSTREAM_Transport.h>
+
+#include "ARSTREAM_Regression_TestBench.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "ARSTREAM_Regression_TB"
+
+/**
+ * @brief Fails the current check (and logs where) if the condition is false
+ */
+#define CHECK(cond)                                                     \
+    do                                                                  \
+    {                                                                   \
+        if (!(cond))                                                    \
+        {                                                               \
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "%s:%d : check failed : %s", __FILE__, __LINE__, #cond); \
+            retVal = -1;                                                \
+        }                                                               \
+    } while (0)
+
+/**
+ * @brief Time given to a sender or reader thread to make progress
+ */
+#define WAIT_TIMEOUT_S (2)
+
+#define FRAGMENT_SIZE (1000)
+#define MAX_NB_FRAGMENTS (128)
+#define NB_FILTERS (2)
+#define NB_FRAMES (20)
+
+#define PACKET_MAX_SIZE (sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + FRAGMENT_SIZE)
+#define PACKET_QUEUE_SIZE (16)
+#define READER_FRAME_SIZE (MAX_NB_FRAGMENTS * FRAGMENT_SIZE)
+
+#define RTP_VERSION_2 (0x8000)
+#define RTP_MARKER_FLAG (0x0080)
+#define RTP_PAYLOAD_TYPE (96)
+#define RTP_PAYLOAD_SIZE (100)
+#define RTP_NALU_REFERENCE_SLICE (0x61)
+
+#define UDP_READER_PORT (47310)
+#define UDP_SENDER_PORT (47311)
+#define TRANSPORT_NB_PACKETS (8)
+#define IMPAIRMENT_DELAY_MS (20)
+#define FRAME_AGE_MS (50)
+#define RETRY_TIME_MS (5)
+#define CLOCK_SYNC_INTERVAL_MS (10)
+#define ALIGNED_NB_NAL_UNITS (5)
+#define ALIGNED_NAL_UNIT_SIZE (700)
+#define STREAM_NB_FRAMES (5)
+#define STREAM_FRAME_NB_FRAGMENTS (3)
+
+#define NB_ELEMENTS(array) ((int)(sizeof (array) / sizeof ((array)[0])))
+
+/*
+ * Types
+ */
+
+/**
+ * @brief One regression check
+ */
+typedef struct {
+    const char *name;
+    /** Runs the check, returns 0 on success */
+    int (*run)(void);
+} ARSTREAM_RegressionTb_Check_t;
+
+/**
+ * @brief Counters of a filter
+ */
+typedef struct {
+    int nbGetBuffer;
+    int nbRelease;
+    int nbNullInput;
+} ARSTREAM_RegressionTb_FilterCounters_t;
+
+/**
+ * @brief State shared by a check and the library threads
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int nbSubmitted; // Frames submitted to the sender transport
+    int nbFragments; // Fragments given to the sender transport
+    uint8_t lastFrameFlags; // frameFlags of the last fragment given to the sender transport
+    int nbSent; // ARSTREAM_SENDER_STATUS_FRAME_SENT callbacks
+    int nbExpired; // ARSTREAM_SENDER_STATUS_FRAME_EXPIRED callbacks
+    int nbCancelled; // Other sender callbacks
+    int nbHookFragments; // Packets from the sender seen by the loopback hook
+    int nbHookAcks; // Packets from the reader seen by the loopback hook
+    int nbHookControls; // Control frames from the sender seen by the loopback hook
+    int nbAlignedFragments; // Fragments with an offset, starting on a start code, seen by the loopback hook
+    ARSTREAM_RegressionTb_FilterCounters_t filterCounters [NB_FILTERS];
+
+    /* Reader side : packets pushed by the check, polled by the reader data thread */
+    uint8_t packets [PACKET_QUEUE_SIZE][PACKET_MAX_SIZE];
+    int packetSizes [PACKET_QUEUE_SIZE];
+    int nbPushed;
+    int nbPopped;
+    int nbPolls; // Calls of receiveFragment
+    int nbPollsAtLastPop;
+    int nbComplete; // ARSTREAM_READER_CAUSE_FRAME_COMPLETE callbacks
+    uint32_t lastCompleteSize;
+    int lastSkippedFrames; // numberOfSkippedFrames of the last complete frame
+    uint8_t *readerBuffer;
+} ARSTREAM_RegressionTb_Context_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Inits / destroys the synchronisation of a context
+ */
+static void ARSTREAM_RegressionTb_ContextInit (ARSTREAM_RegressionTb_Context_t *ctx);
+static void ARSTREAM_RegressionTb_ContextDestroy (ARSTREAM_RegressionTb_Context_t *ctx);
+
+/**
+ * @brief Sends a burst of fragments from sender to reader, then an ack from reader to sender, and checks what was received
+ * The first half of the burst has the same size, to be sent as one message by the UDP segmentation offload
+ * @return 0, or -1 if a packet was lost or modified
+ */
+static int ARSTREAM_RegressionTb_TransportRoundTrip (ARSTREAM_Transport_t *sender, ARSTREAM_Transport_t *reader);
+
+/**
+ * @brief Runs ARSTREAM_RegressionTb_TransportRoundTrip() on a pair of UDP transports over 127.0.0.1
+ * @return 0, or -1 on error
+ */
+static int ARSTREAM_RegressionTb_UdpRoundTrip (eARSTREAM_TRANSPORT_UDP_IO_ENGINE ioEngine, int offload);
+
+/**
+ * @brief Waits until *counter reaches value
+ * @return 0, or -1 on timeout
+ */
+static int ARSTREAM_RegressionTb_WaitCounter (ARSTREAM_RegressionTb_Context_t *ctx, int *counter, int value);
+
+/**
+ * @brief Increments *counter and wakes up the waiters
+ */
+static void ARSTREAM_RegressionTb_IncCounter (ARSTREAM_RegressionTb_Context_t *ctx, int *counter);
+
+/**
+ * @brief Sender side transport : packets are dropped, submits are counted
+ */
+static eARSTREAM_ERROR ARSTREAM_RegressionTb_NullSendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback);
+static void ARSTREAM_RegressionTb_NullSubmit (void *context);
+static eARSTREAM_ERROR ARSTREAM_RegressionTb_NullReceive (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+
+/**
+ * @brief Creates a sender over the null transport of ctx, with retries every retryTimeMs
+ */
+static ARSTREAM_Sender_t* ARSTREAM_RegressionTb_NewNullSender (ARSTREAM_RegressionTb_Context_t *ctx, ARSTREAM_Transport_t *transport, int retryTimeMs);
+
+/**
+ * @brief Sends a one fragment frame, and counts the fragments given to the transport until it was submitted nbLoops more times
+ * @return The number of fragments sent for the frame, or -1 on error
+ */
+static int ARSTREAM_RegressionTb_CountFrameFragments (ARSTREAM_RegressionTb_Context_t *ctx, ARSTREAM_Sender_t *sender, const ARSTREAM_Sender_FrameParams_t *params, int nbLoops);
+
+/**
+ * @brief Reader side transport : gives the packets pushed by the check
+ */
+static eARSTREAM_ERROR ARSTREAM_RegressionTb_QueueReceiveFragment (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_RegressionTb_QueueSendAck (void *context, uint8_t *data, int size);
+
+/**
+ * @brief Pushes a native packet to the reader side transport, of a flush key frame or of a reference frame
+ */
+static void ARSTREAM_RegressionTb_PushFragment (ARSTREAM_RegressionTb_Context_t *ctx, uint16_t frameNumber, uint8_t fragmentNumber, uint8_t fragmentsPerFrame, int isFlushFrame);
+
+/**
+ * @brief Pushes a single NAL unit RTP packet to the reader side transport
+ */
+static void ARSTREAM_RegressionTb_PushRtpPacket (ARSTREAM_RegressionTb_Context_t *ctx, uint16_t seqNum, uint32_t timestamp, int marker);
+
+/**
+ * @brief Waits until the reader data thread processed all the pushed packets
+ * @return 0, or -1 on timeout
+ */
+static int ARSTREAM_RegressionTb_WaitReaderIdle (ARSTREAM_RegressionTb_Context_t *ctx);
+
+/**
+ * @brief Creates a reader over the reader side transport of ctx, and starts its data thread
+ */
+static ARSTREAM_Reader_t* ARSTREAM_RegressionTb_StartReader (ARSTREAM_RegressionTb_Context_t *ctx, ARSTREAM_Transport_t *transport, eARSTREAM_READER_PACKETIZATION mode, pthread_t *dataThread);
+
+/**
+ * @brief Stops and deletes a reader created by ARSTREAM_RegressionTb_StartReader
+ */
+static void ARSTREAM_RegressionTb_StopReader (ARSTREAM_Reader_t **reader, pthread_t dataThread);
+
+/**
+ * @brief Counting filter : copies its input in a new buffer
+ */
+static uint8_t* ARSTREAM_RegressionTb_FilterGetBuffer (void *context, int size);
+static int ARSTREAM_RegressionTb_FilterGetOutputSize (void *context, int inputSize);
+static int ARSTREAM_RegressionTb_FilterBuffer (void *context, uint8_t *input, int inSize, uint8_t *output, int outSize);
+static void ARSTREAM_RegressionTb_FilterReleaseBuffer (void *context, uint8_t *buffer);
+
+/**
+ * @see ARSTREAM_Sender.h
+ */
+static void ARSTREAM_RegressionTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
+
+/**
+ * @see ARSTREAM_Reader.h
+ */
+static uint8_t* ARSTREAM_RegressionTb_FrameCompleteCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom);
+
+/**
+ * @brief Ack bitfields of exactly 64 and 128 fragments, and flags of the high word
+ */
+static int ARSTREAM_RegressionTb_AckPacketFullWords (void);
+
+/**
+ * @brief A sender filter chain calls the application back once per frame, and releases every buffer
+ */
+static int ARSTREAM_RegressionTb_SenderFilterChain (void);
+
+/**
+ * @brief The first frame of a new reader needs all its fragments, whatever the reader memory held before
+ */
+static int ARSTREAM_RegressionTb_ReaderFirstFrame (void);
+
+/**
+ * @brief A late RTP packet from a previous frame is dropped without ending the current frame
+ */
+static int ARSTREAM_RegressionTb_RtpLatePacket (void);
+
+/**
+ * @brief Whole RTP frames lost in a sequence number gap are counted from the timestamps
+ */
+static int ARSTREAM_RegressionTb_RtpMissedFrames (void);
+
+/**
+ * @brief Frames without a priority are retried until replaced, frames with a priority follow its retry limit
+ */
+static int ARSTREAM_RegressionTb_SenderRetriesWithoutPriority (void);
+
+/**
+ * @brief In the default mode, a new frame replaces an unacknowledged flush frame right away, unless priorities are used
+ */
+static int ARSTREAM_RegressionTb_SenderDefaultReplace (void);
+
+/**
+ * @brief Tagged frames of the ack buffer are recognized by their header, ack frames are never mistaken for them
+ */
+static int ARSTREAM_RegressionTb_AckBufferControlTags (void);
+
+/**
+ * @brief The auto classification sees every NAL unit of frames with more NAL units than a queued frame keeps
+ */
+static int ARSTREAM_RegressionTb_SenderManyNalUnits (void);
+
+/**
+ * @brief A full jitter buffer skips its least valuable frame, and keeps the flush frames
+ */
+static int ARSTREAM_RegressionTb_JitterBufferOverflow (void);
+
+/**
+ * @brief Bytes not acknowledged yet are not counted as lost by the congestion controller, missing fragments are
+ */
+static int ARSTREAM_RegressionTb_RateControlLoss (void);
+
+/**
+ * @brief An io_uring UDP transport releases its port and receive buffers on destroy, and can be created again
+ */
+static int ARSTREAM_RegressionTb_UdpUringReinit (void);
+
+/**
+ * @brief Packets go through the loopback transport pair in both directions, in order and unmodified
+ */
+static int ARSTREAM_RegressionTb_TransportLoopback (void);
+
+/**
+ * @brief Packets go through the shared memory transport in both directions, in order and unmodified
+ */
+static int ARSTREAM_RegressionTb_TransportShm (void);
+
+/**
+ * @brief Packets go through the UDP transport with the syscalls engine, without offload
+ */
+static int ARSTREAM_RegressionTb_TransportUdp (void);
+
+/**
+ * @brief Packets go through the UDP transport with the syscalls engine, with the segmentation and receive offloads
+ */
+static int ARSTREAM_RegressionTb_TransportUdpOffload (void);
+
+/**
+ * @brief Packets go through the UDP transport with the io_uring engine
+ */
+static int ARSTREAM_RegressionTb_TransportUdpIoUring (void);
+
+/**
+ * @brief Delayed packets are sent by the impairment thread, lost packets are counted and never sent
+ */
+static int ARSTREAM_RegressionTb_TransportImpairment (void);
+
+/**
+ * @brief Frames older than their maximum age are given back as expired, from the queue or while being sent
+ */
+static int ARSTREAM_RegressionTb_SenderFrameExpiry (void);
+
+/**
+ * @brief A full queue rejects, drops or replaces frames following its policy, and decimation drops the non-reference frames first
+ */
+static int ARSTREAM_RegressionTb_SenderQueuePolicies (void);
+
+/**
+ * @brief A best effort sender sends each fragment once, and a reader without ACKs sends nothing back
+ */
+static int ARSTREAM_RegressionTb_BestEffortStream (void);
+
+/**
+ * @brief Loopback hook : drops the second fragment of every frame, and counts the packets from the reader
+ */
+static int ARSTREAM_RegressionTb_DropSecondFragment (void *customData, eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION direction, const uint8_t *data, int size);
+
+/**
+ * @brief A frame abandoned by the reader is cancelled by the sender, which stops retrying it
+ */
+static int ARSTREAM_RegressionTb_ReaderAbandonFrame (void);
+
+/**
+ * @brief Loopback hook : counts the packets, and the fragments which start on a NAL unit start code
+ */
+static int ARSTREAM_RegressionTb_CountAlignedFragments (void *customData, eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION direction, const uint8_t *data, int size);
+
+/**
+ * @brief Once the reader sent control frames, a NAL aligned sender cuts its fragments on start codes, and the reader places them back
+ */
+static int ARSTREAM_RegressionTb_NalAlignedFragments (void);
+
+/**
+ * @brief The auto classification gives each kind of frame its priority, and keeps the application parameters of other frames
+ */
+static int ARSTREAM_RegressionTb_SenderAutoClassification (void);
+
+/**
+ * @brief The cached keyframe is resent as a flush frame, and given back to the application once replaced in the cache
+ */
+static int ARSTREAM_RegressionTb_SenderKeyframeCache (void);
+
+/**
+ * @brief A reader waiting for a keyframe discards the frames before the first flush frame, and measures its startup
+ */
+static int ARSTREAM_RegressionTb_ReaderWaitKeyframe (void);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_RegressionTb_ContextInit (ARSTREAM_RegressionTb_Context_t *ctx)
+{
+    memset (ctx, 0, sizeof (*ctx));
+    pthread_mutex_init (&(ctx->mutex), NULL);
+    pthread_cond_init (&(ctx->cond), NULL);
+}
+
+static void ARSTREAM_RegressionTb_ContextDestroy (ARSTREAM_RegressionTb_Context_t *ctx)
+{
+    pthread_cond_destroy (&(ctx->cond));
+    pthread_mutex_destroy (&(ctx->mutex));
+}
+
+static int ARSTREAM_RegressionTb_TransportRoundTrip (ARSTREAM_Transport_t *sender, ARSTREAM_Transport_t *reader)
+{
+    uint8_t packet [FRAGMENT_SIZE];
+    ARSTREAM_NetworkHeaders_AckPacket_t ack;
+    int size = 0;
+    int retVal = 0;
+    int i, j;
+
+    /* Packets of the same size, then of decreasing sizes, sent as one burst */
+    for (i = 0; i < TRANSPORT_NB_PACKETS; i++)
+    {
+        size = (i < TRANSPORT_NB_PACKETS / 2) ? FRAGMENT_SIZE : FRAGMENT_SIZE - 100 * i;
+        for (j = 0; j < size; j++)
+        {
+            packet[j] = (uint8_t)(i + j);
+        }
+        CHECK (sender->sendFragment (sender->context, packet, size, NULL, NULL) == ARSTREAM_OK);
+    }
+    if (sender->submit != NULL)
+    {
+        sender->submit (sender->context);
+    }
+
+    for (i = 0; (i < TRANSPORT_NB_PACKETS) && (retVal == 0); i++)
+    {
+        size = 0;
+        CHECK (reader->receiveFragment (reader->context, packet, sizeof (packet), &size, WAIT_TIMEOUT_S * 1000) == ARSTREAM_OK);
+        CHECK (size == ((i < TRANSPORT_NB_PACKETS / 2) ? FRAGMENT_SIZE : FRAGMENT_SIZE - 100 * i));
+        for (j = 0; (j < size) && (retVal == 0); j++)
+        {
+            CHECK (packet[j] == (uint8_t)(i + j));
+        }
+    }
+
+    /* The reader answers on the same transport */
+    if (retVal == 0)
+    {
+        memset (&ack, 0x5A, sizeof (ack));
+        CHECK (reader->sendAck (reader->context, (uint8_t *)&ack, sizeof (ack)) == ARSTREAM_OK);
+        size = 0;
+        memset (packet, 0, sizeof (packet));
+        CHECK (sender->receiveAck (sender->context, packet, sizeof (packet), &size, WAIT_TIMEOUT_S * 1000) == ARSTREAM_OK);
+        CHECK (size == (int)sizeof (ack));
+        CHECK (memcmp (packet, &ack, sizeof (ack)) == 0);
+    }
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_UdpRoundTrip (eARSTREAM_TRANSPORT_UDP_IO_ENGINE ioEngine, int offload)
+{
+    ARSTREAM_Transport_UdpParams_t params;
+    ARSTREAM_Transport_t sender;
+    ARSTREAM_Transport_t reader;
+    eARSTREAM_ERROR readerErr, senderErr;
+    int retVal = 0;
+
+    /* The reader has no remote address : it answers the source of the fragments */
+    ARSTREAM_Transport_UdpParamsDefaultInit (&params);
+    params.localPort = UDP_READER_PORT;
+    params.maxFragmentSize = FRAGMENT_SIZE;
+    params.offload = offload;
+    params.ioEngine = ioEngine;
+    readerErr = ARSTREAM_Transport_InitUdp (&reader, &params);
+    CHECK (readerErr == ARSTREAM_OK);
+    params.localPort = UDP_SENDER_PORT;
+    params.remoteAddress = "127.0.0.1";
+    params.remotePort = UDP_READER_PORT;
+    senderErr = ARSTREAM_Transport_InitUdp (&sender, &params);
+    CHECK (senderErr == ARSTREAM_OK);
+    if (retVal == 0)
+    {
+        CHECK (ARSTREAM_RegressionTb_TransportRoundTrip (&sender, &reader) == 0);
+    }
+    if (senderErr == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_Destroy (&sender);
+    }
+    if (readerErr == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_Destroy (&reader);
+    }
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_WaitCounter (ARSTREAM_RegressionTb_Context_t *ctx, int *counter, int value)
+{
+    int retVal = 0;
+    struct timespec deadline;
+    clock_gettime (CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += WAIT_TIMEOUT_S;
+    pthread_mutex_lock (&(ctx->mutex));
+    while ((retVal == 0) &&
+           (*counter < value))
+    {
+        if (pthread_cond_timedwait (&(ctx->cond), &(ctx->mutex), &deadline) == ETIMEDOUT)
+        {
+            retVal = (*counter < value) ? -1 : 0;
+        }
+    }
+    pthread_mutex_unlock (&(ctx->mutex));
+    return retVal;
+}
+
+static void ARSTREAM_RegressionTb_IncCounter (ARSTREAM_RegressionTb_Context_t *ctx, int *counter)
+{
+    pthread_mutex_lock (&(ctx->mutex));
+    (*counter)++;
+    pthread_cond_broadcast (&(ctx->cond));
+    pthread_mutex_unlock (&(ctx->mutex));
+}
+
+static eARSTREAM_ERROR ARSTREAM_RegressionTb_NullSendFragment (void *context, uint8_t *data, int size, void *customData, ARSTREAM_Transport_SendCallback_t callback)
+{
+    ARSTREAM_RegressionTb_Context_t *ctx = (ARSTREAM_RegressionTb_Context_t *)context;
+    if (size >= (int)sizeof (ARSTREAM_NetworkHeaders_DataHeader_t))
+    {
+        pthread_mutex_lock (&(ctx->mutex));
+        ctx->lastFrameFlags = ((ARSTREAM_NetworkHeaders_DataHeader_t *)data)->frameFlags;
+        pthread_mutex_unlock (&(ctx->mutex));
+    }
+    ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbFragments));
+    if (callback != NULL)
+    {
+        callback (customData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+    }
+    return ARSTREAM_OK;
+}
+
+static void ARSTREAM_RegressionTb_NullSubmit (void *context)
+{
+    ARSTREAM_RegressionTb_Context_t *ctx = (ARSTREAM_RegressionTb_Context_t *)context;
+    ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbSubmitted));
+}
+
+static eARSTREAM_ERROR ARSTREAM_RegressionTb_NullReceive (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    (void)context;
+    (void)data;
+    (void)maxSize;
+    (void)size;
+    usleep (1000 * timeoutMs);
+    return ARSTREAM_ERROR_TIMEOUT;
+}
+
+static ARSTREAM_Sender_t* ARSTREAM_RegressionTb_NewNullSender (ARSTREAM_RegressionTb_Context_t *ctx, ARSTREAM_Transport_t *transport, int retryTimeMs)
+{
+    ARSTREAM_Sender_t *sender;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    memset (transport, 0, sizeof (*transport));
+    transport->sendFragment = ARSTREAM_RegressionTb_NullSendFragment;
+    transport->submit = ARSTREAM_RegressionTb_NullSubmit;
+    transport->receiveAck = ARSTREAM_RegressionTb_NullReceive;
+    transport->context = ctx;
+    sender = ARSTREAM_Sender_NewWithTransport (transport, ARSTREAM_RegressionTb_FrameUpdateCallback, NB_FRAMES, FRAGMENT_SIZE, MAX_NB_FRAGMENTS, ctx, &err);
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Sender_SetTimeBetweenRetries (sender, retryTimeMs, retryTimeMs);
+    }
+    if (err != ARSTREAM_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create a sender : %s", ARSTREAM_Error_ToString (err));
+        ARSTREAM_Sender_Delete (&sender);
+    }
+    return sender;
+}
+
+static int ARSTREAM_RegressionTb_CountFrameFragments (ARSTREAM_RegressionTb_Context_t *ctx, ARSTREAM_Sender_t *sender, const ARSTREAM_Sender_FrameParams_t *params, int nbLoops)
+{
+    static uint8_t frame [FRAGMENT_SIZE];
+    int nbFragments;
+    int nbSubmitted;
+    pthread_mutex_lock (&(ctx->mutex));
+    nbFragments = ctx->nbFragments;
+    nbSubmitted = ctx->nbSubmitted;
+    pthread_mutex_unlock (&(ctx->mutex));
+    if ((ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), params, NULL) == ARSTREAM_OK) &&
+        (ARSTREAM_RegressionTb_WaitCounter (ctx, &(ctx->nbSubmitted), nbSubmitted + nbLoops) == 0))
+    {
+        pthread_mutex_lock (&(ctx->mutex));
+        nbFragments = ctx->nbFragments - nbFragments;
+        pthread_mutex_unlock (&(ctx->mutex));
+    }
+    else
+    {
+        nbFragments = -1;
+    }
+    return nbFragments;
+}
+
+static eARSTREAM_ERROR ARSTREAM_RegressionTb_QueueReceiveFragment (void *context, uint8_t *data, int maxSize, int *size, int timeoutMs)
+{
+    ARSTREAM_RegressionTb_Context_t *ctx = (ARSTREAM_RegressionTb_Context_t *)context;
+    eARSTREAM_ERROR retVal = ARSTREAM_ERROR_TIMEOUT;
+    struct timespec deadline;
+    clock_gettime (CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += (long)timeoutMs * 1000000;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000;
+    deadline.tv_nsec %= 1000000000;
+
+    pthread_mutex_lock (&(ctx->mutex));
+    ctx->nbPolls++;
+    pthread_cond_broadcast (&(ctx->cond));
+    while ((ctx->nbPopped == ctx->nbPushed) &&
+           (pthread_cond_timedwait (&(ctx->cond), &(ctx->mutex), &deadline) != ETIMEDOUT))
+    {
+        // Wait for a packet
+    }
+    if (ctx->nbPopped < ctx->nbPushed)
+    {
+        int index = ctx->nbPopped % PACKET_QUEUE_SIZE;
+        *size = (ctx->packetSizes[index] < maxSize) ? ctx->packetSizes[index] : maxSize;
+        memcpy (data, ctx->packets[index], *size);
+        ctx->nbPopped++;
+        ctx->nbPollsAtLastPop = ctx->nbPolls;
+        retVal = ARSTREAM_OK;
+    }
+    pthread_mutex_unlock (&(ctx->mutex));
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_RegressionTb_QueueSendAck (void *context, uint8_t *data, int size)
+{
+    (void)context;
+    (void)data;
+    (void)size;
+    return ARSTREAM_OK;
+}
+
+static void ARSTREAM_RegressionTb_PushFragment (ARSTREAM_RegressionTb_Context_t *ctx, uint16_t frameNumber, uint8_t fragmentNumber, uint8_t fragmentsPerFrame, int isFlushFrame)
+{
+    int index;
+    ARSTREAM_NetworkHeaders_DataHeader_t *header;
+    eARSTREAM_SENDER_FRAME_PRIORITY priority = (isFlushFrame != 0) ? ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME : ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+    pthread_mutex_lock (&(ctx->mutex));
+    index = ctx->nbPushed % PACKET_QUEUE_SIZE;
+    header = (ARSTREAM_NetworkHeaders_DataHeader_t *)ctx->packets[index];
+    header->frameNumber = frameNumber;
+    header->frameFlags = ((isFlushFrame != 0) ? ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME : 0) |
+        ((priority << ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT) & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK) |
+        ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_VALID;
+    header->fragmentNumber = fragmentNumber;
+    header->fragmentsPerFrame = fragmentsPerFrame;
+    memset (&(ctx->packets[index][sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)]), fragmentNumber, FRAGMENT_SIZE);
+    ctx->packetSizes[index] = PACKET_MAX_SIZE;
+    ctx->nbPushed++;
+    pthread_cond_broadcast (&(ctx->cond));
+    pthread_mutex_unlock (&(ctx->mutex));
+}
+
+static void ARSTREAM_RegressionTb_PushRtpPacket (ARSTREAM_RegressionTb_Context_t *ctx, uint16_t seqNum, uint32_t timestamp, int marker)
+{
+    int index;
+    ARSTREAM_NetworkHeaders_DataHeader2_t *header;
+    uint8_t *payload;
+    pthread_mutex_lock (&(ctx->mutex));
+    index = ctx->nbPushed % PACKET_QUEUE_SIZE;
+    header = (ARSTREAM_NetworkHeaders_DataHeader2_t *)ctx->packets[index];
+    header->flags = htons (RTP_VERSION_2 | ((marker != 0) ? RTP_MARKER_FLAG : 0) | RTP_PAYLOAD_TYPE);
+    header->seqNum = htons (seqNum);
+    header->timestamp = htonl (timestamp);
+    header->ssrc = 0;
+    payload = &(ctx->packets[index][sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t)]);
+    memset (payload, seqNum & 0xFF, RTP_PAYLOAD_SIZE);
+    payload[0] = RTP_NALU_REFERENCE_SLICE;
+    ctx->packetSizes[index] = sizeof (ARSTREAM_NetworkHeaders_DataHeader2_t) + RTP_PAYLOAD_SIZE;
+    ctx->nbPushed++;
+    pthread_cond_broadcast (&(ctx->cond));
+    pthread_mutex_unlock (&(ctx->mutex));
+}
+
+static int ARSTREAM_RegressionTb_WaitReaderIdle (ARSTREAM_RegressionTb_Context_t *ctx)
+{
+    int retVal = 0;
+    struct timespec deadline;
+    clock_gettime (CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += WAIT_TIMEOUT_S;
+    pthread_mutex_lock (&(ctx->mutex));
+    /* The last packet was processed once the data thread polls again */
+    while ((retVal == 0) &&
+           ((ctx->nbPopped < ctx->nbPushed) ||
+            (ctx->nbPolls <= ctx->nbPollsAtLastPop)))
+    {
+        if (pthread_cond_timedwait (&(ctx->cond), &(ctx->mutex), &deadline) == ETIMEDOUT)
+        {
+            retVal = -1;
+        }
+    }
+    pthread_mutex_unlock (&(ctx->mutex));
+    return retVal;
+}
+
+static ARSTREAM_Reader_t* ARSTREAM_RegressionTb_StartReader (ARSTREAM_RegressionTb_Context_t *ctx, ARSTREAM_Transport_t *transport, eARSTREAM_READER_PACKETIZATION mode, pthread_t *dataThread)
+{
+    ARSTREAM_Reader_t *reader;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    memset (transport, 0, sizeof (*transport));
+    transport->receiveFragment = ARSTREAM_RegressionTb_QueueReceiveFragment;
+    transport->sendAck = ARSTREAM_RegressionTb_QueueSendAck;
+    transport->context = ctx;
+    reader = ARSTREAM_Reader_NewWithTransport (transport, ARSTREAM_RegressionTb_FrameCompleteCallback, ctx->readerBuffer, READER_FRAME_SIZE, FRAGMENT_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK, ctx, &err);
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Reader_SetPacketizationMode (reader, mode);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        pthread_create (dataThread, NULL, ARSTREAM_Reader_RunDataThread, reader);
+    }
+    else
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create a reader : %s", ARSTREAM_Error_ToString (err));
+        ARSTREAM_Reader_Delete (&reader);
+    }
+    return reader;
+}
+
+static void ARSTREAM_RegressionTb_StopReader (ARSTREAM_Reader_t **reader, pthread_t dataThread)
+{
+    if (*reader != NULL)
+    {
+        ARSTREAM_Reader_StopReader (*reader);
+        pthread_join (dataThread, NULL);
+        ARSTREAM_Reader_Delete (reader);
+    }
+}
+
+static uint8_t* ARSTREAM_RegressionTb_FilterGetBuffer (void *context, int size)
+{
+    ARSTREAM_RegressionTb_FilterCounters_t *counters = (ARSTREAM_RegressionTb_FilterCounters_t *)context;
+    counters->nbGetBuffer++;
+    return malloc (size);
+}
+
+static int ARSTREAM_RegressionTb_FilterGetOutputSize (void *context, int inputSize)
+{
+    (void)context;
+    return inputSize;
+}
+
+static int ARSTREAM_RegressionTb_FilterBuffer (void *context, uint8_t *input, int inSize, uint8_t *output, int outSize)
+{
+    ARSTREAM_RegressionTb_FilterCounters_t *counters = (ARSTREAM_RegressionTb_FilterCounters_t *)context;
+    int cpSize = (inSize < outSize) ? inSize : outSize;
+    if (input == NULL)
+    {
+        counters->nbNullInput++;
+        return 0;
+    }
+    memcpy (output, input, cpSize);
+    return cpSize;
+}
+
+static void ARSTREAM_RegressionTb_FilterReleaseBuffer (void *context, uint8_t *buffer)
+{
+    ARSTREAM_RegressionTb_FilterCounters_t *counters = (ARSTREAM_RegressionTb_FilterCounters_t *)context;
+    counters->nbRelease++;
+    free (buffer);
+}
+
+static void ARSTREAM_RegressionTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom)
+{
+    ARSTREAM_RegressionTb_Context_t *ctx = (ARSTREAM_RegressionTb_Context_t *)custom;
+    (void)framePointer;
+    (void)frameSize;
+    switch (status)
+    {
+    case ARSTREAM_SENDER_STATUS_FRAME_SENT:
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbSent));
+        break;
+    case ARSTREAM_SENDER_STATUS_FRAME_EXPIRED:
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbExpired));
+        break;
+    default:
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbCancelled));
+        break;
+    }
+}
+
+static int ARSTREAM_RegressionTb_AckPacketFullWords (void)
+{
+    ARSTREAM_NetworkHeaders_AckPacket_t packet;
+    int retVal = 0;
+    int i;
+
+    /* A 64 fragments frame is not complete with one fragment */
+    ARSTREAM_NetworkHeaders_AckPacketReset (&packet);
+    ARSTREAM_NetworkHeaders_AckPacketSetFlag (&packet, 0);
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&packet, 64) == 0);
+    for (i = 1; i < 63; i++)
+    {
+        ARSTREAM_NetworkHeaders_AckPacketSetFlag (&packet, i);
+    }
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&packet, 64) == 0);
+    ARSTREAM_NetworkHeaders_AckPacketSetFlag (&packet, 63);
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&packet, 64) == 1);
+
+    /* Same for a 128 fragments frame */
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&packet, 128) == 0);
+    for (i = 64; i < 127; i++)
+    {
+        ARSTREAM_NetworkHeaders_AckPacketSetFlag (&packet, i);
+    }
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&packet, 128) == 0);
+    ARSTREAM_NetworkHeaders_AckPacketSetFlag (&packet, 127);
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&packet, 128) == 1);
+
+    /* Unsetting a flag of the high word clears that flag only */
+    ARSTREAM_NetworkHeaders_AckPacketUnsetFlag (&packet, 100);
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&packet, 100) == 0);
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&packet, 99) == 1);
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&packet, 101) == 1);
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketCountNotSet (&packet, 128) == 1);
+    CHECK (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&packet, 128) == 0);
+
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_SenderFilterChain (void)
+{
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Filter_t filters [NB_FILTERS];
+    ARSTREAM_Sender_t *sender;
+    pthread_t dataThread;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    uint8_t frame [4 * FRAGMENT_SIZE];
+    int retVal = 0;
+    int i;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    memset (frame, 0x42, sizeof (frame));
+    memset (&transport, 0, sizeof (transport));
+    transport.sendFragment = ARSTREAM_RegressionTb_NullSendFragment;
+    transport.submit = ARSTREAM_RegressionTb_NullSubmit;
+    transport.receiveAck = ARSTREAM_RegressionTb_NullReceive;
+    transport.context = &ctx;
+    sender = ARSTREAM_Sender_NewWithTransport (&transport, ARSTREAM_RegressionTb_FrameUpdateCallback, NB_FRAMES, FRAGMENT_SIZE, MAX_NB_FRAGMENTS, &ctx, &err);
+    CHECK (err == ARSTREAM_OK);
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Sender_SetReliabilityMode (sender, ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT, 0);
+        CHECK (err == ARSTREAM_OK);
+    }
+    for (i = 0; (err == ARSTREAM_OK) && (i < NB_FILTERS); i++)
+    {
+        filters[i].getBuffer = ARSTREAM_RegressionTb_FilterGetBuffer;
+        filters[i].getOutputSize = ARSTREAM_RegressionTb_FilterGetOutputSize;
+        filters[i].filterBuffer = ARSTREAM_RegressionTb_FilterBuffer;
+        filters[i].releaseBuffer = ARSTREAM_RegressionTb_FilterReleaseBuffer;
+        filters[i].context = &(ctx.filterCounters[i]);
+        err = ARSTREAM_Sender_AddFilter (sender, &filters[i]);
+        CHECK (err == ARSTREAM_OK);
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        pthread_create (&dataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+        for (i = 0; i < NB_FRAMES; i++)
+        {
+            CHECK (ARSTREAM_Sender_SendNewFrame (sender, frame, sizeof (frame), 0, NULL) == ARSTREAM_OK);
+            CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbSubmitted), i + 1) == 0);
+        }
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (dataThread, NULL);
+    }
+    ARSTREAM_Sender_Delete (&sender);
+
+    /* One callback per frame, and every filter buffer given back */
+    CHECK (ctx.nbSent == NB_FRAMES);
+    CHECK (ctx.nbCancelled == 0);
+    for (i = 0; i < NB_FILTERS; i++)
+    {
+        CHECK (ctx.filterCounters[i].nbNullInput == 0);
+        CHECK (ctx.filterCounters[i].nbGetBuffer == NB_FRAMES);
+        CHECK (ctx.filterCounters[i].nbRelease == NB_FRAMES);
+    }
+
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static uint8_t* ARSTREAM_RegressionTb_FrameCompleteCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom)
+{
+    ARSTREAM_RegressionTb_Context_t *ctx = (ARSTREAM_RegressionTb_Context_t *)custom;
+    (void)framePointer;
+    (void)isFlushFrame;
+    if (cause == ARSTREAM_READER_CAUSE_FRAME_COMPLETE)
+    {
+        pthread_mutex_lock (&(ctx->mutex));
+        ctx->lastCompleteSize = frameSize;
+        ctx->lastSkippedFrames = numberOfSkippedFrames;
+        pthread_mutex_unlock (&(ctx->mutex));
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbComplete));
+    }
+    *newBufferCapacity = READER_FRAME_SIZE;
+    return ctx->readerBuffer;
+}
+
+static int ARSTREAM_RegressionTb_ReaderFirstFrame (void)
+{
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Reader_t *reader;
+    pthread_t dataThread;
+    uint16_t firstFrameNumbers [] = { 0, 1, 1 };
+    int retVal = 0;
+    int i;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    ctx.readerBuffer = malloc (READER_FRAME_SIZE);
+
+    /* Successive readers, usually allocated over the memory of the previous one : the
+     * last frame of a reader is the first frame of the next one */
+    for (i = 0; i < NB_ELEMENTS (firstFrameNumbers); i++)
+    {
+        int nbComplete = ctx.nbComplete;
+        reader = ARSTREAM_RegressionTb_StartReader (&ctx, &transport, ARSTREAM_READER_PACKETIZATION_NATIVE, &dataThread);
+        CHECK (reader != NULL);
+        if (reader == NULL)
+        {
+            break;
+        }
+        ARSTREAM_RegressionTb_PushFragment (&ctx, firstFrameNumbers[i], 0, 2, 1);
+        CHECK (ARSTREAM_RegressionTb_WaitReaderIdle (&ctx) == 0);
+        CHECK (ctx.nbComplete == nbComplete);
+        ARSTREAM_RegressionTb_PushFragment (&ctx, firstFrameNumbers[i], 1, 2, 1);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbComplete), nbComplete + 1) == 0);
+        CHECK (ctx.lastCompleteSize == 2 * FRAGMENT_SIZE);
+        ARSTREAM_RegressionTb_StopReader (&reader, dataThread);
+    }
+
+    free (ctx.readerBuffer);
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_RtpLatePacket (void)
+{
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Reader_t *reader;
+    pthread_t dataThread;
+    int retVal = 0;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    ctx.readerBuffer = malloc (READER_FRAME_SIZE);
+    reader = ARSTREAM_RegressionTb_StartReader (&ctx, &transport, ARSTREAM_READER_PACKETIZATION_RTP_H264, &dataThread);
+    CHECK (reader != NULL);
+    if (reader != NULL)
+    {
+        /* Two packets frame, with a packet of the previous frame arriving in between */
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 100, 3000, 0);
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 99, 0, 1);
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 101, 3000, 1);
+        CHECK (ARSTREAM_RegressionTb_WaitReaderIdle (&ctx) == 0);
+        CHECK (ctx.nbComplete == 1);
+        CHECK (ctx.lastCompleteSize == 2 * (4 + RTP_PAYLOAD_SIZE));
+
+        /* A duplicated packet does not start a new frame either */
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 102, 6000, 0);
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 101, 3000, 1);
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 103, 6000, 1);
+        CHECK (ARSTREAM_RegressionTb_WaitReaderIdle (&ctx) == 0);
+        CHECK (ctx.nbComplete == 2);
+        CHECK (ctx.lastCompleteSize == 2 * (4 + RTP_PAYLOAD_SIZE));
+        ARSTREAM_RegressionTb_StopReader (&reader, dataThread);
+    }
+
+    free (ctx.readerBuffer);
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_RtpMissedFrames (void)
+{
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Reader_t *reader;
+    pthread_t dataThread;
+    int retVal = 0;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    ctx.readerBuffer = malloc (READER_FRAME_SIZE);
+    reader = ARSTREAM_RegressionTb_StartReader (&ctx, &transport, ARSTREAM_READER_PACKETIZATION_RTP_H264, &dataThread);
+    CHECK (reader != NULL);
+    if (reader != NULL)
+    {
+        /* Two consecutive frames give the frame duration */
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 10, 0, 1);
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 11, 3000, 1);
+        CHECK (ARSTREAM_RegressionTb_WaitReaderIdle (&ctx) == 0);
+        CHECK (ctx.nbComplete == 2);
+        CHECK (ctx.lastSkippedFrames == 0);
+
+        /* Single packet frames 12 and 13 are lost */
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 14, 12000, 1);
+        CHECK (ARSTREAM_RegressionTb_WaitReaderIdle (&ctx) == 0);
+        CHECK (ctx.nbComplete == 3);
+        CHECK (ctx.lastSkippedFrames == 2);
+
+        /* A frame which lost a packet is still given, and is not a missed frame */
+        ARSTREAM_RegressionTb_PushRtpPacket (&ctx, 16, 15000, 1);
+        CHECK (ARSTREAM_RegressionTb_WaitReaderIdle (&ctx) == 0);
+        CHECK (ctx.nbComplete == 4);
+        CHECK (ctx.lastSkippedFrames == 0);
+        ARSTREAM_RegressionTb_StopReader (&reader, dataThread);
+    }
+
+    free (ctx.readerBuffer);
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_SenderRetriesWithoutPriority (void)
+{
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_FrameParams_t params;
+    ARSTREAM_Sender_t *sender;
+    pthread_t dataThread;
+    int nbLoops = 10;
+    int retVal = 0;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    sender = ARSTREAM_RegressionTb_NewNullSender (&ctx, &transport, 1);
+    CHECK (sender != NULL);
+    if (sender != NULL)
+    {
+        pthread_create (&dataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+
+        /* No acknowledge ever comes : frames are retried until their limit, or until replaced */
+        ARSTREAM_Sender_FrameParamsDefaultInit (&params);
+        CHECK (ARSTREAM_RegressionTb_CountFrameFragments (&ctx, sender, &params, nbLoops) >= nbLoops - 1);
+        params.flushPreviousFrames = 1;
+        CHECK (ARSTREAM_RegressionTb_CountFrameFragments (&ctx, sender, &params, nbLoops) >= nbLoops - 1);
+        params.flushPreviousFrames = 0;
+        params.priority = ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE;
+        CHECK (ARSTREAM_RegressionTb_CountFrameFragments (&ctx, sender, &params, nbLoops) == 2);
+        params.priority = ARSTREAM_SENDER_FRAME_PRIORITY_DISPOSABLE;
+        CHECK (ARSTREAM_RegressionTb_CountFrameFragments (&ctx, sender, &params, nbLoops) == 1);
+
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (dataThread, NULL);
+        ARSTREAM_Sender_Delete (&sender);
+    }
+
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_SenderDefaultReplace (void)
+{
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_FrameParams_t params;
+    ARSTREAM_Sender_t *sender;
+    pthread_t dataThread;
+    uint8_t frame [FRAGMENT_SIZE];
+    int retVal = 0;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    memset (frame, 0x42, sizeof (frame));
+    /* Retries are slow enough for the next frame to be queued before the first one */
+    sender = ARSTREAM_RegressionTb_NewNullSender (&ctx, &transport, 300);
+    CHECK (sender != NULL);
+    if (sender != NULL)
+    {
+        pthread_create (&dataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+
+        /* Without priorities, the next fragment sent belongs to the new frame */
+        CHECK (ARSTREAM_Sender_SendNewFrame (sender, frame, sizeof (frame), 1, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), 1) == 0);
+        CHECK (ARSTREAM_Sender_SendNewFrame (sender, frame, sizeof (frame), 0, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), 2) == 0);
+        CHECK (ctx.nbCancelled == 1);
+
+        /* A key frame with a priority is retried before a lower priority frame replaces it */
+        ARSTREAM_Sender_FrameParamsDefaultInit (&params);
+        params.flushPreviousFrames = 1;
+        params.priority = ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME;
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbCancelled), 2) == 0);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), 3) == 0);
+        params.flushPreviousFrames = 0;
+        params.priority = ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), 4) == 0);
+        CHECK (ctx.nbCancelled == 2);
+
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (dataThread, NULL);
+        ARSTREAM_Sender_Delete (&sender);
+    }
+
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_AckBufferControlTags (void)
+{
+    ARSTREAM_NetworkHeaders_FeedbackPacket_t feedback;
+    ARSTREAM_NetworkHeaders_ClockFrame_t clock;
+    ARSTREAM_NetworkHeaders_AckPacket_t ack;
+    uint8_t buffer [sizeof (feedback)];
+    int retVal = 0;
+
+    /* Tagged frames must never have the size of an ack frame */
+    CHECK (sizeof (feedback) != sizeof (ack));
+    CHECK (sizeof (clock) != sizeof (ack));
+
+    memset (&clock, 0, sizeof (clock));
+    ARSTREAM_NetworkHeaders_ControlHeaderInit (&(clock.control), ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK);
+    CHECK (ARSTREAM_NetworkHeaders_ControlFrameType ((uint8_t *)&clock, sizeof (clock)) == ARSTREAM_NETWORK_HEADERS_CONTROL_CLOCK);
+
+    memset (&feedback, 0, sizeof (feedback));
+    ARSTREAM_NetworkHeaders_ControlHeaderInit (&(feedback.control), ARSTREAM_NETWORK_HEADERS_CONTROL_FEEDBACK);
+    memcpy (buffer, &feedback, sizeof (feedback));
+    CHECK (ARSTREAM_NetworkHeaders_ControlFrameType (buffer, sizeof (feedback)) == ARSTREAM_NETWORK_HEADERS_CONTROL_FEEDBACK);
+    CHECK (ARSTREAM_NetworkHeaders_ControlFrameType (buffer, sizeof (ARSTREAM_NetworkHeaders_ControlHeader_t) - 1) == ARSTREAM_NETWORK_HEADERS_CONTROL_NONE);
+
+    /* An ack frame is untagged, even if its first bytes look like a header */
+    memset (&ack, 0, sizeof (ack));
+    memcpy (&ack, &feedback, sizeof (feedback.control));
+    CHECK (ARSTREAM_NetworkHeaders_ControlFrameType ((uint8_t *)&ack, sizeof (ack)) == ARSTREAM_NETWORK_HEADERS_CONTROL_NONE);
+
+    /* A frame with a wrong magic is not tagged */
+    buffer [0] ^= 0xFF;
+    CHECK (ARSTREAM_NetworkHeaders_ControlFrameType (buffer, sizeof (feedback)) == ARSTREAM_NETWORK_HEADERS_CONTROL_NONE);
+
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_SenderManyNalUnits (void)
+{
+    /* Non-reference slice, then IDR slice (which replaces the first frame right away) */
+    static const uint8_t sliceHeaders [] = { 0x01, 0x65 };
+    static const eARSTREAM_SENDER_FRAME_PRIORITY slicePriorities [] = { ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE, ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME };
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_t *sender;
+    pthread_t dataThread;
+    uint8_t frames [NB_ELEMENTS (sliceHeaders)][FRAGMENT_SIZE];
+    uint32_t frameSize = 0;
+    int retVal = 0;
+    int i, j;
+
+    /* 40 SEI NAL units, then one slice NAL unit */
+    memset (frames, 0x42, sizeof (frames));
+    for (j = 0; j <= 40; j++)
+    {
+        for (i = 0; i < NB_ELEMENTS (sliceHeaders); i++)
+        {
+            frames [i][frameSize + 0] = 0;
+            frames [i][frameSize + 1] = 0;
+            frames [i][frameSize + 2] = 0;
+            frames [i][frameSize + 3] = 1;
+            frames [i][frameSize + 4] = (j < 40) ? ARSTREAM_H264_NALU_TYPE_SEI : sliceHeaders [i];
+        }
+        frameSize += 8;
+    }
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    sender = ARSTREAM_RegressionTb_NewNullSender (&ctx, &transport, 300);
+    CHECK (sender != NULL);
+    if (sender != NULL)
+    {
+        CHECK (ARSTREAM_Sender_SetAutoClassification (sender, 1) == ARSTREAM_OK);
+        pthread_create (&dataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+
+        for (i = 0; i < NB_ELEMENTS (sliceHeaders); i++)
+        {
+            uint8_t flags;
+            CHECK (ARSTREAM_Sender_SendNewFrame (sender, frames [i], frameSize, 0, NULL) == ARSTREAM_OK);
+            CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), i + 1) == 0);
+            pthread_mutex_lock (&(ctx.mutex));
+            flags = ctx.lastFrameFlags;
+            pthread_mutex_unlock (&(ctx.mutex));
+            CHECK ((int)((flags & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK) >> ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT) == (int)slicePriorities [i]);
+            CHECK (((flags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0) == (i == 1));
+        }
+
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (dataThread, NULL);
+        ARSTREAM_Sender_Delete (&sender);
+    }
+
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_JitterBufferOverflow (void)
+{
+    ARSTREAM_JitterBuffer_t jb;
+    ARSTREAM_JitterBuffer_Frame_t frame;
+    int retVal = 0;
+    int i;
+
+    /* A flush frame, then reference frames with one non-reference frame */
+    ARSTREAM_JitterBuffer_Init (&jb, 10, 100);
+    for (i = 0; i <= ARSTREAM_JITTER_BUFFER_MAX_FRAMES + 1; i++)
+    {
+        memset (&frame, 0, sizeof (frame));
+        frame.capacity = FRAGMENT_SIZE;
+        frame.buffer = ARSTREAM_JitterBuffer_GetBuffer (&jb, &(frame.capacity));
+        frame.size = FRAGMENT_SIZE;
+        frame.isFlushFrame = (i == 0) ? 1 : 0;
+        frame.infos.frameNumber = i;
+        frame.infos.isFlushFrame = frame.isFlushFrame;
+        frame.infos.priority = (i == 0) ? ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME :
+                               (i == 10) ? ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE : ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+        ARSTREAM_JitterBuffer_Push (&jb, &frame, 0);
+    }
+
+    /* The non-reference frame goes first, then the oldest reference frame */
+    CHECK (jb.nbFrames == ARSTREAM_JITTER_BUFFER_MAX_FRAMES);
+    CHECK (jb.nbSkippedFrames == 2);
+    CHECK (jb.frames [jb.head].infos.frameNumber == 0);
+    CHECK (jb.frames [(jb.head + 1) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES].infos.frameNumber == 2);
+    CHECK (jb.frames [(jb.head + 1) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES].numberOfSkippedFrames == 1);
+    CHECK (jb.frames [(jb.head + 9) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES].infos.frameNumber == 11);
+    CHECK (jb.frames [(jb.head + 9) % ARSTREAM_JITTER_BUFFER_MAX_FRAMES].numberOfSkippedFrames == 1);
+
+    ARSTREAM_JitterBuffer_Free (&jb);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_RateControlLoss (void)
+{
+    ARSTREAM_RateControl_t rc;
+    struct timespec now = { 1000, 0 };
+    int retVal = 0;
+
+    ARSTREAM_RateControl_Init (&rc, 1000000, 10000000);
+    ARSTREAM_RateControl_Update (&rc, &now);
+
+    /* Most of the interval data is still in flight */
+    ARSTREAM_RateControl_DataSent (&rc, 100000);
+    ARSTREAM_RateControl_AckReceived (&rc, 10000, &now);
+    ARSTREAM_RateControl_FragmentsAcked (&rc, 10, 0);
+    now.tv_nsec += 100000000;
+    ARSTREAM_RateControl_Update (&rc, &now);
+    CHECK (ARSTREAM_RateControl_GetTargetBitrate (&rc) == 10000000);
+
+    /* 20% of the fragments are reported missing */
+    ARSTREAM_RateControl_DataSent (&rc, 10000);
+    ARSTREAM_RateControl_AckReceived (&rc, 8000, &now);
+    ARSTREAM_RateControl_FragmentsAcked (&rc, 8, 2);
+    now.tv_nsec += 100000000;
+    ARSTREAM_RateControl_Update (&rc, &now);
+    CHECK (ARSTREAM_RateControl_GetTargetBitrate (&rc) < 10000000);
+
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_UdpUringReinit (void)
+{
+    int retVal = 0;
+    int i;
+
+    /* Each loop runs the multishot receive, then destroys the transports while it is still pending */
+    for (i = 0; (i < 4) && (retVal == 0); i++)
+    {
+        CHECK (ARSTREAM_RegressionTb_UdpRoundTrip (ARSTREAM_TRANSPORT_UDP_IO_ENGINE_IO_URING, i / 2) == 0);
+    }
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_TransportLoopback (void)
+{
+    ARSTREAM_Transport_LoopbackParams_t params;
+    ARSTREAM_Transport_LoopbackStats_t stats;
+    ARSTREAM_Transport_t sender;
+    ARSTREAM_Transport_t reader;
+    eARSTREAM_ERROR err;
+    int retVal = 0;
+
+    ARSTREAM_Transport_LoopbackParamsDefaultInit (&params);
+    params.maxFragmentSize = FRAGMENT_SIZE;
+    err = ARSTREAM_Transport_InitLoopback (&sender, &reader, &params);
+    CHECK (err == ARSTREAM_OK);
+    if (err == ARSTREAM_OK)
+    {
+        CHECK (ARSTREAM_RegressionTb_TransportRoundTrip (&sender, &reader) == 0);
+        CHECK (ARSTREAM_Transport_GetLoopbackStats (&sender, ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_DATA, &stats) == ARSTREAM_OK);
+        CHECK (stats.nbPackets == TRANSPORT_NB_PACKETS);
+        CHECK (stats.nbOverflowDropped == 0);
+        CHECK (ARSTREAM_Transport_GetLoopbackStats (&reader, ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_ACK, &stats) == ARSTREAM_OK);
+        CHECK (stats.nbPackets == 1);
+        ARSTREAM_Transport_Destroy (&sender);
+        ARSTREAM_Transport_Destroy (&reader);
+    }
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_TransportShm (void)
+{
+    ARSTREAM_Transport_ShmParams_t params;
+    ARSTREAM_Transport_t sender;
+    ARSTREAM_Transport_t reader;
+    eARSTREAM_ERROR senderErr, readerErr = ARSTREAM_ERROR_TRANSPORT;
+    int fd = -1;
+    int retVal = 0;
+
+    ARSTREAM_Transport_ShmParamsDefaultInit (&params);
+    params.maxFragmentSize = FRAGMENT_SIZE;
+    senderErr = ARSTREAM_Transport_InitShmCreate (&sender, &params, ARSTREAM_TRANSPORT_SHM_SIDE_SENDER, &fd);
+    CHECK (senderErr == ARSTREAM_OK);
+    if (senderErr == ARSTREAM_OK)
+    {
+        /* The transports keep their own mapping : the descriptor can be closed right away */
+        readerErr = ARSTREAM_Transport_InitShmAttach (&reader, fd, ARSTREAM_TRANSPORT_SHM_SIDE_READER);
+        CHECK (readerErr == ARSTREAM_OK);
+        close (fd);
+    }
+    if (retVal == 0)
+    {
+        CHECK (ARSTREAM_RegressionTb_TransportRoundTrip (&sender, &reader) == 0);
+    }
+    if (senderErr == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_Destroy (&sender);
+    }
+    if (readerErr == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_Destroy (&reader);
+    }
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_TransportUdp (void)
+{
+    return ARSTREAM_RegressionTb_UdpRoundTrip (ARSTREAM_TRANSPORT_UDP_IO_ENGINE_SYSCALLS, 0);
+}
+
+static int ARSTREAM_RegressionTb_TransportUdpOffload (void)
+{
+    return ARSTREAM_RegressionTb_UdpRoundTrip (ARSTREAM_TRANSPORT_UDP_IO_ENGINE_SYSCALLS, 1);
+}
+
+static int ARSTREAM_RegressionTb_TransportUdpIoUring (void)
+{
+    return ARSTREAM_RegressionTb_UdpRoundTrip (ARSTREAM_TRANSPORT_UDP_IO_ENGINE_IO_URING, 1);
+}
+
+static int ARSTREAM_RegressionTb_TransportImpairment (void)
+{
+    ARSTREAM_Transport_LoopbackParams_t loopbackParams;
+    ARSTREAM_Transport_ImpairmentParams_t params;
+    ARSTREAM_Transport_ImpairmentStats_t stats;
+    ARSTREAM_Transport_t sender;
+    ARSTREAM_Transport_t reader;
+    pthread_t impairmentThread;
+    uint8_t packet [FRAGMENT_SIZE];
+    struct timespec start, end;
+    eARSTREAM_ERROR err;
+    int size = 0;
+    int retVal = 0;
+    int i;
+
+    /* Delayed fragments, sent by the impairment thread */
+    ARSTREAM_Transport_LoopbackParamsDefaultInit (&loopbackParams);
+    loopbackParams.maxFragmentSize = FRAGMENT_SIZE;
+    err = ARSTREAM_Transport_InitLoopback (&sender, &reader, &loopbackParams);
+    CHECK (err == ARSTREAM_OK);
+    if (err == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_ImpairmentParamsDefaultInit (&params);
+        params.delayMs = IMPAIRMENT_DELAY_MS;
+        err = ARSTREAM_Transport_InitImpairment (&sender, &sender, &params);
+        CHECK (err == ARSTREAM_OK);
+        if (err != ARSTREAM_OK)
+        {
+            ARSTREAM_Transport_Destroy (&sender);
+        }
+    }
+    if (err == ARSTREAM_OK)
+    {
+        pthread_create (&impairmentThread, NULL, ARSTREAM_Transport_RunImpairmentThread, &sender);
+        clock_gettime (CLOCK_MONOTONIC, &start);
+        CHECK (ARSTREAM_RegressionTb_TransportRoundTrip (&sender, &reader) == 0);
+        clock_gettime (CLOCK_MONOTONIC, &end);
+        CHECK ((end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000 >= IMPAIRMENT_DELAY_MS);
+        ARSTREAM_Transport_StopImpairment (&sender);
+        pthread_join (impairmentThread, NULL);
+        CHECK (ARSTREAM_Transport_GetImpairmentStats (&sender, &stats) == ARSTREAM_OK);
+        CHECK (stats.nbPackets == TRANSPORT_NB_PACKETS);
+        CHECK (stats.nbLost == 0);
+        ARSTREAM_Transport_Destroy (&sender);
+        ARSTREAM_Transport_Destroy (&reader);
+    }
+
+    /* Lost fragments, without impairment thread */
+    err = ARSTREAM_Transport_InitLoopback (&sender, &reader, &loopbackParams);
+    CHECK (err == ARSTREAM_OK);
+    if (err == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_ImpairmentParamsDefaultInit (&params);
+        params.lossModel = ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_BERNOULLI;
+        params.lossRate = 1.0;
+        err = ARSTREAM_Transport_InitImpairment (&sender, &sender, &params);
+        CHECK (err == ARSTREAM_OK);
+        if (err != ARSTREAM_OK)
+        {
+            ARSTREAM_Transport_Destroy (&sender);
+        }
+    }
+    if (err == ARSTREAM_OK)
+    {
+        memset (packet, 0x42, sizeof (packet));
+        for (i = 0; i < TRANSPORT_NB_PACKETS; i++)
+        {
+            CHECK (sender.sendFragment (sender.context, packet, sizeof (packet), NULL, NULL) == ARSTREAM_OK);
+        }
+        sender.submit (sender.context);
+        CHECK (reader.receiveFragment (reader.context, packet, sizeof (packet), &size, 100) == ARSTREAM_ERROR_TIMEOUT);
+        CHECK (ARSTREAM_Transport_GetImpairmentStats (&sender, &stats) == ARSTREAM_OK);
+        CHECK (stats.nbPackets == TRANSPORT_NB_PACKETS);
+        CHECK (stats.nbLost == TRANSPORT_NB_PACKETS);
+        ARSTREAM_Transport_Destroy (&sender);
+        ARSTREAM_Transport_Destroy (&reader);
+    }
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_SenderFrameExpiry (void)
+{
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_FrameParams_t params;
+    ARSTREAM_Sender_t *sender;
+    pthread_t dataThread;
+    uint8_t frame [FRAGMENT_SIZE];
+    int retVal = 0;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    memset (frame, 0x42, sizeof (frame));
+    sender = ARSTREAM_RegressionTb_NewNullSender (&ctx, &transport, 5);
+    CHECK (sender != NULL);
+    if (sender != NULL)
+    {
+        /* Nothing is ever acknowledged : the queued frames wait behind the current one */
+        CHECK (ARSTREAM_Sender_SetReliabilityMode (sender, ARSTREAM_SENDER_RELIABILITY_FULLY_RELIABLE, ARSTREAM_SENDER_DEFAULT_MAX_RETRIES) == ARSTREAM_OK);
+        CHECK (ARSTREAM_Sender_SetMaximumFrameAge (sender, FRAME_AGE_MS) == ARSTREAM_OK);
+        pthread_create (&dataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+
+        /* A frame without age limit is retried forever */
+        ARSTREAM_Sender_FrameParamsDefaultInit (&params);
+        params.maxFrameAgeMs = ARSTREAM_SENDER_INFINITE_FRAME_AGE;
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), 1) == 0);
+
+        /* A frame of the stream age expires in the queue */
+        params.maxFrameAgeMs = ARSTREAM_SENDER_STREAM_FRAME_AGE;
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbExpired), 1) == 0);
+        usleep (2 * FRAME_AGE_MS * 1000);
+        CHECK (ctx.nbExpired == 1);
+        CHECK (ctx.nbCancelled == 0);
+        CHECK (ctx.nbSent == 0);
+
+        /* A flush frame replaces the first one, then expires while being sent */
+        params.flushPreviousFrames = 1;
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbCancelled), 1) == 0);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbExpired), 2) == 0);
+        CHECK (ctx.nbSent == 0);
+
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (dataThread, NULL);
+        ARSTREAM_Sender_Delete (&sender);
+    }
+
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_SenderQueuePolicies (void)
+{
+    static const eARSTREAM_SENDER_FRAME_PRIORITY decimatedPriorities [] = {
+        ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE, ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE,
+        ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE, ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE,
+    };
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_FrameParams_t params;
+    ARSTREAM_Sender_t *sender;
+    uint8_t frame [FRAGMENT_SIZE];
+    int nbCancelled;
+    int retVal = 0;
+    int i;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    memset (frame, 0x42, sizeof (frame));
+    /* Without data thread, the queued frames stay in the queue, and its callbacks are called right away */
+    sender = ARSTREAM_RegressionTb_NewNullSender (&ctx, &transport, 5);
+    CHECK (sender != NULL);
+    if (sender != NULL)
+    {
+        /* The default policy rejects the new frame */
+        ARSTREAM_Sender_FrameParamsDefaultInit (&params);
+        for (i = 0; i < NB_FRAMES; i++)
+        {
+            CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        }
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_ERROR_QUEUE_FULL);
+        CHECK (ctx.nbCancelled == 0);
+
+        /* The oldest frame makes room for the new one */
+        CHECK (ARSTREAM_Sender_SetQueuePolicy (sender, ARSTREAM_SENDER_QUEUE_POLICY_DROP_OLDEST, 0) == ARSTREAM_OK);
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        CHECK (ctx.nbCancelled == 1);
+
+        /* Only a key frame gets in, and it cancels all the frames of lower priority */
+        CHECK (ARSTREAM_Sender_SetQueuePolicy (sender, ARSTREAM_SENDER_QUEUE_POLICY_REPLACE_WITH_KEYFRAME, 0) == ARSTREAM_OK);
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_ERROR_QUEUE_FULL);
+        CHECK (ctx.nbCancelled == 1);
+        params.priority = ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME;
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        CHECK (ctx.nbCancelled == 1 + NB_FRAMES);
+        CHECK (ARSTREAM_Sender_FlushFramesQueue (sender) == ARSTREAM_OK);
+        CHECK (ctx.nbCancelled == 2 + NB_FRAMES);
+
+        /* Above the watermark, the oldest non-reference frames go first */
+        CHECK (ARSTREAM_Sender_SetQueuePolicy (sender, ARSTREAM_SENDER_QUEUE_POLICY_DROP_NEWEST, NB_ELEMENTS (decimatedPriorities)) == ARSTREAM_OK);
+        nbCancelled = ctx.nbCancelled;
+        for (i = 0; i < NB_ELEMENTS (decimatedPriorities); i++)
+        {
+            params.priority = decimatedPriorities [i];
+            CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+        }
+        CHECK (ctx.nbCancelled == nbCancelled);
+        /* Each of the first two reference frames drops a non-reference frame, the third one has nothing to drop */
+        params.priority = ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE;
+        for (i = 1; i <= 3; i++)
+        {
+            CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_OK);
+            CHECK (ctx.nbCancelled == nbCancelled + ((i < 2) ? i : 2));
+        }
+
+        /* With only reference frames left, the non-reference frames are rejected */
+        params.priority = ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE;
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_ERROR_QUEUE_FULL);
+        params.priority = ARSTREAM_SENDER_FRAME_PRIORITY_DISPOSABLE;
+        CHECK (ARSTREAM_Sender_SendNewFrameWithParams (sender, frame, sizeof (frame), &params, NULL) == ARSTREAM_ERROR_QUEUE_FULL);
+        CHECK (ctx.nbCancelled == nbCancelled + 2);
+
+        ARSTREAM_Sender_Delete (&sender);
+    }
+
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_BestEffortStream (void)
+{
+    static uint8_t frames [STREAM_NB_FRAMES][STREAM_FRAME_NB_FRAGMENTS * FRAGMENT_SIZE];
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_LoopbackParams_t params;
+    ARSTREAM_Transport_LoopbackStats_t stats;
+    ARSTREAM_Transport_t senderTransport;
+    ARSTREAM_Transport_t readerTransport;
+    ARSTREAM_Sender_t *sender = NULL;
+    ARSTREAM_Reader_t *reader = NULL;
+    pthread_t senderThread, readerThread;
+    eARSTREAM_ERROR transportErr, err;
+    int retVal = 0;
+    int i;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    ctx.readerBuffer = malloc (READER_FRAME_SIZE);
+    memset (frames, 0x42, sizeof (frames));
+    ARSTREAM_Transport_LoopbackParamsDefaultInit (&params);
+    params.maxFragmentSize = FRAGMENT_SIZE;
+    transportErr = ARSTREAM_Transport_InitLoopback (&senderTransport, &readerTransport, &params);
+    CHECK (transportErr == ARSTREAM_OK);
+    err = transportErr;
+    if (err == ARSTREAM_OK)
+    {
+        sender = ARSTREAM_Sender_NewWithTransport (&senderTransport, ARSTREAM_RegressionTb_FrameUpdateCallback, NB_FRAMES, FRAGMENT_SIZE, MAX_NB_FRAGMENTS, &ctx, &err);
+        CHECK (err == ARSTREAM_OK);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Sender_SetReliabilityMode (sender, ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT, 0);
+        CHECK (err == ARSTREAM_OK);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        reader = ARSTREAM_Reader_NewWithTransport (&readerTransport, ARSTREAM_RegressionTb_FrameCompleteCallback, ctx.readerBuffer, READER_FRAME_SIZE, FRAGMENT_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK, &ctx, &err);
+        CHECK (err == ARSTREAM_OK);
+    }
+
+    /* Only the two data threads run */
+    if (err == ARSTREAM_OK)
+    {
+        pthread_create (&readerThread, NULL, ARSTREAM_Reader_RunDataThread, reader);
+        pthread_create (&senderThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+        for (i = 0; i < STREAM_NB_FRAMES; i++)
+        {
+            CHECK (ARSTREAM_Sender_SendNewFrame (sender, frames [i], sizeof (frames [i]), (i == 0) ? 1 : 0, NULL) == ARSTREAM_OK);
+        }
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbSent), STREAM_NB_FRAMES) == 0);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbComplete), STREAM_NB_FRAMES) == 0);
+        CHECK (ctx.lastCompleteSize == sizeof (frames [0]));
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (senderThread, NULL);
+        ARSTREAM_Reader_StopReader (reader);
+        pthread_join (readerThread, NULL);
+
+        /* Every frame sent once, without any retry, and reported sent without ACK */
+        CHECK (ctx.nbCancelled == 0);
+        CHECK (ctx.nbExpired == 0);
+        CHECK (ARSTREAM_Transport_GetLoopbackStats (&senderTransport, ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_DATA, &stats) == ARSTREAM_OK);
+        CHECK (stats.nbPackets == STREAM_NB_FRAMES * STREAM_FRAME_NB_FRAGMENTS);
+        CHECK (ARSTREAM_Transport_GetLoopbackStats (&readerTransport, ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_ACK, &stats) == ARSTREAM_OK);
+        CHECK (stats.nbPackets == 0);
+    }
+
+    ARSTREAM_Reader_Delete (&reader);
+    ARSTREAM_Sender_Delete (&sender);
+    if (transportErr == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_Destroy (&senderTransport);
+        ARSTREAM_Transport_Destroy (&readerTransport);
+    }
+    free (ctx.readerBuffer);
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_DropSecondFragment (void *customData, eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION direction, const uint8_t *data, int size)
+{
+    ARSTREAM_RegressionTb_Context_t *ctx = (ARSTREAM_RegressionTb_Context_t *)customData;
+    int retVal = 1;
+    if (direction == ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_ACK)
+    {
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbHookAcks));
+    }
+    else
+    {
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbHookFragments));
+        if ((size >= (int)sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)) &&
+            (((const ARSTREAM_NetworkHeaders_DataHeader_t *)data)->fragmentNumber == 1))
+        {
+            retVal = 0;
+        }
+    }
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_ReaderAbandonFrame (void)
+{
+    static uint8_t frame [2 * FRAGMENT_SIZE];
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_LoopbackParams_t params;
+    ARSTREAM_Transport_t senderTransport;
+    ARSTREAM_Transport_t readerTransport;
+    ARSTREAM_Sender_t *sender = NULL;
+    ARSTREAM_Reader_t *reader = NULL;
+    pthread_t senderDataThread, senderAckThread, readerThread;
+    eARSTREAM_ERROR transportErr, err;
+    int nbFragments;
+    int retVal = 0;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    ctx.readerBuffer = malloc (READER_FRAME_SIZE);
+    memset (frame, 0x42, sizeof (frame));
+    ARSTREAM_Transport_LoopbackParamsDefaultInit (&params);
+    params.maxFragmentSize = FRAGMENT_SIZE;
+    params.hook = ARSTREAM_RegressionTb_DropSecondFragment;
+    params.hookCustomData = &ctx;
+    transportErr = ARSTREAM_Transport_InitLoopback (&senderTransport, &readerTransport, &params);
+    CHECK (transportErr == ARSTREAM_OK);
+    err = transportErr;
+    if (err == ARSTREAM_OK)
+    {
+        sender = ARSTREAM_Sender_NewWithTransport (&senderTransport, ARSTREAM_RegressionTb_FrameUpdateCallback, NB_FRAMES, FRAGMENT_SIZE, MAX_NB_FRAGMENTS, &ctx, &err);
+        CHECK (err == ARSTREAM_OK);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Sender_SetTimeBetweenRetries (sender, RETRY_TIME_MS, RETRY_TIME_MS);
+        CHECK (err == ARSTREAM_OK);
+    }
+    /* The reader sends no ACK : without the abandon, the frame would be retried until replaced */
+    if (err == ARSTREAM_OK)
+    {
+        reader = ARSTREAM_Reader_NewWithTransport (&readerTransport, ARSTREAM_RegressionTb_FrameCompleteCallback, ctx.readerBuffer, READER_FRAME_SIZE, FRAGMENT_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK, &ctx, &err);
+        CHECK (err == ARSTREAM_OK);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Reader_SetMaximumFrameLatency (reader, FRAME_AGE_MS);
+        CHECK (err == ARSTREAM_OK);
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        pthread_create (&readerThread, NULL, ARSTREAM_Reader_RunDataThread, reader);
+        pthread_create (&senderDataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+        pthread_create (&senderAckThread, NULL, ARSTREAM_Sender_RunAckThread, sender);
+        CHECK (ARSTREAM_Sender_SendNewFrame (sender, frame, sizeof (frame), 1, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbCancelled), 1) == 0);
+        CHECK (ctx.nbSent == 0);
+        CHECK (ctx.nbComplete == 0);
+        CHECK (ctx.nbHookAcks == 1);
+
+        /* No more retry of the cancelled frame, once the round in progress is done */
+        usleep (RETRY_TIME_MS * 2000);
+        pthread_mutex_lock (&(ctx.mutex));
+        nbFragments = ctx.nbHookFragments;
+        pthread_mutex_unlock (&(ctx.mutex));
+        usleep (FRAME_AGE_MS * 1000);
+        CHECK (ctx.nbHookFragments == nbFragments);
+        CHECK (ctx.nbCancelled == 1);
+
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (senderDataThread, NULL);
+        pthread_join (senderAckThread, NULL);
+        ARSTREAM_Reader_StopReader (reader);
+        pthread_join (readerThread, NULL);
+    }
+
+    ARSTREAM_Reader_Delete (&reader);
+    ARSTREAM_Sender_Delete (&sender);
+    if (transportErr == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_Destroy (&senderTransport);
+        ARSTREAM_Transport_Destroy (&readerTransport);
+    }
+    free (ctx.readerBuffer);
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_CountAlignedFragments (void *customData, eARSTREAM_TRANSPORT_LOOPBACK_DIRECTION direction, const uint8_t *data, int size)
+{
+    static const uint8_t startCode [] = { 0, 0, 0, 1 };
+    ARSTREAM_RegressionTb_Context_t *ctx = (ARSTREAM_RegressionTb_Context_t *)customData;
+    const ARSTREAM_NetworkHeaders_DataHeader_t *header = (const ARSTREAM_NetworkHeaders_DataHeader_t *)data;
+    int payloadOffset = sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_FragmentOffset_t);
+    if (direction == ARSTREAM_TRANSPORT_LOOPBACK_DIRECTION_ACK)
+    {
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbHookAcks));
+    }
+    else if ((header->frameFlags & (ARSTREAM_NETWORK_HEADERS_FLAG_CLOCK_FRAME | ARSTREAM_NETWORK_HEADERS_FLAG_FRAME_TIMESTAMP)) != 0)
+    {
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbHookControls));
+    }
+    else
+    {
+        ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbHookFragments));
+        if (((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FRAGMENT_OFFSET) != 0) &&
+            (size >= payloadOffset + (int)sizeof (startCode)) &&
+            (memcmp (&data[payloadOffset], startCode, sizeof (startCode)) == 0))
+        {
+            ARSTREAM_RegressionTb_IncCounter (ctx, &(ctx->nbAlignedFragments));
+        }
+    }
+    return 1;
+}
+
+static int ARSTREAM_RegressionTb_NalAlignedFragments (void)
+{
+    static uint8_t frame [ALIGNED_NB_NAL_UNITS * ALIGNED_NAL_UNIT_SIZE];
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_LoopbackParams_t params;
+    ARSTREAM_Transport_t senderTransport;
+    ARSTREAM_Transport_t readerTransport;
+    ARSTREAM_Sender_t *sender = NULL;
+    ARSTREAM_Reader_t *reader = NULL;
+    pthread_t senderDataThread, senderAckThread, readerDataThread, readerAckThread;
+    eARSTREAM_ERROR transportErr, err;
+    int retVal = 0;
+    int i;
+
+    /* Slices shorter than a fragment : a fixed size cut would split all but the first one */
+    memset (frame, 0x42, sizeof (frame));
+    for (i = 0; i < ALIGNED_NB_NAL_UNITS; i++)
+    {
+        uint8_t *nalUnit = &frame [i * ALIGNED_NAL_UNIT_SIZE];
+        nalUnit [0] = 0;
+        nalUnit [1] = 0;
+        nalUnit [2] = 0;
+        nalUnit [3] = 1;
+        nalUnit [4] = RTP_NALU_REFERENCE_SLICE;
+    }
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    ctx.readerBuffer = malloc (READER_FRAME_SIZE);
+    ARSTREAM_Transport_LoopbackParamsDefaultInit (&params);
+    params.maxFragmentSize = FRAGMENT_SIZE;
+    params.hook = ARSTREAM_RegressionTb_CountAlignedFragments;
+    params.hookCustomData = &ctx;
+    transportErr = ARSTREAM_Transport_InitLoopback (&senderTransport, &readerTransport, &params);
+    CHECK (transportErr == ARSTREAM_OK);
+    err = transportErr;
+    if (err == ARSTREAM_OK)
+    {
+        sender = ARSTREAM_Sender_NewWithTransport (&senderTransport, ARSTREAM_RegressionTb_FrameUpdateCallback, NB_FRAMES, FRAGMENT_SIZE, MAX_NB_FRAGMENTS, &ctx, &err);
+        CHECK (err == ARSTREAM_OK);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Sender_SetFragmentationMode (sender, ARSTREAM_SENDER_FRAGMENTATION_NAL_ALIGNED);
+        CHECK (err == ARSTREAM_OK);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        reader = ARSTREAM_Reader_NewWithTransport (&readerTransport, ARSTREAM_RegressionTb_FrameCompleteCallback, ctx.readerBuffer, READER_FRAME_SIZE, FRAGMENT_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT, &ctx, &err);
+        CHECK (err == ARSTREAM_OK);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Reader_SetClockSyncInterval (reader, CLOCK_SYNC_INTERVAL_MS);
+        CHECK (err == ARSTREAM_OK);
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        pthread_create (&readerDataThread, NULL, ARSTREAM_Reader_RunDataThread, reader);
+        pthread_create (&readerAckThread, NULL, ARSTREAM_Reader_RunAckThread, reader);
+        pthread_create (&senderDataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+        pthread_create (&senderAckThread, NULL, ARSTREAM_Sender_RunAckThread, sender);
+
+        /* The first clock answer tells that the sender knows the reader */
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbHookControls), 1) == 0);
+        CHECK (ARSTREAM_Sender_SendNewFrame (sender, frame, sizeof (frame), 1, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbComplete), 1) == 0);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbSent), 1) == 0);
+
+        /* One fragment per slice (maybe retried), each starting on its start code, reassembled in place */
+        CHECK (ctx.nbHookFragments >= ALIGNED_NB_NAL_UNITS);
+        CHECK (ctx.nbAlignedFragments == ctx.nbHookFragments);
+        CHECK (ctx.lastCompleteSize == sizeof (frame));
+        CHECK (memcmp (ctx.readerBuffer, frame, sizeof (frame)) == 0);
+
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (senderDataThread, NULL);
+        pthread_join (senderAckThread, NULL);
+        ARSTREAM_Reader_StopReader (reader);
+        pthread_join (readerDataThread, NULL);
+        pthread_join (readerAckThread, NULL);
+    }
+
+    ARSTREAM_Reader_Delete (&reader);
+    ARSTREAM_Sender_Delete (&sender);
+    if (transportErr == ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_Destroy (&senderTransport);
+        ARSTREAM_Transport_Destroy (&readerTransport);
+    }
+    free (ctx.readerBuffer);
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_SenderAutoClassification (void)
+{
+    /* By increasing priority, so that each frame replaces the previous one right away */
+    static uint8_t frames [][16] = {
+        { 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42 }, // Not Annex-B
+        { 0, 0, 0, 1, 0x06, 0x42, 0x42, 0x42, 0, 0, 0, 1, 0x09, 0x42, 0x42, 0x42 }, // SEI and AUD
+        { 0, 0, 0, 1, 0x06, 0x42, 0x42, 0x42, 0, 0, 0, 1, 0x01, 0x42, 0x42, 0x42 }, // SEI and non-reference slice
+        { 0, 0, 0, 1, 0x67, 0x42, 0x42, 0x42, 0, 0, 0, 1, 0x41, 0x42, 0x42, 0x42 }, // SPS and reference slice
+        { 0, 0, 0, 1, 0x68, 0x42, 0x42, 0x42, 0, 0, 0, 1, 0x65, 0x42, 0x42, 0x42 }, // PPS and IDR slice
+    };
+    static const eARSTREAM_SENDER_FRAME_PRIORITY framePriorities [] = {
+        ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE, ARSTREAM_SENDER_FRAME_PRIORITY_DISPOSABLE, ARSTREAM_SENDER_FRAME_PRIORITY_NON_REFERENCE,
+        ARSTREAM_SENDER_FRAME_PRIORITY_REFERENCE, ARSTREAM_SENDER_FRAME_PRIORITY_KEYFRAME,
+    };
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_t *sender;
+    pthread_t dataThread;
+    int retVal = 0;
+    int i;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    sender = ARSTREAM_RegressionTb_NewNullSender (&ctx, &transport, 300);
+    CHECK (sender != NULL);
+    if (sender != NULL)
+    {
+        CHECK (ARSTREAM_Sender_SetAutoClassification (sender, 1) == ARSTREAM_OK);
+        pthread_create (&dataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+
+        for (i = 0; i < NB_ELEMENTS (frames); i++)
+        {
+            uint8_t flags;
+            CHECK (ARSTREAM_Sender_SendNewFrame (sender, frames [i], sizeof (frames [i]), 0, NULL) == ARSTREAM_OK);
+            CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), i + 1) == 0);
+            pthread_mutex_lock (&(ctx.mutex));
+            flags = ctx.lastFrameFlags;
+            pthread_mutex_unlock (&(ctx.mutex));
+            CHECK ((int)((flags & ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_MASK) >> ARSTREAM_NETWORK_HEADERS_FLAG_PRIORITY_SHIFT) == (int)framePriorities [i]);
+            CHECK (((flags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0) == (i == NB_ELEMENTS (frames) - 1));
+        }
+
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (dataThread, NULL);
+        ARSTREAM_Sender_Delete (&sender);
+    }
+
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_SenderKeyframeCache (void)
+{
+    static uint8_t firstKeyframe [] = { 0, 0, 0, 1, 0x67, 0x42, 0x42, 0x42, 0, 0, 0, 1, 0x65, 0x42, 0x42, 0x42 };
+    static uint8_t referenceFrame [] = { 0, 0, 0, 1, 0x41, 0x42, 0x42, 0x42 };
+    static uint8_t secondKeyframe [] = { 0, 0, 0, 1, 0x67, 0x42, 0x42, 0x42, 0, 0, 0, 1, 0x65, 0x42, 0x42, 0x42 };
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Sender_t *sender;
+    pthread_t dataThread;
+    uint8_t flags;
+    int retVal = 0;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    sender = ARSTREAM_RegressionTb_NewNullSender (&ctx, &transport, 300);
+    CHECK (sender != NULL);
+    if (sender != NULL)
+    {
+        /* Each frame is sent once, then given back right away unless the cache holds it */
+        CHECK (ARSTREAM_Sender_SetReliabilityMode (sender, ARSTREAM_SENDER_RELIABILITY_BEST_EFFORT, 0) == ARSTREAM_OK);
+        CHECK (ARSTREAM_Sender_SetKeyframeCache (sender, 1) == ARSTREAM_OK);
+        pthread_create (&dataThread, NULL, ARSTREAM_Sender_RunDataThread, sender);
+
+        CHECK (ARSTREAM_Sender_SendNewFrame (sender, firstKeyframe, sizeof (firstKeyframe), 0, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), 1) == 0);
+        CHECK (ARSTREAM_Sender_SendNewFrame (sender, referenceFrame, sizeof (referenceFrame), 0, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbSent), 1) == 0);
+        CHECK (ctx.nbFragments == 2);
+
+        /* The resend is a flush frame, and does not call the application back */
+        CHECK (ARSTREAM_Sender_ResendKeyframeCache (sender) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), 3) == 0);
+        pthread_mutex_lock (&(ctx.mutex));
+        flags = ctx.lastFrameFlags;
+        pthread_mutex_unlock (&(ctx.mutex));
+        CHECK ((flags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0);
+        usleep (FRAME_AGE_MS * 1000);
+        CHECK (ctx.nbSent == 1);
+
+        /* A new keyframe takes its place in the cache, which gives the first one back */
+        CHECK (ARSTREAM_Sender_SendNewFrame (sender, secondKeyframe, sizeof (secondKeyframe), 0, NULL) == ARSTREAM_OK);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbSent), 2) == 0);
+        CHECK (ARSTREAM_RegressionTb_WaitCounter (&ctx, &(ctx.nbFragments), 4) == 0);
+
+        ARSTREAM_Sender_StopSender (sender);
+        pthread_join (dataThread, NULL);
+        ARSTREAM_Sender_Delete (&sender);
+    }
+
+    /* The last cached frame is given back on delete */
+    CHECK (ctx.nbSent == 3);
+    CHECK (ctx.nbCancelled == 0);
+
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+static int ARSTREAM_RegressionTb_ReaderWaitKeyframe (void)
+{
+    ARSTREAM_RegressionTb_Context_t ctx;
+    ARSTREAM_Transport_t transport;
+    ARSTREAM_Reader_StartupInfos_t infos;
+    ARSTREAM_Reader_t *reader;
+    pthread_t dataThread;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    int retVal = 0;
+
+    ARSTREAM_RegressionTb_ContextInit (&ctx);
+    ctx.readerBuffer = malloc (READER_FRAME_SIZE);
+    memset (&transport, 0, sizeof (transport));
+    transport.receiveFragment = ARSTREAM_RegressionTb_QueueReceiveFragment;
+    transport.sendAck = ARSTREAM_RegressionTb_QueueSendAck;
+    transport.context = &ctx;
+    reader = ARSTREAM_Reader_NewWithTransport (&transport, ARSTREAM_RegressionTb_FrameCompleteCallback, ctx.readerBuffer, READER_FRAME_SIZE, FRAGMENT_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_NO_ACK, &ctx, &err);
+    CHECK (err == ARSTREAM_OK);
+    if (err == ARSTREAM_OK)
+    {
+        err = ARSTREAM_Reader_SetStartupMode (reader, ARSTREAM_READER_STARTUP_WAIT_KEYFRAME);
+        CHECK (err == ARSTREAM_OK);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        CHECK (ARSTREAM_Reader_GetStartupInfos (reader, &infos) == ARSTREAM_OK);
+        CHECK (infos.timeToFirstPacketMs == -1);
+        CHECK (infos.timeToFirstFrameMs == -1);
+        pthread_create (&dataThread, NULL, ARSTREAM_Reader_RunDataThread, reader);
+
+        /* Joining in the middle of the stream : complete frames, but nothing to decode them from */
+        ARSTREAM_RegressionTb_PushFragment (&ctx, 1, 0, 1, 0);
+        ARSTREAM_RegressionTb_PushFragment (&ctx, 2, 0, 1, 0);
+        CHECK (ARSTREAM_RegressionTb_WaitReaderIdle (&ctx) == 0);
+        CHECK (ctx.nbComplete == 0);
+        CHECK (ARSTREAM_Reader_GetStartupInfos (reader, &infos) == ARSTREAM_OK);
+        CHECK (infos.timeToFirstPacketMs >= 0);
+        CHECK (infos.timeToFirstFrameMs >= infos.timeToFirstPacketMs);
+        CHECK (infos.timeToFirstDecodableFrameMs == -1);
+        CHECK (infos.nbDiscardedFrames == 2);
+
+        /* Frames are given from the first flush frame on */
+        ARSTREAM_RegressionTb_PushFragment (&ctx, 3, 0, 1, 1);
+        ARSTREAM_RegressionTb_PushFragment (&ctx, 4, 0, 1, 0);
+        CHECK (ARSTREAM_RegressionTb_WaitReaderIdle (&ctx) == 0);
+        CHECK (ctx.nbComplete == 2);
+        CHECK (ARSTREAM_Reader_GetStartupInfos (reader, &infos) == ARSTREAM_OK);
+        CHECK (infos.timeToFirstDecodableFrameMs >= infos.timeToFirstFrameMs);
+        CHECK (infos.nbDiscardedFrames == 2);
+
+        ARSTREAM_Reader_StopReader (reader);
+        pthread_join (dataThread, NULL);
+    }
+    ARSTREAM_Reader_Delete (&reader);
+
+    free (ctx.readerBuffer);
+    ARSTREAM_RegressionTb_ContextDestroy (&ctx);
+    return retVal;
+}
+
+/*
+ * Implementation
+ */
+
+int ARSTREAM_Regression_TestBenchMain (int argc, char *argv[])
+{
+    static const ARSTREAM_RegressionTb_Check_t checks [] = {
+        { "ack_packet_full_words", ARSTREAM_RegressionTb_AckPacketFullWords },
+        { "sender_filter_chain", ARSTREAM_RegressionTb_SenderFilterChain },
+        { "reader_first_frame", ARSTREAM_RegressionTb_ReaderFirstFrame },
+        { "rtp_late_packet", ARSTREAM_RegressionTb_RtpLatePacket },
+        { "rtp_missed_frames", ARSTREAM_RegressionTb_RtpMissedFrames },
+        { "sender_retries_without_priority", ARSTREAM_RegressionTb_SenderRetriesWithoutPriority },
+        { "sender_default_replace", ARSTREAM_RegressionTb_SenderDefaultReplace },
+        { "ack_buffer_control_tags", ARSTREAM_RegressionTb_AckBufferControlTags },
+        { "sender_many_nal_units", ARSTREAM_RegressionTb_SenderManyNalUnits },
+        { "jitter_buffer_overflow", ARSTREAM_RegressionTb_JitterBufferOverflow },
+        { "rate_control_loss", ARSTREAM_RegressionTb_RateControlLoss },
+        { "udp_uring_reinit", ARSTREAM_RegressionTb_UdpUringReinit },
+        { "transport_loopback", ARSTREAM_RegressionTb_TransportLoopback },
+        { "transport_shm", ARSTREAM_RegressionTb_TransportShm },
+        { "transport_udp", ARSTREAM_RegressionTb_TransportUdp },
+        { "transport_udp_offload", ARSTREAM_RegressionTb_TransportUdpOffload },
+        { "transport_udp_io_uring", ARSTREAM_RegressionTb_TransportUdpIoUring },
+        { "transport_impairment", ARSTREAM_RegressionTb_TransportImpairment },
+        { "sender_frame_expiry", ARSTREAM_RegressionTb_SenderFrameExpiry },
+        { "sender_queue_policies", ARSTREAM_RegressionTb_SenderQueuePolicies },
+        { "best_effort_stream", ARSTREAM_RegressionTb_BestEffortStream },
+        { "reader_abandon_frame", ARSTREAM_RegressionTb_ReaderAbandonFrame },
+        { "nal_aligned_fragments", ARSTREAM_RegressionTb_NalAlignedFragments },
+        { "sender_auto_classification", ARSTREAM_RegressionTb_SenderAutoClassification },
+        { "sender_keyframe_cache", ARSTREAM_RegressionTb_SenderKeyframeCache },
+        { "reader_wait_keyframe", ARSTREAM_RegressionTb_ReaderWaitKeyframe },
+    };
+    int nbFailed = 0;
+    int i;
+    (void)argc;
+    (void)argv;
+
+    for (i = 0; i < NB_ELEMENTS (checks); i++)
+    {
+        int res = checks[i].run ();
+        printf ("%s %s\n", (res == 0) ? "PASS" : "FAIL", checks[i].name);
+        fflush (stdout);
+        if (res != 0)
+        {
+            nbFailed++;
+        }
+    }
+    printf ("%d / %d checks passed\n", NB_ELEMENTS (checks) - nbFailed, NB_ELEMENTS (checks));
+    return (nbFailed == 0) ? 0 : 1;
+}
@@ -110,6 +110,9 @@ static int nbSkippedSinceLast = 0;
 
 static int stillRunning = 1;
 
+static pthread_mutex_t keyframeMutex = PTHREAD_MUTEX_INITIALIZER; // Protects keyframeRequested
+static int keyframeRequested = 0;
+
 float ARSTREAM_Sender_PercentOk = 0.0;
 static int nbSent = 0;
 static int nbOk = 0;
@@ -198,6 +201,11 @@ void ARSTREAM_SenderTb_initMultiBuffers ();
  */
 void ARSTREAM_SenderTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
 
+/**
+ * @see ARSTREAM_Sender.h
+ */
+void ARSTREAM_SenderTb_FeedbackCallback (const ARSTREAM_Sender_Feedback_t *feedback, void *custom);
+
 /**
  * @brief Gets a free buffer pointer
  * @param[in] buffer the buffer to mark as free
@@ -270,6 +278,7 @@ void ARSTREAM_SenderTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint
         ARSTREAM_Sender_PercentOk = (100.f * nbOk) / (1.f * nbSent);
         break;
     case ARSTREAM_SENDER_STATUS_FRAME_CANCEL:
+    case ARSTREAM_SENDER_STATUS_FRAME_EXPIRED:
         ARSTREAM_SenderTb_SetBufferFree (framePointer);
         ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Cancelled a frame of size %u", frameSize);
         nbSent++;
@@ -287,6 +296,25 @@ void ARSTREAM_SenderTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint
     }
 }
 
+void ARSTREAM_SenderTb_FeedbackCallback (const ARSTREAM_Sender_Feedback_t *feedback, void *custom)
+{
+    custom = custom;
+    switch (feedback->type)
+    {
+    case ARSTREAM_SENDER_FEEDBACK_KEYFRAME_REQUEST:
+        ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Reader requested a keyframe (last complete frame : %d)", feedback->lastCompleteFrameNumber);
+        pthread_mutex_lock (&keyframeMutex);
+        keyframeRequested = 1;
+        pthread_mutex_unlock (&keyframeMutex);
+        break;
+    case ARSTREAM_SENDER_FEEDBACK_RECEIVER_REPORT:
+        ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Receiver report : %.1f%% lost, %u lost total, jitter %u us", 100.f * feedback->lossFraction, feedback->cumulativeLost, feedback->jitterUs);
+        break;
+    default:
+        break;
+    }
+}
+
 void ARSTREAM_SenderTb_SetBufferFree (uint8_t *buffer)
 {
     int i;
@@ -347,7 +375,12 @@ void* fakeEncoderThread (void *ARSTREAM_Sender_t_Param)
             {
                 eARSTREAM_ERROR res;
                 int nbPrevious;
-                int flush = ((cnt % I_FRAME_EVERY_N) == 1) ? 1 : 0;
+                int flush;
+                /* Test and clear at once, or a request coming in between would be lost */
+                pthread_mutex_lock (&keyframeMutex);
+                flush = (((cnt % I_FRAME_EVERY_N) == 1) || (keyframeRequested == 1)) ? 1 : 0;
+                keyframeRequested = 0;
+                pthread_mutex_unlock (&keyframeMutex);
                 memset (nextFrameAddr, cnt, frameSize);
                 res = ARSTREAM_Sender_SendNewFrame (sender, nextFrameAddr, frameSize, flush, &nbPrevious);
                 switch (res)
@@ -394,6 +427,7 @@ int ARSTREAM_SenderTb_StartStreamTest (ARNETWORK_Manager_t *manager)
     }
 
     ARSTREAM_SenderTB_AddFilters();
+    ARSTREAM_Sender_SetFeedbackCallback (g_Sender, ARSTREAM_SenderTb_FeedbackCallback);
 
     pthread_t streamsend, streamread;
     pthread_create (&streamsend, NULL, ARSTREAM_Sender_RunDataThread, g_Sender);
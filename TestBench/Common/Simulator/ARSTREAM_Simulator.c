@@ -0,0 +1,447 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Simulator.c
+ * @brief Deterministic virtual time scheduler for the ARStream threads
+ * @date 10/17/2026
+ */
+
+/*
+ * System Headers
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARStream/ARSTREAM_Clock.h>
+
+#include "ARSTREAM_Simulator.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "ARSTREAM_Simulator"
+
+#define NO_DEADLINE (UINT64_MAX)
+
+/*
+ * Types
+ */
+
+typedef enum {
+    THREAD_STATE_READY = 0,
+    THREAD_STATE_WAITING,
+    THREAD_STATE_DONE,
+} eTHREAD_STATE;
+
+typedef struct {
+    ARSTREAM_Simulator_t *simulator;
+    int id;
+    pthread_t thread;
+    pthread_cond_t wakeCond;
+    void* (*function)(void *);
+    void *param;
+    eTHREAD_STATE state;
+    uint64_t readySeq; // Order of the READY threads (FIFO)
+    uint64_t waitSeq; // Order of the threads waiting on a condition (FIFO)
+    ARSAL_Cond_t *waitCond; // NULL for a sleep
+    uint64_t deadlineUs;
+    int signaled;
+} ARSTREAM_Simulator_Thread_t;
+
+struct ARSTREAM_Simulator_t {
+    pthread_mutex_t mutex; // Protects everything below
+    pthread_cond_t doneCond;
+    ARSTREAM_Simulator_Thread_t **threads;
+    int nbThreads;
+    int capacity;
+    int current; // Index of the running thread, or -1
+    uint64_t nowUs;
+    uint64_t nextSeq;
+    uint64_t nbSwitches;
+    int finished;
+    int deadlock;
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Gives the hand to the next thread (or ends the simulation)
+ * @note Called with the mutex locked, by the current thread (or by ARSTREAM_Simulator_Run to start)
+ */
+static void ARSTREAM_Simulator_Schedule (ARSTREAM_Simulator_t *simulator);
+
+/**
+ * @brief Makes the current thread wait for a signal or a deadline, and gives the hand to the next one
+ * @note Called with the mutex locked
+ * @return 1 if signaled, 0 on deadline
+ */
+static int ARSTREAM_Simulator_Wait (ARSTREAM_Simulator_t *simulator, ARSAL_Cond_t *cond, uint64_t deadlineUs);
+
+static void* ARSTREAM_Simulator_ThreadMain (void *param);
+
+static void ARSTREAM_Simulator_GetTime (void *context, struct timespec *now);
+static int ARSTREAM_Simulator_CondWait (void *context, ARSAL_Cond_t *cond, ARSAL_Mutex_t *mutex, int timeoutMs);
+static void ARSTREAM_Simulator_CondSignal (void *context, ARSAL_Cond_t *cond);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_Simulator_Schedule (ARSTREAM_Simulator_t *simulator)
+{
+    ARSTREAM_Simulator_Thread_t *next = NULL;
+    int nbWaiting = 0;
+    int i;
+
+    /* Oldest ready thread first */
+    for (i = 0; i < simulator->nbThreads; i++)
+    {
+        ARSTREAM_Simulator_Thread_t *thread = simulator->threads[i];
+        if ((thread->state == THREAD_STATE_READY) &&
+            ((next == NULL) || (thread->readySeq < next->readySeq)))
+        {
+            next = thread;
+        }
+    }
+
+    /* Else jump to the earliest deadline (lowest id on ties) */
+    if (next == NULL)
+    {
+        for (i = 0; i < simulator->nbThreads; i++)
+        {
+            ARSTREAM_Simulator_Thread_t *thread = simulator->threads[i];
+            if (thread->state == THREAD_STATE_WAITING)
+            {
+                nbWaiting++;
+                if ((thread->deadlineUs != NO_DEADLINE) &&
+                    ((next == NULL) || (thread->deadlineUs < next->deadlineUs)))
+                {
+                    next = thread;
+                }
+            }
+        }
+        if (next != NULL)
+        {
+            if (next->deadlineUs > simulator->nowUs)
+            {
+                simulator->nowUs = next->deadlineUs;
+            }
+            next->state = THREAD_STATE_READY;
+            next->signaled = 0;
+        }
+    }
+
+    if (next == NULL)
+    {
+        if (nbWaiting > 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Deadlock: %d threads waiting without timeout", nbWaiting);
+            simulator->deadlock = 1;
+        }
+        simulator->current = -1;
+        simulator->finished = 1;
+        pthread_cond_signal (&(simulator->doneCond));
+        return;
+    }
+
+    simulator->current = next->id;
+    simulator->nbSwitches++;
+    pthread_cond_signal (&(next->wakeCond));
+}
+
+static int ARSTREAM_Simulator_Wait (ARSTREAM_Simulator_t *simulator, ARSAL_Cond_t *cond, uint64_t deadlineUs)
+{
+    ARSTREAM_Simulator_Thread_t *self = simulator->threads[simulator->current];
+
+    self->state = THREAD_STATE_WAITING;
+    self->waitCond = cond;
+    self->waitSeq = simulator->nextSeq++;
+    self->deadlineUs = deadlineUs;
+    self->signaled = 0;
+    ARSTREAM_Simulator_Schedule (simulator);
+    while (simulator->current != self->id)
+    {
+        pthread_cond_wait (&(self->wakeCond), &(simulator->mutex));
+    }
+    self->waitCond = NULL;
+    return self->signaled;
+}
+
+static void* ARSTREAM_Simulator_ThreadMain (void *param)
+{
+    ARSTREAM_Simulator_Thread_t *self = (ARSTREAM_Simulator_Thread_t *)param;
+    ARSTREAM_Simulator_t *simulator = self->simulator;
+
+    pthread_mutex_lock (&(simulator->mutex));
+    while (simulator->current != self->id)
+    {
+        pthread_cond_wait (&(self->wakeCond), &(simulator->mutex));
+    }
+    pthread_mutex_unlock (&(simulator->mutex));
+
+    self->function (self->param);
+
+    pthread_mutex_lock (&(simulator->mutex));
+    self->state = THREAD_STATE_DONE;
+    ARSTREAM_Simulator_Schedule (simulator);
+    pthread_mutex_unlock (&(simulator->mutex));
+    return (void *)0;
+}
+
+static void ARSTREAM_Simulator_GetTime (void *context, struct timespec *now)
+{
+    uint64_t nowUs = ARSTREAM_Simulator_GetTimeUs ((ARSTREAM_Simulator_t *)context);
+    now->tv_sec = nowUs / 1000000;
+    now->tv_nsec = (nowUs % 1000000) * 1000;
+}
+
+static int ARSTREAM_Simulator_CondWait (void *context, ARSAL_Cond_t *cond, ARSAL_Mutex_t *mutex, int timeoutMs)
+{
+    ARSTREAM_Simulator_t *simulator = (ARSTREAM_Simulator_t *)context;
+    int signaled;
+
+    pthread_mutex_lock (&(simulator->mutex));
+    if (simulator->current < 0)
+    {
+        /* Not a simulator thread: nothing can signal it */
+        pthread_mutex_unlock (&(simulator->mutex));
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Condition wait outside of a simulator thread");
+        return ETIMEDOUT;
+    }
+    /* The other threads only run once this one waits: releasing the mutex now is safe */
+    ARSAL_Mutex_Unlock (mutex);
+    signaled = ARSTREAM_Simulator_Wait (simulator, cond, (timeoutMs < 0) ? NO_DEADLINE : simulator->nowUs + (uint64_t)timeoutMs * 1000);
+    pthread_mutex_unlock (&(simulator->mutex));
+    ARSAL_Mutex_Lock (mutex);
+    return (signaled == 1) ? 0 : ETIMEDOUT;
+}
+
+static void ARSTREAM_Simulator_CondSignal (void *context, ARSAL_Cond_t *cond)
+{
+    ARSTREAM_Simulator_t *simulator = (ARSTREAM_Simulator_t *)context;
+    ARSTREAM_Simulator_Thread_t *oldest = NULL;
+    int i;
+
+    pthread_mutex_lock (&(simulator->mutex));
+    for (i = 0; i < simulator->nbThreads; i++)
+    {
+        ARSTREAM_Simulator_Thread_t *thread = simulator->threads[i];
+        if ((thread->state == THREAD_STATE_WAITING) &&
+            (thread->waitCond == cond) &&
+            ((oldest == NULL) || (thread->waitSeq < oldest->waitSeq)))
+        {
+            oldest = thread;
+        }
+    }
+    if (oldest != NULL)
+    {
+        oldest->state = THREAD_STATE_READY;
+        oldest->readySeq = simulator->nextSeq++;
+        oldest->signaled = 1;
+    }
+    pthread_mutex_unlock (&(simulator->mutex));
+}
+
+/*
+ * Implementation
+ */
+
+ARSTREAM_Simulator_t* ARSTREAM_Simulator_New (uint64_t startTimeUs)
+{
+    ARSTREAM_Simulator_t *simulator = calloc (1, sizeof (ARSTREAM_Simulator_t));
+    ARSTREAM_Clock_t clock;
+
+    if (simulator == NULL)
+    {
+        return NULL;
+    }
+    pthread_mutex_init (&(simulator->mutex), NULL);
+    pthread_cond_init (&(simulator->doneCond), NULL);
+    simulator->current = -1;
+    simulator->nowUs = startTimeUs;
+
+    clock.getTime = ARSTREAM_Simulator_GetTime;
+    clock.condWait = ARSTREAM_Simulator_CondWait;
+    clock.condSignal = ARSTREAM_Simulator_CondSignal;
+    clock.context = simulator;
+    ARSTREAM_Clock_SetClock (&clock);
+    return simulator;
+}
+
+void ARSTREAM_Simulator_Delete (ARSTREAM_Simulator_t **simulator)
+{
+    int i;
+    if ((simulator == NULL) ||
+        (*simulator == NULL))
+    {
+        return;
+    }
+    ARSTREAM_Clock_SetClock (NULL);
+    if ((*simulator)->deadlock == 0)
+    {
+        for (i = 0; i < (*simulator)->nbThreads; i++)
+        {
+            pthread_cond_destroy (&((*simulator)->threads[i]->wakeCond));
+            free ((*simulator)->threads[i]);
+        }
+        free ((*simulator)->threads);
+        pthread_cond_destroy (&((*simulator)->doneCond));
+        pthread_mutex_destroy (&((*simulator)->mutex));
+        free (*simulator);
+    }
+    /* else the deadlocked threads still use the simulator: leak it */
+    *simulator = NULL;
+}
+
+int ARSTREAM_Simulator_AddThread (ARSTREAM_Simulator_t *simulator, void* (*function)(void *), void *param)
+{
+    ARSTREAM_Simulator_Thread_t *thread;
+    int retVal = 0;
+
+    if ((simulator == NULL) ||
+        (function == NULL))
+    {
+        return -1;
+    }
+    thread = calloc (1, sizeof (ARSTREAM_Simulator_Thread_t));
+    if (thread == NULL)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock (&(simulator->mutex));
+    if (simulator->nbThreads == simulator->capacity)
+    {
+        int newCapacity = (simulator->capacity == 0) ? 16 : (2 * simulator->capacity);
+        ARSTREAM_Simulator_Thread_t **newThreads = realloc (simulator->threads, newCapacity * sizeof (ARSTREAM_Simulator_Thread_t *));
+        if (newThreads == NULL)
+        {
+            retVal = -1;
+        }
+        else
+        {
+            simulator->threads = newThreads;
+            simulator->capacity = newCapacity;
+        }
+    }
+    if (retVal == 0)
+    {
+        thread->simulator = simulator;
+        thread->id = simulator->nbThreads;
+        thread->function = function;
+        thread->param = param;
+        thread->state = THREAD_STATE_READY;
+        thread->readySeq = simulator->nextSeq++;
+        pthread_cond_init (&(thread->wakeCond), NULL);
+        if (pthread_create (&(thread->thread), NULL, ARSTREAM_Simulator_ThreadMain, thread) != 0)
+        {
+            pthread_cond_destroy (&(thread->wakeCond));
+            retVal = -1;
+        }
+        else
+        {
+            simulator->threads[simulator->nbThreads++] = thread;
+        }
+    }
+    pthread_mutex_unlock (&(simulator->mutex));
+
+    if (retVal != 0)
+    {
+        free (thread);
+    }
+    return retVal;
+}
+
+int ARSTREAM_Simulator_Run (ARSTREAM_Simulator_t *simulator)
+{
+    int i;
+    if (simulator == NULL)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock (&(simulator->mutex));
+    simulator->finished = 0;
+    ARSTREAM_Simulator_Schedule (simulator);
+    while (simulator->finished == 0)
+    {
+        pthread_cond_wait (&(simulator->doneCond), &(simulator->mutex));
+    }
+    pthread_mutex_unlock (&(simulator->mutex));
+
+    if (simulator->deadlock == 1)
+    {
+        return -1;
+    }
+    for (i = 0; i < simulator->nbThreads; i++)
+    {
+        pthread_join (simulator->threads[i]->thread, NULL);
+    }
+    return 0;
+}
+
+void ARSTREAM_Simulator_Sleep (ARSTREAM_Simulator_t *simulator, uint64_t delayUs)
+{
+    pthread_mutex_lock (&(simulator->mutex));
+    if (simulator->current >= 0)
+    {
+        ARSTREAM_Simulator_Wait (simulator, NULL, simulator->nowUs + delayUs);
+    }
+    pthread_mutex_unlock (&(simulator->mutex));
+}
+
+uint64_t ARSTREAM_Simulator_GetTimeUs (ARSTREAM_Simulator_t *simulator)
+{
+    uint64_t nowUs;
+    pthread_mutex_lock (&(simulator->mutex));
+    nowUs = simulator->nowUs;
+    pthread_mutex_unlock (&(simulator->mutex));
+    return nowUs;
+}
+
+uint64_t ARSTREAM_Simulator_GetNbSwitches (ARSTREAM_Simulator_t *simulator)
+{
+    uint64_t nbSwitches;
+    pthread_mutex_lock (&(simulator->mutex));
+    nbSwitches = simulator->nbSwitches;
+    pthread_mutex_unlock (&(simulator->mutex));
+    return nbSwitches;
+}
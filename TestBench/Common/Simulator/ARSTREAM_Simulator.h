@@ -0,0 +1,117 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Simulator.h
+ * @brief Deterministic virtual time scheduler for the ARStream threads
+ * @date 10/17/2026
+ */
+
+#ifndef _ARSTREAM_SIMULATOR_H_
+#define _ARSTREAM_SIMULATOR_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * Types
+ */
+
+/**
+ * @brief A virtual time scheduler
+ * While a simulator exists, it is the ARStream clock (see ARSTREAM_Clock_SetClock()).
+ * The simulator threads are real threads, but only one of them runs at a time: a
+ * thread runs until it waits on a condition (through the ARStream clock) or returns.
+ * The next thread is then the oldest one woken up by a signal or, if there is none,
+ * the one with the earliest timeout: the virtual time jumps to this timeout.
+ * Running code takes no virtual time, and a run only depends on its inputs.
+ */
+typedef struct ARSTREAM_Simulator_t ARSTREAM_Simulator_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Creates a simulator and installs it as the ARStream clock
+ * @warning No sender, reader or transport may exist when calling this function
+ * @param[in] startTimeUs Initial virtual time
+ * @return The new simulator, or NULL on error
+ */
+ARSTREAM_Simulator_t* ARSTREAM_Simulator_New (uint64_t startTimeUs);
+
+/**
+ * @brief Deletes a simulator and restores the default ARStream clock
+ * @warning No sender, reader or transport may exist anymore when calling this function
+ * @param[in] simulator Pointer to the simulator to delete (set to NULL)
+ */
+void ARSTREAM_Simulator_Delete (ARSTREAM_Simulator_t **simulator);
+
+/**
+ * @brief Adds a thread to the simulation
+ * May be called before ARSTREAM_Simulator_Run() or from a simulator thread.
+ * @param[in] simulator The simulator
+ * @param[in] function The thread function (e.g. ARSTREAM_Sender_RunDataThread)
+ * @param[in] param The thread function parameter
+ * @return 0, or -1 on error
+ */
+int ARSTREAM_Simulator_AddThread (ARSTREAM_Simulator_t *simulator, void* (*function)(void *), void *param);
+
+/**
+ * @brief Runs the simulation until all its threads have returned
+ * @param[in] simulator The simulator
+ * @return 0, or -1 if the threads are deadlocked (all waiting without timeout)
+ */
+int ARSTREAM_Simulator_Run (ARSTREAM_Simulator_t *simulator);
+
+/**
+ * @brief Makes the calling simulator thread sleep in virtual time
+ * @param[in] simulator The simulator
+ * @param[in] delayUs The sleep duration
+ */
+void ARSTREAM_Simulator_Sleep (ARSTREAM_Simulator_t *simulator, uint64_t delayUs);
+
+/**
+ * @brief Gets the virtual time
+ * @param[in] simulator The simulator
+ * @return The virtual time in microseconds
+ */
+uint64_t ARSTREAM_Simulator_GetTimeUs (ARSTREAM_Simulator_t *simulator);
+
+/**
+ * @brief Gets the number of context switches done by the simulator
+ * @param[in] simulator The simulator
+ * @return The number of context switches
+ */
+uint64_t ARSTREAM_Simulator_GetNbSwitches (ARSTREAM_Simulator_t *simulator);
+
+#endif /* _ARSTREAM_SIMULATOR_H_ */
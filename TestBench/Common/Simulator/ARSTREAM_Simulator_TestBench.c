@@ -0,0 +1,602 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Simulator_TestBench.c
+ * @brief Virtual time simulation of sender/reader pairs over impaired links
+ * @date 10/17/2026
+ */
+
+/*
+ * System Headers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Time.h>
+#include <libARStream/ARSTREAM_Sender.h>
+#include <libARStream/ARSTREAM_Reader.h>
+#include <libARStream/ARSTREAM_Transport.h>
+
+#include "ARSTREAM_Simulator.h"
+#include "ARSTREAM_Simulator_TestBench.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "ARSTREAM_Simulator_TB"
+
+#define START_TIME_US (1000000)
+
+#define FRAG_SIZE (1000)
+#define MAX_NB_FRAG (128)
+
+#define FPS (30)
+#define I_FRAME_EVERY_N (30)
+#define P_FRAME_SIZE (8000)
+#define I_FRAME_SIZE (40000)
+#define FRAME_SIZE_VARIATION (2000)
+#define FRAME_MAX_SIZE (I_FRAME_SIZE + FRAME_SIZE_VARIATION)
+
+#define NB_BUFFERS (64)
+
+#define DRAIN_TIME_MS (2000)
+
+/**
+ * @brief Frame header written by the fake encoder : frame number and send time
+ */
+#define FRAME_HEADER_SIZE (12)
+
+#define DEFAULT_NB_STREAMS (1)
+#define DEFAULT_DURATION_S (60)
+#define DEFAULT_LOSS_PERCENT (1.0)
+/**
+ * @brief Default one way delay : the acknowledges come back within a frame
+ * interval, before the next frame replaces the current one
+ */
+#define DEFAULT_DELAY_MS (10)
+#define DEFAULT_SEED (1)
+
+#define SMOKE_NB_STREAMS (2)
+#define SMOKE_DURATION_S (2)
+/**
+ * @brief Minimum share of the received frames which must also be acknowledged in the smoke run
+ */
+#define SMOKE_MIN_ACKED_PERCENT (80)
+
+#define FNV_OFFSET (0xcbf29ce484222325ULL)
+#define FNV_PRIME (0x100000001b3ULL)
+
+/*
+ * Types
+ */
+
+typedef struct {
+    int index;
+    ARSTREAM_Simulator_t *simulator;
+    int nbFrames;
+    uint64_t rng;
+
+    ARSTREAM_Transport_t senderTransport;
+    ARSTREAM_Transport_t readerTransport;
+    ARSTREAM_Sender_t *sender;
+    ARSTREAM_Reader_t *reader;
+
+    uint8_t *buffers [NB_BUFFERS];
+    int bufferIsFree [NB_BUFFERS];
+    uint8_t *readerBuffer;
+
+    uint32_t nbEncoded;
+    uint32_t nbEncoderDropped;
+    uint32_t nbAcked;
+    uint32_t nbCancelled;
+    uint32_t nbReceived;
+    uint32_t nbSkipped;
+    uint64_t latencySumUs;
+    uint64_t latencyMaxUs;
+    uint64_t digest;
+} ARSTREAM_SimulatorTb_Stream_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Print the parameters of the application
+ */
+static void ARSTREAM_SimulatorTb_PrintUsage (const char *appName);
+
+/**
+ * @brief Deterministic random generator (xorshift64*)
+ */
+static uint32_t ARSTREAM_SimulatorTb_Random (uint64_t *state);
+
+/**
+ * @brief Adds a value to a FNV-1a digest
+ */
+static void ARSTREAM_SimulatorTb_Digest (uint64_t *digest, uint64_t value);
+
+/**
+ * @see ARSTREAM_Sender.h
+ */
+static void ARSTREAM_SimulatorTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
+
+/**
+ * @see ARSTREAM_Reader.h
+ */
+static uint8_t* ARSTREAM_SimulatorTb_FrameCompleteCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom);
+
+/**
+ * @brief Fake encoder thread function
+ * Generates the frames of a stream at FPS in virtual time, waits for the last
+ * frames to be delivered, then stops the stream.
+ * @param param An ARSTREAM_SimulatorTb_Stream_t, casted as a (void *)
+ * @return No meaningful value : (void *)0
+ */
+static void* ARSTREAM_SimulatorTb_EncoderThread (void *param);
+
+/**
+ * @brief Creates the transports, sender and reader of a stream and adds their threads to the simulator
+ * @return 0, or -1 on error
+ */
+static int ARSTREAM_SimulatorTb_StreamInit (ARSTREAM_SimulatorTb_Stream_t *stream, const ARSTREAM_Transport_ImpairmentParams_t *impairment);
+
+/**
+ * @brief Releases a stream
+ */
+static void ARSTREAM_SimulatorTb_StreamDestroy (ARSTREAM_SimulatorTb_Stream_t *stream);
+
+/**
+ * @brief Runs a simulation, prints the per stream and total results
+ * @param[out] total Counters and digest summed over all streams
+ * @return 0, or 1 on error
+ */
+static int ARSTREAM_SimulatorTb_Run (int nbStreams, int durationS, double lossPercent, int delayMs, uint32_t seed, ARSTREAM_SimulatorTb_Stream_t *total);
+
+/**
+ * @brief Runs the fixed seed smoke configuration twice and checks its results
+ * @return 0 if all checks passed, 1 otherwise
+ */
+static int ARSTREAM_SimulatorTb_Smoke (void);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_SimulatorTb_PrintUsage (const char *appName)
+{
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Usage : %s [nbStreams [durationS [lossPercent [delayMs [seed]]]]]", appName);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        %s --smoke", appName);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        nbStreams   -> streams simulated together (default %d)", DEFAULT_NB_STREAMS);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        durationS   -> virtual duration of the encoded frames, followed by %d ms of drain (default %d)", DRAIN_TIME_MS, DEFAULT_DURATION_S);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        lossPercent -> random loss in both directions (default %.1f)", DEFAULT_LOSS_PERCENT);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        delayMs     -> one way delay, with a quarter of jitter (default %d)", DEFAULT_DELAY_MS);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        seed        -> random seed (default %d)", DEFAULT_SEED);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        --smoke     -> short fixed seed run (%d streams, %d s of frames), twice, checked", SMOKE_NB_STREAMS, SMOKE_DURATION_S);
+}
+
+static uint32_t ARSTREAM_SimulatorTb_Random (uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return (uint32_t)((x * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static void ARSTREAM_SimulatorTb_Digest (uint64_t *digest, uint64_t value)
+{
+    int i;
+    for (i = 0; i < 8; i++)
+    {
+        *digest ^= (value >> (8 * i)) & 0xFF;
+        *digest *= FNV_PRIME;
+    }
+}
+
+static void ARSTREAM_SimulatorTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom)
+{
+    ARSTREAM_SimulatorTb_Stream_t *stream = (ARSTREAM_SimulatorTb_Stream_t *)custom;
+    int i;
+    (void)frameSize;
+
+    switch (status)
+    {
+    case ARSTREAM_SENDER_STATUS_FRAME_SENT:
+        stream->nbAcked++;
+        break;
+    case ARSTREAM_SENDER_STATUS_FRAME_CANCEL:
+    case ARSTREAM_SENDER_STATUS_FRAME_EXPIRED:
+        stream->nbCancelled++;
+        break;
+    default:
+        return;
+    }
+    ARSTREAM_SimulatorTb_Digest (&(stream->digest), ((uint64_t)status << 32) | framePointer[0] | (framePointer[1] << 8) | (framePointer[2] << 16));
+    for (i = 0; i < NB_BUFFERS; i++)
+    {
+        if (stream->buffers[i] == framePointer)
+        {
+            stream->bufferIsFree[i] = 1;
+        }
+    }
+}
+
+static uint8_t* ARSTREAM_SimulatorTb_FrameCompleteCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom)
+{
+    ARSTREAM_SimulatorTb_Stream_t *stream = (ARSTREAM_SimulatorTb_Stream_t *)custom;
+    (void)isFlushFrame;
+
+    if ((cause == ARSTREAM_READER_CAUSE_FRAME_COMPLETE) &&
+        (frameSize >= FRAME_HEADER_SIZE))
+    {
+        uint32_t frameNumber;
+        uint64_t sendTimeUs, nowUs;
+        memcpy (&frameNumber, framePointer, sizeof (frameNumber));
+        memcpy (&sendTimeUs, framePointer + sizeof (frameNumber), sizeof (sendTimeUs));
+        nowUs = ARSTREAM_Simulator_GetTimeUs (stream->simulator);
+        stream->nbReceived++;
+        if (numberOfSkippedFrames > 0)
+        {
+            stream->nbSkipped += numberOfSkippedFrames;
+        }
+        stream->latencySumUs += nowUs - sendTimeUs;
+        if (nowUs - sendTimeUs > stream->latencyMaxUs)
+        {
+            stream->latencyMaxUs = nowUs - sendTimeUs;
+        }
+        ARSTREAM_SimulatorTb_Digest (&(stream->digest), frameNumber);
+        ARSTREAM_SimulatorTb_Digest (&(stream->digest), nowUs);
+    }
+    /* The frame is consumed here : the same buffer can hold the next one */
+    *newBufferCapacity = FRAME_MAX_SIZE;
+    return stream->readerBuffer;
+}
+
+static void* ARSTREAM_SimulatorTb_EncoderThread (void *param)
+{
+    ARSTREAM_SimulatorTb_Stream_t *stream = (ARSTREAM_SimulatorTb_Stream_t *)param;
+    uint64_t frameIntervalUs = 1000000 / FPS;
+    uint64_t startUs = ARSTREAM_Simulator_GetTimeUs (stream->simulator);
+    uint32_t frameNumber;
+
+    for (frameNumber = 0; frameNumber < (uint32_t)stream->nbFrames; frameNumber++)
+    {
+        int isKeyframe = ((frameNumber % I_FRAME_EVERY_N) == 0) ? 1 : 0;
+        uint32_t frameSize = ((isKeyframe == 1) ? I_FRAME_SIZE : P_FRAME_SIZE) + ARSTREAM_SimulatorTb_Random (&(stream->rng)) % FRAME_SIZE_VARIATION;
+        int bufferIndex = frameNumber % NB_BUFFERS;
+        uint64_t nowUs = ARSTREAM_Simulator_GetTimeUs (stream->simulator);
+
+        stream->nbEncoded++;
+        if (stream->bufferIsFree[bufferIndex] == 1)
+        {
+            uint8_t *buffer = stream->buffers[bufferIndex];
+            int nbPrevious;
+            memcpy (buffer, &frameNumber, sizeof (frameNumber));
+            memcpy (buffer + sizeof (frameNumber), &nowUs, sizeof (nowUs));
+            stream->bufferIsFree[bufferIndex] = 0;
+            if (ARSTREAM_Sender_SendNewFrame (stream->sender, buffer, frameSize, isKeyframe, &nbPrevious) != ARSTREAM_OK)
+            {
+                stream->bufferIsFree[bufferIndex] = 1;
+                stream->nbEncoderDropped++;
+            }
+        }
+        else
+        {
+            stream->nbEncoderDropped++;
+        }
+
+        /* Sleep until the next frame, without drift */
+        nowUs = ARSTREAM_Simulator_GetTimeUs (stream->simulator);
+        if (startUs + (frameNumber + 1) * frameIntervalUs > nowUs)
+        {
+            ARSTREAM_Simulator_Sleep (stream->simulator, startUs + (frameNumber + 1) * frameIntervalUs - nowUs);
+        }
+    }
+
+    ARSTREAM_Simulator_Sleep (stream->simulator, (uint64_t)DRAIN_TIME_MS * 1000);
+    ARSTREAM_Sender_StopSender (stream->sender);
+    ARSTREAM_Reader_StopReader (stream->reader);
+    ARSTREAM_Transport_StopImpairment (&(stream->senderTransport));
+    ARSTREAM_Transport_StopImpairment (&(stream->readerTransport));
+    return (void *)0;
+}
+
+static int ARSTREAM_SimulatorTb_StreamInit (ARSTREAM_SimulatorTb_Stream_t *stream, const ARSTREAM_Transport_ImpairmentParams_t *impairment)
+{
+    ARSTREAM_Transport_LoopbackParams_t loopbackParams;
+    ARSTREAM_Transport_ImpairmentParams_t impairmentParams = *impairment;
+    eARSTREAM_ERROR err;
+    int i;
+
+    for (i = 0; i < NB_BUFFERS; i++)
+    {
+        stream->buffers[i] = calloc (1, FRAME_MAX_SIZE);
+        stream->bufferIsFree[i] = 1;
+        if (stream->buffers[i] == NULL)
+        {
+            return -1;
+        }
+    }
+    stream->readerBuffer = malloc (FRAME_MAX_SIZE);
+    if (stream->readerBuffer == NULL)
+    {
+        return -1;
+    }
+
+    /* Impaired loopback pair : one seed per stream and direction */
+    ARSTREAM_Transport_LoopbackParamsDefaultInit (&loopbackParams);
+    loopbackParams.maxFragmentSize = FRAG_SIZE;
+    err = ARSTREAM_Transport_InitLoopback (&(stream->senderTransport), &(stream->readerTransport), &loopbackParams);
+    if (err == ARSTREAM_OK)
+    {
+        impairmentParams.seed = impairment->seed + 2 * stream->index;
+        err = ARSTREAM_Transport_InitImpairment (&(stream->senderTransport), &(stream->senderTransport), &impairmentParams);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        impairmentParams.seed = impairment->seed + 2 * stream->index + 1;
+        err = ARSTREAM_Transport_InitImpairment (&(stream->readerTransport), &(stream->readerTransport), &impairmentParams);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        stream->sender = ARSTREAM_Sender_NewWithTransport (&(stream->senderTransport), ARSTREAM_SimulatorTb_FrameUpdateCallback, NB_BUFFERS, FRAG_SIZE, MAX_NB_FRAG, stream, &err);
+    }
+    if (err == ARSTREAM_OK)
+    {
+        stream->reader = ARSTREAM_Reader_NewWithTransport (&(stream->readerTransport), ARSTREAM_SimulatorTb_FrameCompleteCallback, stream->readerBuffer, FRAME_MAX_SIZE, FRAG_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT, stream, &err);
+    }
+    if (err != ARSTREAM_OK)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create stream %d : %s", stream->index, ARSTREAM_Error_ToString (err));
+        return -1;
+    }
+
+    if ((ARSTREAM_Simulator_AddThread (stream->simulator, ARSTREAM_Transport_RunImpairmentThread, &(stream->senderTransport)) != 0) ||
+        (ARSTREAM_Simulator_AddThread (stream->simulator, ARSTREAM_Transport_RunImpairmentThread, &(stream->readerTransport)) != 0) ||
+        (ARSTREAM_Simulator_AddThread (stream->simulator, ARSTREAM_Sender_RunDataThread, stream->sender) != 0) ||
+        (ARSTREAM_Simulator_AddThread (stream->simulator, ARSTREAM_Sender_RunAckThread, stream->sender) != 0) ||
+        (ARSTREAM_Simulator_AddThread (stream->simulator, ARSTREAM_Reader_RunDataThread, stream->reader) != 0) ||
+        (ARSTREAM_Simulator_AddThread (stream->simulator, ARSTREAM_Reader_RunAckThread, stream->reader) != 0) ||
+        (ARSTREAM_Simulator_AddThread (stream->simulator, ARSTREAM_Reader_RunPlayoutThread, stream->reader) != 0) ||
+        (ARSTREAM_Simulator_AddThread (stream->simulator, ARSTREAM_SimulatorTb_EncoderThread, stream) != 0))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to start the threads of stream %d", stream->index);
+        return -1;
+    }
+    return 0;
+}
+
+static void ARSTREAM_SimulatorTb_StreamDestroy (ARSTREAM_SimulatorTb_Stream_t *stream)
+{
+    int i;
+    ARSTREAM_Sender_Delete (&(stream->sender));
+    ARSTREAM_Reader_Delete (&(stream->reader));
+    ARSTREAM_Transport_Destroy (&(stream->senderTransport));
+    ARSTREAM_Transport_Destroy (&(stream->readerTransport));
+    for (i = 0; i < NB_BUFFERS; i++)
+    {
+        free (stream->buffers[i]);
+    }
+    free (stream->readerBuffer);
+}
+
+static int ARSTREAM_SimulatorTb_Run (int nbStreams, int durationS, double lossPercent, int delayMs, uint32_t seed, ARSTREAM_SimulatorTb_Stream_t *total)
+{
+    ARSTREAM_Transport_ImpairmentParams_t impairment;
+    ARSTREAM_SimulatorTb_Stream_t *streams;
+    ARSTREAM_Simulator_t *simulator;
+    struct timespec wallStart, wallEnd;
+    uint64_t virtualStartUs, virtualUs;
+    int wallMs;
+    int retVal = 0;
+    int i;
+
+    ARSTREAM_Transport_ImpairmentParamsDefaultInit (&impairment);
+    impairment.seed = seed * 1000003;
+    impairment.lossModel = ARSTREAM_TRANSPORT_IMPAIRMENT_LOSS_BERNOULLI;
+    impairment.lossRate = lossPercent / 100.0;
+    impairment.delayMs = delayMs;
+    impairment.jitterMs = delayMs / 4;
+
+    streams = calloc (nbStreams, sizeof (ARSTREAM_SimulatorTb_Stream_t));
+    simulator = ARSTREAM_Simulator_New (START_TIME_US);
+    if ((streams == NULL) ||
+        (simulator == NULL))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Allocation error");
+        free (streams);
+        ARSTREAM_Simulator_Delete (&simulator);
+        return 1;
+    }
+    /* The library may use rand () (RTP sequence numbers) */
+    srand (seed);
+
+    for (i = 0; (retVal == 0) && (i < nbStreams); i++)
+    {
+        streams[i].index = i;
+        streams[i].simulator = simulator;
+        streams[i].nbFrames = durationS * FPS;
+        streams[i].rng = ((uint64_t)seed << 32) + i + 1;
+        streams[i].digest = FNV_OFFSET;
+        if (ARSTREAM_SimulatorTb_StreamInit (&(streams[i]), &impairment) != 0)
+        {
+            retVal = 1;
+        }
+    }
+
+    if (retVal == 0)
+    {
+        ARSAL_Time_GetTime (&wallStart);
+        virtualStartUs = ARSTREAM_Simulator_GetTimeUs (simulator);
+        if (ARSTREAM_Simulator_Run (simulator) != 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Simulation deadlocked");
+            /* The threads are blocked : nothing can be released */
+            return 1;
+        }
+        ARSAL_Time_GetTime (&wallEnd);
+        virtualUs = ARSTREAM_Simulator_GetTimeUs (simulator) - virtualStartUs;
+        wallMs = ARSAL_Time_ComputeTimespecMsTimeDiff (&wallStart, &wallEnd);
+
+        memset (total, 0, sizeof (*total));
+        total->digest = FNV_OFFSET;
+        for (i = 0; i < nbStreams; i++)
+        {
+            ARSTREAM_SimulatorTb_Stream_t *s = &(streams[i]);
+            printf ("stream=%d encoded=%u encoderDropped=%u acked=%u cancelled=%u received=%u skipped=%u latencyMeanMs=%.2f latencyMaxMs=%.2f digest=%016llx\n",
+                    i, s->nbEncoded, s->nbEncoderDropped, s->nbAcked, s->nbCancelled, s->nbReceived, s->nbSkipped,
+                    (s->nbReceived > 0) ? (s->latencySumUs / 1000.0 / s->nbReceived) : 0.0, s->latencyMaxUs / 1000.0,
+                    (unsigned long long)s->digest);
+            total->nbEncoded += s->nbEncoded;
+            total->nbEncoderDropped += s->nbEncoderDropped;
+            total->nbAcked += s->nbAcked;
+            total->nbCancelled += s->nbCancelled;
+            total->nbReceived += s->nbReceived;
+            total->nbSkipped += s->nbSkipped;
+            total->latencySumUs += s->latencySumUs;
+            ARSTREAM_SimulatorTb_Digest (&(total->digest), s->digest);
+        }
+        /* The virtual time also covers the drain and the threads shutdown */
+        printf ("total streams=%d durationS=%d drainS=%.3f virtualS=%.3f wallS=%.3f speedup=%.1f switches=%llu encoded=%u acked=%u cancelled=%u received=%u latencyMeanMs=%.2f digest=%016llx\n",
+                nbStreams, durationS, DRAIN_TIME_MS / 1000.0, virtualUs / 1000000.0, wallMs / 1000.0, (wallMs > 0) ? (virtualUs / 1000.0 / wallMs) : 0.0,
+                (unsigned long long)ARSTREAM_Simulator_GetNbSwitches (simulator),
+                total->nbEncoded, total->nbAcked, total->nbCancelled, total->nbReceived,
+                (total->nbReceived > 0) ? (total->latencySumUs / 1000.0 / total->nbReceived) : 0.0,
+                (unsigned long long)total->digest);
+    }
+
+    for (i = 0; i < nbStreams; i++)
+    {
+        ARSTREAM_SimulatorTb_StreamDestroy (&(streams[i]));
+    }
+    free (streams);
+    ARSTREAM_Simulator_Delete (&simulator);
+    return retVal;
+}
+
+static int ARSTREAM_SimulatorTb_Smoke (void)
+{
+    ARSTREAM_SimulatorTb_Stream_t first, second;
+    int nbFailed = 0;
+
+    if ((ARSTREAM_SimulatorTb_Run (SMOKE_NB_STREAMS, SMOKE_DURATION_S, DEFAULT_LOSS_PERCENT, DEFAULT_DELAY_MS, DEFAULT_SEED, &first) != 0) ||
+        (ARSTREAM_SimulatorTb_Run (SMOKE_NB_STREAMS, SMOKE_DURATION_S, DEFAULT_LOSS_PERCENT, DEFAULT_DELAY_MS, DEFAULT_SEED, &second) != 0))
+    {
+        printf ("FAIL smoke : simulation error\n");
+        return 1;
+    }
+
+    /* Every encoded frame is either dropped by the encoder or gets exactly one sender callback */
+    if (first.nbEncoded != (uint32_t)(SMOKE_NB_STREAMS * SMOKE_DURATION_S * FPS))
+    {
+        printf ("FAIL smoke : %u frames encoded, %d expected\n", first.nbEncoded, SMOKE_NB_STREAMS * SMOKE_DURATION_S * FPS);
+        nbFailed++;
+    }
+    if (first.nbAcked + first.nbCancelled + first.nbEncoderDropped != first.nbEncoded)
+    {
+        printf ("FAIL smoke : %u acked + %u cancelled + %u dropped != %u encoded\n", first.nbAcked, first.nbCancelled, first.nbEncoderDropped, first.nbEncoded);
+        nbFailed++;
+    }
+    if ((first.nbReceived == 0) ||
+        (first.nbReceived > first.nbEncoded))
+    {
+        printf ("FAIL smoke : %u frames received for %u encoded\n", first.nbReceived, first.nbEncoded);
+        nbFailed++;
+    }
+    /* With the default delay, acknowledges come back before the next frame */
+    if (first.nbAcked * 100 < first.nbReceived * SMOKE_MIN_ACKED_PERCENT)
+    {
+        printf ("FAIL smoke : %u frames acked for %u received, less than %d%%\n", first.nbAcked, first.nbReceived, SMOKE_MIN_ACKED_PERCENT);
+        nbFailed++;
+    }
+    /* Same seed, same virtual time : the runs must be identical */
+    if (first.digest != second.digest)
+    {
+        printf ("FAIL smoke : digest %016llx then %016llx with the same seed\n", (unsigned long long)first.digest, (unsigned long long)second.digest);
+        nbFailed++;
+    }
+
+    if (nbFailed == 0)
+    {
+        printf ("PASS smoke\n");
+    }
+    return (nbFailed == 0) ? 0 : 1;
+}
+
+/*
+ * Implementation
+ */
+
+int ARSTREAM_Simulator_TestBenchMain (int argc, char *argv[])
+{
+    int nbStreams = DEFAULT_NB_STREAMS;
+    int durationS = DEFAULT_DURATION_S;
+    double lossPercent = DEFAULT_LOSS_PERCENT;
+    int delayMs = DEFAULT_DELAY_MS;
+    uint32_t seed = DEFAULT_SEED;
+    ARSTREAM_SimulatorTb_Stream_t total;
+
+    if ((argc == 2) &&
+        (strcmp (argv[1], "--smoke") == 0))
+    {
+        return ARSTREAM_SimulatorTb_Smoke ();
+    }
+    if (argc > 6)
+    {
+        ARSTREAM_SimulatorTb_PrintUsage (argv[0]);
+        return 1;
+    }
+    if (argc > 1) nbStreams = atoi (argv[1]);
+    if (argc > 2) durationS = atoi (argv[2]);
+    if (argc > 3) lossPercent = atof (argv[3]);
+    if (argc > 4) delayMs = atoi (argv[4]);
+    if (argc > 5) seed = strtoul (argv[5], NULL, 0);
+    if ((nbStreams <= 0) ||
+        (durationS <= 0) ||
+        (lossPercent < 0.0) ||
+        (lossPercent > 100.0) ||
+        (delayMs < 0))
+    {
+        ARSTREAM_SimulatorTb_PrintUsage (argv[0]);
+        return 1;
+    }
+
+    return ARSTREAM_SimulatorTb_Run (nbStreams, durationS, lossPercent, delayMs, seed, &total);
+}
@@ -19,16 +19,93 @@ LOCAL_CFLAGS := \
 
 LOCAL_SRC_FILES := \
 	Sources/ARSTREAM_Buffers.c \
+	Sources/ARSTREAM_Clock.c \
+	Sources/ARSTREAM_ClockSync.c \
+	Sources/ARSTREAM_H264.c \
+	Sources/ARSTREAM_JitterBuffer.c \
 	Sources/ARSTREAM_NetworkHeaders.c \
+	Sources/ARSTREAM_RateControl.c \
 	Sources/ARSTREAM_Reader.c \
+	Sources/ARSTREAM_Rtp.c \
 	Sources/ARSTREAM_Sender.c \
+	Sources/ARSTREAM_Transport.c \
+	Sources/ARSTREAM_TransportImpairment.c \
+	Sources/ARSTREAM_TransportLoopback.c \
+	Sources/ARSTREAM_TransportShm.c \
+	Sources/ARSTREAM_TransportUdp.c \
+	Sources/ARSTREAM_Uring.c \
 	gen/Sources/ARSTREAM_Error.c
 
 LOCAL_INSTALL_HEADERS := \
 	Includes/libARStream/ARStream.h:usr/include/libARStream/ \
+	Includes/libARStream/ARSTREAM_Clock.h:usr/include/libARStream/ \
 	Includes/libARStream/ARSTREAM_Error.h:usr/include/libARStream/ \
 	Includes/libARStream/ARSTREAM_Filter.h:usr/include/libARStream/ \
 	Includes/libARStream/ARSTREAM_Reader.h:usr/include/libARStream/  \
 	Includes/libARStream/ARSTREAM_Sender.h:usr/include/libARStream/ \
+	Includes/libARStream/ARSTREAM_Transport.h:usr/include/libARStream/ \
 
 include $(BUILD_LIBRARY)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := arstream-simulator
+LOCAL_DESCRIPTION := ARSDK Stream library virtual time simulator (--smoke for a short checked run)
+LOCAL_CATEGORY_PATH := dragon/libs/arstream
+
+LOCAL_LIBRARIES := libARSAL libARStream
+
+LOCAL_SRC_FILES := \
+	TestBench/Common/Simulator/ARSTREAM_Simulator.c \
+	TestBench/Common/Simulator/ARSTREAM_Simulator_TestBench.c \
+	TestBench/Linux/Simulator/ARSTREAM_Simulator_LinuxTestBench.c
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := arstream-regression
+LOCAL_DESCRIPTION := ARSDK Stream library regression checks
+LOCAL_CATEGORY_PATH := dragon/libs/arstream
+
+LOCAL_LIBRARIES := libARSAL libARStream
+
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/Sources
+
+LOCAL_SRC_FILES := \
+	TestBench/Common/Regression/ARSTREAM_Regression_TestBench.c \
+	TestBench/Linux/Regression/ARSTREAM_Regression_LinuxTestBench.c
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := arstream-benchmark
+LOCAL_DESCRIPTION := ARSDK Stream library end-to-end benchmark (--smoke for a short checked run)
+LOCAL_CATEGORY_PATH := dragon/libs/arstream
+
+LOCAL_LIBRARIES := libARSAL libARNetworkAL libARNetwork libARStream
+
+LOCAL_SRC_FILES := \
+	TestBench/Common/Benchmark/ARSTREAM_Benchmark_TestBench.c \
+	TestBench/Linux/Benchmark/ARSTREAM_Benchmark_LinuxTestBench.c
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := arstream-microbenchmark
+LOCAL_DESCRIPTION := ARSDK Stream library microbenchmarks (--smoke for a short checked run)
+LOCAL_CATEGORY_PATH := dragon/libs/arstream
+
+LOCAL_LIBRARIES := libARSAL libARStream
+
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/Sources
+
+LOCAL_SRC_FILES := \
+	TestBench/Common/MicroBenchmark/ARSTREAM_MicroBenchmark_TestBench.c \
+	TestBench/Linux/MicroBenchmark/ARSTREAM_MicroBenchmark_LinuxTestBench.c
+
+include $(BUILD_EXECUTABLE)
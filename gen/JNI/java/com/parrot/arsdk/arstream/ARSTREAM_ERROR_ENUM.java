@@ -54,7 +54,13 @@ public enum ARSTREAM_ERROR_ENUM {
    /** Object is busy and the operation can not be applied on running objects */
     ARSTREAM_ERROR_BUSY (4, "Object is busy and the operation can not be applied on running objects"),
    /** Frame queue is full */
-    ARSTREAM_ERROR_QUEUE_FULL (5, "Frame queue is full");
+    ARSTREAM_ERROR_QUEUE_FULL (5, "Frame queue is full"),
+   /** Clocks are not synchronized yet */
+    ARSTREAM_ERROR_NOT_SYNCHRONIZED (6, "Clocks are not synchronized yet"),
+   /** No data was received before the timeout */
+    ARSTREAM_ERROR_TIMEOUT (7, "No data was received before the timeout"),
+   /** The transport layer failed to send or receive data */
+    ARSTREAM_ERROR_TRANSPORT (8, "The transport layer failed to send or receive data");
 
     private final int value;
     private final String comment;
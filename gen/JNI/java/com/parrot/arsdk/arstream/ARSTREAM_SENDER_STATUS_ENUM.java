@@ -45,11 +45,13 @@ public enum ARSTREAM_SENDER_STATUS_ENUM {
     eARSTREAM_SENDER_STATUS_UNKNOWN_ENUM_VALUE (Integer.MIN_VALUE, "Dummy value for all unknown cases"),
    /** Frame was sent and acknowledged by peer */
     ARSTREAM_SENDER_STATUS_FRAME_SENT (0, "Frame was sent and acknowledged by peer"),
-   /** Frame was not sent, and was cancelled by a new frame */
-    ARSTREAM_SENDER_STATUS_FRAME_CANCEL (1, "Frame was not sent, and was cancelled by a new frame"),
+   /** Frame was not sent, and was cancelled by a new frame, or abandoned by the reader */
+    ARSTREAM_SENDER_STATUS_FRAME_CANCEL (1, "Frame was not sent, and was cancelled by a new frame, or abandoned by the reader"),
    /** We received a full ack for an old frame. The callback will be called with null pointer and zero size. */
     ARSTREAM_SENDER_STATUS_FRAME_LATE_ACK (2, "We received a full ack for an old frame. The callback will be called with null pointer and zero size."),
-   ARSTREAM_SENDER_STATUS_MAX (3);
+   /** Frame was not sent before its maximum age, and was cancelled */
+    ARSTREAM_SENDER_STATUS_FRAME_EXPIRED (3, "Frame was not sent before its maximum age, and was cancelled"),
+   ARSTREAM_SENDER_STATUS_MAX (4);
 
     private final int value;
     private final String comment;
@@ -62,6 +62,15 @@ const char* ARSTREAM_Error_ToString (eARSTREAM_ERROR error)
     case ARSTREAM_ERROR_QUEUE_FULL:
         return "Frame queue is full";
         break;
+    case ARSTREAM_ERROR_NOT_SYNCHRONIZED:
+        return "Clocks are not synchronized yet";
+        break;
+    case ARSTREAM_ERROR_TIMEOUT:
+        return "No data was received before the timeout";
+        break;
+    case ARSTREAM_ERROR_TRANSPORT:
+        return "The transport layer failed to send or receive data";
+        break;
     default:
         break;
     }